@@ -0,0 +1,334 @@
+/* AssetCache.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <AssetCache.h>
+
+#include <Log.h>
+
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAS_ZLIB
+	#include <zlib.h>
+#endif
+#ifdef HAS_BROTLI
+	#include <brotli/encode.h>
+#endif
+
+namespace {
+
+	/// Files smaller then this are not compressed
+	constexpr std::size_t MIN_COMPRESS_SIZE = 256;
+
+	bool isCompressible(const std::string &file) {
+		static const char *EXTENSIONS[] = {
+			".html", ".css", ".js", ".json", ".xml", ".m3u", ".txt", ".svg"
+		};
+		for (const char *ext : EXTENSIONS) {
+			const std::size_t len = std::char_traits<char>::length(ext);
+			if (file.size() >= len && file.compare(file.size() - len, len, ext) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool readAll(const std::string &path, std::string &data) {
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) {
+			return false;
+		}
+		data.clear();
+		char buf[16 * 1024];
+		ssize_t size;
+		while ((size = ::read(fd, buf, sizeof(buf))) > 0) {
+			data.append(buf, size);
+		}
+		::close(fd);
+		return size == 0;
+	}
+
+	std::string makeETag(const std::string &data, const struct stat &st) {
+		// FNV-1a over the content, so a touch without change keeps the ETag
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (const char c : data) {
+			hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+		}
+		char etag[64];
+		if (data.empty()) {
+			std::snprintf(etag, sizeof(etag), "\"%lx-%lx\"",
+				static_cast<unsigned long>(st.st_size), static_cast<unsigned long>(st.st_mtime));
+		} else {
+			std::snprintf(etag, sizeof(etag), "\"%lx-%016llx\"",
+				static_cast<unsigned long>(data.size()), static_cast<unsigned long long>(hash));
+		}
+		return etag;
+	}
+
+	std::string makeHTTPDate(const std::time_t time) {
+		struct tm tm;
+		char date[64];
+		::gmtime_r(&time, &tm);
+		std::strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+		return date;
+	}
+
+	std::string compressGzip(const std::string &data) {
+#ifdef HAS_ZLIB
+		z_stream zs = {};
+		// 15 + 16 = max window with a gzip header
+		if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+			return std::string();
+		}
+		std::string out(deflateBound(&zs, data.size()), '\0');
+		zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+		zs.avail_in = data.size();
+		zs.next_out = reinterpret_cast<Bytef *>(&out[0]);
+		zs.avail_out = out.size();
+		const int result = deflate(&zs, Z_FINISH);
+		out.resize(zs.total_out);
+		deflateEnd(&zs);
+		return result == Z_STREAM_END ? out : std::string();
+#else
+		(void)data;
+		return std::string();
+#endif
+	}
+
+	std::string compressBrotli(const std::string &data) {
+#ifdef HAS_BROTLI
+		std::size_t size = BrotliEncoderMaxCompressedSize(data.size());
+		std::string out(size, '\0');
+		if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+				data.size(), reinterpret_cast<const uint8_t *>(data.data()), &size,
+				reinterpret_cast<uint8_t *>(&out[0]))) {
+			return std::string();
+		}
+		out.resize(size);
+		return out;
+#else
+		(void)data;
+		return std::string();
+#endif
+	}
+
+	/// Use the precompressed file next to it (eg. 'x.js.gz'), else compress it
+	/// ourselves when build with support for it
+	std::string makeVariant(const std::string &path, const std::string &ext,
+			const std::string &data, std::string (*compress)(const std::string &)) {
+		std::string variant;
+		if (!readAll(path + ext, variant)) {
+			variant = compress(data);
+		}
+		return (variant.size() < data.size()) ? variant : std::string();
+	}
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+AssetCache::AssetCache() :
+	_inotifyFD(-1) {}
+
+AssetCache::~AssetCache() {
+	base::MutexLock lock(_mutex);
+	clear_L();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void AssetCache::load(const std::string &webPath) {
+	base::MutexLock lock(_mutex);
+	load_L(webPath);
+}
+
+AssetCache::SpAsset AssetCache::get(const std::string &webPath, const std::string &file) {
+	base::MutexLock lock(_mutex);
+	if (webPath != _webPath) {
+		load_L(webPath);
+	}
+	handleFileEvents_L();
+	const auto it = _assets.find(file);
+	if (it != _assets.end()) {
+		return it->second;
+	}
+	// Not loaded yet, or changed since then
+	if (file.find("..") != std::string::npos) {
+		return nullptr;
+	}
+	SpAsset asset = readFile_L(file);
+	if (asset) {
+		_assets[file] = asset;
+	}
+	return asset;
+}
+
+AssetCache::SpAsset AssetCache::getRendered(const SpAsset &asset,
+		const std::string &key, const RenderFunction &render) {
+	base::MutexLock lock(_mutex);
+	Rendered &rendered = _rendered[asset->path];
+	if (rendered.source != asset || rendered.key != key) {
+		std::shared_ptr<Asset> result = std::make_shared<Asset>();
+		result->path = asset->path;
+		result->data = render(asset->data);
+		result->size = result->data.size();
+		result->lastModified = asset->lastModified;
+		result->gzip = compressGzip(result->data);
+		result->brotli = compressBrotli(result->data);
+		struct stat st = {};
+		result->etag = makeETag(result->data, st);
+		rendered.source = asset;
+		rendered.key = key;
+		rendered.asset = result;
+	}
+	return rendered.asset;
+}
+
+void AssetCache::load_L(const std::string &webPath) {
+	clear_L();
+	_webPath = webPath;
+	_inotifyFD = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_inotifyFD == -1) {
+		SI_LOG_PERROR("inotify_init1");
+	}
+	loadDirectory_L("");
+	std::size_t size = 0;
+	for (const auto &[_, asset] : _assets) {
+		size += asset->data.size() + asset->gzip.size() + asset->brotli.size();
+	}
+	SI_LOG_INFO("Loaded @#1 files (@#2 KB) from web path @#3", _assets.size(), size / 1024, _webPath);
+}
+
+void AssetCache::loadDirectory_L(const std::string &dir) {
+	const std::string path = dir.empty() ? _webPath : _webPath + "/" + dir;
+	if (_inotifyFD != -1) {
+		const int wd = ::inotify_add_watch(_inotifyFD, path.c_str(),
+			IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE |
+			IN_MOVED_FROM | IN_MOVED_TO);
+		if (wd != -1) {
+			_watchDirs[wd] = dir;
+		}
+	}
+	DIR *dp = ::opendir(path.c_str());
+	if (dp == nullptr) {
+		return;
+	}
+	while (const struct dirent *entry = ::readdir(dp)) {
+		const std::string name = entry->d_name;
+		if (name == "." || name == "..") {
+			continue;
+		}
+		const std::string file = dir.empty() ? name : dir + "/" + name;
+		struct stat st;
+		if (::stat((_webPath + "/" + file).c_str(), &st) != 0) {
+			continue;
+		}
+		if (S_ISDIR(st.st_mode)) {
+			loadDirectory_L(file);
+		} else if (S_ISREG(st.st_mode)) {
+			SpAsset asset = readFile_L(file);
+			if (asset) {
+				_assets[file] = asset;
+			}
+		}
+	}
+	::closedir(dp);
+}
+
+AssetCache::SpAsset AssetCache::readFile_L(const std::string &file) const {
+	std::shared_ptr<Asset> asset = std::make_shared<Asset>();
+	asset->path = _webPath + "/" + file;
+	struct stat st;
+	if (::stat(asset->path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+		return nullptr;
+	}
+	const bool compressible = isCompressible(file);
+	asset->size = st.st_size;
+	asset->sendFile = asset->size >= MAX_CACHED_SIZE ||
+		(asset->size >= SENDFILE_SIZE && !compressible);
+	if (!asset->sendFile) {
+		if (!readAll(asset->path, asset->data)) {
+			return nullptr;
+		}
+		asset->size = asset->data.size();
+		if (compressible && asset->size >= MIN_COMPRESS_SIZE) {
+			asset->gzip = makeVariant(asset->path, ".gz", asset->data, &compressGzip);
+			asset->brotli = makeVariant(asset->path, ".br", asset->data, &compressBrotli);
+		}
+	}
+	asset->etag = makeETag(asset->data, st);
+	asset->lastModified = makeHTTPDate(st.st_mtime);
+	return asset;
+}
+
+void AssetCache::handleFileEvents_L() {
+	if (_inotifyFD == -1) {
+		return;
+	}
+	alignas(struct inotify_event) char buf[4096];
+	ssize_t size;
+	while ((size = ::read(_inotifyFD, buf, sizeof(buf))) > 0) {
+		for (char *ptr = buf; ptr < buf + size; ) {
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+			ptr += sizeof(struct inotify_event) + event->len;
+			const auto dir = _watchDirs.find(event->wd);
+			if (dir == _watchDirs.end() || event->len == 0) {
+				continue;
+			}
+			std::string file = dir->second.empty() ?
+				std::string(event->name) : dir->second + "/" + event->name;
+			// A precompressed variant changed, then drop the file itself
+			for (const char *ext : { ".gz", ".br" }) {
+				if (file.size() > 3 && file.compare(file.size() - 3, 3, ext) == 0) {
+					file.erase(file.size() - 3);
+				}
+			}
+			if ((event->mask & IN_ISDIR) != 0) {
+				if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+					loadDirectory_L(file);
+				}
+				continue;
+			}
+			SI_LOG_DEBUG("Web file changed: @#1", file);
+			_assets.erase(file);
+			_rendered.erase(_webPath + "/" + file);
+		}
+	}
+}
+
+void AssetCache::clear_L() {
+	if (_inotifyFD != -1) {
+		::close(_inotifyFD);
+		_inotifyFD = -1;
+	}
+	_watchDirs.clear();
+	_assets.clear();
+	_rendered.clear();
+}
@@ -0,0 +1,127 @@
+/* AssetCache.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef ASSET_CACHE_H_INCLUDE
+#define ASSET_CACHE_H_INCLUDE ASSET_CACHE_H_INCLUDE
+
+#include <base/Mutex.h>
+
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/// The class @c AssetCache keeps the files of the web path in memory, with
+/// their compressed variants, ETag and Last-Modified date. The web path is
+/// watched with inotify, so changed files are read again on next request.
+class AssetCache {
+	public:
+
+		/// Files from this size that do not compress are send with sendfile
+		static constexpr std::size_t SENDFILE_SIZE = 64 * 1024;
+
+		/// Files from this size are always send with sendfile
+		static constexpr std::size_t MAX_CACHED_SIZE = 4 * 1024 * 1024;
+
+		struct Asset {
+			std::string path;         // full path of the file on disk
+			std::string data;         // empty when send with sendfile
+			std::string gzip;         // gzip variant or empty
+			std::string brotli;       // brotli variant or empty
+			std::size_t size = 0;     // size of the (uncompressed) file
+			std::string etag;
+			std::string lastModified;
+			bool sendFile = false;
+		};
+		using SpAsset = std::shared_ptr<const Asset>;
+
+		/// Function to fill in the template data of a file
+		using RenderFunction = std::function<std::string(const std::string &data)>;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		AssetCache();
+
+		virtual ~AssetCache();
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Read all files of the web path and start watching it
+		/// @param webPath specifies the path of the web files
+		void load(const std::string &webPath);
+
+		/// Get the requested file
+		/// @param webPath specifies the path of the web files, when it differs
+		/// from the loaded one the cache is loaded again
+		/// @param file specifies the file relative to the web path
+		/// @return the asset or nullptr if the file is not found
+		SpAsset get(const std::string &webPath, const std::string &file);
+
+		/// Get the requested file with its template data filled in. The result
+		/// is kept until the file or the @p key changes.
+		/// @param asset specifies the asset from @c get()
+		/// @param key specifies all the data the render function depends on
+		/// @param render specifies the function filling in the template
+		SpAsset getRendered(const SpAsset &asset, const std::string &key,
+			const RenderFunction &render);
+
+	private:
+
+		///
+		void load_L(const std::string &webPath);
+
+		/// Load all files in this directory and its sub directories
+		void loadDirectory_L(const std::string &dir);
+
+		/// Read the file and make the compressed variants
+		SpAsset readFile_L(const std::string &file) const;
+
+		/// Handle the pending inotify events and drop the changed files
+		void handleFileEvents_L();
+
+		/// Stop watching and forget all files
+		void clear_L();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		struct Rendered {
+			SpAsset source;
+			std::string key;
+			SpAsset asset;
+		};
+
+		base::Mutex _mutex;
+		std::string _webPath;
+		int _inotifyFD;
+		std::unordered_map<int, std::string> _watchDirs;
+		std::unordered_map<std::string, SpAsset> _assets;
+		std::unordered_map<std::string, Rendered> _rendered;
+};
+
+#endif // ASSET_CACHE_H_INCLUDE
@@ -28,27 +28,33 @@
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
 
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
 HttpServer::HttpServer(
 	base::XMLSupport &xml,
 	StreamManager &streamManager,
 	const Properties &properties) :
 	ThreadBase("HttpServer"),
-	HttpcServer(20, "HTTP", streamManager, properties),
-	_xml(xml) {}
+	HttpcServer("HTTP", streamManager, properties),
+	_xml(xml),
+	_statusCache(xml, STATUS_REFRESH_INTERVAL) {}
 
 HttpServer::~HttpServer() {
+	terminateWorkers();
 	cancelThread();
 	joinThread();
 }
 
-void HttpServer::initialize(
-		int port,
-		bool nonblock) {
-	HttpcServer::initialize(port, nonblock);
+void HttpServer::initialize(const int port) {
+	_assetCache.load(_properties.getWebPath());
+	HttpcServer::initialize(port);
 	startThread();
 }
 
@@ -56,25 +62,96 @@ void HttpServer::threadEntry() {
 	SI_LOG_INFO("Setting up HTTP server");
 
 	for (;; ) {
-		// call poll with a timeout of 500 ms
-		poll(500);
+		// call poll with a timeout of at most 500 ms, and keep the status
+		// snapshot up to date for the polling web pages
+		const std::chrono::milliseconds refresh = _statusCache.refreshIfDue();
+		poll(static_cast<int>(std::min<std::chrono::milliseconds::rep>(500, refresh.count())));
 	}
 }
 
-std::size_t HttpServer::readFile(const char *filePath, std::string &data) const {
-	try {
-		std::ifstream file;
-		file.open(filePath);
-		if (file.is_open()) {
-			data = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-			file.close();
-			return data.size();
+bool HttpServer::sendAsset(SocketClient &client, const bool headOnly,
+		const std::string &file, const std::string &contentType,
+		const AssetCache::SpAsset &asset, const unsigned int rtspPort) {
+	const HeaderVector &headers = client.getHeaders();
+	std::string extraHeaders = StringConverter::stringFormat("ETag: @#1\r\nLast-Modified: @#2\r\n",
+		asset->etag, asset->lastModified);
+
+	// Does the client have this version already
+	const std::string ifNoneMatch = headers.getFieldParameter("If-None-Match");
+	const bool notModified = !ifNoneMatch.empty() ?
+		(ifNoneMatch.find(asset->etag) != std::string::npos || ifNoneMatch == "*") :
+		(headers.getFieldParameter("If-Modified-Since") == asset->lastModified);
+	if (notModified) {
+		std::string htmlBody;
+		getHtmlBodyWithContent(htmlBody, HTML_NOT_MODIFIED, file, contentType, 0, 0, rtspPort, extraHeaders);
+		if (!client.sendData(htmlBody.data(), htmlBody.size(), 0)) {
+			SI_LOG_ERROR("Send htmlBody failed");
+			return false;
+		}
+		return true;
+	}
+
+	// Pick the smallest variant the client accepts
+	const std::string *content = &asset->data;
+	if (!asset->gzip.empty() || !asset->brotli.empty()) {
+		extraHeaders += "Vary: Accept-Encoding\r\n";
+		const std::string acceptEncoding = headers.getFieldParameter("Accept-Encoding");
+		if (!asset->brotli.empty() && acceptEncoding.find("br") != std::string::npos) {
+			content = &asset->brotli;
+			extraHeaders += "Content-Encoding: br\r\n";
+		} else if (!asset->gzip.empty() && acceptEncoding.find("gzip") != std::string::npos) {
+			content = &asset->gzip;
+			extraHeaders += "Content-Encoding: gzip\r\n";
 		}
-	} catch (...) {
-		// Eat this exception
 	}
-	SI_LOG_ERROR("Unable to read from File: @#1", filePath);
-	return 0;
+	const std::size_t size = asset->sendFile ? asset->size : content->size();
+
+	std::string htmlBody;
+	getHtmlBodyWithContent(htmlBody, HTML_OK, file, contentType, size, 0, rtspPort, extraHeaders);
+	if (!client.sendData(htmlBody.data(), htmlBody.size(), 0)) {
+		SI_LOG_ERROR("Send htmlBody failed");
+		return false;
+	}
+	if (headOnly || size == 0) {
+		return true;
+	}
+	if (asset->sendFile) {
+		const int fd = ::open(asset->path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) {
+			SI_LOG_PERROR("Unable to open File: @#1", asset->path);
+			return false;
+		}
+		off_t offset = 0;
+		while (static_cast<std::size_t>(offset) < size) {
+			const ssize_t sent = ::sendfile(client.getFD(), fd, &offset, size - offset);
+			if (sent <= 0) {
+				if (sent == -1 && errno == EAGAIN) {
+					// Client socket is non-blocking, so wait until the
+					// client made room again (same timeout as writeData)
+					struct pollfd pfd;
+					pfd.fd = client.getFD();
+					pfd.events = POLLOUT;
+					pfd.revents = 0;
+					const int ready = ::poll(&pfd, 1, SEND_TIMEOUT_MS);
+					if (ready > 0 && (pfd.revents & POLLOUT) != 0) {
+						continue;
+					}
+					SI_LOG_ERROR("sendfile: Client @#1 did not read for @#2 ms or closed",
+						client.getIPAddressOfSocket(), SEND_TIMEOUT_MS);
+					break;
+				}
+				SI_LOG_PERROR("sendfile");
+				break;
+			}
+		}
+		::close(fd);
+		return static_cast<std::size_t>(offset) == size;
+	}
+	if (!client.sendData(content->data(), content->size(), 0)) {
+		SI_LOG_ERROR("Send docType failed");
+		return false;
+	}
+	return true;
 }
 
 bool HttpServer::methodPost(SocketClient &client) {
@@ -83,6 +160,7 @@ bool HttpServer::methodPost(SocketClient &client) {
 		const std::string file = client.getRequestedFile();
 		if (file == "/SatPI.xml") {
 			_xml.fromXML(content);
+			_statusCache.invalidate();
 		}
 	}
 	// setup reply
@@ -134,84 +212,108 @@ bool HttpServer::methodGet(SocketClient &client, bool headOnly) {
 				file.erase(found + 4, 1);
 			}
 
-			const std::string filePath = _properties.getWebPath() + "/" + file;
 			if (file == "SatPI.xml") {
-				_xml.addToXML(docType);
+				docType = _statusCache.getXML();
 				docTypeSize = docType.size();
 				getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_XML, docTypeSize, 0);
+			} else if (file == "status.json" || file.compare(0, 12, "status.json?") == 0) {
+				// Only the values changed after version 'since' of 'epoch'
+				const TransportParamVector &params = client.getTransportParameters();
+				const std::string since = params.getParameter("since");
+				const std::string epoch = params.getParameter("epoch");
+				docType = _statusCache.getJSON(std::strtoull(since.data(), nullptr, 10),
+					std::strtoul(epoch.data(), nullptr, 10));
+				docTypeSize = docType.size();
+				getHtmlBodyWithContent(htmlBody, HTML_OK, "status.json", CONTENT_TYPE_JSON, docTypeSize, 0);
 			} else if (file == "log.json") {
 				docType = Log::makeJSON();
 				docTypeSize = docType.size();
 				getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_JSON, docTypeSize, 0);
+			} else if (file == "metrics") {
+				docType = _streamManager.getMetrics();
+				docTypeSize = docType.size();
+				getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_METRICS, docTypeSize, 0);
 			} else if (file == "STOP") {
 				exitRequest = true;
 				getHtmlBodyWithContent(htmlBody, HTML_NO_RESPONSE, "", CONTENT_TYPE_HTML, 0, 0);
 			} else if (file == "RESTART") {
 				restartRequest = true;
 				getHtmlBodyWithContent(htmlBody, HTML_RESET_CONTENT, "", CONTENT_TYPE_HTML, 0, 0);
-			} else if ((docTypeSize = readFile(filePath.data(), docType))) {
+			} else if (const AssetCache::SpAsset asset = _assetCache.get(_properties.getWebPath(), file)) {
 				if (file.find(".xml") != std::string::npos) {
 					// check if the request is the SAT>IP description xml then fill in the server version, UUID,
 					// XSatipM3U, presentationURL and tuner string
-					if (docType.find("urn:ses-com:device") != std::string::npos) {
+					if (asset->data.find("urn:ses-com:device") != std::string::npos) {
 						SI_LOG_DEBUG("Client: @#1 requested @#2", client.getIPAddressOfSocket(), file);
 						// check did we get our desc.xml (we assume there are some @#1 in there)
-						if (docType.find("@#1") != std::string::npos) {
+						if (asset->data.find("@#1") != std::string::npos) {
 							// @todo 'presentationURL' change this later
 							const std::string presentationURL = StringConverter::stringFormat("http://@#1:@#2/",
 									_properties.getIpAddress(),
 									std::to_string(_properties.getHttpPort()));
 							const std::string modelName = StringConverter::stringFormat("SatPI Server (@#1)", _properties.getIpAddress());
-							const std::string newDocType = StringConverter::stringFormat(docType.data(),
-								modelName, _properties.getUPnPVersion(), _properties.getUUID(), presentationURL,
-								_streamManager.getXMLDeliveryString(), _properties.getXSatipM3U());
-							docType = newDocType;
-							docTypeSize = docType.size();
+							const std::string upnpVersion = _properties.getUPnPVersion();
+							const std::string uuid = _properties.getUUID();
+							const std::string delivery = _streamManager.getXMLDeliveryString();
+							const std::string xSatipM3U = _properties.getXSatipM3U();
+							const std::string key = modelName + upnpVersion + uuid + presentationURL + delivery + xSatipM3U;
+							return sendAsset(client, headOnly, file, CONTENT_TYPE_XML,
+								_assetCache.getRendered(asset, key, [&](const std::string &data) {
+									return StringConverter::stringFormat(data.data(), modelName,
+										upnpVersion, uuid, presentationURL, delivery, xSatipM3U);
+								}), _properties.getRtspPort());
 						}
 					}
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_XML, docTypeSize, 0, _properties.getRtspPort());
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_XML, asset, _properties.getRtspPort());
 				} else if (file.find(".html") != std::string::npos) {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_HTML, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_HTML, asset);
 				} else if (file.find(".json") != std::string::npos) {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_JSON, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_JSON, asset);
 				} else if (file.find(".js") != std::string::npos) {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_JS, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_JS, asset);
 				} else if (file.find(".css") != std::string::npos) {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_CSS, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_CSS, asset);
 				} else if (file.find(".m3u") != std::string::npos) {
 					SI_LOG_DEBUG("Client: @#1 requested @#2", client.getIPAddressOfSocket(), file);
 					// did we read our *.m3u, we assume there are some @#1
-					if (docType.find("@#1") != std::string::npos) {
+					if (asset->data.find("@#1") != std::string::npos) {
 						const std::string rtsp = StringConverter::stringFormat("@#1:@#2",
 								_properties.getIpAddress(), std::to_string(_properties.getRtspPort()));
 						const std::string http = StringConverter::stringFormat("@#1:@#2",
 								_properties.getIpAddress(), std::to_string(_properties.getHttpPort()));
-						std::stringstream docTypeStream(docType);
-						docType.clear();
-						for (std::string line; std::getline(docTypeStream, line); ) {
-							line += "\n";
-							if (line.find("@#1") == std::string::npos) {
-								docType += line;
-								continue;
-							}
-							if (line.find("rtsp://") != std::string::npos) {
-								docType += StringConverter::stringFormat(line.data(), rtsp);
-							} else if (line.find("http://") != std::string::npos) {
-								docType += StringConverter::stringFormat(line.data(), http);
-							}
-						}
-						docTypeSize = docType.size();
+						return sendAsset(client, headOnly, file, CONTENT_TYPE_VIDEO,
+							_assetCache.getRendered(asset, rtsp + " " + http, [&](const std::string &data) {
+								std::stringstream docTypeStream(data);
+								std::string m3u;
+								for (std::string line; std::getline(docTypeStream, line); ) {
+									line += "\n";
+									if (line.find("@#1") == std::string::npos) {
+										m3u += line;
+										continue;
+									}
+									if (line.find("rtsp://") != std::string::npos) {
+										m3u += StringConverter::stringFormat(line.data(), rtsp);
+									} else if (line.find("http://") != std::string::npos) {
+										m3u += StringConverter::stringFormat(line.data(), http);
+									}
+								}
+								return m3u;
+							}));
 					}
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_VIDEO, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_VIDEO, asset);
 				} else if ((file.find(".png") != std::string::npos) ||
 				           (file.find(".ico") != std::string::npos)) {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_PNG, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_PNG, asset);
 				} else {
-					getHtmlBodyWithContent(htmlBody, HTML_OK, file, CONTENT_TYPE_HTML, docTypeSize, 0);
+					return sendAsset(client, headOnly, file, CONTENT_TYPE_HTML, asset);
 				}
 			} else {
 				file = _properties.getWebPath() + "/" + "404.html";
-				docTypeSize = readFile(file.data(), docType);
+				const AssetCache::SpAsset notFound = _assetCache.get(_properties.getWebPath(), "404.html");
+				if (notFound) {
+					docType = notFound->data;
+					docTypeSize = docType.size();
+				}
 				getHtmlBodyWithContent(htmlBody, HTML_NOT_FOUND, file, CONTENT_TYPE_HTML, docTypeSize, 0);
 			}
 		}
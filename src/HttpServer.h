@@ -20,7 +20,9 @@
 #ifndef HTTP_SERVER_H_INCLUDE
 #define HTTP_SERVER_H_INCLUDE HTTP_SERVER_H_INCLUDE
 
+#include <AssetCache.h>
 #include <FwDecl.h>
+#include <StatusCache.h>
 #include <base/ThreadBase.h>
 #include <HttpcServer.h>
 
@@ -32,6 +34,16 @@ FW_DECL_NS1(base, XMLSupport);
 class HttpServer :
 	public base::ThreadBase,
 	public HttpcServer {
+	public:
+
+		/// The status snapshot for the polling web pages is regenerated at this
+		/// rate
+		static constexpr std::chrono::milliseconds STATUS_REFRESH_INTERVAL{1000};
+
+		/// A client that does not read a sendfile() asset for this long is
+		/// given up
+		static constexpr int SEND_TIMEOUT_MS = 5000;
+
 		// =======================================================================
 		// Constructors and destructor
 		// =======================================================================
@@ -50,9 +62,7 @@ class HttpServer :
 	public:
 
 		/// Call this to initialize, setup and start this server
-		virtual void initialize(
-			int port,
-			bool nonblock);
+		virtual void initialize(int port);
 
 	protected:
 
@@ -65,8 +75,10 @@ class HttpServer :
 		/// Method for getting the required files
 		virtual bool methodPost(SocketClient &client) final;
 
-		///
-		std::size_t readFile(const char *filePath, std::string &data) const;
+		/// Send the asset, or 304 Not Modified when the client has it already
+		bool sendAsset(SocketClient &client, bool headOnly,
+			const std::string &file, const std::string &contentType,
+			const AssetCache::SpAsset &asset, unsigned int rtspPort = 0);
 
 		// =======================================================================
 		// Data members
@@ -74,6 +86,8 @@ class HttpServer :
 	private:
 
 		base::XMLSupport &_xml;
+		AssetCache _assetCache;
+		StatusCache _statusCache;
 
 };
 
@@ -63,11 +63,13 @@ const std::string HttpcServer::HTML_NO_RESPONSE         = "204 No Response";
 const std::string HttpcServer::HTML_RESET_CONTENT       = "205 Reset Content";
 const std::string HttpcServer::HTML_NOT_FOUND           = "404 Not Found";
 const std::string HttpcServer::HTML_MOVED_PERMA         = "301 Moved Permanently";
+const std::string HttpcServer::HTML_NOT_MODIFIED        = "304 Not Modified";
 const std::string HttpcServer::HTML_REQUEST_TIMEOUT     = "408 Request Timeout";
 const std::string HttpcServer::HTML_SERVICE_UNAVAILABLE = "503 Service Unavailable";
 
 //const std::string HttpcServer::CONTENT_TYPE_XML         = "application/xml; charset=UTF-8";
 const std::string HttpcServer::CONTENT_TYPE_JSON        = "application/json; charset=UTF-8";
+const std::string HttpcServer::CONTENT_TYPE_METRICS     = "text/plain; version=0.0.4; charset=utf-8";
 const std::string HttpcServer::CONTENT_TYPE_JS          = "application/javascript; charset=UTF-8";
 const std::string HttpcServer::CONTENT_TYPE_XML         = "text/xml; charset=UTF-8";
 const std::string HttpcServer::CONTENT_TYPE_HTML        = "text/html; charset=UTF-8";
@@ -78,31 +80,30 @@ const std::string HttpcServer::CONTENT_TYPE_VIDEO       = "video/MP2T";
 const std::string HttpcServer::CONTENT_TYPE_TEXT        = "text/parameters";
 
 HttpcServer::HttpcServer(
-		int maxClients,
 		const std::string& protocol,
 		StreamManager& streamManager,
 		const Properties& properties) :
-		TcpSocket(maxClients, protocol),
+		TcpSocket(protocol),
 		_streamManager(streamManager),
 		_properties(properties) {}
 
-void HttpcServer::initialize(
-		int port,
-		bool nonblock) {
-	TcpSocket::initialize(_properties.getBindIPAddress(), port, nonblock);
+void HttpcServer::initialize(const int port) {
+	TcpSocket::initialize(_properties.getBindIPAddress(), port,
+		_properties.getMaxClients(), _properties.getHttpcThreads());
 }
 
 void HttpcServer::getHtmlBodyWithContent(std::string &htmlBody,
 		const std::string &html, const std::string &location,
 		const std::string &contentType, std::size_t docTypeSize,
-		std::size_t cseq, const unsigned int rtspPort) const {
+		std::size_t cseq, const unsigned int rtspPort,
+		const std::string &extraHeaders) const {
 	// Check do we need to add TvHeadend specific "X-SATIP-RTSP-Port"
 	const std::string satipRtspPort = (rtspPort == 0) ? "" :
 		StringConverter::stringFormat("X-SATIP-RTSP-Port: @#1\r\n", rtspPort);
 
 	htmlBody = StringConverter::stringFormat(HTML_BODY_WITH_CONTENT,
 		getProtocolVersionString(), html, location, cseq, contentType,
-		docTypeSize, satipRtspPort);
+		docTypeSize, satipRtspPort + extraHeaders);
 }
 
 void HttpcServer::getHtmlBodyNoContent(std::string &htmlBody, const std::string &html,
@@ -127,7 +128,9 @@ bool HttpcServer::process(SocketClient &client) {
 		processStreamingRequest(client);
 	} else if (protocol == "HTTP") {
 		if (method == "GET" || method == "HEAD") {
-			if (client.hasTransportParameters()) {
+			// The status API takes a query too, but is no stream request
+			if (client.hasTransportParameters() &&
+					client.getRequestedFile().compare(0, 13, "/status.json?") != 0) {
 				processStreamingRequest(client);
 			} else {
 				methodGet(client, method == "HEAD");
@@ -152,8 +155,8 @@ void HttpcServer::processStreamingRequest(SocketClient &client) {
 		client.getProtocolString(), "None", client.getIPAddressOfSocket(),
 		client.getSocketPort(), client.getRawMessage());
 
-	HeaderVector headers = client.getHeaders();
-	TransportParamVector params = client.getTransportParameters();
+	const HeaderVector &headers = client.getHeaders();
+	const TransportParamVector &params = client.getTransportParameters();
 
 	// Save clients seq number
 	const std::string fieldCSeq = headers.getFieldParameter("CSeq");
@@ -177,13 +180,16 @@ void HttpcServer::processStreamingRequest(SocketClient &client) {
 	} else if (sessionID.empty() && method == "DESCRIBE") {
 		methodDescribe("", cseq, feIndex, httpcReply);
 	} else {
+		// With more request threads the session requests are still handled
+		// one after the other, so finding, updating and tearing down a
+		// StreamClient can not interleave with an other request
+		base::MutexLock lock(_sessionMutex);
 		const auto [stream, streamClient] = _streamManager.findStreamAndClientFor(client);
 		if (stream != nullptr) {
 			stream->processStreamingRequest(client, streamClient);
 
 			// Check the Method
 			if (method == "GET") {
-				stream->update(streamClient);
 				const std::string multicast = params.getParameter("multicast");
 				if (multicast.empty()) {
 					getHtmlBodyNoContent(httpcReply, HTML_OK, "", CONTENT_TYPE_VIDEO, 0);
@@ -192,6 +198,14 @@ void HttpcServer::processStreamingRequest(SocketClient &client) {
 					getHtmlBodyWithContent(httpcReply, HTML_OK, "", CONTENT_TYPE_TEXT, content.size(), 0);
 					httpcReply += content;
 				}
+				// Send the reply before starting the stream, else the first stream
+				// data can overtake the HTTP header on this connection
+				SI_LOG_DEBUG("Send reply in @#1 ms\r\n@#2", sw.getIntervalMS(), httpcReply);
+				if (!client.sendData(httpcReply.data(), httpcReply.size(), MSG_NOSIGNAL)) {
+					SI_LOG_ERROR("Send Streaming reply failed");
+				}
+				httpcReply.clear();
+				stream->update(streamClient);
 			} else if (method == "SETUP") {
 				httpcReply = streamClient->getSetupMethodReply(stream->getStreamID());
 
@@ -226,6 +240,9 @@ void HttpcServer::processStreamingRequest(SocketClient &client) {
 			httpcReply += content;
 		}
 	}
+	if (httpcReply.empty()) {
+		return;
+	}
 	const unsigned long time = sw.getIntervalMS();
 	SI_LOG_DEBUG("Send reply in @#1 ms\r\n@#2", time, httpcReply);
 	if (!client.sendData(httpcReply.data(), httpcReply.size(), MSG_NOSIGNAL)) {
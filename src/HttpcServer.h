@@ -22,6 +22,7 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <base/Mutex.h>
 #include <socket/TcpSocket.h>
 #include <Unused.h>
 
@@ -48,6 +49,7 @@ class HttpcServer :
 		static const std::string HTML_RESET_CONTENT;
 		static const std::string HTML_NOT_FOUND;
 		static const std::string HTML_MOVED_PERMA;
+		static const std::string HTML_NOT_MODIFIED;
 		static const std::string HTML_REQUEST_TIMEOUT;
 		static const std::string HTML_SERVICE_UNAVAILABLE;
 
@@ -56,6 +58,7 @@ class HttpcServer :
 		static const std::string CONTENT_TYPE_ICO;
 		static const std::string CONTENT_TYPE_JS;
 		static const std::string CONTENT_TYPE_JSON;
+		static const std::string CONTENT_TYPE_METRICS;
 		static const std::string CONTENT_TYPE_PNG;
 		static const std::string CONTENT_TYPE_XML;
 		static const std::string CONTENT_TYPE_TEXT;
@@ -67,7 +70,6 @@ class HttpcServer :
 	public:
 
 		HttpcServer(
-			int maxClients,
 			const std::string& protocol,
 			StreamManager& streamManager,
 			const Properties& properties);
@@ -75,16 +77,15 @@ class HttpcServer :
 		virtual ~HttpcServer() = default;
 
 		/// Call this to initialize, setup and start this server
-		virtual void initialize(
-			int port,
-			bool nonblock);
+		virtual void initialize(int port);
 
 	protected:
 
 		///
 		void getHtmlBodyWithContent(std::string &htmlBody, const std::string &html,
 			const std::string &location, const std::string &contentType,
-			std::size_t docTypeSize, std::size_t cseq, unsigned int rtspPort = 0) const;
+			std::size_t docTypeSize, std::size_t cseq, unsigned int rtspPort = 0,
+			const std::string &extraHeaders = std::string()) const;
 
 		///
 		void getHtmlBodyNoContent(std::string &htmlBody, const std::string &html,
@@ -126,6 +127,10 @@ class HttpcServer :
 		StreamManager& _streamManager;
 		const Properties& _properties;
 
+	private:
+
+		base::Mutex _sessionMutex;
+
 };
 
 #endif // HTTPC_SERVER_H_INCLUDE
@@ -22,8 +22,15 @@
 #include <StringConverter.h>
 #include <base/Mutex.h>
 #include <base/JSONSerializer.h>
+#include <base/Thread.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <ctime>
 
 #include <stdio.h>
@@ -34,12 +41,91 @@
 #define LOG_SIZE 550
 
 namespace {
+
+	/// Single producer (the owning thread), single consumer (whoever holds
+	/// globalLogMutex) ring with the pending log messages of one thread
+	class LogRing {
+		public:
+			struct Entry {
+				int priority = 0;
+				struct timespec timeStamp = {};
+				std::string msg;
+			};
+
+			/// Add a message to the ring
+			/// @return false if the ring is full
+			bool push(const int priority, const struct timespec &timeStamp, std::string &&msg) {
+				const std::size_t head = _head.load(std::memory_order_relaxed);
+				if (head - _tail.load(std::memory_order_acquire) == RING_SIZE) {
+					return false;
+				}
+				Entry &entry = _entry[head % RING_SIZE];
+				entry.priority = priority;
+				entry.timeStamp = timeStamp;
+				entry.msg = std::move(msg);
+				_head.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			/// Move all pending messages to @c entries
+			void popAll(std::vector<Entry> &entries) {
+				std::size_t tail = _tail.load(std::memory_order_relaxed);
+				const std::size_t head = _head.load(std::memory_order_acquire);
+				for (; tail != head; ++tail) {
+					entries.push_back(std::move(_entry[tail % RING_SIZE]));
+				}
+				_tail.store(tail, std::memory_order_release);
+			}
+
+			/// The owning thread has gone
+			void close() {
+				_closed.store(true, std::memory_order_release);
+			}
+
+			bool isClosed() const {
+				return _closed.load(std::memory_order_acquire);
+			}
+
+		private:
+			static constexpr std::size_t RING_SIZE = 256;
+			std::array<Entry, RING_SIZE> _entry;
+			std::atomic<std::size_t> _head{0};
+			std::atomic<std::size_t> _tail{0};
+			std::atomic<bool> _closed{false};
+	};
+	using SpLogRing = std::shared_ptr<LogRing>;
+
+	/// Closes the ring when the owning thread exits
+	struct ThreadLogRing {
+		~ThreadLogRing() {
+			if (ring) {
+				ring->close();
+			}
+		}
+		SpLogRing ring;
+	};
+
 	base::Mutex globalLogMutex;
+	base::Mutex ringMutex;
+	std::vector<SpLogRing> ringVector;
+	std::atomic<bool> logThreadRunning(false);
+	std::unique_ptr<base::Thread> logThread;
+	thread_local ThreadLogRing threadLogRing;
+
+	LogRing &getThreadLogRing() {
+		if (!threadLogRing.ring) {
+			threadLogRing.ring = std::make_shared<LogRing>();
+			base::MutexLock lock(ringMutex);
+			ringVector.push_back(threadLogRing.ring);
+		}
+		return *threadLogRing.ring;
+	}
+
 }
 
-bool Log::_syslogOn = false;
+std::atomic<bool> Log::_syslogOn(false);
 bool Log::_coutLog = true;
-bool Log::_logDebug = true;
+std::atomic<bool> Log::_logDebug(true);
 
 Log::LogBuffer Log::_appLogBuffer;
 
@@ -52,10 +138,34 @@ void Log::openAppLog(const char *deamonName, const bool daemonize) {
 }
 
 void Log::closeAppLog() {
+	if (logThread) {
+		logThread->terminateThread();
+		logThread.reset();
+	}
+	logThreadRunning = false;
+	{
+		base::MutexLock lock(globalLogMutex);
+		drain_L();
+	}
 	// close logging interface
 	closelog();
 }
 
+void Log::startLogThread() {
+	if (logThread) {
+		return;
+	}
+	logThread.reset(new base::Thread("Log", [] {
+		{
+			base::MutexLock lock(globalLogMutex);
+			drain_L();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return true;
+	}));
+	logThreadRunning = logThread->startThread();
+}
+
 void Log::startSysLog(bool start) {
 	_syslogOn = start;
 }
@@ -64,18 +174,54 @@ bool Log::getSysLogState() {
 	return _syslogOn;
 }
 
-void Log::log(const int priority, const std::string &msg) {
-	if ((priority & MPEGTS_TABLES) == MPEGTS_TABLES) {
+void Log::log(const int priority, std::string &&msg) {
+	if (!isEnabled(priority)) {
 		return;
 	}
-	if (priority == LOG_DEBUG && !_logDebug) {
+	struct timespec timeStamp;
+	clock_gettime(CLOCK_REALTIME, &timeStamp);
+	if (logThreadRunning.load(std::memory_order_acquire) &&
+			getThreadLogRing().push(priority, timeStamp, std::move(msg))) {
 		return;
 	}
+	// No log thread or our ring is full, then write it ourself after
+	// everything that is still pending (to keep the order of this thread)
+	base::MutexLock lock(globalLogMutex);
+	drain_L();
+	write_L(priority, timeStamp, msg);
+}
+
+void Log::drain_L() {
+	std::vector<SpLogRing> rings;
+	{
+		base::MutexLock lock(ringMutex);
+		rings = ringVector;
+	}
+	std::vector<LogRing::Entry> entries;
+	for (const SpLogRing &ring : rings) {
+		// Check closed before draining, so nothing can be missed
+		const bool closed = ring->isClosed();
+		ring->popAll(entries);
+		if (closed) {
+			base::MutexLock lock(ringMutex);
+			ringVector.erase(std::remove(ringVector.begin(), ringVector.end(), ring), ringVector.end());
+		}
+	}
+	// Merge the messages of the threads in time order
+	std::stable_sort(entries.begin(), entries.end(),
+		[](const LogRing::Entry &a, const LogRing::Entry &b) {
+			return (a.timeStamp.tv_sec < b.timeStamp.tv_sec) ||
+				(a.timeStamp.tv_sec == b.timeStamp.tv_sec && a.timeStamp.tv_nsec < b.timeStamp.tv_nsec);
+		});
+	for (const LogRing::Entry &entry : entries) {
+		write_L(entry.priority, entry.timeStamp, entry.msg);
+	}
+}
+
+void Log::write_L(const int priority, const struct timespec &timeStamp, const std::string &msg) {
 	// set timestamp
-	struct timespec timeStamp;
 	struct tm result;
 	char asciiTime[100];
-	clock_gettime(CLOCK_REALTIME, &timeStamp);
 	localtime_r(&timeStamp.tv_sec, &result);
 	std::strftime(asciiTime, sizeof(asciiTime), "%c", &result);
 
@@ -85,7 +231,6 @@ void Log::log(const int priority, const std::string &msg) {
 		&asciiTime[0], DIGIT(timeStamp.tv_nsec/100000, 4), &asciiTime[20]);
 
 	std::string::size_type index = 0;
-	base::MutexLock lock(globalLogMutex);
 	for (;;) {
 		std::string line = StringConverter::getline(msg, index, "\r\n");
 		if (line.empty()) {
@@ -118,6 +263,7 @@ std::string Log::makeJSON() {
 	json.startArrayWithName("log");
 	{
 		base::MutexLock lock(globalLogMutex);
+		drain_L();
 		if (!_appLogBuffer.empty()) {
 			for (const LogElem& elem : _appLogBuffer) {
 				json.startObject();
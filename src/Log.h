@@ -22,14 +22,28 @@
 
 #include <StringConverter.h>
 
+#include <atomic>
 #include <string>
 #include <deque>
 
 #include <sys/types.h>
 #include <syslog.h>
 #include <string.h>
+#include <time.h>
+
+#define MPEGTS_TABLES 0x100
+
+/// The lowest priority that is compiled in, like LOG_INFO to remove all
+/// debug logging at compile time (see Makefile option NODEBUGLOG)
+#ifndef SI_LOG_LEVEL
+#define SI_LOG_LEVEL LOG_DEBUG
+#endif
 
 /// The class @c Log.
+/// Log lines are formatted by the calling thread, but only when the priority
+/// is enabled. They are then queued into a lock-free ring of the calling
+/// thread and a log thread takes the timestamps apart and feeds syslog and
+/// the log buffer for the web interface.
 class Log {
 	public:
 		// =========================================================================
@@ -39,6 +53,10 @@ class Log {
 
 		static void closeAppLog();
 
+		/// Start the log thread, call it after daemonizing. Until then all
+		/// logging is done directly by the calling thread
+		static void startLogThread();
+
 		static void startSysLog(bool start);
 
 		static bool getSysLogState();
@@ -51,24 +69,51 @@ class Log {
 			return _logDebug;
 		}
 
+		/// Check if the requested priority will be logged, it should be
+		/// checked before formatting any of the log arguments
+		static bool isEnabled(const int priority) noexcept {
+			if ((priority & MPEGTS_TABLES) == MPEGTS_TABLES) {
+				return false;
+			}
+			if ((priority & LOG_PRIMASK) > SI_LOG_LEVEL) {
+				return false;
+			}
+			return (priority & LOG_PRIMASK) != LOG_DEBUG ||
+				_logDebug.load(std::memory_order_relaxed);
+		}
+
 		template <typename... Args>
 		static void binlog(int priority, const unsigned char* p, int length, const char * format, Args&&... args) {
 			std::string data = StringConverter::convertToHexASCIITable(p, length, 16);
 			std::string line = StringConverter::stringFormat(format, std::forward<Args>(args)...);
-			log(priority, StringConverter::stringFormat("@#1\r\n@#2\r\nEND\r\n", line, data));
+			log(priority, line + "\r\n" + data + "\r\nEND\r\n");
 		}
 
 		template <typename... Args>
 		static void applog(int priority, const char * format, Args&&... args) {
-			std::string line = StringConverter::stringFormat(format, std::forward<Args>(args)...);
-			log(priority, line);
+			log(priority, StringConverter::stringFormat(format, std::forward<Args>(args)...));
+		}
+
+		/// Same as @c applog, but prefix the line with the file and line number
+		template <typename... Args>
+		static void applogAt(int priority, const char *file, int line, const char * format, Args&&... args) {
+			log(priority, StringConverter::stringFormat("[@#1:@#2] ", STR(file, 45), DIGIT(line, 3)) +
+				StringConverter::stringFormat(format, std::forward<Args>(args)...));
 		}
 
 		static std::string makeJSON();
 
 	private:
 
-		static void log(int priority, const std::string &msg);
+		static void log(int priority, std::string &&msg);
+
+		/// Write the messages of all threads to syslog and the log buffer
+		/// @pre globalLogMutex should be locked
+		static void drain_L();
+
+		/// Write one (multi line) message to syslog and the log buffer
+		/// @pre globalLogMutex should be locked
+		static void write_L(int priority, const struct timespec &timeStamp, const std::string &msg);
 
 		struct LogElem {
 			LogElem(const int prio, const std::string m, const std::string t) :
@@ -89,31 +134,32 @@ class Log {
 		using LogBuffer = std::deque<LogElem>;
 
 		static LogBuffer _appLogBuffer;
-		static bool _syslogOn;
+		static std::atomic<bool> _syslogOn;
 		static bool _coutLog;
-		static bool _logDebug;
+		static std::atomic<bool> _logDebug;
 };
 
-#define MPEGTS_TABLES 0x100
+#define SI_LOG(priority, function, ...) \
+	do { if (Log::isEnabled(priority)) { function(priority, ##__VA_ARGS__); } } while (0)
 
 #ifdef DEBUG_LOG
-#define SI_LOG_INFO(format, ...)              Log::applog(LOG_INFO,  "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__))
-#define SB_LOG_INFO(subsys, format, ...)      Log::applog(LOG_INFO | subsys, "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__))
-#define SI_LOG_ERROR(format, ...)             Log::applog(LOG_ERR,   "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__))
-#define SI_LOG_DEBUG(format, ...)             Log::applog(LOG_DEBUG, "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__))
-#define SI_LOG_PERROR(format, ...)            Log::applog(LOG_ERR,   "[@#1:@#2] @#3: @#4 (code @#5)", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__), strerror(errno), errno)
-#define SI_LOG_GIA_PERROR(format, err, ...)   Log::applog(LOG_ERR,   "[@#1:@#2] @#3: @#4 (code @#5)", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(format, ##__VA_ARGS__), gai_strerror(err), err)
+#define SI_LOG_INFO(format, ...)              SI_LOG(LOG_INFO, Log::applogAt, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#define SB_LOG_INFO(subsys, format, ...)      SI_LOG(LOG_INFO | subsys, Log::applogAt, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#define SI_LOG_ERROR(format, ...)             SI_LOG(LOG_ERR, Log::applogAt, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#define SI_LOG_DEBUG(format, ...)             SI_LOG(LOG_DEBUG, Log::applogAt, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#define SI_LOG_PERROR(format, ...)            SI_LOG(LOG_ERR, Log::applogAt, __FILE__, __LINE__, "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), strerror(errno), errno)
+#define SI_LOG_GIA_PERROR(format, err, ...)   SI_LOG(LOG_ERR, Log::applogAt, __FILE__, __LINE__, "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), gai_strerror(err), err)
 #define SI_LOG_COND_DEBUG(cond, format, ...)  if (cond) { SI_LOG_DEBUG(format, ##__VA_ARGS__); }
-#define SI_LOG_BIN_DEBUG(p, length, fmt, ...) Log::binlog(LOG_DEBUG, p, length, "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(fmt, ##__VA_ARGS__))
+#define SI_LOG_BIN_DEBUG(p, length, fmt, ...) SI_LOG(LOG_DEBUG, Log::binlog, p, length, "[@#1:@#2] @#3", STR(__FILE__, 45), DIGIT(__LINE__, 3), StringConverter::stringFormat(fmt, ##__VA_ARGS__))
 #else
-#define SI_LOG_INFO(format, ...)              Log::applog(LOG_INFO,  format, ##__VA_ARGS__)
-#define SB_LOG_INFO(subsys, format, ...)      Log::applog(LOG_INFO | subsys,  format, ##__VA_ARGS__)
-#define SI_LOG_ERROR(format, ...)             Log::applog(LOG_ERR,   format, ##__VA_ARGS__)
-#define SI_LOG_DEBUG(format, ...)             Log::applog(LOG_DEBUG, format, ##__VA_ARGS__)
-#define SI_LOG_PERROR(format, ...)            Log::applog(LOG_ERR,   "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), strerror(errno), errno)
-#define SI_LOG_GIA_PERROR(format, err, ...)   Log::applog(LOG_ERR,   "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), gai_strerror(err), err)
+#define SI_LOG_INFO(format, ...)              SI_LOG(LOG_INFO, Log::applog, format, ##__VA_ARGS__)
+#define SB_LOG_INFO(subsys, format, ...)      SI_LOG(LOG_INFO | subsys, Log::applog, format, ##__VA_ARGS__)
+#define SI_LOG_ERROR(format, ...)             SI_LOG(LOG_ERR, Log::applog, format, ##__VA_ARGS__)
+#define SI_LOG_DEBUG(format, ...)             SI_LOG(LOG_DEBUG, Log::applog, format, ##__VA_ARGS__)
+#define SI_LOG_PERROR(format, ...)            SI_LOG(LOG_ERR, Log::applog, "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), strerror(errno), errno)
+#define SI_LOG_GIA_PERROR(format, err, ...)   SI_LOG(LOG_ERR, Log::applog, "@#1: @#2 (code @#3)", StringConverter::stringFormat(format, ##__VA_ARGS__), gai_strerror(err), err)
 #define SI_LOG_COND_DEBUG(cond, format, ...)  if (cond) { SI_LOG_DEBUG(format, ##__VA_ARGS__); }
-#define SI_LOG_BIN_DEBUG(p, length, fmt, ...) Log::binlog(LOG_DEBUG, p, length, fmt, ##__VA_ARGS__)
+#define SI_LOG_BIN_DEBUG(p, length, fmt, ...) SI_LOG(LOG_DEBUG, Log::binlog, p, length, fmt, ##__VA_ARGS__)
 #endif
 
 #endif // LOG_H_INCLUDE
@@ -35,7 +35,9 @@ Properties::Properties(
 		const std::string& ipAddress,
 		const std::string& bindIPAddress,
 		const unsigned int httpPortOpt,
-		const unsigned int rtspPortOpt) :
+		const unsigned int rtspPortOpt,
+		const unsigned int maxClientsOpt,
+		const unsigned int httpcThreadsOpt) :
 	XMLSupport(),
 	_uuid(uuid),
 	_versionString(satpi_version),
@@ -49,6 +51,8 @@ Properties::Properties(
 	_rtspPort = rtspPortOpt == 0 ? 554 : rtspPortOpt;
 	_httpPortOpt = httpPortOpt;
 	_rtspPortOpt = rtspPortOpt;
+	_maxClients = maxClientsOpt;
+	_httpcThreads = httpcThreadsOpt == 0 ? 1 : httpcThreadsOpt;
 	_ipAddress = ipAddress;
 	_bindIPAddress = bindIPAddress;
 
@@ -62,7 +66,7 @@ Properties::Properties(
 //  -- base::XMLSupport --------------------------------------------------------
 // =============================================================================
 
-void Properties::doFromXML(const std::string &xml) {
+void Properties::doFromXML(const base::XMLElement &xml) {
 	std::string element;
 	if (findXMLElement(xml, "xsatipm3u.value", element)) {
 		_xSatipM3U = element;
@@ -177,6 +181,16 @@ unsigned int Properties::getRtspPort() const {
 	return _rtspPort;
 }
 
+unsigned int Properties::getMaxClients() const {
+	base::MutexLock lock(_mutex);
+	return _maxClients;
+}
+
+unsigned int Properties::getHttpcThreads() const {
+	base::MutexLock lock(_mutex);
+	return _httpcThreads;
+}
+
 std::string Properties::getIpAddress() const {
 	base::MutexLock lock(_mutex);
 	return _ipAddress;
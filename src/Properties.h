@@ -37,6 +37,7 @@ class Properties :
 		static constexpr unsigned int TCP_PORT_MAX = 65535;
 		static constexpr unsigned int HTTP_PORT_MIN = 1024;
 		static constexpr unsigned int RTSP_PORT_MIN = 554;
+		static constexpr unsigned int HTTPC_THREADS_MAX = 16;
 
 		// =====================================================================
 		// -- Constructors and destructor --------------------------------------
@@ -51,7 +52,9 @@ class Properties :
 			const std::string& ipAddress,
 			const std::string& bindIPAddress,
 			unsigned int httpPortOpt,
-			unsigned int rtspPortOpt);
+			unsigned int rtspPortOpt,
+			unsigned int maxClientsOpt,
+			unsigned int httpcThreadsOpt);
 
 		virtual ~Properties() = default;
 
@@ -64,7 +67,7 @@ class Properties :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =====================================================================
 		// -- Other member functions -------------------------------------------
@@ -104,6 +107,12 @@ class Properties :
 		/// Get RtspPort
 		unsigned int getRtspPort() const;
 
+		/// Get the maximum amount of clients per HTTP/RTSP server (0 no limit)
+		unsigned int getMaxClients() const;
+
+		/// Get the amount of threads handling requests per HTTP/RTSP server
+		unsigned int getHttpcThreads() const;
+
 		/// Get IP Address
 		std::string getIpAddress() const;
 
@@ -147,6 +156,8 @@ class Properties :
 		std::string _appdataPathOpt;
 		unsigned int _httpPortOpt;
 		unsigned int _rtspPortOpt;
+		unsigned int _maxClients;
+		unsigned int _httpcThreads;
 		std::time_t _appStartTime;     // the application start time (EPOCH)
 		mutable bool _exitApplication;
 		mutable bool _restartApplication;
@@ -31,17 +31,16 @@ extern const char* const satpi_version;
 
 RtspServer::RtspServer(StreamManager& streamManager, const Properties& properties) :
 		ThreadBase("RtspServer"),
-		HttpcServer(20, "RTSP", streamManager, properties) {}
+		HttpcServer("RTSP", streamManager, properties) {}
 
 RtspServer::~RtspServer() {
+	terminateWorkers();
 	cancelThread();
 	joinThread();
 }
 
-void RtspServer::initialize(
-		int port,
-		bool nonblock) {
-	HttpcServer::initialize(port, nonblock);
+void RtspServer::initialize(const int port) {
+	HttpcServer::initialize(port);
 	startThread();
 }
 
@@ -43,7 +43,7 @@ class RtspServer :
 		virtual ~RtspServer();
 
 		/// Call this to initialize, setup and start this server
-		virtual void initialize(int port, bool nonblock);
+		virtual void initialize(int port);
 
 	protected:
 		/// Thread function
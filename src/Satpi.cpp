@@ -34,7 +34,8 @@ SatPI::SatPI(const SatPI::Params &params) :
 	_interface(params.ifaceName),
 	_streamManager(),
 	_properties(_interface.getUUID(), params.currentPath, params.appdataPath, params.webPath,
-		_interface.getIPAddress(), _interface.getBindIPAddress(), params.httpPort, params.rtspPort),
+		_interface.getIPAddress(), _interface.getBindIPAddress(), params.httpPort, params.rtspPort,
+		params.maxClients, params.httpcThreads),
 	_httpServer(*this, _streamManager, _properties),
 	_rtspServer(_streamManager, _properties),
 	_ssdpServer(params.ssdpTTL, _properties) {
@@ -43,7 +44,7 @@ SatPI::SatPI(const SatPI::Params &params) :
 	//
 	_streamManager.enumerateDevices(_interface.getIPAddress(),
 		_properties.getAppDataPath(), params.dvbPath, params.numberOfChildPIPE,
-		params.enableUnsecureFrontends);
+		params.numberOfHTTP, params.numberOfSynthetic, params.enableUnsecureFrontends);
 	//
 	std::string xml;
 	if (restoreXML(xml)) {
@@ -51,9 +52,12 @@ SatPI::SatPI(const SatPI::Params &params) :
 	} else {
 		saveXML();
 	}
+	if (params.enableUnsecureFrontends) {
+		_streamManager.enableCapture();
+	}
 
-	_httpServer.initialize(_properties.getHttpPort(), true);
-	_rtspServer.initialize(_properties.getRtspPort(), true);
+	_httpServer.initialize(_properties.getHttpPort());
+	_rtspServer.initialize(_properties.getRtspPort());
 	if (params.ssdp) {
 		_ssdpServer.startThread();
 	}
@@ -80,8 +84,8 @@ void SatPI::doAddToXML(std::string &xml) const {
 	ADD_XML_END_ELEMENT(xml, "data");
 }
 
-void SatPI::doFromXML(const std::string &xml) {
-	std::string element;
+void SatPI::doFromXML(const base::XMLElement &xml) {
+	base::XMLElement element;
 	if (findXMLElement(xml, "streams", element)) {
 		_streamManager.fromXML(element);
 	}
@@ -49,8 +49,12 @@ class SatPI :
 			unsigned int httpPort = 0;
 			unsigned int rtspPort = 0;
 			int numberOfChildPIPE = 0;
+			int numberOfHTTP = 0;
+			int numberOfSynthetic = 0;
 			bool enableUnsecureFrontends = false;
 			int ssdpTTL = 1;
+			unsigned int maxClients = 0;
+			unsigned int httpcThreads = 1;
 		};
 
 		// =====================================================================
@@ -69,7 +73,7 @@ class SatPI :
 
 		virtual void doAddToXML(std::string &xml) const final;
 
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =======================================================================
 		// -- base::XMLSaveSupport -----------------------------------------------
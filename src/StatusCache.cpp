@@ -0,0 +1,289 @@
+/* StatusCache.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <StatusCache.h>
+
+#include <base/JSONSerializer.h>
+#include <base/XMLSupport.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <random>
+
+namespace {
+
+	/// Append the numeric character reference, like '#65' or '#x41', as UTF-8
+	/// @return false when it is not a valid character reference
+	bool appendCharRef(std::string &str, const std::string &entity) {
+		const bool hex = entity[1] == 'x' || entity[1] == 'X';
+		const char *digits = entity.data() + (hex ? 2 : 1);
+		// strtoul skips whitespace and accepts signs, a reference has only digits
+		if (*digits == '\0' || !std::isxdigit(static_cast<unsigned char>(*digits))) {
+			return false;
+		}
+		char *endPtr = nullptr;
+		const unsigned long cp = std::strtoul(digits, &endPtr, hex ? 16 : 10);
+		if (*endPtr != '\0' || cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+			return false;
+		}
+		if (cp < 0x80) {
+			str += static_cast<char>(cp);
+		} else if (cp < 0x800) {
+			str += static_cast<char>(0xC0 | (cp >> 6));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		} else if (cp < 0x10000) {
+			str += static_cast<char>(0xE0 | (cp >> 12));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		} else {
+			str += static_cast<char>(0xF0 | (cp >> 18));
+			str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+		return true;
+	}
+
+	/// Replace the XML entities made by @see base::XMLSupport::makeXMLString
+	std::string decodeXMLString(const std::string &xml, std::size_t begin, std::size_t end) {
+		std::string str;
+		str.reserve(end - begin);
+		while (begin < end) {
+			const std::size_t amp = xml.find('&', begin);
+			if (amp == std::string::npos || amp >= end) {
+				str.append(xml, begin, end - begin);
+				break;
+			}
+			str.append(xml, begin, amp - begin);
+			const std::size_t semi = xml.find(';', amp);
+			if (semi == std::string::npos || semi >= end) {
+				str.append(xml, amp, end - amp);
+				break;
+			}
+			const std::string entity = xml.substr(amp + 1, semi - amp - 1);
+			if (entity == "amp") {
+				str += '&';
+			} else if (entity == "quot") {
+				str += '"';
+			} else if (entity == "apos") {
+				str += '\'';
+			} else if (entity == "gt") {
+				str += '>';
+			} else if (entity == "lt") {
+				str += '<';
+			} else if (entity.size() > 1 && entity[0] == '#') {
+				if (!appendCharRef(str, entity)) {
+					str.append(xml, amp, semi - amp + 1);
+				}
+			} else {
+				str.append(xml, amp, semi - amp + 1);
+			}
+			begin = semi + 1;
+		}
+		return str;
+	}
+
+	using Leafs = std::vector<std::pair<std::string, std::string>>;
+
+	/// Get the leaf elements of the XML with their path in document order,
+	/// repeated elements get an index like 'stream[1]'
+	Leafs flattenXML(const std::string &xml) {
+		struct Element {
+			std::string path;
+			std::map<std::string, unsigned int> children;
+			bool hasChild;
+			std::size_t contentBegin;
+		};
+		Leafs leafs;
+		std::vector<Element> stack;
+		stack.push_back({ "", {}, false, 0 });
+
+		std::size_t pos = 0;
+		while ((pos = xml.find('<', pos)) != std::string::npos) {
+			// Skip comments, declarations and processing instructions
+			if (xml.compare(pos, 4, "<!--") == 0) {
+				const std::size_t end = xml.find("-->", pos);
+				if (end == std::string::npos) {
+					break;
+				}
+				pos = end + 3;
+				continue;
+			}
+			const std::size_t end = xml.find('>', pos);
+			if (end == std::string::npos) {
+				break;
+			}
+			if (xml[pos + 1] == '?' || xml[pos + 1] == '!') {
+				pos = end + 1;
+				continue;
+			}
+			if (xml[pos + 1] == '/') {
+				// End tag
+				if (stack.size() > 1) {
+					const Element &element = stack.back();
+					if (!element.hasChild) {
+						leafs.emplace_back(element.path, decodeXMLString(xml, element.contentBegin, pos));
+					}
+					stack.pop_back();
+				}
+			} else {
+				// Start tag
+				const bool emptyElement = xml[end - 1] == '/';
+				const std::size_t nameEnd = std::min(xml.find_first_of(" \t\r\n/>", pos + 1), end);
+				const std::string name = xml.substr(pos + 1, nameEnd - pos - 1);
+				Element &parent = stack.back();
+				parent.hasChild = true;
+				const unsigned int index = parent.children[name]++;
+				std::string path = parent.path.empty() ? name : parent.path + "/" + name;
+				if (index > 0) {
+					path += "[" + std::to_string(index) + "]";
+				}
+				if (emptyElement) {
+					leafs.emplace_back(path, std::string());
+				} else {
+					stack.push_back({ path, {}, false, end + 1 });
+				}
+			}
+			pos = end + 1;
+		}
+		return leafs;
+	}
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+StatusCache::StatusCache(
+	const base::XMLSupport &xml,
+	const std::chrono::milliseconds refreshInterval) :
+	_xml(xml),
+	_refreshInterval(refreshInterval),
+	_epoch(std::random_device()()) {}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+std::string StatusCache::getXML() {
+	base::MutexLock lock(_mutex);
+	request_L();
+	return _snapshot;
+}
+
+std::string StatusCache::getJSON(const std::uint64_t since, const std::uint32_t epoch) {
+	base::MutexLock lock(_mutex);
+	request_L();
+
+	// Send everything when the client is new, from before a restart or
+	// from before values were added or removed
+	const bool full = since == 0 || epoch != _epoch || since < _layoutVersion || since > _version;
+
+	base::JSONSerializer json;
+	json.startObject();
+	json.addValueNumber("epoch", std::to_string(_epoch));
+	json.addValueNumber("version", std::to_string(_version));
+	json.addValueNumber("full", full ? "true" : "false");
+	json.startObjectWithName("values");
+	for (const Value &value : _values) {
+		if (full || value.version > since) {
+			json.addValueString(value.path, value.value);
+		}
+	}
+	json.endObject();
+	json.endObject();
+	return json.getString();
+}
+
+void StatusCache::invalidate() {
+	base::MutexLock lock(_mutex);
+	_valid = false;
+}
+
+std::chrono::milliseconds StatusCache::refreshIfDue() {
+	base::MutexLock lock(_mutex);
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!_valid) {
+		return _refreshInterval;
+	}
+	if (now - _lastRequest > IDLE_TIMEOUT) {
+		// Nobody is polling, the next request regenerates the snapshot
+		_valid = false;
+		return _refreshInterval;
+	}
+	if (now - _lastRefresh >= _refreshInterval) {
+		refresh_L(now);
+		return _refreshInterval;
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		_refreshInterval - (now - _lastRefresh));
+}
+
+void StatusCache::request_L() {
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	_lastRequest = now;
+	if (!_valid) {
+		refresh_L(now);
+	}
+}
+
+void StatusCache::refresh_L(const std::chrono::steady_clock::time_point now) {
+	std::string xml;
+	_xml.addToXML(xml);
+	_snapshot.swap(xml);
+	_lastRefresh = now;
+	_valid = true;
+	updateValues_L();
+}
+
+void StatusCache::updateValues_L() {
+	const Leafs leafs = flattenXML(_snapshot);
+	const std::uint64_t version = _version + 1;
+
+	// Values added or removed, then all are new
+	bool sameLayout = leafs.size() == _values.size();
+	for (std::size_t i = 0; sameLayout && i < leafs.size(); ++i) {
+		sameLayout = leafs[i].first == _values[i].path;
+	}
+	if (!sameLayout) {
+		_values.clear();
+		_values.reserve(leafs.size());
+		for (const auto &[path, str] : leafs) {
+			_values.push_back({ path, str, version });
+		}
+		_layoutVersion = version;
+		_version = version;
+		return;
+	}
+	bool changed = false;
+	for (std::size_t i = 0; i < leafs.size(); ++i) {
+		Value &value = _values[i];
+		if (value.value != leafs[i].second) {
+			value.value = leafs[i].second;
+			value.version = version;
+			changed = true;
+		}
+	}
+	if (changed) {
+		_version = version;
+	}
+}
@@ -0,0 +1,121 @@
+/* StatusCache.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef STATUS_CACHE_H_INCLUDE
+#define STATUS_CACHE_H_INCLUDE STATUS_CACHE_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+FW_DECL_NS1(base, XMLSupport);
+
+/// The class @c StatusCache keeps a versioned snapshot of the status XML, so
+/// polling web pages do not take the locks of every Stream, Device and Filter
+/// on each request. The snapshot is regenerated at a fixed rate by calling
+/// @c refreshIfDue, no matter how many clients are polling. Without polling
+/// clients the regeneration stops.
+class StatusCache {
+	public:
+
+		/// Stop the regeneration when no client polled for this long
+		static constexpr std::chrono::milliseconds IDLE_TIMEOUT{10000};
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// @param xml specifies the XML to take the snapshots from
+		/// @param refreshInterval specifies the rate the snapshot is
+		/// regenerated with
+		StatusCache(const base::XMLSupport &xml,
+			std::chrono::milliseconds refreshInterval);
+
+		virtual ~StatusCache() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the status as XML
+		std::string getXML();
+
+		/// Get the status as JSON, one value per XML leaf element with its path
+		/// as name, in document order.
+		/// @param since specifies the version the client has, only the values
+		/// changed after it are returned. Use 0 to get all values
+		/// @param epoch specifies the epoch the client got with @c since, all
+		/// values are returned when it is not the epoch of this instance
+		std::string getJSON(std::uint64_t since, std::uint32_t epoch);
+
+		/// Regenerate the snapshot on the next request (eg. after a config change)
+		void invalidate();
+
+		/// Regenerate the snapshot when the refresh interval passed and a client
+		/// polled recently, call this periodically
+		/// @return the time until the next regeneration is due
+		std::chrono::milliseconds refreshIfDue();
+
+	private:
+
+		/// Make sure there is a snapshot for the request
+		void request_L();
+
+		/// Regenerate the snapshot
+		void refresh_L(std::chrono::steady_clock::time_point now);
+
+		/// Update the values with the leaf elements of the snapshot
+		void updateValues_L();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		struct Value {
+			std::string path;
+			std::string value;
+			std::uint64_t version;
+		};
+
+		base::Mutex _mutex;
+		const base::XMLSupport &_xml;
+		const std::chrono::milliseconds _refreshInterval;
+		/// Random per instance, so a client notices a restart
+		const std::uint32_t _epoch;
+		std::chrono::steady_clock::time_point _lastRefresh;
+		std::chrono::steady_clock::time_point _lastRequest;
+		bool _valid = false;
+		std::string _snapshot;
+		std::uint64_t _version = 0;
+		/// Version in which values were added or removed, clients from before
+		/// it get all values
+		std::uint64_t _layoutVersion = 0;
+		/// The leaf values in document order
+		std::vector<Value> _values;
+};
+
+#endif // STATUS_CACHE_H_INCLUDE
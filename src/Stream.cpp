@@ -24,6 +24,7 @@
 #include <Utils.h>
 #include <output/StreamClient.h>
 #include <input/Device.h>
+#include <input/capture/CaptureWriter.h>
 #include <input/dvb/Frontend.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DVBS.h>
@@ -39,6 +40,19 @@
 #include <algorithm>
 #include <thread>
 
+namespace {
+
+	/// Get the path of a file that is written to the app data path
+	/// @param name specifies the file name, without a path
+	/// @return the path or an empty string when the name is not allowed
+	std::string makeAppDataFilePath(const std::string &appDataPath, const std::string &name) {
+		if (name.find('/') != std::string::npos || name == "." || name == "..") {
+			return std::string();
+		}
+		return appDataPath + "/" + name;
+	}
+
+}
 
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
@@ -59,7 +73,12 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_writeIndex(0),
 	_readIndex(0),
 	_sendInterval(100),
-	_signalLock(false) {
+	_signalLock(false),
+	_ringUsed(0),
+	_latencySampling(0),
+	_latencySampleCnt(0),
+	_capture(std::make_shared<input::capture::CaptureWriter>()),
+	_captureEnabled(false) {
 	ASSERT(device);
 #ifdef LIBDVBCSA
 	ASSERT(decrypt);
@@ -76,6 +95,16 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_tsEmpty.initialize(0, 0);
 	std::memcpy(_tsEmpty.getWriteBufferPtr(), nullPacked.data(), nullPacked.size());
 	_tsEmpty.addAmountOfBytesWritten(188);
+	_device->setCaptureWriter(_capture);
+}
+
+Stream::~Stream() {
+	// A session can still be active when the application stops, so stop the
+	// threads that use this Stream before it is gone
+	base::MutexLock lock(_mutex);
+	if (_streamInUse) {
+		stopStreaming();
+	}
 }
 
 // ===========================================================================
@@ -96,13 +125,33 @@ void Stream::doAddToXML(std::string &xml) const {
 	ADD_XML_CHECKBOX(xml, "enable", (_enabled ? "true" : "false"));
 	ADD_XML_ELEMENT(xml, "attached", _streamInUse ? "yes" : "no");
 	ADD_XML_NUMBER_INPUT(xml, "rtcpSignalUpdate", _rtcpSignalUpdate, 1, 5);
+	ADD_XML_NUMBER_INPUT(xml, "latencySampling", _latencySampling.load(), 0, 100000);
+	{
+		base::MutexLock lock(_latencyDumpMutex);
+		ADD_XML_TEXT_INPUT(xml, "latencyDumpFile", _latencyDumpFile);
+	}
+	ADD_XML_TEXT_INPUT(xml, "captureFile", getCaptureFile());
+	ADD_XML_ELEMENT(xml, "captureBytes", _capture->getBytesWritten());
+	ADD_XML_ELEMENT(xml, "captureBytesDropped", _capture->getBytesDropped());
+	ADD_XML_BEGIN_ELEMENT(xml, "latency");
+		ADD_XML_ELEMENT(xml, "ingestP50", _latencyIngestUS.getQuantile(0.5));
+		ADD_XML_ELEMENT(xml, "ingestP99", _latencyIngestUS.getQuantile(0.99));
+		ADD_XML_ELEMENT(xml, "descrambleP50", _latencyDescrambleUS.getQuantile(0.5));
+		ADD_XML_ELEMENT(xml, "descrambleP99", _latencyDescrambleUS.getQuantile(0.99));
+		ADD_XML_ELEMENT(xml, "queueP50", _latencyQueueUS.getQuantile(0.5));
+		ADD_XML_ELEMENT(xml, "queueP99", _latencyQueueUS.getQuantile(0.99));
+		ADD_XML_ELEMENT(xml, "sendP50", _latencySendUS.getQuantile(0.5));
+		ADD_XML_ELEMENT(xml, "sendP99", _latencySendUS.getQuantile(0.99));
+		ADD_XML_ELEMENT(xml, "totalP50", _latencyTotalUS.getQuantile(0.5));
+		ADD_XML_ELEMENT(xml, "totalP99", _latencyTotalUS.getQuantile(0.99));
+	ADD_XML_END_ELEMENT(xml, "latency");
 	for (const output::SpStreamClient &client : _streamClientVector) {
 		client->addToXML(xml);
 	}
 	_device->addToXML(xml);
 }
 
-void Stream::doFromXML(const std::string &xml) {
+void Stream::doFromXML(const base::XMLElement &xml) {
 	std::string element;
 	if (findXMLElement(xml, "enable.value", element)) {
 		_enabled = (element == "true") ? true : false;
@@ -110,6 +159,44 @@ void Stream::doFromXML(const std::string &xml) {
 	if (findXMLElement(xml, "rtcpSignalUpdate.value", element)) {
 		_rtcpSignalUpdate = std::stoi(element);
 	}
+	if (findXMLElement(xml, "latencySampling.value", element)) {
+		_latencySampling = std::stoi(element);
+	}
+	if (findXMLElement(xml, "latencyDumpFile.value", element)) {
+		base::MutexLock lock(_latencyDumpMutex);
+		if (element != _latencyDumpFile) {
+			_latencyDumpFile = element;
+			_latencyDump.close();
+			if (!_latencyDumpFile.empty()) {
+				const std::string path = makeAppDataFilePath(_appDataPath, _latencyDumpFile);
+				if (!path.empty()) {
+					_latencyDump.open(path, std::ios::out | std::ios::app);
+				}
+				if (!_latencyDump.is_open()) {
+					SI_LOG_ERROR("Frontend: @#1, Unable to open latency dump file: @#2 (only a file name in @#3)",
+						_device->getFeID(), _latencyDumpFile, _appDataPath);
+				}
+			}
+		}
+	}
+	// A capture is not restored from the saved configuration, it is only
+	// started by a client and only with --enable-unsecure-frontends
+	if (_captureEnabled && findXMLElement(xml, "captureFile.value", element) &&
+			element != getCaptureFile()) {
+		if (element.empty()) {
+			_capture->close();
+		} else {
+			const std::string path = makeAppDataFilePath(_appDataPath, element);
+			if (!path.empty() && _capture->open(path)) {
+				SI_LOG_INFO("Frontend: @#1, Capturing to: @#2", _device->getFeID(), path);
+				// Start with the PIDs that are open now, the replay needs them
+				_capture->addPIDs(_device->getFilter().getPidCSV());
+			} else {
+				SI_LOG_ERROR("Frontend: @#1, Unable to open capture file: @#2 (only a new file name in @#3)",
+					_device->getFeID(), element, _appDataPath);
+			}
+		}
+	}
 	_device->fromXML(xml);
 }
 
@@ -117,6 +204,16 @@ void Stream::doFromXML(const std::string &xml) {
 // -- Other member functions -------------------------------------------------
 // ===========================================================================
 
+std::string Stream::getCaptureFile() const {
+	if (!_capture->isOpen()) {
+		return std::string();
+	}
+	std::string path;
+	std::string file;
+	StringConverter::splitPath(_capture->getPath(), path, file);
+	return file;
+}
+
 StreamID Stream::getStreamID() const {
 	return _device->getStreamID();
 }
@@ -196,9 +293,7 @@ void Stream::stopStreaming() {
 }
 
 void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &client) {
-	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
-	const TransportParamVector params = client.getTransportParameters();
+	const TransportParamVector &params = client.getTransportParameters();
 	const std::string method = client.getMethod();
 	if (method == "GET") {
 		const std::string multicast = params.getParameter("multicast");
@@ -209,7 +304,6 @@ void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &cli
 				client.spoofHeaderWith(StringConverter::stringFormat(
 					"Transport: RTP/AVP;multicast;destination=@#1;port=@#2-@#3;ttl=@#4\r\n",
 					multiParam[0], multiParam[1], multiParam[2], multiParam[3]));
-				headers = client.getHeaders();
 				SI_LOG_INFO("Frontend: @#1, Setup Multicast (@#2) for StreamClient",
 					feID, multicast);
 				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: HTTP -> Multicast", feID);
@@ -220,7 +314,7 @@ void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &cli
 			_streamClientVector.push_back(output::StreamClientOutputHttp::makeSP(feID));
 		}
 	} else {
-		const std::string transport = headers.getFieldParameter("Transport");
+		const std::string transport = client.getHeaders().getFieldParameter("Transport");
 		if (transport.find("unicast") != std::string::npos) {
 			if (transport.find("RTP/AVP") != std::string::npos) {
 				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTP/AVP", feID);
@@ -240,7 +334,7 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 		const bool newSession, const std::string sessionID) {
 	base::MutexLock lock(_mutex);
 	const FeID id = _device->getFeID();
-	const TransportParamVector params = socketClient.getTransportParameters();
+	const TransportParamVector &params = socketClient.getTransportParameters();
 	const input::InputSystem msys = params.getMSYSParameter();
 	const bool shareable = _device->capableToShare(params);
 
@@ -286,6 +380,9 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 					id, sessionID);
 			}
 			client->setSocketClient(socketClient);
+			// Claim the slot under the lock, so a concurrent request (other
+			// request thread) can not get the same StreamClient
+			client->setSessionID(sessionID);
 			_streamInUse = true;
 			return client;
 		}
@@ -310,7 +407,9 @@ void Stream::checkForSessionTimeout() {
 	if (!_streamInUse) {
 		return;
 	}
-	for (const output::SpStreamClient &client : _streamClientVector) {
+	// Iterate a copy, because teardown removes the StreamClient from the vector
+	const std::vector<output::SpStreamClient> streamClientVector = _streamClientVector;
+	for (const output::SpStreamClient &client : streamClientVector) {
 		if (client->sessionTimeout() || !_enabled) {
 			if (_enabled) {
 				SI_LOG_INFO("Frontend: @#1, Watchdog kicked in for StreamClient with SessionID @#2",
@@ -324,6 +423,38 @@ void Stream::checkForSessionTimeout() {
 	}
 }
 
+void Stream::addToMetrics(base::MetricsWriter &metrics) const {
+	const std::string labels = base::MetricsWriter::makeLabel("frontend",
+		std::to_string(_device->getFeID().getID()));
+	metrics.addCounter("satpi_stream_read_bytes_total",
+		"Bytes of TS data read from the device", labels, _bytesRead.get());
+	metrics.addCounter("satpi_stream_read_packets_total",
+		"TS packets read from the device", labels, _packetsRead.get());
+	metrics.addGauge("satpi_stream_ring_buffers_used",
+		"Buffers in the ring waiting to be send to the clients", labels,
+		_ringUsed.load(std::memory_order_relaxed));
+	metrics.addGauge("satpi_stream_ring_buffers_size",
+		"Number of buffers in the ring", labels, _tsBuffer.size());
+	metrics.addCounter("satpi_stream_ring_overflows_total",
+		"Buffers read from the device and dropped because the ring was full", labels, _ringOverflows.get());
+	metrics.addHistogram("satpi_stream_latency_ingest_microseconds",
+		"Traced buffers: time from read completed until filtering completed", labels, _latencyIngestUS);
+	metrics.addHistogram("satpi_stream_latency_descramble_microseconds",
+		"Traced buffers: time from filtering until decrypting completed", labels, _latencyDescrambleUS);
+	metrics.addHistogram("satpi_stream_latency_queue_microseconds",
+		"Traced buffers: time from decrypting until sending started", labels, _latencyQueueUS);
+	metrics.addHistogram("satpi_stream_latency_send_microseconds",
+		"Traced buffers: time to send to all clients", labels, _latencySendUS);
+	metrics.addHistogram("satpi_stream_latency_total_microseconds",
+		"Traced buffers: time from read completed until send to all clients", labels, _latencyTotalUS);
+	_device->addToMetrics(metrics, labels);
+
+	base::MutexLock lock(_mutex);
+	for (const output::SpStreamClient &client : _streamClientVector) {
+		client->addToMetrics(metrics, labels);
+	}
+}
+
 bool Stream::update(output::SpStreamClient streamClient) {
 	base::MutexLock lock(_mutex);
 
@@ -333,6 +464,9 @@ bool Stream::update(output::SpStreamClient streamClient) {
 	if (!_device->update()) {
 		return false;
 	}
+	if (_capture->isOpen()) {
+		_capture->addPIDs(_device->getFilter().getPidCSV());
+	}
 
 	// start or restart streaming again
 	const bool threadStopped = _threadDeviceDataReader.isStopped();
@@ -351,14 +485,17 @@ bool Stream::teardown(output::SpStreamClient streamClient) {
 		_device->getFeID(), streamClient->getSessionID());
 
 	const auto s = std::find(_streamClientVector.begin(), _streamClientVector.end(), streamClient);
-	if (s != _streamClientVector.end()) {
-		_streamClientVector.erase(s);
-	}
+	const bool found = s != _streamClientVector.end();
 
-	streamClient->teardown();
-	if (_streamClientVector.size() == 0) {
+	// The reader and monitor thread use the StreamClients without the lock, so
+	// stop them before the last one is removed and torn down
+	if (_streamClientVector.size() == (found ? 1u : 0u)) {
 		stopStreaming();
 	}
+	if (found) {
+		_streamClientVector.erase(s);
+	}
+	streamClient->teardown();
 	return true;
 }
 
@@ -368,8 +505,23 @@ bool Stream::processStreamingRequest(const SocketClient &client, output::SpStrea
 	if (client.hasTransportParameters()) {
 		const std::string method = client.getMethod();
 		if (method == "SETUP" || method == "PLAY"  || method == "GET") {
-			const TransportParamVector params = client.getTransportParameters();
+			TransportParamVector params = client.getTransportParameters();
+			// Hand a requested start position, like 'Range: bytes=<offset>-'
+			// or 'Range: npt=<sec>-', to the device as 'range' parameter
+			const std::string range = client.getHeaders().getFieldParameter("Range");
+			if (!range.empty()) {
+				params.replaceParameter("range", range);
+			}
 			_device->parseStreamString(params);
+			if (_capture->isOpen() && _device->hasDeviceFrequencyChanged()) {
+				std::string request;
+				for (const std::string &param : params) {
+					if (param.find('=') != std::string::npos) {
+						request += request.empty() ? param : "&" + param;
+					}
+				}
+				_capture->addTune(request);
+			}
 		}
 	}
 
@@ -383,6 +535,7 @@ bool Stream::processStreamingRequest(const SocketClient &client, output::SpStrea
 }
 
 std::string Stream::getSDPMediaLevelString() const {
+	base::MutexLock lock(_mutex);
 	_device->monitorSignal(false);
 	const std::string fmtp = _device->attributeDescribeString();
 	std::string mediaLevel;
@@ -400,7 +553,23 @@ bool Stream::threadExecuteDeviceDataReader() {
 
 //	SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4  A @#5", _device->getFeID(), _tsBuffer.size(), write, read, availableSize);
 	if (_device->isDataAvailable() && availableSize >= 1) {
+		// Should we trace this new buffer
+		const unsigned int sampling = _latencySampling.load(std::memory_order_relaxed);
+		if (sampling > 0 && _tsBuffer[_writeIndex].empty() && ++_latencySampleCnt >= sampling) {
+			_latencySampleCnt = 0;
+			_tsBuffer[_writeIndex].setTraced();
+		}
 		if (_device->readTSPackets(_tsBuffer[_writeIndex])) {
+			_bytesRead.add(_tsBuffer[_writeIndex].getCurrentBufferSize());
+			_packetsRead.add(_tsBuffer[_writeIndex].getNumberOfCompletedPackets());
+			// Ring is full, the write index would run into the read index and
+			// the ring would look empty, so drop this buffer instead
+			if (availableSize == 1) {
+				_ringOverflows.add();
+				_tsBuffer[_writeIndex].reset();
+				executeStreamClientWriter();
+				return true;
+			}
 #ifdef LIBDVBCSA
 			// When LIBDVBCSA is defined _decrypt is created
 			_decrypt->decrypt(_device->getFeIndex(), _device->getFeID(), _tsBuffer[_writeIndex]);
@@ -410,6 +579,9 @@ bool Stream::threadExecuteDeviceDataReader() {
 			_writeIndex %= _tsBuffer.size();
 			// reset next
 			_tsBuffer[_writeIndex].reset();
+			if (sampling > 0) {
+				stampDecrypted();
+			}
 		}
 	}
 	executeStreamClientWriter();
@@ -425,6 +597,8 @@ void Stream::executeStreamClientWriter() {
 	const size_t availableSize = (_writeIndex >= _readIndex) ?
 			(_writeIndex - _readIndex) : ((_tsBuffer.size() - _readIndex) + _writeIndex);
 
+	_ringUsed.store(availableSize, std::memory_order_relaxed);
+
 	if (availableSize > 0 || intervalExeeded) {
 		const size_t cnt = (availableSize > 4) ? 4 : 1;
 //		SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4 A @#5 C @#6", _device->getFeID(), _tsBuffer.size(), write, read, availableSize, cnt);
@@ -433,6 +607,11 @@ void Stream::executeStreamClientWriter() {
 			if (readyToSend) {
 				_t1 = _t2;
 				bool incrementReadIndex = false;
+				// Decrypted without a later read, see stampDecrypted()
+				if (!_tsBuffer[_readIndex].hasStamp(mpegts::PacketBuffer::Stage::DECRYPT)) {
+					_tsBuffer[_readIndex].stamp(mpegts::PacketBuffer::Stage::DECRYPT);
+				}
+				_tsBuffer[_readIndex].stamp(mpegts::PacketBuffer::Stage::SEND);
 				// Send the packet full or not, else send null packet
 				for (const output::SpStreamClient &client : _streamClientVector) {
 					if (client->writeData(_tsBuffer[_readIndex])) {
@@ -440,6 +619,10 @@ void Stream::executeStreamClientWriter() {
 					}
 				}
 				if (incrementReadIndex) {
+					// Only once, not for each attempt to send it
+					if (_tsBuffer[_readIndex].isTraced()) {
+						traceLatency(_tsBuffer[_readIndex]);
+					}
 					++_readIndex;
 					_readIndex %= _tsBuffer.size();
 				}
@@ -455,6 +638,42 @@ void Stream::executeStreamClientWriter() {
 	}
 }
 
+void Stream::stampDecrypted() {
+	// The descrambling is batched, so a buffer can be decrypted during the
+	// decrypt of a later buffer. Only the traced buffers in the ring matter
+	for (std::size_t i = _readIndex; i != _writeIndex; i = (i + 1) % _tsBuffer.size()) {
+		mpegts::PacketBuffer &buffer = _tsBuffer[i];
+		if (buffer.isTraced() && !buffer.hasStamp(mpegts::PacketBuffer::Stage::DECRYPT) &&
+				buffer.isReadyToSend()) {
+			buffer.stamp(mpegts::PacketBuffer::Stage::DECRYPT);
+		}
+	}
+}
+
+void Stream::traceLatency(const mpegts::PacketBuffer &buffer) {
+	using Stage = mpegts::PacketBuffer::Stage;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const std::uint64_t ingest = buffer.getLatencyUS(Stage::READ, Stage::FILTER);
+	const std::uint64_t descramble = buffer.getLatencyUS(Stage::FILTER, Stage::DECRYPT);
+	const std::uint64_t queue = buffer.getLatencyUS(Stage::DECRYPT, Stage::SEND);
+	const std::uint64_t send = buffer.getLatencyUS(Stage::SEND, now);
+	const std::uint64_t total = buffer.getLatencyUS(Stage::READ, now);
+	_latencyIngestUS.observe(ingest);
+	_latencyDescrambleUS.observe(descramble);
+	_latencyQueueUS.observe(queue);
+	_latencySendUS.observe(send);
+	_latencyTotalUS.observe(total);
+
+	base::MutexLock lock(_latencyDumpMutex);
+	if (_latencyDump.is_open()) {
+		// Format: feID,read timestamp (us),ingest,descramble,queue,send,total (us)
+		const long read = std::chrono::duration_cast<std::chrono::microseconds>(
+			buffer.getStamp(Stage::READ).time_since_epoch()).count();
+		_latencyDump << _device->getFeID().getID() << ',' << read << ',' << ingest << ','
+			<< descramble << ',' << queue << ',' << send << ',' << total << '\n';
+	}
+}
+
 bool Stream::threadExecuteDeviceMonitor() {
 	// check do we need to update Device monitor signals
 	_signalLock = _device->monitorSignal(false);
@@ -21,6 +21,7 @@
 #define STREAM_H_INCLUDE STREAM_H_INCLUDE
 
 #include <FwDecl.h>
+#include <base/Metrics.h>
 #include <base/Mutex.h>
 #include <base/Thread.h>
 #include <base/XMLSupport.h>
@@ -29,12 +30,14 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <fstream>
 #include <string>
 #include <vector>
 
 FW_DECL_NS0(SocketClient);
 
 FW_DECL_SP_NS1(input, Device);
+FW_DECL_SP_NS2(input, capture, CaptureWriter);
 FW_DECL_SP_NS1(output, StreamClient);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
 FW_DECL_SP_NS2(input, dvb, FrontendDecryptInterface);
@@ -53,7 +56,7 @@ class Stream :
 
 		Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt);
 
-		virtual ~Stream() = default;
+		virtual ~Stream();
 
 		// =========================================================================
 		// -- static member functions ----------------------------------------------
@@ -71,7 +74,7 @@ class Stream :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		// -- Other member functions -----------------------------------------------
@@ -115,6 +118,24 @@ class Stream :
 		/// that should be closed
 		void checkForSessionTimeout();
 
+		/// Add the metrics of this stream, its device and clients
+		void addToMetrics(base::MetricsWriter &metrics) const;
+
+		/// Set the path the latency dump and capture files are written to, call
+		/// this before the configuration is restored
+		void setAppDataPath(const std::string &appDataPath) {
+			_appDataPath = appDataPath;
+		}
+
+		/// Allow 'captureFile' to start a capture, call this after the
+		/// configuration is restored, so a capture is never started at startup
+		void enableCapture() {
+			_captureEnabled = true;
+		}
+
+		/// Get the file name of the running capture, empty if there is none
+		std::string getCaptureFile() const;
+
 	private:
 
 		///
@@ -139,6 +160,13 @@ class Stream :
 		/// Write data to Streamclients
 		void executeStreamClientWriter();
 
+		/// Stamp the traced buffers in the ring that are decrypted now
+		void stampDecrypted();
+
+		/// Add the latencies of the traced buffer that is just send to the
+		/// clients
+		void traceLatency(const mpegts::PacketBuffer &buffer);
+
 		/// Thread execute function @see base::Thread should @return true to
 		/// keep thread running and @return false will stop and then terminate this thread
 		bool threadExecuteDeviceMonitor();
@@ -182,6 +210,25 @@ class Stream :
 		std::chrono::steady_clock::time_point _t1;
 		std::chrono::steady_clock::time_point _t2;
 		std::atomic_bool _signalLock;
+		base::Counter _bytesRead;
+		base::Counter _packetsRead;
+		base::Counter _ringOverflows;
+		std::atomic<std::size_t> _ringUsed;
+
+		// Latency tracing, every _latencySampling buffer is traced (0 is off)
+		std::atomic<unsigned int> _latencySampling;
+		unsigned int _latencySampleCnt;
+		base::Histogram _latencyIngestUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Histogram _latencyDescrambleUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Histogram _latencyQueueUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Histogram _latencySendUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Histogram _latencyTotalUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Mutex _latencyDumpMutex;
+		std::string _appDataPath;
+		std::string _latencyDumpFile;
+		std::ofstream _latencyDump;
+		input::capture::SpCaptureWriter _capture;
+		std::atomic_bool _captureEnabled;
 
 };
 
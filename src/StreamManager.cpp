@@ -21,13 +21,18 @@
 
 #include <Stream.h>
 #include <Log.h>
+#include <base/Metrics.h>
+#include <base/Mutex.h>
 #include <output/StreamClient.h>
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
+#include <input/capture/Replayer.h>
 #include <input/childpipe/TSReader.h>
+#include <input/http/TSReader.h>
 #include <input/dvb/Frontend.h>
 #include <input/file/TSReader.h>
 #include <input/stream/Streamer.h>
+#include <input/synthetic/TSGenerator.h>
 #ifdef LIBDVBCSA
 	#include <decrypt/dvbapi/Client.h>
 	#include <input/dvb/FrontendDecryptInterface.h>
@@ -59,6 +64,8 @@ void StreamManager::enumerateDevices(
 		const std::string &appDataPath,
 		const std::string &dvbPath,
 		const int numberOfChildPIPE,
+		const int numberOfHTTP,
+		const int numberOfSynthetic,
 		const bool enableUnsecureFrontends) {
 #ifdef NOT_PREFERRED_DVB_API
 	SI_LOG_ERROR("Not the preferred DVB API version, for correct function it should be 5.5 or higher");
@@ -72,6 +79,18 @@ void StreamManager::enumerateDevices(
 	for (int i = 0; i < numberOfChildPIPE; ++i) {
 		input::childpipe::TSReader::enumerate(_streamVector, appDataPath, enableUnsecureFrontends);
 	}
+	for (int i = 0; i < numberOfHTTP; ++i) {
+		input::http::TSReader::enumerate(_streamVector, appDataPath, enableUnsecureFrontends);
+	}
+	for (int i = 0; i < numberOfSynthetic; ++i) {
+		input::synthetic::TSGenerator::enumerate(_streamVector);
+	}
+	if (enableUnsecureFrontends) {
+		input::capture::Replayer::enumerate(_streamVector, _decrypt, enableUnsecureFrontends);
+	}
+	for (SpStream &stream : _streamVector) {
+		stream->setAppDataPath(appDataPath);
+	}
 }
 
 std::string StreamManager::getXMLDeliveryString() const {
@@ -140,8 +159,8 @@ std::tuple<FeIndex, FeID, StreamID> StreamManager::findFrontendID(const Transpor
 std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClientFor(SocketClient &socketClient) {
 	// Here we need to find the correct Stream and StreamClient
 	assert(!_streamVector.empty());
-	HeaderVector headers = socketClient.getHeaders();
-	TransportParamVector params = socketClient.getTransportParameters();
+	const HeaderVector &headers = socketClient.getHeaders();
+	const TransportParamVector &params = socketClient.getTransportParameters();
 
 	// Now find index for FrontendID and/or StreamID of this message
 	const auto [feIndex, feID, streamID] = findFrontendID(params);
@@ -172,7 +191,6 @@ std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClient
 		for (SpStream stream : _streamVector) {
 			output::SpStreamClient streamClient = stream->findStreamClientFor(socketClient, newSession, sessionID);
 			if (streamClient) {
-				streamClient->setSessionID(sessionID);
 				return { stream, streamClient };
 			}
 		}
@@ -181,14 +199,12 @@ std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClient
 		// Did we find the StreamClient?
 		output::SpStreamClient streamClient = _streamVector[feIndex]->findStreamClientFor(socketClient, newSession, sessionID);
 		if (streamClient) {
-			streamClient->setSessionID(sessionID);
 			return { _streamVector[feIndex], streamClient };
 		}
 		// No, Then try to search in other Streams
 		for (SpStream stream : _streamVector) {
 			streamClient = stream->findStreamClientFor(socketClient, newSession, sessionID);
 			if (streamClient) {
-				streamClient->setSessionID(sessionID);
 				return { stream, streamClient };
 			}
 		}
@@ -198,6 +214,12 @@ std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClient
 	return { nullptr, nullptr };
 }
 
+void StreamManager::enableCapture() {
+	for (SpStream &stream : _streamVector) {
+		stream->enableCapture();
+	}
+}
+
 void StreamManager::checkForSessionTimeout() {
 	assert(!_streamVector.empty());
 	for (SpStream stream : _streamVector) {
@@ -205,6 +227,15 @@ void StreamManager::checkForSessionTimeout() {
 	}
 }
 
+std::string StreamManager::getMetrics() const {
+	base::MetricsWriter metrics;
+	for (const SpStream &stream : _streamVector) {
+		stream->addToMetrics(metrics);
+	}
+	base::MutexProfiler::addToMetrics(metrics);
+	return metrics.getString();
+}
+
 std::string StreamManager::getSDPSessionLevelString(
 		const std::string& bindIPAddress,
 		const std::string& sessionID) const {
@@ -249,16 +280,16 @@ input::dvb::SpFrontendDecryptInterface StreamManager::getFrontendDecryptInterfac
 //  -- base::XMLSupport --------------------------------------------------------
 // =============================================================================
 
-void StreamManager::doFromXML(const std::string &xml) {
+void StreamManager::doFromXML(const base::XMLElement &xml) {
 	for (SpStream stream : _streamVector) {
-		std::string element;
+		base::XMLElement element;
 		const std::string find = StringConverter::stringFormat("stream@#1", stream->getFeID());
 		if (findXMLElement(xml, find, element)) {
 			stream->fromXML(element);
 		}
 	}
 #ifdef LIBDVBCSA
-	std::string element;
+	base::XMLElement element;
 	if (findXMLElement(xml, "decrypt", element)) {
 		_decrypt->fromXML(element);
 	}
@@ -57,7 +57,7 @@ class StreamManager :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =====================================================================
 		// -- Other member functions -------------------------------------------
@@ -69,14 +69,22 @@ class StreamManager :
 		/// @param appDataPath specifies the path were to store application data
 		/// @param dvbPath specifies the path were to find dvb devices eg. /dev/dvb
 		/// @param numberOfChildPIPE to enable the requested amount of frontends 'Child PIPE - TS Reader'
-		/// @param enableUnsecureFrontends to enable to use 'Child PIPE - TS Reader' in command directly
+		/// @param numberOfHTTP to enable the requested amount of frontends 'HTTP - TS Reader'
+		/// @param numberOfSynthetic to enable the requested amount of frontends 'Synthetic TS Generator'
+		/// @param enableUnsecureFrontends to enable to use 'Child PIPE - TS Reader', 'HTTP - TS Reader' in command directly, 'Capture Replayer' and stream captures
 		void enumerateDevices(
 			const std::string &bindIPAddress,
 			const std::string &appDataPath,
 			const std::string &dvbPath,
 			int numberOfChildPIPE,
+			int numberOfHTTP,
+			int numberOfSynthetic,
 			bool enableUnsecureFrontends);
 
+		/// Allow the clients to start a capture on the streams, call this after
+		/// the configuration is restored
+		void enableCapture();
+
 		///
 		std::tuple<SpStream, output::SpStreamClient> findStreamAndClientFor(SocketClient &socketClient);
 
@@ -89,6 +97,9 @@ class StreamManager :
 		///
 		std::string getXMLDeliveryString() const;
 
+		/// Get the metrics of all streams in the Prometheus text format
+		std::string getMetrics() const;
+
 		///
 		std::size_t getMaxStreams() const {
 			return _streamVector.size();
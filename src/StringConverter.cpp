@@ -20,11 +20,143 @@
 #include <StringConverter.h>
 
 #include <Log.h>
+#include <base/Benchmark.h>
 #include <input/dvb/dvbfix.h>
 
 #include <iostream>
 #include <cstdarg>
 
+namespace {
+
+	/// The previous ostringstream based implementation of stringFormat, only
+	/// used as the 'format/legacy' baseline in StringConverter::runBenchmarks()
+	template <typename Type>
+	void legacyMakeVectArgs(std::vector<std::string> &vec, Type&& t) {
+		std::ostringstream stream;
+		stream.setf(std::ios::fixed);
+		stream.precision(4);
+		stream << std::move(t);
+		vec.emplace_back(std::move(stream.str()));
+	}
+
+	template <typename... Args>
+	std::string legacyStringFormat(const char *format, Args&&... args) {
+		std::vector<std::string> vectArgs;
+		vectArgs.push_back("?");
+		const int dummy[] = { 0, ((void) legacyMakeVectArgs(vectArgs, std::forward<Args>(args)), 0)... };
+		(void)dummy;
+		std::string line;
+		std::size_t size = std::strlen(format);
+		for (std::size_t i = 1; i < vectArgs.size(); ++i) {
+			size += vectArgs[i].size();
+		}
+		size -= (vectArgs.size() - 1) * 2;
+		line.reserve(size);
+		for (; *format != '\0'; ++format) {
+			if (*format == '@' && *(format + 1) != '\0' && *(format + 1) == '#') {
+				++format;
+				if (*(format + 1) != '\0' && std::isdigit(*(format + 1))) {
+					++format;
+					const char *formatDigit = format;
+					while (std::isdigit(*formatDigit)) {
+					  ++formatDigit;
+					}
+					const std::size_t digitCnt = formatDigit - format;
+					const std::size_t index = std::stoul(std::string(format, digitCnt));
+					if (index < vectArgs.size()) {
+						line += vectArgs[index];
+					} else {
+						line += std::string(format - 2, digitCnt + 2);
+					}
+					format += digitCnt - 1;
+				} else {
+					line += "@#E";
+				}
+			} else {
+				line += *format;
+			}
+		}
+		return line;
+	}
+
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+void StringConverter::formatTo(std::string &line, const char *format,
+		const FormatArg *args, const std::size_t argCnt) {
+	// Make as little reallocations as possible, so calc size
+	const std::size_t formatSize = std::strlen(format);
+	std::size_t size = line.size() + formatSize;
+	for (std::size_t i = 1; i < argCnt; ++i) {
+		size += args[i].view().size();
+	}
+	line.reserve(size);
+
+	const char *end = format + formatSize;
+	while (format < end) {
+		// Copy everything up to the next marker in one go
+		const char *marker = static_cast<const char *>(std::memchr(format, '@', end - format));
+		if (marker == nullptr) {
+			line.append(format, end - format);
+			break;
+		}
+		line.append(format, marker - format);
+		format = marker + 1;
+		if (format == end || *format != '#') {
+			line += '@';
+			continue;
+		}
+		++format;
+		if (format == end || !std::isdigit(*format)) {
+			// Error @# near end of line
+			line += "@#E";
+			continue;
+		}
+		std::size_t index = 0;
+		const char *digit = format;
+		for (; digit < end && std::isdigit(*digit); ++digit) {
+			if (index < argCnt) {
+				index = (index * 10) + (*digit - '0');
+			}
+		}
+		if (index < argCnt) {
+			line += args[index].view();
+		} else {
+			line.append(marker, digit - marker);
+		}
+		format = digit;
+	}
+}
+
+void StringConverter::runBenchmarks(base::Benchmark &benchmark) {
+	const FeID id = 3;
+	const std::string session = "0286615978";
+	const std::string ip = "192.168.178.24";
+	benchmark.run("format/log-line", 0, [&] {
+		base::Benchmark::doNotOptimize(stringFormat("Frontend: @#1, StreamClient with SessionID @#2 for @#3 port @#4", id, session, ip, 8875));
+	});
+	// The same log line with the previous implementation, as the baseline
+	benchmark.run("format/legacy", 0, [&] {
+		base::Benchmark::doNotOptimize(legacyStringFormat("Frontend: @#1, StreamClient with SessionID @#2 for @#3 port @#4", id.getID(), session, ip, 8875));
+	});
+	benchmark.run("format/rtsp-reply", 0, [&] {
+		base::Benchmark::doNotOptimize(stringFormat("RTSP/1.0 200 OK\r\nCSeq: @#1\r\nSession: @#2;timeout=@#3\r\nTransport: RTP/AVP;unicast;client_port=@#4-@#5\r\ncom.ses.streamID: @#6\r\n\r\n",
+			42, session, 60, 45000, 45001, 1));
+	});
+	benchmark.run("format/hex-digit", 0, [&] {
+		base::Benchmark::doNotOptimize(stringFormat("PID @#1 CRC @#2 Level @#3 SNR @#4", PID(18), HEX(0xDEADBEEF, 8), DIGIT(240, 3), 12.5));
+	});
+	std::string xml;
+	benchmark.run("format/xml-element", 0, [&] {
+		xml.clear();
+		stringFormatTo(xml, "<@#1>@#2</@#1>", "signallevel", 240);
+		base::Benchmark::doNotOptimize(xml);
+	});
+}
+
 void StringConverter::splitPath(const std::string &fullPath, std::string &path, std::string &file) {
 	std::string::size_type end = fullPath.find_last_of("/\\");
 	path = fullPath.substr(0, end);
@@ -247,6 +379,12 @@ std::string_view StringConverter::delsys_to_string(const input::InputSystem syst
 			return "file";
 		case input::InputSystem::STREAMER:
 			return "streamer";
+		case input::InputSystem::SYNTHETIC:
+			return "synthetic";
+		case input::InputSystem::REPLAY:
+			return "replay";
+		case input::InputSystem::HTTP:
+			return "http";
 		case input::InputSystem::DVBC:
 			return "dvbc";
 		default:
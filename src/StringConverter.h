@@ -21,22 +21,53 @@
 #define STRING_CONVERTER_H_INCLUDE STRING_CONVERTER_H_INCLUDE
 
 #include <Defs.h>
+#include <FwDecl.h>
 #include <input/InputSystem.h>
 
 #include <string>
 #include <string_view>
 #include <cctype>
+#include <charconv>
+#include <cstdio>
 #include <sstream>
 #include <cstring>
+#include <type_traits>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
 
+FW_DECL_NS1(base, Benchmark);
+
 /// The class @c StringConverter has some string manipulation functions
 class StringConverter  {
 
 	public:
 
+		/// Adaptor for @c stringFormat to print an unsigned value as hexadecimal
+		/// with at least @c width digits, see HEX, HEX2 and HEXPL
+		struct Hex {
+			unsigned long value;
+			int width;
+			bool plain;
+
+			friend std::ostream &operator<<(std::ostream &stream, const Hex &hex) {
+				return stream << StringConverter::stringFormat("@#1", hex);
+			}
+		};
+
+		/// Adaptor for @c stringFormat to right align a value in at least
+		/// @c width characters, see STR, DIGIT and PID
+		template<class T>
+		struct Pad {
+			T value;
+			int width;
+			char fill;
+
+			friend std::ostream &operator<<(std::ostream &stream, const Pad &pad) {
+				return stream << StringConverter::stringFormat("@#1", pad);
+			}
+		};
+
 		/// Returns a copy of the string where all specified markers are replaced
 		/// with the specified arguments.<br>
 		/// <b>Example:</b> @c std::string s = StringConverter::stringFormat(
@@ -45,85 +76,64 @@ class StringConverter  {
 		/// with the specified arguments.
 		template <typename... Args>
 		static std::string stringFormat(const char *format, Args&&... args) {
-			std::vector<std::string> vectArgs;
-			vectArgs.push_back("?");
-			// trick for pack expansion
-			const int dummy[] = { 0, ((void) makeVectArgs(vectArgs, std::forward<Args>(args)), 0)... };
-			(void)dummy;
-
-			// Make as little reallocations as possible, so calc size
 			std::string line;
-			std::size_t size = std::strlen(format);
-			for (std::size_t i = 1; i < vectArgs.size(); ++i) {
-				size += vectArgs[i].size();
-			}
-			// remove @#-tags from size (-1 because of always '?' arg)
-			size -= (vectArgs.size() - 1) * 2;
-			line.reserve(size);
-
-			for (; *format != '\0'; ++format) {
-				if (*format == '@' && *(format + 1) != '\0' && *(format + 1) == '#') {
-					++format;
-					if (*(format + 1) != '\0' && std::isdigit(*(format + 1))) {
-						++format;
-						const char *formatDigit = format;
-						while (std::isdigit(*formatDigit)) {
-						  ++formatDigit;
-						}
-						const std::size_t digitCnt = formatDigit - format;
-						const std::size_t index = std::stoul(std::string(format, digitCnt));
-						if (index < vectArgs.size()) {
-							line += vectArgs[index];
-						} else {
-							line += std::string(format - 2, digitCnt + 2);
-						}
-						// -1 because of ++format in for statement
-						format += digitCnt - 1;
-					} else {
-						// Error @# near end of line
-						line += "@#E";
-					}
-				} else {
-					line += *format;
-				}
-			}
+			stringFormatTo(line, format, std::forward<Args>(args)...);
 			return line;
 		}
 
+		/// Same as @c stringFormat, but append the result to @c line.
+		/// The arguments are converted into small buffers on the stack, so
+		/// the only allocation is the growth of @c line (if any).
+		template <typename... Args>
+		static void stringFormatTo(std::string &line, const char *format, Args&&... args) {
+			FormatArg vectArgs[sizeof...(Args) + 1];
+			vectArgs[0].setView("?");
+			std::size_t i = 1;
+			(vectArgs[i++].set(std::forward<Args>(args)), ...);
+			(void)i;
+			formatTo(line, format, vectArgs, sizeof...(Args) + 1);
+		}
+
 		static std::string convertToHexASCIITable(const unsigned char* p, std::size_t length, std::size_t blockSize);
 
+		template<class T>
+		static Hex hex(const T &value, const int width) {
+			return { static_cast<unsigned long>(value), width, false };
+		}
+
+		template<class T>
+		static Hex hexPlain(const T &value, const int width) {
+			return { static_cast<unsigned long>(value), width, true };
+		}
+
+		template<class T>
+		static Pad<std::decay_t<const T>> pad(const T &value, const int width, const char fill) {
+			return { value, width, fill };
+		}
+
 		template<class T>
 		static std::string hexString(const T &value, const int width) {
-			std::ostringstream stream;
-			stream.flags(std::ios_base::fmtflags(std::ios::hex | std::ios::uppercase));
-			stream << "0x" << std::setfill('0') << std::setw(width);
-			stream << static_cast<unsigned long>(value);
-			return stream.str();
+			return stringFormat("@#1", hex(value, width));
 		}
 
 		template<class T>
 		static std::string hexPlainString(const T &value, const int width) {
-			std::ostringstream stream;
-			stream.flags(std::ios_base::fmtflags(std::ios::hex));
-			stream << std::setfill('0') << std::setw(width);
-			stream << static_cast<unsigned long>(value);
-			return stream.str();
+			return stringFormat("@#1", hexPlain(value, width));
 		}
 
 		template<class T>
 		static std::string alphaString(const T &value, const int width) {
-			std::ostringstream stream;
-			stream << std::setfill(' ') << std::setw(width) << value;
-			return stream.str();
+			return stringFormat("@#1", pad(value, width, ' '));
 		}
 
 		template<class T>
 		static std::string digitString(const T &value, const int width) {
-			std::ostringstream stream;
-			stream << std::setfill('0') << std::setw(width) << value;
-			return stream.str();
+			return stringFormat("@#1", pad(value, width, '0'));
 		}
 
+		/// Run the (selected) stringFormat micro benchmarks
+		static void runBenchmarks(base::Benchmark &benchmark);
+
 		///
 		template<class T>
 		static std::string toStringFrom4BitBCD(const T bcd, const int charNr) {
@@ -182,26 +192,143 @@ class StringConverter  {
 
 	protected:
 
-		/// Helper function for stringFormat
-		template <typename Type>
-		static void makeVectArgs(std::vector<std::string> &vec, Type&& t) {
-			std::ostringstream stream;
-			stream.setf(std::ios::fixed);
-			stream.precision(4);
-			stream << std::move(t);
-			vec.emplace_back(std::move(stream.str()));
-		}
+		/// The text of one @c stringFormat argument. Strings are referenced,
+		/// other known types are converted into the small buffer and only
+		/// unknown types fall back to an std::ostringstream.
+		class FormatArg {
+			public:
+				std::string_view view() const {
+					return _view;
+				}
+
+				void setView(const std::string_view view) {
+					_view = view;
+				}
+
+				void set(const char *str) {
+					_view = (str == nullptr) ? std::string_view() : std::string_view(str);
+				}
+
+				void set(const std::string &str) {
+					_view = str;
+				}
+
+				void set(const std::string_view str) {
+					_view = str;
+				}
+
+				void set(const Hex &hex) {
+					char digits[2 * sizeof(unsigned long)];
+					const std::size_t len = std::to_chars(digits, digits + sizeof(digits), hex.value, 16).ptr - digits;
+					char *p = _buf;
+					if (!hex.plain) {
+						*p++ = '0';
+						*p++ = 'x';
+					}
+					for (std::size_t i = len; static_cast<int>(i) < hex.width && p < _buf + sizeof(_buf) - len; ++i) {
+						*p++ = '0';
+					}
+					for (std::size_t i = 0; i < len; ++i) {
+						*p++ = hex.plain ? digits[i] : static_cast<char>(std::toupper(digits[i]));
+					}
+					_view = std::string_view(_buf, p - _buf);
+				}
+
+				template<class T>
+				void set(const Pad<T> &pad) {
+					FormatArg arg;
+					if constexpr (std::is_floating_point_v<T>) {
+						// Same as std::ostream without std::fixed
+						arg.setFloat("%g", pad.value);
+					} else {
+						arg.set(pad.value);
+					}
+					const std::string_view text = arg.view();
+					const std::size_t fill = (static_cast<std::size_t>(pad.width) > text.size()) ?
+						pad.width - text.size() : 0;
+					if (fill + text.size() <= sizeof(_buf)) {
+						std::memset(_buf, pad.fill, fill);
+						std::memcpy(_buf + fill, text.data(), text.size());
+						_view = std::string_view(_buf, fill + text.size());
+					} else {
+						_str.assign(fill, pad.fill);
+						_str += text;
+						_view = _str;
+					}
+				}
+
+				template<class T>
+				void set(const T &value) {
+					if constexpr (std::is_same_v<T, bool>) {
+						_view = value ? "1" : "0";
+					} else if constexpr (std::is_same_v<T, char> ||
+							std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+						_buf[0] = static_cast<char>(value);
+						_view = std::string_view(_buf, 1);
+					} else if constexpr (std::is_integral_v<T>) {
+						_view = std::string_view(_buf, std::to_chars(_buf, _buf + sizeof(_buf), value).ptr - _buf);
+					} else if constexpr (std::is_floating_point_v<T>) {
+						// Same as std::ostream with std::fixed and precision 4
+						setFloat("%.4f", value);
+					} else if constexpr (std::is_base_of_v<TypeID, T>) {
+						set(value.getID());
+					} else if constexpr (std::is_enum_v<T>) {
+						if constexpr (std::is_convertible_v<T, std::underlying_type_t<T>>) {
+							set(static_cast<std::underlying_type_t<T>>(value));
+						} else {
+							setStream(value);
+						}
+					} else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+						set(std::string_view(value));
+					} else {
+						setStream(value);
+					}
+				}
+
+			private:
+
+				template<class T>
+				void setStream(const T &value) {
+					std::ostringstream stream;
+					stream.setf(std::ios::fixed);
+					stream.precision(4);
+					stream << value;
+					_str = stream.str();
+					_view = _str;
+				}
+
+				template<class T>
+				void setFloat(const char *fmt, const T value) {
+					const int len = std::snprintf(_buf, sizeof(_buf), fmt, static_cast<double>(value));
+					if (len >= 0 && static_cast<std::size_t>(len) < sizeof(_buf)) {
+						_view = std::string_view(_buf, len);
+					} else {
+						_str.resize(len + 1);
+						std::snprintf(&_str[0], _str.size(), fmt, static_cast<double>(value));
+						_str.resize(len);
+						_view = _str;
+					}
+				}
+
+				char _buf[48];
+				std::string_view _view;
+				std::string _str;
+		};
+
+		/// Replace the markers of @c format with @c args and append it to @c line
+		static void formatTo(std::string &line, const char *format,
+			const FormatArg *args, std::size_t argCnt);
 };
 
-#define HEX(value, size) StringConverter::hexString(value, size)
-#define HEX2(value) StringConverter::hexString(value, 2)
+#define HEX(value, size) StringConverter::hex(value, size)
+#define HEX2(value) StringConverter::hex(value, 2)
 
-#define HEXPL(value, size) StringConverter::hexPlainString(value, size)
+#define HEXPL(value, size) StringConverter::hexPlain(value, size)
 
-#define STR(value, size) StringConverter::alphaString(value, size)
+#define STR(value, size) StringConverter::pad(value, size, ' ')
 
-#define DIGIT(value, size) StringConverter::digitString(value, size)
+#define DIGIT(value, size) StringConverter::pad(value, size, '0')
 
-#define PID(value) StringConverter::digitString(value, 4)
+#define PID(value) StringConverter::pad(value, 4, '0')
 
 #endif // STRING_CONVERTER_H_INCLUDE
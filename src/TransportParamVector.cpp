@@ -22,6 +22,11 @@
 #include <Log.h>
 #include <StringConverter.h>
 
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
 // =============================================================================
 // -- Other member functions ---------------------------------------------------
 // =============================================================================
@@ -60,7 +65,13 @@ double TransportParamVector::getDoubleParameter(const std::string_view parameter
 	if (val.empty()) {
 		return -1.0;
 	}
-	return std::isdigit(val[0]) ? std::stof(val) : -1.0;
+	if (!std::isdigit(val[0])) {
+		return -1.0;
+	}
+	// Do not throw on out of range values, like std::stof, just ignore them
+	errno = 0;
+	const float value = std::strtof(val.c_str(), nullptr);
+	return (errno == ERANGE || !std::isfinite(value)) ? -1.0 : value;
 }
 
 int TransportParamVector::getIntParameter(std::string_view parameter) const {
@@ -68,7 +79,13 @@ int TransportParamVector::getIntParameter(std::string_view parameter) const {
 	if (val.empty()) {
 		return -1.0;
 	}
-	return std::isdigit(val[0]) ? std::stoi(val) : -1;
+	if (!std::isdigit(val[0])) {
+		return -1;
+	}
+	// Do not throw on out of range values, like std::stoi, just ignore them
+	errno = 0;
+	const long value = std::strtol(val.c_str(), nullptr, 10);
+	return (errno == ERANGE || value > std::numeric_limits<int>::max()) ? -1 : value;
 }
 
 input::InputSystem TransportParamVector::getMSYSParameter() const {
@@ -90,6 +107,12 @@ input::InputSystem TransportParamVector::getMSYSParameter() const {
 			return input::InputSystem::STREAMER;
 		} else if (val == "childpipe") {
 			return input::InputSystem::CHILDPIPE;
+		} else if (val == "synthetic") {
+			return input::InputSystem::SYNTHETIC;
+		} else if (val == "replay") {
+			return input::InputSystem::REPLAY;
+		} else if (val == "http") {
+			return input::InputSystem::HTTP;
 		}
 	}
 	return input::InputSystem::UNDEFINED;
@@ -67,8 +67,9 @@ void Utils::annotateBackTrace(const char *app, const char *file) {
 			exec.open(addr2line);
 			std::string code;
 			char buffer[256];
-			std::size_t s;
-			while ((s = exec.read(reinterpret_cast<unsigned char *>(buffer), 255)) > 0) {
+			ssize_t s;
+			while (exec.waitForData(1000) &&
+					(s = exec.read(reinterpret_cast<unsigned char *>(buffer), 255)) >= 0) {
 				code.append(buffer, s);
 				code.erase(std::find(code.begin(), code.end(), '\n'));
 			}
@@ -0,0 +1 @@
+const char *satpi_version = "-unknown";
@@ -0,0 +1,170 @@
+/* Benchmark.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/Benchmark.h>
+
+#include <base/JSONSerializer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+namespace base {
+
+namespace {
+
+	/// Number of measure rounds per case, the median is the result
+	constexpr std::size_t ROUNDS = 5;
+
+	/// Minimal duration of one calibrated batch
+	constexpr std::chrono::microseconds MIN_BATCH_TIME(1000);
+
+	std::string toNumber(const double value) {
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), "%.3f", value);
+		return buf;
+	}
+
+	/// Get the (unescaped) JSON string that starts at pos
+	std::string getJSONString(const std::string &json, std::size_t pos) {
+		std::string str;
+		for (; pos < json.size() && json[pos] != '"'; ++pos) {
+			if (json[pos] == '\\' && pos + 1 < json.size()) {
+				++pos;
+			}
+			str += json[pos];
+		}
+		return str;
+	}
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+Benchmark::Benchmark(const std::string &filter, const unsigned int msec) :
+	_filter(filter == "all" ? "" : filter),
+	_msec(msec) {}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool Benchmark::isSelected(const std::string &name) const {
+	return _filter.empty() || name.find(_filter) != std::string::npos;
+}
+
+void Benchmark::measure(const std::string &name, const std::size_t bytesPerOp,
+		const std::function<void(std::uint64_t n)> &loop) {
+	using Clock = std::chrono::steady_clock;
+	if (_results.empty()) {
+		std::printf("%-40s %12s %12s %10s\r\n", "case", "ns/op", "min ns/op", "MB/s");
+	}
+	// Calibrate the batch size, this also warms up the caches
+	std::uint64_t batch = 1;
+	for (;;) {
+		const Clock::time_point start = Clock::now();
+		loop(batch);
+		if (Clock::now() - start >= MIN_BATCH_TIME) {
+			break;
+		}
+		batch *= 2;
+	}
+	// Measure the rounds
+	const auto roundTime = std::chrono::milliseconds(std::max(1u, _msec / static_cast<unsigned int>(ROUNDS)));
+	std::vector<double> nsPerOp;
+	std::uint64_t iterations = 0;
+	for (std::size_t r = 0; r < ROUNDS; ++r) {
+		std::uint64_t n = 0;
+		const Clock::time_point start = Clock::now();
+		Clock::time_point now;
+		do {
+			loop(batch);
+			n += batch;
+			now = Clock::now();
+		} while (now - start < roundTime);
+		nsPerOp.push_back(std::chrono::duration<double, std::nano>(now - start).count() / n);
+		iterations += n;
+	}
+	std::sort(nsPerOp.begin(), nsPerOp.end());
+	Result result;
+	result.name = name;
+	result.iterations = iterations;
+	result.nsPerOp = nsPerOp[ROUNDS / 2];
+	result.minNsPerOp = nsPerOp[0];
+	result.mbPerSec = (bytesPerOp == 0) ? 0.0 : (bytesPerOp * 1000.0) / result.nsPerOp;
+	std::printf("%-40s %12.1f %12.1f %10.1f\r\n", name.c_str(),
+		result.nsPerOp, result.minNsPerOp, result.mbPerSec);
+	std::fflush(stdout);
+	_results.push_back(std::move(result));
+}
+
+std::string Benchmark::toJSON() const {
+	JSONSerializer json;
+	json.startObject();
+	json.startArrayWithName("benchmarks");
+	for (const Result &result : _results) {
+		json.startObject();
+		json.addValueString("name", result.name);
+		json.addValueNumber("iterations", std::to_string(result.iterations));
+		json.addValueNumber("nsPerOp", toNumber(result.nsPerOp));
+		json.addValueNumber("minNsPerOp", toNumber(result.minNsPerOp));
+		json.addValueNumber("mbPerSec", toNumber(result.mbPerSec));
+		json.endObject();
+	}
+	json.endArray();
+	json.endObject();
+	return json.getString() + "\n";
+}
+
+bool Benchmark::compareWith(const std::string &baselineJSON) const {
+	static const std::string NAME = "\"name\": \"";
+	static const std::string NS_PER_OP = "\"nsPerOp\": ";
+	std::map<std::string, double> baseline;
+	for (std::size_t pos = baselineJSON.find(NAME); pos != std::string::npos;
+			pos = baselineJSON.find(NAME, pos)) {
+		pos += NAME.size();
+		const std::string name = getJSONString(baselineJSON, pos);
+		const std::size_t value = baselineJSON.find(NS_PER_OP, pos);
+		if (value == std::string::npos) {
+			break;
+		}
+		baseline[name] = std::strtod(baselineJSON.c_str() + value + NS_PER_OP.size(), nullptr);
+	}
+	bool ok = true;
+	std::printf("\r\n%-40s %12s %12s %8s\r\n", "case", "baseline", "ns/op", "change");
+	for (const Result &result : _results) {
+		const auto it = baseline.find(result.name);
+		if (it == baseline.end() || it->second <= 0.0) {
+			std::printf("%-40s %12s %12.1f %8s\r\n", result.name.c_str(), "-", result.nsPerOp, "new");
+			continue;
+		}
+		const double change = ((result.nsPerOp - it->second) * 100.0) / it->second;
+		const bool regression = change > REGRESSION_PERCENTAGE;
+		ok &= !regression;
+		std::printf("%-40s %12.1f %12.1f %+7.1f%%%s\r\n", result.name.c_str(),
+			it->second, result.nsPerOp, change, regression ? "  REGRESSION" : "");
+	}
+	return ok;
+}
+
+} // namespace base
@@ -0,0 +1,132 @@
+/* Benchmark.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_BENCHMARK_H_INCLUDE
+#define BASE_BENCHMARK_H_INCLUDE BASE_BENCHMARK_H_INCLUDE
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace base {
+
+/// The class @c Benchmark is a small micro benchmark harness. Each case is
+/// calibrated first and then measured in a couple of rounds, the median of
+/// the rounds is the result so a single disturbed round does not count. The
+/// results can be saved as JSON and compared with an earlier (baseline) run.
+class Benchmark {
+	public:
+
+		struct Result {
+			std::string name;
+			std::uint64_t iterations;
+			/// Median time per operation of all rounds
+			double nsPerOp;
+			/// Fastest round
+			double minNsPerOp;
+			/// Throughput or 0.0 when the case did not specify bytes
+			double mbPerSec;
+		};
+
+		/// Slower than the baseline by this percentage is a regression (the median
+		/// of a case still moves about 20% between runs on a loaded box)
+		static constexpr double REGRESSION_PERCENTAGE = 25.0;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// @param filter specifies to run only the cases with this in their
+		/// name, 'all' or empty runs all cases
+		/// @param msec specifies the measure time, in msec, per case
+		explicit Benchmark(const std::string &filter, unsigned int msec = 500);
+
+		virtual ~Benchmark() = default;
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Prevent the compiler from optimizing away the result of a case
+		template<typename T>
+		static void doNotOptimize(const T &value) noexcept {
+			asm volatile("" : : "g"(&value) : "memory");
+		}
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Check if the requested case should run
+		bool isSelected(const std::string &name) const;
+
+		/// Run and measure the requested case, if selected, and print its result
+		/// @param name specifies the name like 'group/case'
+		/// @param bytesPerOp specifies the bytes processed per call of func, or 0
+		/// @param func specifies the operation to measure
+		template<typename FUNC>
+		void run(const std::string &name, const std::size_t bytesPerOp, FUNC func) {
+			if (isSelected(name)) {
+				measure(name, bytesPerOp, [&func](const std::uint64_t n) {
+					for (std::uint64_t i = 0; i < n; ++i) {
+						func();
+					}
+				});
+			}
+		}
+
+		/// Get all the results in JSON
+		std::string toJSON() const;
+
+		/// Compare the results with the results of an earlier run and print
+		/// the difference per case
+		/// @param baselineJSON specifies the results of @c toJSON of the earlier run
+		/// @return false if any case is slower then @c REGRESSION_PERCENTAGE
+		bool compareWith(const std::string &baselineJSON) const;
+
+		/// Get the results of the cases that did run
+		const std::vector<Result> &getResults() const noexcept {
+			return _results;
+		}
+
+	private:
+
+		/// Calibrate, measure and print the case
+		/// @param loop specifies the function that runs the case n times
+		void measure(const std::string &name, std::size_t bytesPerOp,
+			const std::function<void(std::uint64_t n)> &loop);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::string _filter;
+		unsigned int _msec;
+		std::vector<Result> _results;
+};
+
+} // namespace base
+
+#endif // BASE_BENCHMARK_H_INCLUDE
@@ -25,13 +25,19 @@
 #include <StringConverter.h>
 #include <base/CharPointerArray.h>
 
+#include <cerrno>
+
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
 #include <sys/types.h>
 
 namespace base {
 
+/// The class @c ChildPIPEReader starts a child process and reads its stdout
+/// through a large pipe. The read end of the pipe is non-blocking, so wait
+/// for data with @c waitForData.
 class ChildPIPEReader {
 		// =====================================================================
 		//  -- Constructors and destructor -------------------------------------
@@ -65,17 +71,45 @@ class ChildPIPEReader {
 			return _open;
 		}
 
-		std::size_t read(unsigned char *buffer, std::size_t size) {
-			return ::read(_stdout, buffer, size);
+		/// Read what is available in the pipe
+		/// @return the amount of bytes read, 0 if nothing is available, or
+		/// -1 if the child closed the pipe (or there was an error)
+		ssize_t read(unsigned char *buffer, std::size_t size) {
+			const ssize_t readSize = ::read(_stdout, buffer, size);
+			if (readSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+				return 0;
+			}
+			return (readSize == 0) ? -1 : readSize;
+		}
+
+		/// Wait until there is data in the pipe (or the child closed it)
+		/// @param timeoutMS specifies the maximum time to wait
+		bool waitForData(const int timeoutMS) const {
+			pollfd pfd;
+			pfd.fd = _stdout;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			return ::poll(&pfd, 1, timeoutMS) > 0;
+		}
+
+		/// Get the size of the pipe
+		int getPipeSize() const {
+			return ::fcntl(_stdout, F_GETPIPE_SZ);
 		}
 
 	private:
 
 		void popen2(const std::string &cmd) {
 			int pipefd[2] = { -1, -1 };
-			if (::pipe2(pipefd, 0) != 0) {
+			if (::pipe2(pipefd, O_CLOEXEC) != 0) {
 				return;
 			}
+			// Enlarge the pipe, so the child can write ahead while we are busy.
+			// Without privileges it is limited by /proc/sys/fs/pipe-max-size
+			if (::fcntl(pipefd[WRITE], F_SETPIPE_SZ, PIPE_SIZE) == -1 &&
+					::fcntl(pipefd[WRITE], F_SETPIPE_SZ, MIN_PIPE_SIZE) == -1) {
+				SI_LOG_PERROR("fcntl: F_SETPIPE_SZ");
+			}
 			StringVector argumentVector = StringConverter::parseCommandArgumentString(cmd);
 			const CharPointerArray charPtrArray(argumentVector);
 			char * const* argv = charPtrArray.getData();
@@ -100,6 +134,7 @@ class ChildPIPEReader {
 			// This is the parent process
 			CLOSE_FD(pipefd[WRITE]);
 			_stdout = pipefd[READ];
+			::fcntl(_stdout, F_SETFL, ::fcntl(_stdout, F_GETFL) | O_NONBLOCK);
 			_open = true;
 		}
 
@@ -110,6 +145,8 @@ class ChildPIPEReader {
 
 		static constexpr int READ = 0;
 		static constexpr int WRITE = 1;
+		static constexpr int PIPE_SIZE = 4 * 1024 * 1024;
+		static constexpr int MIN_PIPE_SIZE = 1024 * 1024;
 		int _stdout = -1;
 		pid_t _pid = -1;
 		bool _open = false;
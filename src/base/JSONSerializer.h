@@ -20,6 +20,7 @@
 #ifndef BASE_JSONSERIALIZER_H_INCLUDE
 #define BASE_JSONSERIALIZER_H_INCLUDE BASE_JSONSERIALIZER_H_INCLUDE
 
+#include <cctype>
 #include <string>
 
 namespace base {
@@ -100,24 +101,41 @@ namespace base {
 		private:
 
 			void checkAddComma() {
+				if (_json.empty()) {
+					return;
+				}
+				// Previous value ended with a string, object, array, number,
+				// 'true', 'false' or 'null'
 				const char c = _json.back();
-				if (c == '\"' || c == '}' || c == ']' || std::isdigit(c)) {
+				if (c == '\"' || c == '}' || c == ']' || std::isdigit(c) || c == 'e' || c == 'l') {
 					_json += ", ";
 				}
 			}
 
 			std::string makeJSONString(const std::string &msg) {
-				std::string json(msg);
-				std::string::iterator it = json.begin();
-				while (it != json.end()) {
-					if (*it == '"' || *it == '\\' || *it == '/' || *it == '\b' ||
-						*it == '\f' || *it == '\n' || *it == '\r' || *it == '\t') {
-						it = json.insert(it, '\\');
-						if (it != json.end()) {
-							++it;
-						}
+				std::string json;
+				json.reserve(msg.size());
+				for (const char c : msg) {
+					switch (c) {
+						case '"':  json += "\\\""; break;
+						case '\\': json += "\\\\"; break;
+						case '/':  json += "\\/"; break;
+						case '\b': json += "\\b"; break;
+						case '\f': json += "\\f"; break;
+						case '\n': json += "\\n"; break;
+						case '\r': json += "\\r"; break;
+						case '\t': json += "\\t"; break;
+						default:
+							if (static_cast<unsigned char>(c) < 0x20) {
+								static const char hex[] = "0123456789abcdef";
+								json += "\\u00";
+								json += hex[(c >> 4) & 0xF];
+								json += hex[c & 0xF];
+							} else {
+								json += c;
+							}
+							break;
 					}
-					++it;
 				}
 				return json;
 			}
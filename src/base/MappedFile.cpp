@@ -0,0 +1,186 @@
+/* MappedFile.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/MappedFile.h>
+
+#include <Log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace base {
+
+namespace {
+
+	/// Where to continue when a copy from a mapping raises a SIGBUS
+	thread_local sigjmp_buf *volatile busJump = nullptr;
+
+	void busHandler(const int sig) {
+		if (busJump != nullptr) {
+			siglongjmp(*busJump, 1);
+		}
+		// Not from a guarded copy, so do what would have happened without us
+		::signal(sig, SIG_DFL);
+		::raise(sig);
+	}
+
+	void installBusHandler() {
+		static const bool installed = [] {
+			struct sigaction action{};
+			action.sa_handler = busHandler;
+			sigemptyset(&action.sa_mask);
+			return ::sigaction(SIGBUS, &action, nullptr) == 0;
+		}();
+		(void)installed;
+	}
+
+	/// Copy from a mapping, an access beyond the end of a truncated file
+	/// raises a SIGBUS
+	/// @return false if the file was truncated
+	bool guardedCopy(unsigned char *dst, const unsigned char *src, const std::size_t size) {
+		sigjmp_buf jump;
+		if (sigsetjmp(jump, 1) != 0) {
+			busJump = nullptr;
+			return false;
+		}
+		busJump = &jump;
+		// Keep the copy between setting and clearing the jump
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		std::memcpy(dst, src, size);
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		busJump = nullptr;
+		return true;
+	}
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool MappedFile::open(const std::string &path) {
+	close();
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return false;
+	}
+	installBusHandler();
+	::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	_path = path;
+	_fd = fd;
+	_size = st.st_size;
+	return true;
+}
+
+void MappedFile::close() {
+	unmapWindow();
+	if (_fd != -1) {
+		::close(_fd);
+	}
+	_fd = -1;
+	_size = 0;
+	_path.clear();
+}
+
+std::size_t MappedFile::read(const std::uint64_t offset, unsigned char *data, const std::size_t size) {
+	if (_fd == -1 || offset >= _size) {
+		return 0;
+	}
+	const std::size_t total = std::min<std::uint64_t>(size, _size - offset);
+	std::size_t done = 0;
+	while (done < total) {
+		const std::uint64_t pos = offset + done;
+		if (!mapWindow(pos)) {
+			break;
+		}
+		const std::size_t inWindow = std::min<std::uint64_t>(total - done,
+			(_windowOffset + _windowSize) - pos);
+		if (!guardedCopy(data + done, _window + (pos - _windowOffset), inWindow)) {
+			// The file was truncated while we had it mapped, continue with
+			// the new size, so we stop at its end
+			struct stat st;
+			_size = (::fstat(_fd, &st) == 0) ? std::min<std::uint64_t>(st.st_size, pos) : pos;
+			unmapWindow();
+			SI_LOG_ERROR("@#1 was truncated to @#2 bytes while reading it", _path, _size);
+			break;
+		}
+		done += inWindow;
+	}
+	return done;
+}
+
+void MappedFile::willNeed(const std::uint64_t offset, const std::size_t size) const {
+	if (_fd == -1 || offset >= _size) {
+		return;
+	}
+	::posix_fadvise(_fd, offset, size, POSIX_FADV_WILLNEED);
+}
+
+bool MappedFile::mapWindow(const std::uint64_t offset) {
+	if (_window != nullptr && offset >= _windowOffset && offset < _windowOffset + _windowSize) {
+		return true;
+	}
+	unmapWindow();
+	// mmap needs a page aligned offset
+	static const std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+	const std::uint64_t windowOffset = offset - (offset % pageSize);
+	const std::size_t windowSize = std::min<std::uint64_t>(WINDOW_SIZE, _size - windowOffset);
+	void *window = ::mmap(nullptr, windowSize, PROT_READ, MAP_PRIVATE, _fd, windowOffset);
+	if (window == MAP_FAILED) {
+		SI_LOG_PERROR("mmap");
+		return false;
+	}
+	_window = static_cast<unsigned char *>(window);
+	_windowOffset = windowOffset;
+	_windowSize = windowSize;
+	::madvise(_window, _windowSize, MADV_SEQUENTIAL);
+	return true;
+}
+
+void MappedFile::unmapWindow() {
+	if (_window != nullptr) {
+		::munmap(_window, _windowSize);
+	}
+	_window = nullptr;
+	_windowOffset = 0;
+	_windowSize = 0;
+}
+
+} // namespace base
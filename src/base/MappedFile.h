@@ -0,0 +1,112 @@
+/* MappedFile.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_MAPPEDFILE_H_INCLUDE
+#define BASE_MAPPEDFILE_H_INCLUDE BASE_MAPPEDFILE_H_INCLUDE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace base {
+
+/// The class @c MappedFile reads a regular file through a read-only memory
+/// mapping, for sequential reading. Only a window of the file is mapped at a
+/// time, so also files larger than the address space (32 bit) can be read.
+/// The kernel is asked to read ahead, so a file on slow (network) storage is
+/// read in large blocks instead of many tiny reads.
+/// When the file is truncated while it is read, the SIGBUS of the access
+/// beyond the end is caught and the read stops at the new end of the file.
+class MappedFile {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		MappedFile() = default;
+
+		virtual ~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Open the file, an already opened file is closed first
+		/// @param path specifies the file to map
+		/// @return false if @c path could not be opened, for example when it
+		/// is not a regular file (like a FIFO)
+		bool open(const std::string &path);
+
+		///
+		void close();
+
+		///
+		bool isOpen() const {
+			return _fd != -1;
+		}
+
+		/// Get the size of the file
+		std::uint64_t size() const {
+			return _size;
+		}
+
+		/// Copy the data at @c offset of the file
+		/// @param offset specifies the offset in the file
+		/// @param data specifies the destination
+		/// @param size specifies the maximum amount of bytes to copy
+		/// @return the amount of bytes copied, less than @c size at the end of
+		/// the file (or when the file was truncated)
+		std::size_t read(std::uint64_t offset, unsigned char *data, std::size_t size);
+
+		/// Start reading ahead the specified range in the background
+		void willNeed(std::uint64_t offset, std::size_t size) const;
+
+	private:
+
+		/// Map the window that holds @c offset
+		/// @return false if it could not be mapped
+		bool mapWindow(std::uint64_t offset);
+
+		///
+		void unmapWindow();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// The size of the mapped window
+		static constexpr std::size_t WINDOW_SIZE = 16 * 1024 * 1024;
+
+		std::string _path;
+		int _fd = -1;
+		std::uint64_t _size = 0;
+		unsigned char *_window = nullptr;
+		std::uint64_t _windowOffset = 0;
+		std::size_t _windowSize = 0;
+};
+
+} // namespace base
+
+#endif // BASE_MAPPEDFILE_H_INCLUDE
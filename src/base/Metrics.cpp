@@ -0,0 +1,128 @@
+/* base/Metrics.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/Metrics.h>
+
+#include <StringConverter.h>
+
+namespace base {
+
+// =============================================================================
+// -- Histogram ----------------------------------------------------------------
+// =============================================================================
+
+Histogram::Histogram(const std::uint64_t *bounds, const std::size_t size) :
+	_size(size),
+	_bounds(new std::uint64_t[size]),
+	_buckets(new Counter[size + 1]) {
+	for (std::size_t i = 0; i < size; ++i) {
+		_bounds[i] = bounds[i];
+	}
+}
+
+std::uint64_t Histogram::getQuantile(const double quantile) const noexcept {
+	std::uint64_t total = 0;
+	for (std::size_t i = 0; i <= _size; ++i) {
+		total += _buckets[i].get();
+	}
+	if (total == 0 || _size == 0) {
+		return 0;
+	}
+	const std::uint64_t rank = static_cast<std::uint64_t>(quantile * (total - 1)) + 1;
+	std::uint64_t count = 0;
+	for (std::size_t i = 0; i < _size; ++i) {
+		count += _buckets[i].get();
+		if (count >= rank) {
+			return _bounds[i];
+		}
+	}
+	return _bounds[_size - 1];
+}
+
+// =============================================================================
+// -- MetricsWriter ------------------------------------------------------------
+// =============================================================================
+
+std::string MetricsWriter::makeLabel(const std::string &name, const std::string &value) {
+	std::string label = name + "=\"";
+	for (const char c : value) {
+		if (c == '\\' || c == '"') {
+			label += '\\';
+			label += c;
+		} else if (c == '\n') {
+			label += "\\n";
+		} else {
+			label += c;
+		}
+	}
+	label += '"';
+	return label;
+}
+
+void MetricsWriter::addCounter(const std::string &name, const std::string &help,
+		const std::string &labels, const std::uint64_t value) {
+	addSample(name, help, "counter", StringConverter::stringFormat("@#1@#2@#3@#4 @#5\n",
+		name, labels.empty() ? "" : "{", labels, labels.empty() ? "" : "}", value));
+}
+
+void MetricsWriter::addGauge(const std::string &name, const std::string &help,
+		const std::string &labels, const double value) {
+	addSample(name, help, "gauge", StringConverter::stringFormat("@#1@#2@#3@#4 @#5\n",
+		name, labels.empty() ? "" : "{", labels, labels.empty() ? "" : "}", value));
+}
+
+void MetricsWriter::addHistogram(const std::string &name, const std::string &help,
+		const std::string &labels, const Histogram &histogram) {
+	const std::string sep = labels.empty() ? "" : ",";
+	std::string samples;
+	std::uint64_t count = 0;
+	for (std::size_t i = 0; i <= histogram.getSize(); ++i) {
+		count += histogram.getCount(i);
+		const std::string le = (i < histogram.getSize()) ?
+			std::to_string(histogram.getBound(i)) : "+Inf";
+		samples += StringConverter::stringFormat("@#1_bucket{@#2@#3le=\"@#4\"} @#5\n",
+			name, labels, sep, le, count);
+	}
+	const std::string braced = labels.empty() ? "" : "{" + labels + "}";
+	samples += StringConverter::stringFormat("@#1_sum@#2 @#3\n", name, braced, histogram.getSum());
+	samples += StringConverter::stringFormat("@#1_count@#2 @#3\n", name, braced, count);
+	addSample(name, help, "histogram", samples);
+}
+
+std::string MetricsWriter::getString() const {
+	std::string metrics;
+	for (const auto &[name, family] : _families) {
+		metrics += StringConverter::stringFormat("# HELP @#1 @#2\n# TYPE @#1 @#3\n",
+			name, family.help, family.type);
+		metrics += family.samples;
+	}
+	return metrics;
+}
+
+void MetricsWriter::addSample(const std::string &name, const std::string &help,
+		const char *type, const std::string &sample) {
+	Family &family = _families[name];
+	if (family.samples.empty()) {
+		family.help = help;
+		family.type = type;
+	}
+	family.samples += sample;
+}
+
+} // namespace base
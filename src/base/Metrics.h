@@ -0,0 +1,250 @@
+/* base/Metrics.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_METRICS_H_INCLUDE
+#define BASE_METRICS_H_INCLUDE BASE_METRICS_H_INCLUDE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace base {
+
+/// The class @c Counter is a lock-free counter for the data path. Every thread
+/// adds to its own cache line, so threads never contend on it. The shards are
+/// only summed when the metrics are scraped.
+class Counter {
+	public:
+
+		static constexpr std::size_t SHARDS = 8;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		Counter() = default;
+
+		virtual ~Counter() = default;
+
+		Counter(const Counter&) = delete;
+
+		Counter& operator=(const Counter&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add to the counter
+		void add(const std::uint64_t value = 1) noexcept {
+			_shard[getThreadShard()].value.fetch_add(value, std::memory_order_relaxed);
+		}
+
+		/// Get the total of all threads
+		std::uint64_t get() const noexcept {
+			std::uint64_t total = 0;
+			for (const Shard &shard : _shard) {
+				total += shard.value.load(std::memory_order_relaxed);
+			}
+			return total;
+		}
+
+	private:
+
+		/// Get the shard of the calling thread
+		static std::size_t getThreadShard() noexcept {
+			static std::atomic<std::size_t> nextShard{0};
+			static thread_local const std::size_t shard =
+				nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+			return shard;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		struct alignas(64) Shard {
+			std::atomic<std::uint64_t> value{0};
+		};
+		std::array<Shard, SHARDS> _shard;
+};
+
+/// The class @c Histogram counts observations in buckets with an upper bound,
+/// like a Prometheus histogram. It uses @c Counter for the buckets, so it is
+/// lock-free as well.
+class Histogram {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// Upper bounds for latencies in microseconds, in 1-2-5 steps from
+		/// 5 us up to 5 sec (HDR like with about one bucket per 3 dB)
+		static constexpr std::array<std::uint64_t, 19> LATENCY_US_BOUNDS = {
+			5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000,
+			50000, 100000, 200000, 500000, 1000000, 2000000, 5000000
+		};
+
+		/// @param bounds specifies the (ascending) upper bounds of the buckets,
+		/// there is always an extra '+Inf' bucket
+		explicit Histogram(std::initializer_list<std::uint64_t> bounds) :
+			Histogram(bounds.begin(), bounds.size()) {}
+
+		/// @param bounds specifies the (ascending) upper bounds of the buckets,
+		/// there is always an extra '+Inf' bucket
+		template <std::size_t N>
+		explicit Histogram(const std::array<std::uint64_t, N> &bounds) :
+			Histogram(bounds.data(), N) {}
+
+		/// @param bounds specifies the (ascending) upper bounds of the buckets
+		/// @param size specifies the number of bounds
+		Histogram(const std::uint64_t *bounds, std::size_t size);
+
+		virtual ~Histogram() = default;
+
+		Histogram(const Histogram&) = delete;
+
+		Histogram& operator=(const Histogram&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add an observation
+		void observe(const std::uint64_t value) noexcept {
+			std::size_t i = 0;
+			while (i < _size && value > _bounds[i]) {
+				++i;
+			}
+			_buckets[i].add();
+			_sum.add(value);
+		}
+
+		/// Get the number of buckets (without the '+Inf' bucket)
+		std::size_t getSize() const noexcept {
+			return _size;
+		}
+
+		/// Get the upper bound of the requested bucket
+		std::uint64_t getBound(const std::size_t i) const noexcept {
+			return _bounds[i];
+		}
+
+		/// Get the number of observations in the requested bucket, the bucket
+		/// at @c getSize() is the '+Inf' bucket
+		std::uint64_t getCount(const std::size_t i) const noexcept {
+			return _buckets[i].get();
+		}
+
+		/// Get the sum of all observations
+		std::uint64_t getSum() const noexcept {
+			return _sum.get();
+		}
+
+		/// Get the upper bound of the bucket with the requested quantile
+		/// @param quantile specifies the quantile like 0.5 or 0.99
+		/// @return the upper bound or 0 without observations, observations
+		/// in the '+Inf' bucket return the largest bound
+		std::uint64_t getQuantile(double quantile) const noexcept;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		const std::size_t _size;
+		std::unique_ptr<std::uint64_t[]> _bounds;
+		std::unique_ptr<Counter[]> _buckets;
+		Counter _sum;
+};
+
+/// The class @c MetricsWriter collects metrics in the Prometheus text format.
+/// Samples of the same metric are grouped, so components can add their
+/// metrics in any order.
+class MetricsWriter {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		MetricsWriter() = default;
+
+		virtual ~MetricsWriter() = default;
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Make a label like 'name="value"' to use with the add functions
+		static std::string makeLabel(const std::string &name, const std::string &value);
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add a counter sample
+		/// @param labels specifies the labels like 'frontend="0"' or empty
+		void addCounter(const std::string &name, const std::string &help,
+			const std::string &labels, std::uint64_t value);
+
+		/// Add a gauge sample
+		/// @param labels specifies the labels like 'frontend="0"' or empty
+		void addGauge(const std::string &name, const std::string &help,
+			const std::string &labels, double value);
+
+		/// Add the samples of a histogram
+		/// @param labels specifies the labels like 'frontend="0"' or empty
+		void addHistogram(const std::string &name, const std::string &help,
+			const std::string &labels, const Histogram &histogram);
+
+		/// Get all metrics in the Prometheus text format
+		std::string getString() const;
+
+	private:
+
+		///
+		void addSample(const std::string &name, const std::string &help,
+			const char *type, const std::string &sample);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		struct Family {
+			std::string help;
+			const char *type;
+			std::string samples;
+		};
+		std::map<std::string, Family> _families;
+};
+
+} // namespace base
+
+#endif // BASE_METRICS_H_INCLUDE
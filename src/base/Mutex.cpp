@@ -0,0 +1,158 @@
+/* Mutex.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/Mutex.h>
+
+#include <base/Metrics.h>
+#include <StringConverter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+// pthread_mutex_clocklock() is available since glibc 2.30
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define HAS_MUTEX_CLOCKLOCK
+#endif
+
+namespace base {
+
+namespace {
+
+	struct ContentionStats {
+		std::uint64_t count = 0;
+		std::uint64_t totalNS = 0;
+		std::uint64_t maxNS = 0;
+	};
+
+	/// Key is the pair 'lock site' and 'holder function'
+	using ContentionKey = std::pair<std::string, std::string>;
+	using ContentionMap = std::map<ContentionKey, ContentionStats>;
+
+	// Do not use base::Mutex here, it would record itself
+	std::mutex contentionMutex;
+	ContentionMap contentionMap;
+
+	ContentionMap getContentionMap() {
+		std::lock_guard<std::mutex> lock(contentionMutex);
+		return contentionMap;
+	}
+
+}
+
+// =============================================================================
+// -- MutexProfiler ------------------------------------------------------------
+// =============================================================================
+
+void MutexProfiler::record(const char *file, const int line,
+		const char *holder, const std::uint64_t waitNS) {
+	ContentionKey key(StringConverter::stringFormat("@#1:@#2", file, line),
+		(holder == nullptr) ? "unknown" : holder);
+	std::lock_guard<std::mutex> lock(contentionMutex);
+	ContentionStats &stats = contentionMap[std::move(key)];
+	++stats.count;
+	stats.totalNS += waitNS;
+	stats.maxNS = std::max(stats.maxNS, waitNS);
+}
+
+void MutexProfiler::addToMetrics(MetricsWriter &metrics) {
+	if (!isEnabled()) {
+		return;
+	}
+	for (const auto &[key, stats] : getContentionMap()) {
+		const std::string labels =
+			MetricsWriter::makeLabel("site", key.first) + "," +
+			MetricsWriter::makeLabel("holder", key.second);
+		metrics.addCounter("satpi_mutex_contended_total",
+			"Locks that had to wait for the holder", labels, stats.count);
+		metrics.addCounter("satpi_mutex_wait_microseconds_total",
+			"Time waited for the holder", labels, stats.totalNS / 1000);
+		metrics.addGauge("satpi_mutex_wait_max_microseconds",
+			"Longest time waited for the holder", labels, stats.maxNS / 1000.0);
+	}
+}
+
+void MutexProfiler::logReport() {
+	if (!isEnabled()) {
+		return;
+	}
+	const ContentionMap map = getContentionMap();
+	std::vector<ContentionMap::const_iterator> sorted;
+	for (auto it = map.begin(); it != map.end(); ++it) {
+		sorted.push_back(it);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+		return a->second.totalNS > b->second.totalNS;
+	});
+	constexpr std::size_t MAX_REPORT = 20;
+	SI_LOG_INFO("Mutex contention, @#1 lock sites (top @#2 by wait time):", sorted.size(), MAX_REPORT);
+	for (std::size_t i = 0; i < sorted.size() && i < MAX_REPORT; ++i) {
+		const auto &[key, stats] = *sorted[i];
+		SI_LOG_INFO("  @#1 waited @#2 times, total @#3 us, max @#4 us, holder @#5",
+			key.first, stats.count, stats.totalNS / 1000, stats.maxNS / 1000, key.second);
+	}
+}
+
+// =============================================================================
+// -- Mutex --------------------------------------------------------------------
+// =============================================================================
+
+bool Mutex::lockContended(const unsigned int timeout, const char *file, const int line) const {
+	if (timeout == 0) {
+		return false;
+	}
+	const bool profile = MutexProfiler::isEnabled();
+	const char *holder = profile ? _holder.load(std::memory_order_relaxed) : nullptr;
+	const auto start = std::chrono::steady_clock::now();
+
+	// Use the monotonic clock when available, so a clock change (NTP etc.)
+	// does not shorten or lengthen the timeout
+#ifdef HAS_MUTEX_CLOCKLOCK
+	constexpr clockid_t clock = CLOCK_MONOTONIC;
+#else
+	constexpr clockid_t clock = CLOCK_REALTIME;
+#endif
+	struct timespec deadline;
+	clock_gettime(clock, &deadline);
+	deadline.tv_sec += timeout / 1000;
+	deadline.tv_nsec += (timeout % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L) {
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000L;
+	}
+#ifdef HAS_MUTEX_CLOCKLOCK
+	const bool locked = pthread_mutex_clocklock(&_mutex, clock, &deadline) == 0;
+#else
+	const bool locked = pthread_mutex_timedlock(&_mutex, &deadline) == 0;
+#endif
+	if (locked && profile) {
+		const auto wait = std::chrono::steady_clock::now() - start;
+		MutexProfiler::record(file, line, holder,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count());
+	}
+	return locked;
+}
+
+} // namespace base
@@ -24,32 +24,101 @@
 #include <Utils.h>
 #include <base/Thread.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <thread>
 
 #include <pthread.h>
 
 namespace base {
 
+class MetricsWriter;
+
+/// The class @c MutexProfiler is an opt-in contention profiler for @c Mutex.
+/// When enabled, it records per lock site how often and how long threads had
+/// to wait, and in which function the holder did lock the @c Mutex.
+class MutexProfiler {
+		// =====================================================================
+		//  -- Static member functions -----------------------------------------
+		// =====================================================================
+	public:
+
+		/// Start recording contention from now on
+		static void enable() noexcept {
+			_enabled.store(true, std::memory_order_relaxed);
+		}
+
+		/// Check if contention should be recorded
+		static bool isEnabled() noexcept {
+			return _enabled.load(std::memory_order_relaxed);
+		}
+
+		/// Record a contended lock
+		/// @param file specifies the source file of the waiting lock site
+		/// @param line specifies the source line of the waiting lock site
+		/// @param holder specifies the function that was holding the @c Mutex
+		/// or nullptr when unknown
+		/// @param waitNS specifies the time, in nsec, the waiter was blocked
+		static void record(const char *file, int line, const char *holder,
+			std::uint64_t waitNS);
+
+		/// Add the recorded contention to the metrics, if enabled
+		static void addToMetrics(MetricsWriter &metrics);
+
+		/// Log the lock sites with the most wait time, if enabled
+		static void logReport();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static inline std::atomic<bool> _enabled{false};
+};
+
 /// The class @c Mutex can be locked exclusively per thread
 /// to guarantee thread safety.
 class Mutex {
+	public:
+
+		/// The kind of @c Mutex
+		enum class Type {
+			/// May be locked again by the thread that is holding it
+			Recursive,
+			/// Spins shortly before sleeping on the futex, for the short
+			/// critical sections on the data path. Locking it again from the
+			/// holding thread is a deadlock (and an error in a DEBUG build)
+			NonRecursive
+		};
+
 		// =====================================================================
 		//  -- Constructors and destructor -------------------------------------
 		// =====================================================================
 	public:
 
-		Mutex() {
+		explicit Mutex(const Type type = Type::Recursive) :
+				_type(type),
+				_holder(nullptr) {
 			pthread_mutexattr_t attr;
 			pthread_mutexattr_init(&attr);
-			pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+			pthread_mutexattr_settype(&attr, getPthreadType(type));
 			pthread_mutex_init(&_mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
 		}
 
+		/// A copy is a new, unlocked, @c Mutex of the same type
+		Mutex(const Mutex &other) : Mutex(other._type) {}
+
 		virtual ~Mutex() {
 			pthread_mutex_destroy(&_mutex);
 		}
 
+		/// Keeps its own (state of the) @c Mutex
+		Mutex& operator=(const Mutex &) {
+			return *this;
+		}
+
 		// =====================================================================
 		//  -- Other member functions ------------------------------------------
 		// =====================================================================
@@ -61,15 +130,22 @@ class Mutex {
 		}
 
 		/// Exclusively try to lock the @c Mutex per thread for a maximum time of
-		/// timeout msec.
+		/// timeout msec. The thread sleeps until the @c Mutex is unlocked, so
+		/// it is acquired as soon as the holder releases it.
 		/// @param timeout specifies the time, in msec, to try locking this mutex.
-		bool tryLock(unsigned int timeout) const {
-			while (pthread_mutex_trylock(&_mutex) != 0) {
-				if (timeout == 0) {
-					return false;
-				}
-				std::this_thread::sleep_for(std::chrono::microseconds(1000));
-				--timeout;
+		/// @param file, line and function specify the lock site for the
+		/// @c MutexProfiler and default to the caller
+		bool tryLock(const unsigned int timeout,
+				const char *file = __builtin_FILE(),
+				const int line = __builtin_LINE(),
+				const char *function = __builtin_FUNCTION()) const {
+			// Fast path when not contended
+			if (pthread_mutex_trylock(&_mutex) != 0 &&
+					!lockContended(timeout, file, line)) {
+				return false;
+			}
+			if (MutexProfiler::isEnabled()) {
+				_holder.store(function, std::memory_order_relaxed);
 			}
 			return true;
 		}
@@ -79,12 +155,35 @@ class Mutex {
 			return pthread_mutex_unlock(&_mutex) == 0;
 		}
 
+	private:
+
+		/// Wait, for a maximum time of timeout msec, until the @c Mutex is
+		/// unlocked by its holder
+		bool lockContended(unsigned int timeout, const char *file, int line) const;
+
+		///
+		static int getPthreadType(const Type type) {
+			if (type == Type::Recursive) {
+				return PTHREAD_MUTEX_RECURSIVE;
+			}
+#if defined(DEBUG)
+			return PTHREAD_MUTEX_ERRORCHECK;
+#elif defined(HAS_NP_FUNCTIONS)
+			return PTHREAD_MUTEX_ADAPTIVE_NP;
+#else
+			return PTHREAD_MUTEX_NORMAL;
+#endif
+		}
+
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
 		// =====================================================================
 	private:
 
+		const Type _type;
 		mutable pthread_mutex_t _mutex;
+		/// The function holding the @c Mutex, only set for the @c MutexProfiler
+		mutable std::atomic<const char *> _holder;
 };
 
 /// The class @c MutexLock can be used for @c Mutex to 'auto' lock and unlock
@@ -94,16 +193,21 @@ class MutexLock {
 		// =====================================================================
 	public:
 
-		MutexLock(const Mutex &mutex, unsigned int timeout = TIMEOUT_15SEC) : _mutex(mutex) {
-			if (!_mutex.tryLock(timeout)) {
-				SI_LOG_ERROR("Mutex in @#1 did not lock within timeout?  !!DEADLOCK!!",
-					Thread::getThisThreadName());
+		MutexLock(const Mutex &mutex, const unsigned int timeout = TIMEOUT_15SEC,
+				const char *file = __builtin_FILE(),
+				const int line = __builtin_LINE(),
+				const char *function = __builtin_FUNCTION()) :
+				_mutex(mutex),
+				_locked(_mutex.tryLock(timeout, file, line, function)) {
+			if (!_locked) {
+				SI_LOG_ERROR("Mutex in @#1 did not lock within timeout at @#2:@#3?  !!DEADLOCK!!",
+					Thread::getThisThreadName(), file, line);
 				Utils::createBackTrace("MutexLock");
 			}
 		}
 
 		virtual ~MutexLock() {
-			if (!_mutex.unlock()) {
+			if (_locked && !_mutex.unlock()) {
 				SI_LOG_ERROR("Mutex in @#1 not unlocked!!", Thread::getThisThreadName());
 			}
 		}
@@ -115,6 +219,7 @@ class MutexLock {
 
 		static constexpr unsigned int TIMEOUT_15SEC = 15000;
 		const Mutex &_mutex;
+		const bool _locked;
 };
 
 } // namespace base
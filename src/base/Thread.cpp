@@ -66,7 +66,8 @@ namespace base {
 	}
 
 	void Thread::stopThread() {
-		if (_state == State::Unknown) {
+		// Stopping a thread that already returned would only wait for the timeout
+		if (_state == State::Unknown || _state == State::Stopped) {
 			return;
 		}
 		_state = State::Stopping;
@@ -108,6 +109,8 @@ namespace base {
 			return;
 		}
 		(void) pthread_join(_thread, nullptr);
+		// The thread is gone, so stopping or joining it again is a no-op
+		_state = State::Unknown;
 	}
 
 	void Thread::setAffinity(int UNUSED(cpu)) {
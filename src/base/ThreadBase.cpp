@@ -84,12 +84,17 @@ namespace base {
 	}
 
 	void ThreadBase::cancelThread() {
-		pthread_cancel(_thread);
+		// The thread may never have been started (e.g. SSDP switched off)
+		if (_thread != 0u) {
+			pthread_cancel(_thread);
+		}
 		_exit = true;
 	}
 
 	void ThreadBase::joinThread() {
-		(void) pthread_join(_thread, nullptr);
+		if (_thread != 0u) {
+			(void) pthread_join(_thread, nullptr);
+		}
 	}
 
 	void ThreadBase::setAffinity(int cpu) {
@@ -141,7 +146,9 @@ namespace base {
 
 	void ThreadBase::threadEntryBase() {
 		pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
-		pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, nullptr);
+		// Cancel only at a cancellation point (poll, sleep etc.), an asynchronous
+		// cancel can hit the thread in a teardown or in malloc and corrupt the heap
+		pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, nullptr);
 #ifdef HAS_NP_FUNCTIONS
 		pthread_setname_np(_thread, _name.data());
 #else
@@ -0,0 +1,162 @@
+/* base/XMLDocument.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/XMLDocument.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace base {
+
+// =============================================================================
+// -- XMLElement ---------------------------------------------------------------
+// =============================================================================
+
+bool XMLElement::find(const std::string_view path, XMLElement &element) const {
+	std::size_t found = 0;
+	if (_doc == nullptr || !_doc->find(_node, path, found)) {
+		return false;
+	}
+	element = XMLElement(_doc, found);
+	return true;
+}
+
+std::string_view XMLElement::getContent() const {
+	if (_doc == nullptr) {
+		return std::string_view();
+	}
+	const XMLDocument::Node &node = _doc->_node[_node];
+	return std::string_view(_doc->_xml).substr(node.contentBegin, node.contentEnd - node.contentBegin);
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+XMLDocument::XMLDocument(std::string xml) :
+	_xml(std::move(xml)) {
+	_valid = parse();
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool XMLDocument::parse() {
+	const std::string_view xml(_xml);
+	_node.push_back({ std::string_view(), 0, xml.size(), 0 });
+	std::vector<std::size_t> open;
+	std::size_t pos = 0;
+	for (;;) {
+		pos = xml.find('<', pos);
+		if (pos == std::string_view::npos) {
+			break;
+		}
+		++pos;
+		if (pos == xml.size()) {
+			return false;
+		}
+		const char type = xml[pos];
+		if (type == '!') {
+			// Comment or DOCTYPE
+			pos = xml.find('>', pos);
+		} else if (type == '?') {
+			// XML declaration, it should end with '?>'
+			pos = xml.find('?', pos + 1);
+			if (pos != std::string_view::npos) {
+				if (pos + 1 == xml.size() || xml[pos + 1] != '>') {
+					return false;
+				}
+				++pos;
+			}
+		} else if (type == '&') {
+			pos = xml.find(';', pos);
+		} else if (type == '/') {
+			const std::size_t end = xml.find('>', pos);
+			if (open.empty()) {
+				// Closing tag without an open tag ends the document
+				break;
+			}
+			if (end == std::string_view::npos) {
+				return false;
+			}
+			Node &node = _node[open.back()];
+			if (node.tag != xml.substr(pos + 1, end - pos - 1)) {
+				return false;
+			}
+			node.contentEnd = pos - 1;
+			node.last = _node.size() - 1;
+			open.pop_back();
+			pos = end;
+		} else {
+			const std::size_t end = xml.find('>', pos);
+			if (end == std::string_view::npos) {
+				if (open.empty()) {
+					break;
+				}
+				return false;
+			}
+			// Skip empty element tags like <tag/>
+			if (xml[end - 1] != '/') {
+				const std::size_t id = _node.size();
+				const std::string_view tag = xml.substr(pos, end - pos);
+				_node.push_back({ tag, end + 1, end + 1, id });
+				_tagIndex[tag].push_back(id);
+				open.push_back(id);
+			}
+			pos = end;
+		}
+		if (pos == std::string_view::npos) {
+			break;
+		}
+		++pos;
+	}
+	_node[0].last = _node.size() - 1;
+	return open.empty();
+}
+
+bool XMLDocument::find(const std::size_t node, const std::string_view path, std::size_t &found) const {
+	if (!_valid) {
+		return false;
+	}
+	const std::string_view::size_type dot = path.find('.');
+	const std::string_view tag = path.substr(0, dot);
+	const TagIndex::const_iterator tagIt = _tagIndex.find(tag);
+	if (tagIt == _tagIndex.end()) {
+		return false;
+	}
+	// Only the elements nested in 'node' are candidates
+	const std::vector<std::size_t> &ids = tagIt->second;
+	const std::size_t last = _node[node].last;
+	bool ok = false;
+	for (auto it = std::upper_bound(ids.begin(), ids.end(), node); it != ids.end() && *it <= last; ++it) {
+		std::size_t candidate = *it;
+		if (dot != std::string_view::npos && !find(*it, path.substr(dot + 1), candidate)) {
+			continue;
+		}
+		// The previous parser returned the match that was closed last
+		if (!ok || _node[candidate].contentEnd > _node[found].contentEnd) {
+			found = candidate;
+			ok = true;
+		}
+	}
+	return ok;
+}
+
+} // namespace base
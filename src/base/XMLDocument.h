@@ -0,0 +1,144 @@
+/* base/XMLDocument.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_XML_DOCUMENT_H_INCLUDE
+#define BASE_XML_DOCUMENT_H_INCLUDE BASE_XML_DOCUMENT_H_INCLUDE
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace base {
+
+class XMLDocument;
+
+/// The class @c XMLElement is a light-weight reference to one element of an
+/// @c XMLDocument. It is only valid as long as that document exists.
+class XMLElement {
+		friend class XMLDocument;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		XMLElement() = default;
+
+		virtual ~XMLElement() = default;
+
+	private:
+
+		XMLElement(const XMLDocument *doc, std::size_t node) :
+			_doc(doc), _node(node) {}
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Find an element with the path like "filterPCR.value" inside this
+		/// element. Each part of the path may be nested deeper than a direct
+		/// child. If there are more matches, the last one in the document is
+		/// returned (like the previous parser did).
+		/// @param path specifies the element to find
+		/// @param element will be the found element
+		/// @return true if the element was found
+		bool find(std::string_view path, XMLElement &element) const;
+
+		/// Get the raw content between the begin and end tag of this element
+		std::string_view getContent() const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		const XMLDocument *_doc = nullptr;
+		std::size_t _node = 0;
+};
+
+/// The class @c XMLDocument parses an XML document once and keeps an index of
+/// all the elements per tag name, so that finding an element does not need to
+/// parse the document again.
+class XMLDocument {
+		friend class XMLElement;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		explicit XMLDocument(std::string xml);
+
+		virtual ~XMLDocument() = default;
+
+		XMLDocument(const XMLDocument&) = delete;
+
+		XMLDocument& operator=(const XMLDocument&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the whole document as element, finding elements fails if
+		/// the document is not well formed
+		XMLElement getRoot() const {
+			return XMLElement(this, 0);
+		}
+
+		/// Check if the document is well formed
+		bool isValid() const {
+			return _valid;
+		}
+
+	private:
+
+		/// Tokenize the whole document into @c _node and @c _tagIndex
+		bool parse();
+
+		bool find(std::size_t node, std::string_view path, std::size_t &found) const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		struct Node {
+			std::string_view tag;
+			std::size_t contentBegin;
+			std::size_t contentEnd;
+			/// The last node that is nested in this node (nodes are numbered
+			/// in document order, so the descendants are a continuous range)
+			std::size_t last;
+		};
+		using NodeVector = std::vector<Node>;
+		using TagIndex = std::unordered_map<std::string_view, std::vector<std::size_t>>;
+
+		std::string _xml;
+		NodeVector _node;
+		TagIndex _tagIndex;
+		bool _valid;
+};
+
+} // namespace base
+
+#endif // BASE_XML_DOCUMENT_H_INCLUDE
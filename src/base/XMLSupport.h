@@ -21,6 +21,7 @@
 #define BASE_XML_SUPPORT_H_INCLUDE BASE_XML_SUPPORT_H_INCLUDE
 
 #include <base/Mutex.h>
+#include <base/XMLDocument.h>
 #include <StringConverter.h>
 #include <Unused.h>
 
@@ -122,8 +123,15 @@ class XMLSupport {
 			doAddToXML(xml);
 		}
 
-		/// Get data from an XML for restoring or web interface
+		/// Get data from an XML for restoring or web interface, the XML is
+		/// parsed only once here
 		void fromXML(const std::string &xml) {
+			const XMLDocument doc(xml);
+			fromXML(doc.getRoot());
+		}
+
+		/// Get data from an element of an already parsed XML
+		void fromXML(const XMLElement &xml) {
 			base::MutexLock lock(_mutex);
 			doFromXML(xml);
 		}
@@ -140,22 +148,21 @@ class XMLSupport {
 		virtual void doAddToXML(std::string &UNUSED(xml)) const {}
 
 		/// Specialization for @see fromXML
-		virtual void doFromXML(const std::string &UNUSED(xml)) {}
+		virtual void doFromXML(const XMLElement &UNUSED(xml)) {}
 
 	protected:
 
 		virtual bool notifyChanges() const;
 
-		///
-		bool findXMLElement(const std::string &xml, const std::string &elementToFind,
-			std::string &element);
-
-	private:
+		/// Find the element with the path like "filterPCR.value" in @c xml
+		/// @param element will be a copy of the raw content of the element
+		bool findXMLElement(const XMLElement &xml, std::string_view elementToFind,
+			std::string &element) const;
 
-		/// Very basic/simple recursive XML parser
-		bool parseXML(const std::string &xml, const std::string &elementToFind,
-			bool &found, std::string &element, std::string::const_iterator &it,
-			std::string &tagEnd, std::string::const_iterator &itEndElement);
+		/// Find the element with the path like "transformation" in @c xml
+		/// @param element will be the found element, to pass it to @c fromXML
+		bool findXMLElement(const XMLElement &xml, std::string_view elementToFind,
+			XMLElement &element) const;
 
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
@@ -169,27 +176,27 @@ class XMLSupport {
 } // namespace base
 
 #define ADD_XML_BEGIN_ELEMENT(XML, ELEMENTNAME) \
-	XML += StringConverter::stringFormat("<@#1>", ELEMENTNAME)
+	StringConverter::stringFormatTo(XML, "<@#1>", ELEMENTNAME)
 
 #define ADD_XML_END_ELEMENT(XML, ELEMENTNAME) \
-	XML += StringConverter::stringFormat("</@#1>", ELEMENTNAME)
+	StringConverter::stringFormatTo(XML, "</@#1>", ELEMENTNAME)
 
 #define ADD_XML_ELEMENT(XML, ELEMENTNAME, VALUE) \
-	XML += StringConverter::stringFormat("<@#1>@#2</@#1>", ELEMENTNAME, base::XMLSupport::makeXMLString(VALUE))
+	StringConverter::stringFormatTo(XML, "<@#1>@#2</@#1>", ELEMENTNAME, base::XMLSupport::makeXMLString(VALUE))
 
 #define ADD_XML_N_ELEMENT(XML, ELEMENTNAME, N, VALUE) \
-	XML += StringConverter::stringFormat("<@#1@#2>@#3</@#1@#2>", ELEMENTNAME, N, base::XMLSupport::makeXMLString(VALUE))
+	StringConverter::stringFormatTo(XML, "<@#1@#2>@#3</@#1@#2>", ELEMENTNAME, N, base::XMLSupport::makeXMLString(VALUE))
 
 #define ADD_XML_CHECKBOX(XML, VARNAME, VALUE) \
-	XML += StringConverter::stringFormat("<@#1><inputtype>checkbox</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
+	StringConverter::stringFormatTo(XML, "<@#1><inputtype>checkbox</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
 
 #define ADD_XML_NUMBER_INPUT(XML, VARNAME, VALUE, MIN, MAX) \
-	XML += StringConverter::stringFormat("<@#1><inputtype>number</inputtype><value>@#2</value><minvalue>@#3</minvalue><maxvalue>@#4</maxvalue></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE), MIN, MAX)
+	StringConverter::stringFormatTo(XML, "<@#1><inputtype>number</inputtype><value>@#2</value><minvalue>@#3</minvalue><maxvalue>@#4</maxvalue></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE), MIN, MAX)
 
 #define ADD_XML_TEXT_INPUT(XML, VARNAME, VALUE) \
-	XML += StringConverter::stringFormat("<@#1><inputtype>text</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
+	StringConverter::stringFormatTo(XML, "<@#1><inputtype>text</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
 
 #define ADD_XML_IP_INPUT(XML, VARNAME, VALUE) \
-	XML += StringConverter::stringFormat("<@#1><inputtype>ip</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
+	StringConverter::stringFormatTo(XML, "<@#1><inputtype>ip</inputtype><value>@#2</value></@#1>", VARNAME, base::XMLSupport::makeXMLString(VALUE))
 
 #endif // BASE_XML_SUPPORT_H_INCLUDE
@@ -33,10 +33,6 @@
 
 #include <cstring>
 
-extern "C" {
-	#include <dvbcsa/dvbcsa.h>
-}
-
 #include <poll.h>
 
 #include <netinet/in.h>
@@ -140,43 +136,39 @@ namespace decrypt::dvbapi {
 							buffer.setDecryptPending();
 						} else {
 							// set decrypt failed by setting NULL packet ID..
-							data[1] |= 0x1F;
-							data[2] |= 0xFF;
-
-							// clear scramble flag, so we can send it.
-							data[3] &= 0x3F;
+							frontend->markDecryptFailed(data);
 						}
 					} else {
 						// Need to filter this packet to OSCam
-						unsigned int demux = 0;
-						unsigned int filter = 0;
-						unsigned int tableID = data[5];
-						mpegts::TSData filterData;
-						if (frontend->findOSCamFilterData(pid, data, tableID, filter, demux, filterData)) {
+						std::vector<decrypt::dvbapi::FilterSection> sections;
+						if (frontend->findOSCamFilterData(pid, data, sections)) {
 							// Don't send PAT or PMT before we have an active
 							if (pid == 0 || frontend->isMarkedAsActivePMT(pid)) {
 							} else {
-								const unsigned char* tableData = filterData.data();
-								const int sectionLength = (((tableData[6] & 0x0F) << 8) | tableData[7]) + 3; // 3 = tableID + length field
-								// Check for ICAM in ECM
-								if ((tableID == mpegts::TableData::ECM0_ID ||	tableID == mpegts::TableData::ECM1_ID)) {
-										frontend->setICAM(((tableData[7] - tableData[9]) == 4) ?
-											tableData[26] : 0, ((tableID & 0x01) > 0));
-								}
-								std::unique_ptr<unsigned char[]> clientData(new unsigned char[sectionLength + 25]);
-								const uint32_t request = htonl(DVBAPI_FILTER_DATA);
-								std::memcpy(&clientData[0], &request, 4);
-								clientData[4] =  demux;
-								clientData[5] =  filter;
-								std::memcpy(&clientData[6], &tableData[5], sectionLength); // copy Table data
-								const int length = sectionLength + 6; // 6 = clientData header
-
-								SI_LOG_DEBUG("Frontend: @#1, Send Filter Data with size @#2 for demux: @#3  filter: @#4 PID @#5 TableID @#6 @#7 @#8 @#9 @#10",
-									id, length, demux, filter, PID(pid),
-									HEX2(tableData[5]), HEX2(tableData[6]), HEX2(tableData[7]), HEX2(tableData[8]), HEX2(tableData[9]));
-
-								if (!_client.sendData(clientData.get(), length, MSG_DONTWAIT)) {
-									SI_LOG_ERROR("Frontend: @#1, Filter - send data to server failed", id);
+								for (const decrypt::dvbapi::FilterSection &section : sections) {
+									const unsigned char* tableData = section.data.data();
+									const int sectionLength = section.data.size();
+									const unsigned int tableID = tableData[0];
+									// Check for ICAM in ECM
+									if ((tableID == mpegts::TableData::ECM0_ID || tableID == mpegts::TableData::ECM1_ID)) {
+											frontend->setICAM((sectionLength > 21 && (tableData[2] - tableData[4]) == 4) ?
+												tableData[21] : 0, ((tableID & 0x01) > 0));
+									}
+									std::unique_ptr<unsigned char[]> clientData(new unsigned char[sectionLength + 25]);
+									const uint32_t request = htonl(DVBAPI_FILTER_DATA);
+									std::memcpy(&clientData[0], &request, 4);
+									clientData[4] =  section.demux;
+									clientData[5] =  section.filter;
+									std::memcpy(&clientData[6], tableData, sectionLength); // copy Table data
+									const int length = sectionLength + 6; // 6 = clientData header
+
+									SI_LOG_DEBUG("Frontend: @#1, Send Filter Data with size @#2 for demux: @#3  filter: @#4 PID @#5 TableID @#6 @#7 @#8 @#9 @#10",
+										id, length, section.demux, section.filter, PID(pid),
+										HEX2(tableData[0]), HEX2(tableData[1]), HEX2(tableData[2]), HEX2(tableData[3]), HEX2(tableData[4]));
+
+									if (!_client.sendData(clientData.get(), length, MSG_DONTWAIT)) {
+										SI_LOG_ERROR("Frontend: @#1, Filter - send data to server failed", id);
+									}
 								}
 							}
 						}
@@ -527,7 +519,7 @@ namespace decrypt::dvbapi {
 	//  -- base::XMLSupport --------------------------------------------------
 	// =======================================================================
 
-	void Client::doFromXML(const std::string &xml) {
+	void Client::doFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "OSCamIP.value", element)) {
 			_serverIPAddr = element;
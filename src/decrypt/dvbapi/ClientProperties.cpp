@@ -22,7 +22,7 @@
 #include <Utils.h>
 #include <Unused.h>
 
-#include <dlfcn.h>
+#include <chrono>
 
 namespace decrypt::dvbapi {
 
@@ -30,24 +30,17 @@ namespace decrypt::dvbapi {
 // -- Constructors and destructor --------------------------------------------
 // ===========================================================================
 
-ClientProperties::ClientProperties() {
-	_batchSizeMax = dvbcsa_bs_batch_size();
+ClientProperties::ClientProperties() :
+	_descrambler(Descrambler::getSelected()),
+	_keys(_descrambler) {
+	_batchSizeMax = _descrambler->getBatchSize();
 	_batchSize = _batchSizeMax;
-	_batch = new dvbcsa_bs_batch_s[_batchSizeMax + 1];
-	_ts = new dvbcsa_bs_batch_s[_batchSizeMax + 1];
+	_batch = new Descrambler::Batch[_batchSizeMax + 1];
+	_ts = new Descrambler::Batch[_batchSizeMax + 1];
 	_batchCount = 0;
 	_parity = 0;
-	void* handle = dlopen("libdvbcsa.so.1", RTLD_LAZY | RTLD_NODELETE);
-	if (handle != nullptr) {
-		if (dlsym(handle, "dvbcsa_bs_key_set_ecm") == nullptr) {
-			SI_LOG_INFO("  ICAM support in libdvbcsa.so: No");
-			_icamEnabled = false;
-		} else {
-			SI_LOG_INFO("  ICAM support in libdvbcsa.so: Yes");
-			_icamEnabled = true;
-		}
-		dlclose(handle);
-	}
+	_icamEnabled = _descrambler->isICAMCapable();
+	SI_LOG_INFO("  ICAM support in @#1: @#2", _descrambler->getName(), _icamEnabled ? "Yes" : "No");
 }
 
 ClientProperties::~ClientProperties() {
@@ -63,9 +56,11 @@ ClientProperties::~ClientProperties() {
 void ClientProperties::doAddToXML(std::string& xml) const {
 	ADD_XML_NUMBER_INPUT(xml, "dvbcsa_bs_batch_size", _batchSize, 0, _batchSizeMax);
 	ADD_XML_ELEMENT(xml, "icamEnabled", _icamEnabled ? "Yes" : "No");
+	ADD_XML_ELEMENT(xml, "descrambler", _descrambler->getName());
+	ADD_XML_ELEMENT(xml, "descramblerMbps", _descrambler->getBenchmarkResult());
 }
 
-void ClientProperties::doFromXML(const std::string& UNUSED(xml)) {
+void ClientProperties::doFromXML(const base::XMLElement &UNUSED(xml)) {
 }
 
 // ===========================================================================
@@ -84,29 +79,39 @@ void ClientProperties::stopOSCamFilters(FeID id) {
 void ClientProperties::decryptBatch() noexcept {
 	const auto key = _keys.get(_parity);
 	if (key != nullptr) {
+		_batchFill.observe(_batchCount);
+		const auto t1 = std::chrono::steady_clock::now();
 		// terminate batch buffer
 		setBatchData(nullptr, 0, _parity, nullptr);
 		// decrypt it
-		dvbcsa_bs_decrypt(key, _batch, 184);
+		_descrambler->decrypt(key, _batch, 184);
+		const auto t2 = std::chrono::steady_clock::now();
+		_decryptTimeUS.observe(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
 
 		// clear scramble flags, so we can send it.
 		for (unsigned int i = 0; _ts[i].data != nullptr; ++i) {
 			_ts[i].data[3] &= 0x3F;
 		}
 	} else {
+		// terminate batch buffer
+		_ts[_batchCount].data = nullptr;
 		for (unsigned int i = 0; _ts[i].data != nullptr; ++i) {
-			// set decrypt failed by setting NULL packet ID..
-			_ts[i].data[1] |= 0x1F;
-			_ts[i].data[2] |= 0xFF;
-
-			// clear scramble flag, so we can send it.
-			_ts[i].data[3] &= 0x3F;
+			markDecryptFailed(_ts[i].data);
 		}
 	}
 	// decrypted this batch reset counter
 	_batchCount = 0;
 }
 
+void ClientProperties::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const {
+	metrics.addHistogram("satpi_decrypt_batch_packets",
+		"Number of TS packets per decrypt batch", labels, _batchFill);
+	metrics.addHistogram("satpi_decrypt_batch_duration_microseconds",
+		"Time to decrypt one batch", labels, _decryptTimeUS);
+	metrics.addCounter("satpi_decrypt_key_miss_packets_total",
+		"Scrambled TS packets made NULL packet because there was no key", labels, _keyMissNullOuts.get());
+}
+
 void ClientProperties::setECMInfo(
 	int UNUSED(pid),
 	int UNUSED(serviceID),
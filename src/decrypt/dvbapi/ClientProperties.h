@@ -23,15 +23,13 @@
 #include <Defs.h>
 #include <FwDecl.h>
 #include <mpegts/TableData.h>
+#include <base/Metrics.h>
 #include <base/TimeCounter.h>
 #include <base/XMLSupport.h>
+#include <decrypt/dvbapi/Descrambler.h>
 #include <decrypt/dvbapi/Filter.h>
 #include <decrypt/dvbapi/Keys.h>
 
-extern "C" {
-	#include <dvbcsa/dvbcsa.h>
-}
-
 namespace decrypt::dvbapi {
 
 ///
@@ -59,7 +57,7 @@ class ClientProperties :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// ================================================================
 		//  -- Other member functions -------------------------------------
@@ -97,6 +95,19 @@ class ClientProperties :
 		/// on failure it will make a NULL TS Packet and clear scramble flag
 		void decryptBatch() noexcept;
 
+		/// Decrypt failed (no key), make it a NULL TS Packet and clear scramble
+		/// flag so we can send it
+		void markDecryptFailed(unsigned char* data) noexcept {
+			data[1] |= 0x1F;
+			data[2] |= 0xFF;
+			data[3] &= 0x3F;
+			_keyMissNullOuts.add();
+		}
+
+		/// Add the decrypt metrics of this frontend
+		/// @param labels specifies the labels of the stream of this frontend
+		void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const;
+
 		/// Set the 'next' key for the requested parity
 		void setKey(const unsigned char* cw, const unsigned int parity, const int index) {
 			_keys.set(cw, parity, index, _icamEnabled);
@@ -107,7 +118,7 @@ class ClientProperties :
 		}
 
 		/// Get the active key for the requested parity
-		const dvbcsa_bs_key_s* getKey(unsigned int parity) const {
+		const DescramblerKey* getKey(unsigned int parity) const {
 			return _keys.get(parity);
 		}
 
@@ -122,10 +133,10 @@ class ClientProperties :
 			_filter.stop(demux, filter);
 		}
 
-		/// Find the correct filter for the 'collected' data or ts packet
-		bool findOSCamFilterData(const FeID id, int pid, const unsigned char* tsPacket, const int tableID,
-			unsigned int& filter, unsigned int& demux, mpegts::TSData& filterData) {
-			return _filter.find(id, pid, tsPacket, tableID, filter, demux, filterData);
+		/// Find the sections, finished with this ts packet, that match the filters
+		bool findOSCamFilterData(const FeID id, int pid, const unsigned char* tsPacket,
+			std::vector<FilterSection>& sections) {
+			return _filter.find(id, pid, tsPacket, sections);
 		}
 
 		/// Get the vector of current 'active' demux filters
@@ -159,8 +170,9 @@ class ClientProperties :
 		// ================================================================
 	private:
 
-		struct dvbcsa_bs_batch_s* _batch;
-		struct dvbcsa_bs_batch_s* _ts;
+		SpDescrambler _descrambler;
+		Descrambler::Batch* _batch;
+		Descrambler::Batch* _ts;
 		unsigned int _batchSizeMax;
 		unsigned int _batchSize;
 		unsigned int _batchCount;
@@ -168,6 +180,9 @@ class ClientProperties :
 		bool _icamEnabled;
 		Keys _keys;
 		Filter _filter;
+		base::Histogram _batchFill{ 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+		base::Histogram _decryptTimeUS{ 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 };
+		base::Counter _keyMissNullOuts;
 
 };
 
@@ -0,0 +1,159 @@
+/* Descrambler.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/Descrambler.h>
+
+#include <base/Benchmark.h>
+#include <decrypt/dvbapi/DescramblerLibDVBCSA.h>
+#include <Log.h>
+#include <StringConverter.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace decrypt::dvbapi {
+
+std::vector<std::string> Descrambler::_selection{"libdvbcsa"};
+
+namespace {
+
+	/// Duration of the benchmark that is run when selecting a backend
+	constexpr unsigned int SELECT_BENCHMARK_MSEC = 100;
+
+	constexpr unsigned int PAYLOAD_SIZE = 184;
+	constexpr unsigned char BENCHMARK_CW[8] = { 0x11, 0x22, 0x33, 0x66, 0x44, 0x55, 0x66, 0xFF };
+
+	/// A full (terminated) batch of TS payloads to benchmark a backend with
+	struct BenchmarkBatch {
+		explicit BenchmarkBatch(const unsigned int batchSize) :
+			payload(batchSize * PAYLOAD_SIZE),
+			batch(batchSize + 1) {
+			for (std::size_t i = 0; i < payload.size(); ++i) {
+				payload[i] = static_cast<unsigned char>(i * 31 + 7);
+			}
+			for (unsigned int i = 0; i < batchSize; ++i) {
+				batch[i].data = &payload[i * PAYLOAD_SIZE];
+				batch[i].len = PAYLOAD_SIZE;
+			}
+			batch[batchSize].data = nullptr;
+			batch[batchSize].len = 0;
+		}
+
+		std::vector<unsigned char> payload;
+		std::vector<Descrambler::Batch> batch;
+	};
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void Descrambler::setSelection(const std::string &selection) {
+	_selection = StringConverter::split(selection, ",");
+}
+
+SpDescrambler Descrambler::getSelected() {
+	static const SpDescrambler selected = [] {
+		SpDescrambler best;
+		for (const std::string &name : _selection) {
+			SpDescrambler descrambler = create(name);
+			if (!descrambler) {
+				continue;
+			}
+			const double mbps = descrambler->benchmark(SELECT_BENCHMARK_MSEC);
+			SI_LOG_INFO("Descrambler: @#1 with batch size @#2 runs @#3 Mbit/s per core",
+				descrambler->getName(), descrambler->getBatchSize(), mbps);
+			if (!best || mbps > best->getBenchmarkResult()) {
+				best = descrambler;
+			}
+		}
+		if (!best) {
+			SI_LOG_ERROR("Descrambler: None of the requested backends available, using libdvbcsa");
+			best = create("libdvbcsa");
+		}
+		SI_LOG_INFO("Descrambler: Selected @#1", best->getName());
+		return best;
+	}();
+	return selected;
+}
+
+SpDescrambler Descrambler::create(const std::string &name) {
+	if (name == "libdvbcsa") {
+		return std::make_shared<DescramblerLibDVBCSA>();
+	}
+	return DescramblerLibDVBCSA::load(name);
+}
+
+void Descrambler::runBenchmarks(base::Benchmark &benchmark) {
+	for (const std::string &name : _selection) {
+		SpDescrambler descrambler = create(name);
+		if (!descrambler) {
+			continue;
+		}
+		BenchmarkBatch data(descrambler->getBatchSize());
+		DescramblerKey *key = descrambler->keyAlloc();
+		descrambler->keySet(BENCHMARK_CW, key);
+		const std::string caseName = StringConverter::stringFormat("descrambler/@#1/batch-@#2",
+			descrambler->getName(), descrambler->getBatchSize());
+		const std::size_t results = benchmark.getResults().size();
+		benchmark.run(caseName, data.payload.size(), [&] {
+			descrambler->decrypt(key, data.batch.data(), PAYLOAD_SIZE);
+		});
+		descrambler->keyFree(key);
+		// The throughput of a descrambler is usually given in Mbit/s per core
+		if (benchmark.getResults().size() > results) {
+			std::printf("%-40s %10.1f Mbit/s per core, ICAM %s\r\n", caseName.c_str(),
+				benchmark.getResults().back().mbPerSec * 8.0,
+				descrambler->isICAMCapable() ? "Yes" : "No");
+		}
+	}
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+double Descrambler::benchmark(const unsigned int msec) {
+	const unsigned int batchSize = getBatchSize();
+	BenchmarkBatch data(batchSize);
+	DescramblerKey *key = keyAlloc();
+	keySet(BENCHMARK_CW, key);
+
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start = Clock::now();
+	const Clock::time_point end = start + std::chrono::milliseconds(msec);
+	unsigned long batches = 0;
+	Clock::time_point now;
+	do {
+		for (unsigned int i = 0; i < 16; ++i) {
+			decrypt(key, data.batch.data(), PAYLOAD_SIZE);
+		}
+		batches += 16;
+		now = Clock::now();
+	} while (now < end);
+	keyFree(key);
+
+	const double sec = std::chrono::duration<double>(now - start).count();
+	_mbps = (batches * batchSize * PAYLOAD_SIZE * 8.0) / (sec * 1000000.0);
+	return _mbps;
+}
+
+}
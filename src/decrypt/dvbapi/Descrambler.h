@@ -0,0 +1,133 @@
+/* Descrambler.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_DESCRAMBLER_H_INCLUDE
+#define DECRYPT_DVBAPI_DESCRAMBLER_H_INCLUDE DECRYPT_DVBAPI_DESCRAMBLER_H_INCLUDE
+
+#include <FwDecl.h>
+
+#include <string>
+#include <vector>
+
+FW_DECL_NS1(base, Benchmark);
+FW_DECL_NS2(decrypt, dvbapi, DescramblerKey);
+FW_DECL_SP_NS2(decrypt, dvbapi, Descrambler);
+
+namespace decrypt::dvbapi {
+
+/// The class @c Descrambler is the interface to a CSA descrambler backend.
+/// Keys are opaque handles owned by the backend that allocated them.
+class Descrambler {
+	public:
+
+		/// Entry of a decrypt batch, it has the same layout as @c dvbcsa_bs_batch_s
+		/// so it can be handed to libdvbcsa without copying. A batch is terminated
+		/// by an entry with @c data set to @c nullptr
+		struct Batch {
+			unsigned char *data;
+			unsigned int len;
+		};
+
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		Descrambler() = default;
+
+		virtual ~Descrambler() = default;
+
+		Descrambler(const Descrambler&) = delete;
+
+		Descrambler& operator=(const Descrambler&) = delete;
+
+		// =====================================================================
+		//  -- Static member functions -----------------------------------------
+		// =====================================================================
+	public:
+
+		/// Set the descrambler backend(s) to select from. The list is comma
+		/// separated, each entry is 'libdvbcsa' (the linked library) or the path
+		/// to a libdvbcsa compatible shared object. With more than one entry the
+		/// fastest one is selected. Should be called before @c getSelected
+		static void setSelection(const std::string &selection);
+
+		/// Get the selected descrambler backend, it is created on first use
+		static SpDescrambler getSelected();
+
+		/// Create the requested descrambler backend
+		/// @param name specifies 'libdvbcsa' or the path to a shared object
+		/// @return the backend or @c nullptr if it could not be created
+		static SpDescrambler create(const std::string &name);
+
+		/// Run the batch decrypt micro benchmark of all backends in the current
+		/// selection, and print their throughput in Mbit/s per core
+		static void runBenchmarks(base::Benchmark &benchmark);
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Run this backend for the requested duration on a single core
+		/// @return the throughput in Mbit/s
+		double benchmark(unsigned int msec);
+
+		/// Get the result of the last benchmark in Mbit/s (per core)
+		double getBenchmarkResult() const noexcept {
+			return _mbps;
+		}
+
+		/// Get the name of this backend
+		virtual std::string getName() const = 0;
+
+		/// Get the maximum number of packets this backend decrypts in one batch
+		virtual unsigned int getBatchSize() const = 0;
+
+		/// Check if this backend supports ICAM keys
+		virtual bool isICAMCapable() const = 0;
+
+		/// Allocate a new key for this backend
+		virtual DescramblerKey *keyAlloc() = 0;
+
+		/// Free a key allocated by @c keyAlloc
+		virtual void keyFree(DescramblerKey *key) = 0;
+
+		/// Set the control word of the key
+		virtual void keySet(const unsigned char *cw, DescramblerKey *key) = 0;
+
+		/// Set the control word of the key with the ICAM ecm byte
+		virtual void keySetECM(unsigned char ecm, const unsigned char *cw, DescramblerKey *key) = 0;
+
+		/// Decrypt the (terminated) batch with the requested key
+		/// @param maxlen specifies the maximum amount of bytes to decrypt per entry
+		virtual void decrypt(const DescramblerKey *key, const Batch *batch, unsigned int maxlen) = 0;
+
+		// =====================================================================
+		//  -- Data members ----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static std::vector<std::string> _selection;
+		double _mbps = 0.0;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_DESCRAMBLER_H_INCLUDE
@@ -0,0 +1,120 @@
+/* DescramblerLibDVBCSA.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/DescramblerLibDVBCSA.h>
+
+#include <Log.h>
+
+#include <cstddef>
+
+#include <dlfcn.h>
+
+extern "C" {
+	#include <dvbcsa/dvbcsa.h>
+	void dvbcsa_bs_key_set_ecm(unsigned char ecm, const dvbcsa_cw_t cw, struct dvbcsa_bs_key_s *key) __attribute__((weak));
+}
+
+namespace decrypt::dvbapi {
+
+static_assert(sizeof(Descrambler::Batch) == sizeof(dvbcsa_bs_batch_s), "Batch layout mismatch");
+static_assert(offsetof(Descrambler::Batch, data) == offsetof(dvbcsa_bs_batch_s, data), "Batch layout mismatch");
+static_assert(offsetof(Descrambler::Batch, len) == offsetof(dvbcsa_bs_batch_s, len), "Batch layout mismatch");
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+DescramblerLibDVBCSA::DescramblerLibDVBCSA() :
+	_name("libdvbcsa"),
+	_handle(nullptr),
+	_batchSize(dvbcsa_bs_batch_size()),
+	_keyAlloc(&dvbcsa_bs_key_alloc),
+	_keyFree(&dvbcsa_bs_key_free),
+	_keySet(&dvbcsa_bs_key_set),
+	_keySetECM(dvbcsa_bs_key_set_ecm),
+	_decrypt(&dvbcsa_bs_decrypt) {}
+
+DescramblerLibDVBCSA::DescramblerLibDVBCSA(const std::string &path, void *handle) :
+	_name(path),
+	_handle(handle),
+	_batchSize(0),
+	_keyAlloc(reinterpret_cast<KeyAllocFunc>(dlsym(handle, "dvbcsa_bs_key_alloc"))),
+	_keyFree(reinterpret_cast<KeyFreeFunc>(dlsym(handle, "dvbcsa_bs_key_free"))),
+	_keySet(reinterpret_cast<KeySetFunc>(dlsym(handle, "dvbcsa_bs_key_set"))),
+	_keySetECM(reinterpret_cast<KeySetECMFunc>(dlsym(handle, "dvbcsa_bs_key_set_ecm"))),
+	_decrypt(reinterpret_cast<DecryptFunc>(dlsym(handle, "dvbcsa_bs_decrypt"))) {
+	const BatchSizeFunc batchSize =
+		reinterpret_cast<BatchSizeFunc>(dlsym(handle, "dvbcsa_bs_batch_size"));
+	if (batchSize != nullptr) {
+		_batchSize = batchSize();
+	}
+}
+
+DescramblerLibDVBCSA::~DescramblerLibDVBCSA() {
+	if (_handle != nullptr) {
+		dlclose(_handle);
+	}
+}
+
+SpDescramblerLibDVBCSA DescramblerLibDVBCSA::load(const std::string &path) {
+	void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (handle == nullptr) {
+		SI_LOG_ERROR("Descrambler: Unable to load @#1: @#2", path, dlerror());
+		return nullptr;
+	}
+	SpDescramblerLibDVBCSA descrambler(new DescramblerLibDVBCSA(path, handle));
+	if (descrambler->_keyAlloc == nullptr || descrambler->_keyFree == nullptr ||
+	    descrambler->_keySet == nullptr || descrambler->_decrypt == nullptr ||
+	    descrambler->_batchSize == 0) {
+		SI_LOG_ERROR("Descrambler: @#1 is not a libdvbcsa compatible library", path);
+		return nullptr;
+	}
+	return descrambler;
+}
+
+// =============================================================================
+//  -- decrypt::dvbapi::Descrambler --------------------------------------------
+// =============================================================================
+
+DescramblerKey *DescramblerLibDVBCSA::keyAlloc() {
+	return reinterpret_cast<DescramblerKey *>(_keyAlloc());
+}
+
+void DescramblerLibDVBCSA::keyFree(DescramblerKey *key) {
+	_keyFree(reinterpret_cast<dvbcsa_bs_key_s *>(key));
+}
+
+void DescramblerLibDVBCSA::keySet(const unsigned char *cw, DescramblerKey *key) {
+	_keySet(cw, reinterpret_cast<dvbcsa_bs_key_s *>(key));
+}
+
+void DescramblerLibDVBCSA::keySetECM(const unsigned char ecm, const unsigned char *cw, DescramblerKey *key) {
+	if (_keySetECM != nullptr) {
+		_keySetECM(ecm, cw, reinterpret_cast<dvbcsa_bs_key_s *>(key));
+	} else {
+		_keySet(cw, reinterpret_cast<dvbcsa_bs_key_s *>(key));
+	}
+}
+
+void DescramblerLibDVBCSA::decrypt(const DescramblerKey *key, const Batch *batch, const unsigned int maxlen) {
+	_decrypt(reinterpret_cast<const dvbcsa_bs_key_s *>(key),
+		reinterpret_cast<const dvbcsa_bs_batch_s *>(batch), maxlen);
+}
+
+}
@@ -0,0 +1,110 @@
+/* DescramblerLibDVBCSA.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_DESCRAMBLER_LIBDVBCSA_H_INCLUDE
+#define DECRYPT_DVBAPI_DESCRAMBLER_LIBDVBCSA_H_INCLUDE DECRYPT_DVBAPI_DESCRAMBLER_LIBDVBCSA_H_INCLUDE
+
+#include <FwDecl.h>
+#include <decrypt/dvbapi/Descrambler.h>
+
+#include <string>
+
+FW_DECL_NS0(dvbcsa_bs_key_s);
+FW_DECL_NS0(dvbcsa_bs_batch_s);
+
+FW_DECL_SP_NS2(decrypt, dvbapi, DescramblerLibDVBCSA);
+
+namespace decrypt::dvbapi {
+
+/// The class @c DescramblerLibDVBCSA uses libdvbcsa as descrambler backend.
+/// This can be the linked library or a libdvbcsa build loaded at runtime,
+/// for example one that is build with '--enable-avx2' for this CPU.
+class DescramblerLibDVBCSA :
+	public Descrambler {
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	public:
+
+		/// Use the linked libdvbcsa
+		DescramblerLibDVBCSA();
+
+		virtual ~DescramblerLibDVBCSA();
+
+		/// Load a libdvbcsa compatible shared object
+		/// @return the backend or @c nullptr if it could not be loaded
+		static SpDescramblerLibDVBCSA load(const std::string &path);
+
+	private:
+
+		DescramblerLibDVBCSA(const std::string &path, void *handle);
+
+
+		// =====================================================================
+		//  -- decrypt::dvbapi::Descrambler ------------------------------------
+		// =====================================================================
+	public:
+
+		virtual std::string getName() const final {
+			return _name;
+		}
+
+		virtual unsigned int getBatchSize() const final {
+			return _batchSize;
+		}
+
+		virtual bool isICAMCapable() const final {
+			return _keySetECM != nullptr;
+		}
+
+		virtual DescramblerKey *keyAlloc() final;
+
+		virtual void keyFree(DescramblerKey *key) final;
+
+		virtual void keySet(const unsigned char *cw, DescramblerKey *key) final;
+
+		virtual void keySetECM(unsigned char ecm, const unsigned char *cw, DescramblerKey *key) final;
+
+		virtual void decrypt(const DescramblerKey *key, const Batch *batch, unsigned int maxlen) final;
+
+		// =====================================================================
+		//  -- Data members ----------------------------------------------------
+		// =====================================================================
+	private:
+
+		using KeyAllocFunc = dvbcsa_bs_key_s *(*)();
+		using KeyFreeFunc = void (*)(dvbcsa_bs_key_s *);
+		using KeySetFunc = void (*)(const unsigned char *, dvbcsa_bs_key_s *);
+		using KeySetECMFunc = void (*)(unsigned char, const unsigned char *, dvbcsa_bs_key_s *);
+		using BatchSizeFunc = unsigned int (*)();
+		using DecryptFunc = void (*)(const dvbcsa_bs_key_s *, const dvbcsa_bs_batch_s *, unsigned int);
+
+		std::string _name;
+		void *_handle;
+		unsigned int _batchSize;
+		KeyAllocFunc _keyAlloc;
+		KeyFreeFunc _keyFree;
+		KeySetFunc _keySet;
+		KeySetECMFunc _keySetECM;
+		DecryptFunc _decrypt;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_DESCRAMBLER_LIBDVBCSA_H_INCLUDE
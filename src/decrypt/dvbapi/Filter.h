@@ -22,9 +22,13 @@
 
 #include <Defs.h>
 #include <base/Mutex.h>
+#include <Unused.h>
 #include <decrypt/dvbapi/FilterData.h>
+#include <mpegts/SectionAssembler.h>
+#include <mpegts/SectionFilter.h>
 
 #include <string>
+#include <vector>
 
 namespace decrypt::dvbapi {
 
@@ -45,45 +49,37 @@ namespace decrypt::dvbapi {
 		public:
 
 			/// Start and add the requested filter
-			void start(const FeID id, int pid, unsigned int demux, unsigned int filter,
+			void start(const FeID UNUSED(id), int pid, unsigned int demux, unsigned int filter,
 					const unsigned char* filterData, const unsigned char* filterMask) {
 				base::MutexLock lock(_mutex);
 				if (demux < DEMUX_SIZE && filter < FILTER_SIZE) {
-					_filterData[demux][filter].set(id, pid, filterData, filterMask);
+					stop_L(demux, filter);
+					const mpegts::SectionFilter::SubscriptionID subscriptionID = _sectionFilter.subscribe(pid,
+						mpegts::SectionFilter::Match(filterData, filterMask),
+						[this, demux, filter](const FeID, const mpegts::Section &section) {
+							_found.push_back({demux, filter, mpegts::TSData(section.data, section.length)});
+						});
+					_filterData[demux][filter].set(pid, subscriptionID);
 				}
 			}
 
-			/// Find the correct filter for the 'collected' data or ts packet
-			bool find(const FeID id, const int pid, const unsigned char* data, const int tableID,
-					unsigned int& filter, unsigned int& demux, mpegts::TSData& filterData) {
+			/// Add the TS packet and find the sections that were finished with it
+			/// and match one or more of the filters
+			/// @param sections will contain the found sections
+			bool find(const FeID id, const int UNUSED(pid), const unsigned char* data,
+					std::vector<FilterSection> &sections) {
 				base::MutexLock lock(_mutex);
-				for (demux = 0; demux < DEMUX_SIZE; ++demux) {
-					for (filter = 0; filter < FILTER_SIZE; ++filter) {
-						// Find filter with correct id and PID
-						if (!_filterData[demux][filter].activeWith(id, pid)) {
-							continue;
-						}
-						// Does filter matches with 'data' or already collecting
-						if (_filterData[demux][filter].matchOrCollecting(data)) {
-							// Collect table data
-							_filterData[demux][filter].collectRawTableData(id, tableID, data, false);
-							if (_filterData[demux][filter].isTableCollected()) {
-								// Finished there is only 1 section
-								filterData = _filterData[demux][filter].getTableData(0);
-								_filterData[demux][filter].resetTableData();
-								return true;
-							}
-						}
-					}
-				}
-				return false;
+				_found.clear();
+				_sectionFilter.filterPacket(id, data);
+				sections.swap(_found);
+				return !sections.empty();
 			}
 
 			/// Stop the requested filter
 			void stop(unsigned int demux, unsigned int filter) {
 				base::MutexLock lock(_mutex);
 				if (demux < DEMUX_SIZE && filter < FILTER_SIZE) {
-					_filterData[demux][filter].clear();
+					stop_L(demux, filter);
 				}
 			}
 
@@ -94,6 +90,7 @@ namespace decrypt::dvbapi {
 						_filterData[demux][filter].clear();
 					}
 				}
+				_sectionFilter.clear();
 			}
 
 			std::vector<int> getActiveDemuxFilters() const {
@@ -119,6 +116,15 @@ namespace decrypt::dvbapi {
 				return pids;
 			}
 
+		private:
+
+			void stop_L(unsigned int demux, unsigned int filter) {
+				if (_filterData[demux][filter].active()) {
+					_sectionFilter.unsubscribe(_filterData[demux][filter].getSubscriptionID());
+				}
+				_filterData[demux][filter].clear();
+			}
+
 			// =======================================================================
 			//  -- Data members ------------------------------------------------------
 			// =======================================================================
@@ -129,6 +135,8 @@ namespace decrypt::dvbapi {
 
 			base::Mutex _mutex;
 			FilterData _filterData[DEMUX_SIZE][FILTER_SIZE];
+			mpegts::SectionFilter _sectionFilter;
+			std::vector<FilterSection> _found;
 	};
 
 }
@@ -21,14 +21,20 @@
 #define DECRYPT_DVBAPI_FILTERDATA_H_INCLUDE DECRYPT_DVBAPI_FILTERDATA_H_INCLUDE
 
 #include <Defs.h>
+#include <mpegts/SectionFilter.h>
 #include <mpegts/TableData.h>
 
-#include <cstring>
-#include <cstdint>
-
 namespace decrypt::dvbapi {
 
-	/// The class @c FilterData carries all filter data for OSCam
+	/// The struct @c FilterSection is a section that matched an OSCam filter
+	struct FilterSection {
+		unsigned int demux;
+		unsigned int filter;
+		/// The section starting with the table_id
+		mpegts::TSData data;
+	};
+
+	/// The class @c FilterData carries the filter data of one OSCam filter
 	class FilterData {
 		public:
 
@@ -51,37 +57,7 @@ namespace decrypt::dvbapi {
 			void clear() {
 				_filterActive = false;
 				_pid = -1;
-				_id = -1;
-				_collecting = false;
-				std::memset(_data, 0x00, 16);
-				std::memset(_mask, 0x00, 16);
-				_tableData.clear();
-			}
-
-			/// Collect Table data for tableID
-			void collectRawTableData(const FeID id, const int tableID, const unsigned char* data, bool trace) {
-				_tableData.collectRawData(id, tableID, data, trace);
-			}
-
-			/// Check if Table is collected for tableID
-			bool isTableCollected() const {
-				return _tableData.isCollected();
-			}
-
-			/// Get the collected table data
-			mpegts::TSData getTableData(size_t secNr) const {
-				return _tableData.getData(secNr);
-			}
-
-			/// Reset/Clear the collected table data
-			void resetTableData() {
-				_collecting = false;
-				_tableData.clear();
-			}
-
-			/// Is the requested pid 'active' in use for filtering
-			bool activeWith(const FeID id, const int pid) const {
-				return (_pid == pid) && (_id == id) && _filterActive;
+				_subscriptionID = -1;
 			}
 
 			/// Is this filtering in use
@@ -94,37 +70,16 @@ namespace decrypt::dvbapi {
 				return _pid;
 			}
 
-			/// Set the requested filter data and set it active
-			void set(const FeID id, int pid, const unsigned char* data, const unsigned char* mask) {
-				_pid = pid;
-				_id = id;
-				_filterActive = true;
-				_collecting = false;
-				_tableData.clear();
-				std::memcpy(_data, data, 16);
-				std::memcpy(_mask, mask, 16);
+			/// Get the subscription of this filter in the @c mpegts::SectionFilter
+			mpegts::SectionFilter::SubscriptionID getSubscriptionID() const {
+				return _subscriptionID;
 			}
 
-			/// Check if the requested data matches this filter or if we already collecting
-			bool matchOrCollecting(const unsigned char* data) const {
-				if (!_collecting) {
-					bool match = true;
-					const uint32_t sectionLength = (((data[6] & 0x0F) << 8) | data[7]) + 3; // 3 = tableID + length field
-					uint32_t i, k;
-					for (i = 0, k = 5; i < 16 && match; ++i, ++k) {
-						// skip sectionLength bytes
-						if (k == 6) {
-							k += 2;
-						}
-						const unsigned char mask = _mask[i];
-						if (mask != 0x00) {
-							const unsigned char filter = (_data[i] & mask);
-							match = (k <= sectionLength) ? (filter == (data[k] & mask)) : false;
-						}
-					}
-					_collecting = (match && i == 16);
-				}
-				return _collecting;
+			/// Set the requested PID and subscription and set it active
+			void set(int pid, mpegts::SectionFilter::SubscriptionID subscriptionID) {
+				_pid = pid;
+				_subscriptionID = subscriptionID;
+				_filterActive = true;
 			}
 
 			// =======================================================================
@@ -134,12 +89,8 @@ namespace decrypt::dvbapi {
 		protected:
 
 			bool _filterActive;
-			FeID _id;
 			int _pid;
-			unsigned char _data[16];
-			unsigned char _mask[16];
-			mpegts::TableData _tableData;
-			mutable bool _collecting = false;
+			mpegts::SectionFilter::SubscriptionID _subscriptionID;
 	};
 
 }
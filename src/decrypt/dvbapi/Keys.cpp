@@ -19,26 +19,29 @@
  */
 #include <decrypt/dvbapi/Keys.h>
 
+#include <decrypt/dvbapi/Descrambler.h>
 #include <Unused.h>
 
-extern "C" {
-	#include <dvbcsa/dvbcsa.h>
-	void dvbcsa_bs_key_set_ecm(unsigned char ecm, const dvbcsa_cw_t cw, struct dvbcsa_bs_key_s *key) __attribute__((weak));
-}
-
 namespace decrypt::dvbapi {
 
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+Keys::Keys(SpDescrambler descrambler) :
+	_descrambler(descrambler) {}
+
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
 
 void Keys::set(const unsigned char* cw, unsigned int parity, int UNUSED(index), const bool icamEnabled) {
-	dvbcsa_bs_key_s* k = dvbcsa_bs_key_alloc();
+	DescramblerKey* k = _descrambler->keyAlloc();
 	const unsigned char icamECM = (_icam[parity].size() > 0) ? _icam[parity].back() : 0;
 	if (icamEnabled) {
-		dvbcsa_bs_key_set_ecm(icamECM, cw, k);
+		_descrambler->keySetECM(icamECM, cw, k);
 	} else {
-		dvbcsa_bs_key_set(cw, k);
+		_descrambler->keySet(cw, k);
 	}
 	_key[parity].push(std::make_tuple(base::TimeCounter::getTicks(), k));
 	while (_key[parity].size() > 1) {
@@ -53,7 +56,7 @@ void Keys::setICAM(const unsigned char ecm, unsigned int parity) {
 	}
 }
 
-const dvbcsa_bs_key_s* Keys::get(unsigned int parity) const {
+const DescramblerKey* Keys::get(unsigned int parity) const {
 	if (!_key[parity].empty()) {
 		const KeyTuple tup = _key[parity].back();
 //		const long duration = base::TimeCounter::getTicks() - pair.first;
@@ -80,7 +83,7 @@ void Keys::freeKeys() {
 
 void Keys::remove(unsigned int parity) {
 	const KeyTuple tup = _key[parity].front();
-	dvbcsa_bs_key_free(std::get<1>(tup));
+	_descrambler->keyFree(std::get<1>(tup));
 	_key[parity].pop();
 }
 
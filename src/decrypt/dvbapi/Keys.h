@@ -28,14 +28,15 @@
 #include <queue>
 #include <tuple>
 
-FW_DECL_NS0(dvbcsa_bs_key_s);
+FW_DECL_NS2(decrypt, dvbapi, DescramblerKey);
+FW_DECL_SP_NS2(decrypt, dvbapi, Descrambler);
 
 namespace decrypt::dvbapi {
 
 ///
 class Keys {
 	public:
-		using KeyTuple = std::tuple<long, dvbcsa_bs_key_s *>;
+		using KeyTuple = std::tuple<long, DescramblerKey *>;
 		using KeyQueue = std::queue<KeyTuple>;
 		using ICAMQueue = std::queue<unsigned char>;
 
@@ -44,7 +45,7 @@ class Keys {
 		// =========================================================================
 	public:
 
-		Keys() = default;
+		explicit Keys(SpDescrambler descrambler);
 
 		virtual ~Keys() = default;
 
@@ -57,7 +58,7 @@ class Keys {
 
 		void setICAM(const unsigned char ecm, unsigned int parity);
 
-		const dvbcsa_bs_key_s *get(unsigned int parity) const;
+		const DescramblerKey *get(unsigned int parity) const;
 
 		void freeKeys();
 
@@ -70,6 +71,7 @@ class Keys {
 		// =====================================================================
 	private:
 
+		SpDescrambler _descrambler;
 		KeyQueue _key[2];
 		ICAMQueue _icam[2];
 };
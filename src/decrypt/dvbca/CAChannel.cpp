@@ -0,0 +1,78 @@
+/* CAChannel.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbca/CAChannel.h>
+
+#include <Log.h>
+#include <mpegts/PMT.h>
+#include <mpegts/SectionAssembler.h>
+
+#include <cstring>
+
+namespace decrypt::dvbca {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+CAChannel &CAChannel::getInstance() {
+	static CAChannel channel;
+	return channel;
+}
+
+void CAChannel::publishPMT(const FeID id, mpegts::SpPMT pmt) {
+	base::MutexLock lock(_mutex);
+	if (_pmts.size() >= MAX_PMTS) {
+		SI_LOG_DEBUG("Frontend: @#1, CA channel full, dropping oldest PMT", id);
+		_pmts.pop_front();
+	}
+	_pmts.push_back(pmt);
+}
+
+void CAChannel::publishTimeDate(const mpegts::Section &section) {
+	if (section.length < 3 + sizeof(_timeDate.utc)) {
+		return;
+	}
+	base::MutexLock lock(_mutex);
+	_timeDate.tableID = section.tableID;
+	std::memcpy(_timeDate.utc, &section.data[3u], sizeof(_timeDate.utc));
+	_timeDateValid = true;
+}
+
+mpegts::SpPMT CAChannel::takePMT() {
+	base::MutexLock lock(_mutex);
+	if (_pmts.empty()) {
+		return nullptr;
+	}
+	mpegts::SpPMT pmt = _pmts.front();
+	_pmts.pop_front();
+	return pmt;
+}
+
+bool CAChannel::takeTimeDate(TimeDate &timeDate) {
+	base::MutexLock lock(_mutex);
+	if (!_timeDateValid) {
+		return false;
+	}
+	timeDate = _timeDate;
+	_timeDateValid = false;
+	return true;
+}
+
+}
@@ -0,0 +1,99 @@
+/* CAChannel.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBCA_CACHANNEL_H_INCLUDE
+#define DECRYPT_DVBCA_CACHANNEL_H_INCLUDE DECRYPT_DVBCA_CACHANNEL_H_INCLUDE
+
+#include <Defs.h>
+#include <FwDecl.h>
+#include <base/Mutex.h>
+
+#include <cstddef>
+#include <deque>
+
+FW_DECL_NS1(mpegts, Section);
+FW_DECL_SP_NS1(mpegts, PMT);
+
+namespace decrypt::dvbca {
+
+/// The class @c CAChannel passes parsed PMT and TDT/TOT sections from the
+/// @c mpegts::Filter of the frontends to the DVB-CA handler thread
+class CAChannel {
+	public:
+
+		/// UTC time of a TDT or TOT section (MJD + BCD encoded time)
+		struct TimeDate {
+			unsigned char tableID;
+			unsigned char utc[5];
+		};
+
+		// =====================================================================
+		//  -- Constructors and destructor -------------------------------------
+		// =====================================================================
+	private:
+
+		CAChannel() = default;
+
+	public:
+
+		virtual ~CAChannel() = default;
+
+		CAChannel(const CAChannel&) = delete;
+
+		CAChannel& operator=(const CAChannel&) = delete;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the channel that is shared between the frontends and DVB-CA handler
+		static CAChannel &getInstance();
+
+		/// Publish a collected and parsed PMT
+		void publishPMT(FeID id, mpegts::SpPMT pmt);
+
+		/// Publish a TDT or TOT section
+		void publishTimeDate(const mpegts::Section &section);
+
+		/// Take the oldest published PMT
+		/// @return @c nullptr if there is none
+		mpegts::SpPMT takePMT();
+
+		/// Take the latest published TDT/TOT
+		/// @return @c false if there was none published since the last call
+		bool takeTimeDate(TimeDate &timeDate);
+
+		// =====================================================================
+		//  -- Data members ----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// Maximum of PMTs kept when nobody is taking them
+		static constexpr std::size_t MAX_PMTS = 32;
+
+		base::Mutex _mutex;
+		std::deque<mpegts::SpPMT> _pmts;
+		TimeDate _timeDate;
+		bool _timeDateValid = false;
+};
+
+}
+
+#endif // DECRYPT_DVBCA_CACHANNEL_H_INCLUDE
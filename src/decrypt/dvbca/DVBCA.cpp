@@ -18,6 +18,7 @@
    Or, point your browser to http://www.gnu.org/copyleft/gpl.html
 */
 #include <decrypt/dvbca/DVBCA.h>
+#include <decrypt/dvbca/CAChannel.h>
 #include <mpegts/PMT.h>
 #include <Utils.h>
 
@@ -37,8 +38,6 @@
 #define RECV_TIMEOUT 100
 #define RECV_SIZE    4096
 
-static char fileFIFO[] = "/tmp/fifo";
-
 	// ========================================================================
 	// -- Constructors and destructor -----------------------------------------
 	// ========================================================================
@@ -47,7 +46,6 @@ static char fileFIFO[] = "/tmp/fifo";
 		XMLSupport(),
 		ThreadBase("DVB-CA handler"),
 		_fd(-1),
-		_fdFifo(-1),
 		_id(0),
         _timeoutCnt(RECV_TIMEOUT),
 		_repeatTime(0),
@@ -64,11 +62,9 @@ static char fileFIFO[] = "/tmp/fifo";
 
 	DVBCA::~DVBCA() {
 		SI_LOG_INFO("Stopping DVB-CA Handler");
-		CLOSE_FD(_fdFifo);
 		close();
 		cancelThread();
 		joinThread();
-		::unlink(fileFIFO);
 	}
 
 	// =======================================================================
@@ -77,7 +73,7 @@ static char fileFIFO[] = "/tmp/fifo";
 
 	void DVBCA::doAddToXML(std::string &/*xml*/) const {}
 
-	void DVBCA::doFromXML(const std::string &/*xml*/) {}
+	void DVBCA::doFromXML(const base::XMLElement &/*xml*/) {}
 
 	// =======================================================================
 	//  -- Other member functions --------------------------------------------
@@ -86,9 +82,9 @@ static char fileFIFO[] = "/tmp/fifo";
     bool DVBCA::open(const std::size_t id) {
         char path[100];
 #ifdef ENIGMA
-        sprintf(path, "/dev/ci%d", id);
+        sprintf(path, "/dev/ci%zu", id);
 #else
-        sprintf(path, "/dev/dvb/adapter%d/ca0", id);
+        sprintf(path, "/dev/dvb/adapter%zu/ca0", id);
 #endif
 		SI_LOG_INFO("Try to detected CA device: @#1", path);
         _fd = ::open(path, O_RDWR | O_NONBLOCK);
@@ -347,7 +343,8 @@ static char fileFIFO[] = "/tmp/fifo";
 				SI_LOG_INFO("  Application Type: @#1", HEX(apduData[4], 2));
 				SI_LOG_INFO("  Application Manufacturer: @#1", HEX((apduData[5] << 8 | apduData[6]), 4));
 				SI_LOG_INFO("  Manufacturer Code: @#1", HEX(((apduData[7] << 8) | apduData[8]), 4));
-				SI_LOG_INFO("  Menu String: @#1", apduData.substr(10, apduData[9]));
+				const CAData menu = apduData.substr(10, apduData[9]);
+				SI_LOG_INFO("  Menu String: @#1", std::string(menu.begin(), menu.end()));
 			}
 		}
 	}
@@ -554,16 +551,7 @@ END
 	// =======================================================================
 	void DVBCA::threadEntry() {
 		SI_LOG_INFO("Setting up DVB-CA Handler");
-		{
-			if (mkfifo(fileFIFO, S_IWUSR | S_IRUSR | S_IRGRP | S_IROTH) < 0) {
-				SI_LOG_PERROR("Error creating FIFO-PIPE");
-			}
-
-			_fdFifo = ::open(fileFIFO, O_RDONLY | O_NONBLOCK);
-			if (_fdFifo < 0) {
-				SI_LOG_ERROR("Error openinge FIFO");
-			}
-		}
+		decrypt::dvbca::CAChannel &channel = decrypt::dvbca::CAChannel::getInstance();
 
 //		path << "/proc/stb/tsmux/input" << tuner_no << "_choices";
 //		if(::access(path.str().data(), R_OK) < 0)
@@ -588,20 +576,15 @@ END
 //	snprintf(buf, sizeof(buf), "/proc/stb/tsmux/ci%d_tsclk", slotid);
 //	if(CFile::write(buf, rate ? "high" : "normal") == -1)
 
-		mpegts::PMT pmt;
 		int id = 0;
 		open(id);
 
-		std::size_t pollSize = 2;
+		const std::size_t pollSize = 1;
 		struct pollfd pfd[pollSize];
 		pfd[0].fd = _fd;
 		pfd[0].events = POLLIN | POLLPRI | POLLERR;
 		pfd[0].revents = 0;
 
-		pfd[1].fd = _fdFifo;
-		pfd[1].events = POLLIN | POLLPRI | POLLERR;
-		pfd[1].revents = 0;
-
 		for (;; ) {
 			const int pollRet = ::poll(pfd, pollSize, POLL_TIMEOUT);
 			if (pollRet > 0) {
@@ -628,41 +611,6 @@ END
 //						_connected = true;
 					}
 				}
-				if (pfd[1].revents != 0) {
-					unsigned char buf[1024];
-					ssize_t recvLen  = ::read(_fdFifo, buf, sizeof(buf));
-					if (recvLen > 0) {
-//						SI_LOG_BIN_DEBUG(buf, recvLen, "FIFO Data (@#1):", _id);
-
-						const unsigned int tableID = buf[5u];
-						if (_connected) {
-							if (!pmt.isCollected()) {
-								pmt.collectData(0, PMT_TABLE_ID, buf, false);
-								// Did we finish collecting PMT
-								if (pmt.isCollected()) {
-									pmt.parse(0);
-									const std::size_t sessionNB = findSessionNumberForRecource(CA_MANAGER);
-									sendCAPMT(sessionNB, pmt);
-									// Clear for next PMT we receive
-									pmt.clear();
-								}
-							}
-							if (tableID == 0x70 || tableID == 0x73) {
-								apduTimeData[0] = 0x05; // Length of UTC-Time
-								apduTimeData[1] = buf[8u]; // UTC-Time
-								apduTimeData[2] = buf[9u]; // UTC-Time
-								apduTimeData[3] = buf[10u]; // UTC-Time
-								apduTimeData[4] = buf[11u]; // UTC-Time
-								apduTimeData[5] = buf[12u]; // UTC-Time
-								const std::size_t sessionNB = findSessionNumberForRecource(DATE_TIME);
-								if (sessionNB > 0) {
-									createAndSendAPDUTag(sessionNB, APDU_DATE_TIME, apduTimeData);
-								}
-							}
-						}
-
-					}
-				}
 			} else if (_connected) {
 /*
 				if (_waiting) {
@@ -681,6 +629,26 @@ END
 				}
 */
 			}
+			// Handle the PMT and TDT/TOT sections published by the frontends
+			for (mpegts::SpPMT pmt = channel.takePMT(); pmt != nullptr; pmt = channel.takePMT()) {
+				if (_connected) {
+					const std::size_t sessionNB = findSessionNumberForRecource(CA_MANAGER);
+					sendCAPMT(sessionNB, *pmt);
+				}
+			}
+			decrypt::dvbca::CAChannel::TimeDate timeDate;
+			if (channel.takeTimeDate(timeDate) && _connected) {
+				apduTimeData[0] = 0x05; // Length of UTC-Time
+				apduTimeData[1] = timeDate.utc[0u]; // UTC-Time
+				apduTimeData[2] = timeDate.utc[1u]; // UTC-Time
+				apduTimeData[3] = timeDate.utc[2u]; // UTC-Time
+				apduTimeData[4] = timeDate.utc[3u]; // UTC-Time
+				apduTimeData[5] = timeDate.utc[4u]; // UTC-Time
+				const std::size_t sessionNB = findSessionNumberForRecource(DATE_TIME);
+				if (sessionNB > 0) {
+					createAndSendAPDUTag(sessionNB, APDU_DATE_TIME, apduTimeData);
+				}
+			}
 			if (_timeDateInterval != 0) {
 				const std::time_t currentTime = std::time(nullptr);
 				if (currentTime > _repeatTime) {
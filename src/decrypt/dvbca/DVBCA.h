@@ -157,11 +157,13 @@ class DVBCA :
 		// =======================================================================
 		// -- base::XMLSupport ---------------------------------------------------
 		// =======================================================================
-	public:
+	private:
 
-		virtual void addToXML(std::string &xml) const final;
+		/// @see XMLSupport
+		virtual void doAddToXML(std::string &xml) const final;
 
-		virtual void fromXML(const std::string &xml) final;
+		/// @see XMLSupport
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =======================================================================
 		//  -- base::ThreadBase --------------------------------------------------
@@ -233,7 +235,6 @@ class DVBCA :
 
 		using  Handle = int;
 		Handle _fd;
-		Handle _fdFifo;
 		std::size_t _id;
 		std::size_t _timeoutCnt;
 		std::time_t _repeatTime;
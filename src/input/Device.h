@@ -22,8 +22,10 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <base/Metrics.h>
 #include <base/XMLSupport.h>
 #include <input/InputSystem.h>
+#include <input/capture/CaptureWriter.h>
 #include <mpegts/Filter.h>
 
 #include <string>
@@ -114,6 +116,13 @@ class Device :
 		///
 		virtual mpegts::Filter &getFilter() = 0;
 
+		/// Add the metrics of this device
+		/// @param labels specifies the labels of the stream of this device
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+			metrics.addCounter("satpi_cc_errors_total",
+				"Continuity Counter errors since tuning", labels, getFilter().getTotalCCErrors());
+		}
+
 		/// Generic pid filtering Update function
 		virtual void updatePIDFilters() {
 			getFilter().updatePIDFilters(_feID,
@@ -136,6 +145,20 @@ class Device :
 				});
 		}
 
+		/// Set the capture of the stream of this device, so the device can
+		/// record its frontend events (@see input::capture::CaptureWriter)
+		void setCaptureWriter(input::capture::SpCaptureWriter capture) {
+			_capture = capture;
+		}
+
+		/// Record the data of one read from the device, if the stream of this
+		/// device is capturing
+		void captureRead(const unsigned char *data, const std::size_t size) {
+			if (_capture && _capture->isOpen()) {
+				_capture->addData(data, size);
+			}
+		}
+
 		///
 		FeID getFeID() const {
 			return _feID;
@@ -159,6 +182,7 @@ class Device :
 		FeIndex _index;
 		FeID _feID;
 		StreamID _streamID;
+		input::capture::SpCaptureWriter _capture;
 };
 
 }
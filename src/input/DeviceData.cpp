@@ -60,14 +60,15 @@ void DeviceData::doAddToXML(std::string &xml) const {
 	doNextAddToXML(xml);
 }
 
-void DeviceData::doFromXML(const std::string &xml) {
+void DeviceData::doFromXML(const base::XMLElement &xml) {
 	base::MutexLock lock(_mutex);
 	std::string element;
 	if (capableOfInternalFiltering() && findXMLElement(xml, "internalPidFiltering.value", element)) {
 		_internalPidFiltering = (element == "true") ? true : false;
 	}
-	if (findXMLElement(xml, "filter", element)) {
-		_filter.fromXML(element);
+	base::XMLElement filter;
+	if (findXMLElement(xml, "filter", filter)) {
+		_filter.fromXML(filter);
 	}
 	doNextFromXML(xml);
 }
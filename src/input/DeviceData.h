@@ -54,7 +54,7 @@ class DeviceData :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
@@ -76,7 +76,7 @@ class DeviceData :
 		virtual void doNextAddToXML(std::string &UNUSED(xml)) const {}
 
 		/// Specialization for @see doFromXML
-		virtual void doNextFromXML(const std::string &UNUSED(xml)) {}
+		virtual void doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 		/// Specialization for @see initialize
 		virtual void doInitialize() {}
@@ -33,7 +33,10 @@ namespace input {
 		FILE_SRC,
 		STREAMER,
 		CHILDPIPE,
-		IPTV
+		IPTV,
+		SYNTHETIC,
+		REPLAY,
+		HTTP
 	};
 
 } // namespace input
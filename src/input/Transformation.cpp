@@ -71,7 +71,7 @@ void Transformation::doAddToXML(std::string &xml) const {
 	ADD_XML_END_ELEMENT(xml, "advertiseAsType");
 }
 
-void Transformation::doFromXML(const std::string &xml) {
+void Transformation::doFromXML(const base::XMLElement &xml) {
 	base::MutexLock lock(_mutex);
 	std::string element;
 	if (findXMLElement(xml, "transformEnable.value", element)) {
@@ -60,7 +60,7 @@ class Transformation :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
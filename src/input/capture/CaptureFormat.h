@@ -0,0 +1,75 @@
+/* CaptureFormat.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_CAPTURE_CAPTUREFORMAT_H_INCLUDE
+#define INPUT_CAPTURE_CAPTUREFORMAT_H_INCLUDE INPUT_CAPTURE_CAPTUREFORMAT_H_INCLUDE
+
+#include <cstddef>
+#include <cstdint>
+
+/// The layout of a capture file (all fields in host byte order):
+///
+///   FileHeader
+///   RecordHeader + payload
+///   RecordHeader + payload
+///   ...
+///
+/// The payload of each record type:
+///   Data - the data of one read from the device (e.g. the DVR), as it was
+///          read, so not necessarily on a TS packet boundary
+///   Tune - the transport parameters of the request, separated by '&'
+///   PIDs - the open PIDs as CSV (@see mpegts::PidTable::getPidCSV)
+///   Key  - int32_t index followed by the Control Word, parity in the header
+namespace input::capture {
+
+	enum class RecordType : std::uint8_t {
+		Data = 1,
+		Tune = 2,
+		PIDs = 3,
+		Key  = 4
+	};
+
+	constexpr char CAPTURE_MAGIC[8] = { 'S', 'a', 't', 'P', 'I', 'C', 'a', 'p' };
+	constexpr std::uint32_t CAPTURE_VERSION = 1;
+
+	/// The size of an Control Word in a Key record
+	constexpr std::size_t CAPTURE_CW_SIZE = 8;
+
+	struct FileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t reserved;
+	};
+
+	struct RecordHeader {
+		/// Monotonic time since the capture was started
+		std::uint64_t timeNS;
+		/// The size of the payload following this header
+		std::uint32_t size;
+		RecordType type;
+		std::uint8_t parity;
+		std::uint16_t reserved;
+	};
+
+	static_assert(sizeof(FileHeader) == 16, "Unexpected capture file header size");
+	static_assert(sizeof(RecordHeader) == 16, "Unexpected capture record header size");
+
+} // namespace input::capture
+
+#endif // INPUT_CAPTURE_CAPTUREFORMAT_H_INCLUDE
@@ -0,0 +1,68 @@
+/* CaptureReader.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/capture/CaptureReader.h>
+
+#include <cstring>
+
+namespace input::capture {
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool CaptureReader::open(const std::string &path) {
+	close();
+	_file.open(path, std::ios::in | std::ios::binary);
+	if (!_file.is_open()) {
+		return false;
+	}
+	FileHeader header{};
+	_file.read(reinterpret_cast<char *>(&header), sizeof(header));
+	if (!_file || std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != CAPTURE_VERSION) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void CaptureReader::close() {
+	_file.close();
+	_file.clear();
+}
+
+bool CaptureReader::next(Record &record) {
+	if (!_file.is_open()) {
+		return false;
+	}
+	RecordHeader header{};
+	_file.read(reinterpret_cast<char *>(&header), sizeof(header));
+	if (!_file || header.size > MAX_RECORD_SIZE) {
+		return false;
+	}
+	record.type = header.type;
+	record.parity = header.parity;
+	record.time = std::chrono::nanoseconds(header.timeNS);
+	record.data.resize(header.size);
+	_file.read(reinterpret_cast<char *>(record.data.data()), header.size);
+	return static_cast<bool>(_file);
+}
+
+}
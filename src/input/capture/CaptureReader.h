@@ -0,0 +1,87 @@
+/* CaptureReader.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_CAPTURE_CAPTUREREADER_H_INCLUDE
+#define INPUT_CAPTURE_CAPTUREREADER_H_INCLUDE INPUT_CAPTURE_CAPTUREREADER_H_INCLUDE
+
+#include <input/capture/CaptureFormat.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace input::capture {
+
+/// The class @c CaptureReader reads the records of a capture file made by
+/// @c CaptureWriter (@see CaptureFormat.h)
+class CaptureReader {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		struct Record {
+			RecordType type = RecordType::Data;
+			unsigned int parity = 0;
+			/// The time since the capture was started
+			std::chrono::nanoseconds time{0};
+			std::vector<unsigned char> data;
+		};
+
+		CaptureReader() = default;
+
+		virtual ~CaptureReader() = default;
+
+		// =========================================================================
+		// -- Other member functions -----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Open a capture file and check its header
+		/// @return true if @c path is a capture file we can read
+		bool open(const std::string &path);
+
+		///
+		void close();
+
+		///
+		bool isOpen() const {
+			return _file.is_open();
+		}
+
+		/// Read the next record
+		/// @return false at the end of the capture (or on a broken record)
+		bool next(Record &record);
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// The maximum payload we accept, to guard against broken files
+		static constexpr std::uint32_t MAX_RECORD_SIZE = 1024 * 1024;
+
+		std::ifstream _file;
+};
+
+}
+
+#endif // INPUT_CAPTURE_CAPTUREREADER_H_INCLUDE
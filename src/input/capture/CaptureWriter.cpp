@@ -0,0 +1,178 @@
+/* CaptureWriter.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/capture/CaptureWriter.h>
+
+#include <Log.h>
+
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <sys/stat.h>
+
+namespace input::capture {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+CaptureWriter::CaptureWriter() :
+	_thread("Capture", std::bind(&CaptureWriter::threadExecuteWriter, this)) {}
+
+CaptureWriter::~CaptureWriter() {
+	close();
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool CaptureWriter::open(const std::string &path) {
+	close();
+	// Never overwrite a previous capture
+	struct stat st;
+	if (::stat(path.c_str(), &st) == 0) {
+		SI_LOG_ERROR("Capture @#1 already exists", path);
+		return false;
+	}
+	_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_file.is_open()) {
+		return false;
+	}
+	FileHeader header{};
+	std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+	header.version = CAPTURE_VERSION;
+	_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	{
+		base::MutexLock lock(_mutex);
+		_queue.clear();
+		_path = path;
+		_start = std::chrono::steady_clock::now();
+	}
+	_writeError = false;
+	_bytesWritten = sizeof(header);
+	_bytesDropped = 0;
+	_open = true;
+	if (!_thread.startThread()) {
+		SI_LOG_ERROR("Capture @#1 unable to start writer", path);
+		close();
+		return false;
+	}
+	return true;
+}
+
+void CaptureWriter::close() {
+	if (!_file.is_open()) {
+		return;
+	}
+	_open = false;
+	_thread.terminateThread();
+	// Write what was queued before we stopped
+	writeQueue();
+	_file.close();
+	std::string path;
+	{
+		base::MutexLock lock(_mutex);
+		path.swap(_path);
+	}
+	SI_LOG_INFO("Capture @#1 closed, @#2 bytes written, @#3 bytes dropped",
+		path, _bytesWritten.load(), _bytesDropped.load());
+}
+
+std::string CaptureWriter::getPath() const {
+	base::MutexLock lock(_mutex);
+	return _path;
+}
+
+void CaptureWriter::addData(const unsigned char *data, const std::size_t size) {
+	queueRecord(RecordType::Data, 0, data, size);
+}
+
+void CaptureWriter::addTune(const std::string &request) {
+	queueRecord(RecordType::Tune, 0, request.data(), request.size());
+}
+
+void CaptureWriter::addPIDs(const std::string &pidCSV) {
+	queueRecord(RecordType::PIDs, 0, pidCSV.data(), pidCSV.size());
+}
+
+void CaptureWriter::addKey(const unsigned char *cw, const unsigned int parity, const int index) {
+	const std::int32_t keyIndex = index;
+	queueRecord(RecordType::Key, parity, &keyIndex, sizeof(keyIndex), cw, CAPTURE_CW_SIZE);
+}
+
+void CaptureWriter::queueRecord(const RecordType type, const unsigned int parity,
+		const void *data, const std::size_t size,
+		const void *data2, const std::size_t size2) {
+	if (!isOpen()) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	base::MutexLock lock(_mutex);
+	const std::size_t recordSize = sizeof(RecordHeader) + size + size2;
+	if (_queue.size() + recordSize > MAX_QUEUE_SIZE) {
+		_bytesDropped.fetch_add(recordSize, std::memory_order_relaxed);
+		return;
+	}
+	RecordHeader header{};
+	header.timeNS = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _start).count();
+	header.size = size + size2;
+	header.type = type;
+	header.parity = parity;
+	const unsigned char *headerPtr = reinterpret_cast<const unsigned char *>(&header);
+	_queue.insert(_queue.end(), headerPtr, headerPtr + sizeof(header));
+	_queue.insert(_queue.end(), static_cast<const unsigned char *>(data),
+		static_cast<const unsigned char *>(data) + size);
+	if (size2 > 0) {
+		_queue.insert(_queue.end(), static_cast<const unsigned char *>(data2),
+			static_cast<const unsigned char *>(data2) + size2);
+	}
+}
+
+bool CaptureWriter::threadExecuteWriter() {
+	if (!writeQueue()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+	return true;
+}
+
+bool CaptureWriter::writeQueue() {
+	_writeBuffer.clear();
+	{
+		base::MutexLock lock(_mutex);
+		_queue.swap(_writeBuffer);
+	}
+	if (_writeBuffer.empty() || _writeError) {
+		return false;
+	}
+	// Flush every time, so the capture is usable up to here if we are killed
+	_file.write(reinterpret_cast<const char *>(_writeBuffer.data()), _writeBuffer.size());
+	_file.flush();
+	if (!_file) {
+		SI_LOG_ERROR("Capture @#1 write error, stopping capture", getPath());
+		_writeError = true;
+		_open = false;
+		return false;
+	}
+	_bytesWritten.fetch_add(_writeBuffer.size(), std::memory_order_relaxed);
+	return true;
+}
+
+}
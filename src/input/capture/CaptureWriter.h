@@ -0,0 +1,144 @@
+/* CaptureWriter.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_CAPTURE_CAPTUREWRITER_H_INCLUDE
+#define INPUT_CAPTURE_CAPTUREWRITER_H_INCLUDE INPUT_CAPTURE_CAPTUREWRITER_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <base/Thread.h>
+#include <input/capture/CaptureFormat.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+FW_DECL_SP_NS2(input, capture, CaptureWriter);
+
+namespace input::capture {
+
+/// The class @c CaptureWriter records the data read from a device, together
+/// with the frontend events, into a capture file (@see CaptureFormat.h).
+/// The records are queued and written to the file by its own thread, so the
+/// reader of the device never waits for the disk.
+/// The capture can be replayed with @c input::capture::Replayer
+class CaptureWriter {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		CaptureWriter();
+
+		virtual ~CaptureWriter();
+
+		CaptureWriter(const CaptureWriter&) = delete;
+
+		CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+		// =========================================================================
+		// -- Other member functions -----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Start a new capture, an already open capture is closed first
+		/// @param path specifies the capture file to create, it may not exist
+		/// @return true if the capture file could be created
+		bool open(const std::string &path);
+
+		/// Stop capturing, the queued records are written first
+		void close();
+
+		/// Check if we are capturing
+		bool isOpen() const {
+			return _open.load(std::memory_order_acquire);
+		}
+
+		/// Get the path of the current capture, empty if there is none
+		std::string getPath() const;
+
+		/// Get the amount of bytes written to the current capture
+		std::uint64_t getBytesWritten() const {
+			return _bytesWritten.load(std::memory_order_relaxed);
+		}
+
+		/// Get the amount of bytes of records dropped, because the disk could
+		/// not keep up
+		std::uint64_t getBytesDropped() const {
+			return _bytesDropped.load(std::memory_order_relaxed);
+		}
+
+		/// Record the data of one read from the device, as it was read
+		void addData(const unsigned char *data, std::size_t size);
+
+		/// Record a tune request
+		/// @param request specifies the transport parameters of the request
+		void addTune(const std::string &request);
+
+		/// Record the open PIDs
+		/// @param pidCSV specifies the open PIDs (@see mpegts::Filter::getPidCSV)
+		void addPIDs(const std::string &pidCSV);
+
+		/// Record a Control Word received from OSCam
+		void addKey(const unsigned char *cw, unsigned int parity, int index);
+
+	private:
+
+		/// Queue a record with the current time for the writer thread
+		void queueRecord(RecordType type, unsigned int parity,
+			const void *data, std::size_t size,
+			const void *data2 = nullptr, std::size_t size2 = 0);
+
+		/// Thread function that writes the queued records
+		bool threadExecuteWriter();
+
+		/// Write the records queued until now to the file
+		/// @return false if there was nothing to write
+		bool writeQueue();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// The maximum amount of queued bytes, more is dropped
+		static constexpr std::size_t MAX_QUEUE_SIZE = 32 * 1024 * 1024;
+
+		base::Mutex _mutex;
+		base::Thread _thread;
+		/// The records waiting to be written (protected by _mutex)
+		std::vector<unsigned char> _queue;
+		/// The records being written (only used by the writer)
+		std::vector<unsigned char> _writeBuffer;
+		std::ofstream _file;
+		std::string _path;
+		std::chrono::steady_clock::time_point _start;
+		std::atomic_bool _open{false};
+		bool _writeError = false;
+		std::atomic<std::uint64_t> _bytesWritten{0};
+		std::atomic<std::uint64_t> _bytesDropped{0};
+};
+
+}
+
+#endif // INPUT_CAPTURE_CAPTUREWRITER_H_INCLUDE
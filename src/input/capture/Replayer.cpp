@@ -0,0 +1,296 @@
+/* Replayer.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/capture/Replayer.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <Stream.h>
+#include <StringConverter.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace input::capture {
+
+namespace {
+
+	/// The maximum time to sleep in @c isDataAvailable, so the writer of the
+	/// stream still gets called regularly
+	constexpr std::chrono::milliseconds MAX_WAIT(2);
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+Replayer::Replayer(const FeIndex index, const bool enableUnsecureFrontends) :
+		Device(index),
+		_enableUnsecureFrontends(enableUnsecureFrontends) {}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void Replayer::enumerate(
+		StreamSpVector &streamVector,
+		decrypt::dvbapi::SpClient decrypt,
+		const bool enableUnsecureFrontends) {
+	SI_LOG_INFO("Setting up Capture Replayer");
+	const StreamSpVector::size_type size = streamVector.size();
+	const input::capture::SpReplayer replayer =
+		std::make_shared<input::capture::Replayer>(size, enableUnsecureFrontends);
+	streamVector.push_back(Stream::makeSP(replayer, decrypt));
+}
+
+// =============================================================================
+//  -- base::XMLSupport --------------------------------------------------------
+// =============================================================================
+
+void Replayer::doAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "frontendname", "Capture Replayer");
+
+#ifdef LIBDVBCSA
+	_dvbapiData.addToXML(xml);
+#endif
+	_deviceData.addToXML(xml);
+}
+
+void Replayer::doFromXML(const base::XMLElement &xml) {
+#ifdef LIBDVBCSA
+	_dvbapiData.fromXML(xml);
+#endif
+	_deviceData.fromXML(xml);
+}
+
+// =============================================================================
+//  -- input::Device -----------------------------------------------------------
+// =============================================================================
+
+void Replayer::addDeliverySystemCount(
+		std::size_t &UNUSED(dvbs2),
+		std::size_t &UNUSED(dvbt),
+		std::size_t &UNUSED(dvbt2),
+		std::size_t &UNUSED(dvbc),
+		std::size_t &UNUSED(dvbc2)) {}
+
+bool Replayer::isDataAvailable() {
+	std::chrono::steady_clock::time_point due;
+	bool replaying;
+	{
+		base::MutexLock lock(_mutex);
+		replaying = readNextRecord_L();
+		if (replaying) {
+			due = getDueTime_L();
+		}
+	}
+	if (!replaying) {
+		std::this_thread::sleep_for(MAX_WAIT);
+		return false;
+	}
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now >= due) {
+		return true;
+	}
+	std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - now, MAX_WAIT));
+	return std::chrono::steady_clock::now() >= due;
+}
+
+bool Replayer::readTSPackets(mpegts::PacketBuffer& buffer) {
+	bool dataAdded = false;
+	{
+		base::MutexLock lock(_mutex);
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		// Apply the events and reads that are due, until the buffer is full.
+		// A read can be split over two buffers, like with the original device
+		while (!buffer.full() && readNextRecord_L() && getDueTime_L() <= now) {
+			if (_record.type != RecordType::Data) {
+				_pending = false;
+				applyEvent_L();
+				continue;
+			}
+			const std::size_t size = std::min(_record.data.size() - _dataOffset,
+				buffer.getAmountOfBytesToWrite());
+			std::memcpy(buffer.getWriteBufferPtr(), _record.data.data() + _dataOffset, size);
+			buffer.addAmountOfBytesWritten(size);
+			_dataOffset += size;
+			dataAdded = true;
+			if (_dataOffset == _record.data.size()) {
+				_pending = false;
+				_dataOffset = 0;
+				++_dataRecords;
+			}
+		}
+	}
+	if (dataAdded) {
+		buffer.trySyncing();
+		// Add data to Filter
+		_deviceData.getFilter().filterData(_feID, buffer, false);
+	}
+	return buffer.full();
+}
+
+bool Replayer::capableOf(const input::InputSystem system) const {
+	if (_enableUnsecureFrontends) {
+		return system == input::InputSystem::REPLAY;
+	}
+	return false;
+}
+
+bool Replayer::capableToShare(const TransportParamVector& UNUSED(params)) const {
+	return false;
+}
+
+bool Replayer::capableToTransform(const TransportParamVector& UNUSED(params)) const {
+	return false;
+}
+
+bool Replayer::isLockedByOtherProcess() const {
+	return false;
+}
+
+bool Replayer::monitorSignal(bool UNUSED(showStatus)) {
+	_deviceData.setMonitorData(FE_HAS_LOCK, 240, 15, 0, 0);
+	return true;
+}
+
+bool Replayer::hasDeviceFrequencyChanged() const {
+	return _deviceData.hasDeviceFrequencyChanged();
+}
+
+void Replayer::parseStreamString(const TransportParamVector& params) {
+	SI_LOG_INFO("Frontend: @#1, Parsing transport parameters...", _feID);
+	_deviceData.parseStreamString(_feID, params);
+	SI_LOG_DEBUG("Frontend: @#1, Parsing transport parameters (Finished)", _feID);
+}
+
+bool Replayer::update() {
+	SI_LOG_INFO("Frontend: @#1, Updating frontend...", _feID);
+	if (_deviceData.hasDeviceFrequencyChanged()) {
+		_deviceData.resetDeviceFrequencyChanged();
+		const std::string filePath = _deviceData.getFilePath();
+		base::MutexLock lock(_mutex);
+		_pending = false;
+		_dataOffset = 0;
+		_dataRecords = 0;
+		_speed = _deviceData.getSpeed();
+		_start = std::chrono::steady_clock::now();
+		if (_reader.open(filePath)) {
+			SI_LOG_INFO("Frontend: @#1, Replaying capture: @#2 at speed @#3",
+				_feID, filePath, _speed);
+		} else {
+			SI_LOG_ERROR("Frontend: @#1, Unable to open capture: @#2", _feID, filePath);
+		}
+	}
+	updatePIDFilters();
+	SI_LOG_DEBUG("Frontend: @#1, Updating frontend (Finished)", _feID);
+	return true;
+}
+
+bool Replayer::teardown() {
+	closeActivePIDFilters();
+	_deviceData.initialize();
+	base::MutexLock lock(_mutex);
+	_reader.close();
+	_pending = false;
+	_dataOffset = 0;
+	return true;
+}
+
+std::string Replayer::attributeDescribeString() const {
+	base::MutexLock lock(_mutex);
+	if (_reader.isOpen()) {
+		return _deviceData.attributeDescribeString(_feID);
+	}
+	return "";
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool Replayer::readNextRecord_L() {
+	if (_pending) {
+		return true;
+	}
+	if (!_reader.isOpen()) {
+		return false;
+	}
+	if (_reader.next(_record)) {
+		_pending = true;
+		return true;
+	}
+	SI_LOG_INFO("Frontend: @#1, Replay finished after @#2 reads", _feID, _dataRecords);
+	_reader.close();
+	return false;
+}
+
+std::chrono::steady_clock::time_point Replayer::getDueTime_L() const {
+	if (_speed <= 0.0) {
+		return _start;
+	}
+	return _start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::nanoseconds(static_cast<std::int64_t>(_record.time.count() / _speed)));
+}
+
+void Replayer::applyEvent_L() {
+	switch (_record.type) {
+		case RecordType::Tune: {
+			const std::string request(_record.data.begin(), _record.data.end());
+			SI_LOG_INFO("Frontend: @#1, Replay tune: @#2", _feID, request);
+			// A tune starts with new tables, like the original frontend
+			_deviceData.getFilter().clear();
+			updatePIDFilters();
+			break;
+		}
+		case RecordType::PIDs: {
+			const std::string pidCSV(_record.data.begin(), _record.data.end());
+			SI_LOG_DEBUG("Frontend: @#1, Replay PIDs: @#2", _feID, pidCSV);
+			mpegts::Filter &filter = _deviceData.getFilter();
+			filter.parsePIDString(_feID, "none", false);
+			if (!pidCSV.empty()) {
+				filter.parsePIDString(_feID, pidCSV, true);
+			}
+			updatePIDFilters();
+			break;
+		}
+		case RecordType::Key:
+#ifdef LIBDVBCSA
+			if (_record.data.size() == sizeof(std::int32_t) + CAPTURE_CW_SIZE) {
+				std::int32_t index;
+				std::memcpy(&index, _record.data.data(), sizeof(index));
+				setKey(_record.data.data() + sizeof(index), _record.parity, index);
+			}
+#endif
+			break;
+		case RecordType::Data:
+			break;
+		default:
+			// A newer capture may have records we do not know, skip them
+			SI_LOG_INFO("Frontend: @#1, Replay skipping unknown record type: @#2",
+				_feID, static_cast<int>(_record.type));
+			break;
+	}
+}
+
+}
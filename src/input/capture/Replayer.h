@@ -0,0 +1,268 @@
+/* Replayer.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_CAPTURE_REPLAYER_H_INCLUDE
+#define INPUT_CAPTURE_REPLAYER_H_INCLUDE INPUT_CAPTURE_REPLAYER_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <input/Device.h>
+#include <input/capture/CaptureReader.h>
+#include <input/capture/ReplayerData.h>
+
+#ifdef LIBDVBCSA
+#include <Unused.h>
+#include <input/dvb/FrontendDecryptInterface.h>
+#include <decrypt/dvbapi/ClientProperties.h>
+#endif
+
+#include <chrono>
+#include <string>
+
+FW_DECL_SP_NS2(input, capture, Replayer);
+FW_DECL_SP_NS2(decrypt, dvbapi, Client);
+
+FW_DECL_VECTOR_OF_SP_NS0(Stream);
+
+namespace input::capture {
+
+/// The class @c Replayer is an input device that replays a capture made by
+/// @c CaptureWriter (set 'captureFile' of a stream). The captured buffers are
+/// fed through the Filter, decrypt and output of the stream at the original
+/// timing, or scaled with 'speed' (0 is as fast as possible). The captured
+/// tune and PID changes are applied to the Filter and the captured Control
+/// Words to the descrambler, at the time they were captured.
+/// Some example for replaying a capture at twice the original speed:
+/// http://ip.of.your.box:8875/?msys=replay&uri="capture.satcap"&speed=2&pids=all
+class Replayer :
+#ifdef LIBDVBCSA
+	public input::dvb::FrontendDecryptInterface,
+#endif
+	public input::Device {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		Replayer(FeIndex index, bool enableUnsecureFrontends);
+
+		virtual ~Replayer() = default;
+
+		// =========================================================================
+		//  -- Static member functions ---------------------------------------------
+		// =========================================================================
+	public:
+
+		///
+		static void enumerate(
+			StreamSpVector &streamVector,
+			decrypt::dvbapi::SpClient decrypt,
+			bool enableUnsecureFrontends);
+
+		// =========================================================================
+		// -- base::XMLSupport -----------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// @see XMLSupport
+		virtual void doAddToXML(std::string &xml) const final;
+
+		/// @see XMLSupport
+		virtual void doFromXML(const base::XMLElement &xml) final;
+
+#ifdef LIBDVBCSA
+		// =========================================================================
+		// -- FrontendDecryptInterface ---------------------------------------------
+		// =========================================================================
+	public:
+
+		virtual FeID getFeID() const noexcept final {
+			return _feID;
+		}
+
+		virtual unsigned int getBatchCount() const noexcept final {
+			return _dvbapiData.getBatchCount();
+		}
+
+		virtual unsigned int getBatchParity() const noexcept final {
+			return _dvbapiData.getBatchParity();
+		}
+
+		virtual unsigned int getMaximumBatchSize() const noexcept final {
+			return _dvbapiData.getMaximumBatchSize();
+		}
+
+		virtual void decryptBatch() noexcept final {
+			return _dvbapiData.decryptBatch();
+		}
+
+		virtual void setBatchData(unsigned char* ptr, unsigned int len,
+				unsigned int parity, unsigned char* originalPtr) noexcept final {
+			_dvbapiData.setBatchData(ptr, len, parity, originalPtr);
+		}
+
+		virtual void markDecryptFailed(unsigned char* data) noexcept final {
+			_dvbapiData.markDecryptFailed(data);
+		}
+
+		virtual const decrypt::dvbapi::DescramblerKey* getKey(unsigned int parity) const final {
+			return _dvbapiData.getKey(parity);
+		}
+
+		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) final {
+			_dvbapiData.setKey(cw, parity, index);
+		}
+
+		virtual void setICAM(const unsigned char ecm, unsigned int parity) final {
+			_dvbapiData.setICAM(ecm, parity);
+		}
+
+		virtual void startOSCamFilterData(int pid, unsigned int demux, unsigned int filter,
+				const unsigned char* filterData, const unsigned char* filterMask) final {
+			_dvbapiData.startOSCamFilterData(_feID, pid, demux, filter, filterData, filterMask);
+			_deviceData.getFilter().setPID(pid, true);
+			updatePIDFilters();
+		}
+
+		virtual void stopOSCamFilterData(int UNUSED(pid), unsigned int demux, unsigned int filter) final {
+			_dvbapiData.stopOSCamFilterData(demux, filter);
+		}
+
+		virtual bool findOSCamFilterData(int pid, const unsigned char* tsPacket,
+				std::vector<decrypt::dvbapi::FilterSection>& sections) final {
+			return _dvbapiData.findOSCamFilterData(_feID, pid, tsPacket, sections);
+		}
+
+		virtual std::vector<int> getActiveOSCamDemuxFilters() const final {
+			return _dvbapiData.getActiveOSCamDemuxFilters();
+		}
+
+		virtual void stopOSCamFilters(FeID id) final {
+			_dvbapiData.stopOSCamFilters(id);
+		}
+
+		virtual void setECMInfo(
+			int pid,
+			int serviceID,
+			int caID,
+			int provID,
+			int emcTime,
+			const std::string& cardSystem,
+			const std::string& readerName,
+			const std::string& sourceName,
+			const std::string& protocolName,
+			int hops) final {
+			_dvbapiData.setECMInfo(pid, serviceID, caID, provID, emcTime,
+				cardSystem, readerName, sourceName, protocolName, hops);
+		}
+
+		virtual bool isMarkedAsActivePMT(int pid) const final {
+			return _deviceData.getFilter().isMarkedAsActivePMT(pid);
+		}
+
+		virtual mpegts::SpPMT getPMTData(int pid) const final {
+			return _deviceData.getFilter().getPMTData(pid);
+		}
+
+		virtual mpegts::SpSDT getSDTData() const final {
+			return _deviceData.getFilter().getSDTData();
+		}
+#endif
+
+		// =========================================================================
+		//  -- input::Device--------------------------------------------------------
+		// =========================================================================
+	public:
+
+		virtual void addDeliverySystemCount(
+			std::size_t &dvbs2,
+			std::size_t &dvbt,
+			std::size_t &dvbt2,
+			std::size_t &dvbc,
+			std::size_t &dvbc2) final;
+
+		virtual bool isDataAvailable() final;
+
+		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
+
+		virtual bool capableOf(input::InputSystem msys) const final;
+
+		virtual bool capableToShare(const TransportParamVector& params) const final;
+
+		virtual bool capableToTransform(const TransportParamVector& params) const final;
+
+		virtual bool isLockedByOtherProcess() const final;
+
+		virtual bool monitorSignal(bool showStatus) final;
+
+		virtual bool hasDeviceFrequencyChanged() const final;
+
+		virtual void parseStreamString(const TransportParamVector& params) final;
+
+		virtual bool update() final;
+
+		virtual bool teardown() final;
+
+		virtual std::string attributeDescribeString() const final;
+
+		virtual mpegts::Filter &getFilter() final {
+			return _deviceData.getFilter();
+		}
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	private:
+
+		/// Read the next record of the capture, if there is none pending
+		/// @return false at the end of the capture
+		bool readNextRecord_L();
+
+		/// Get the time the pending record is due
+		std::chrono::steady_clock::time_point getDueTime_L() const;
+
+		/// Apply the pending (event) record
+		void applyEvent_L();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		ReplayerData _deviceData;
+#ifdef LIBDVBCSA
+		decrypt::dvbapi::ClientProperties _dvbapiData;
+#endif
+		const bool _enableUnsecureFrontends;
+		/// Protects the replay, the reader thread uses it while a client can
+		/// start an other replay
+		base::Mutex _mutex;
+		CaptureReader _reader;
+		CaptureReader::Record _record;
+		bool _pending = false;
+		/// The part of the pending Data record that is already replayed
+		std::size_t _dataOffset = 0;
+		double _speed = 1.0;
+		std::chrono::steady_clock::time_point _start;
+		std::size_t _dataRecords = 0;
+};
+
+}
+
+#endif // INPUT_CAPTURE_REPLAYER_H_INCLUDE
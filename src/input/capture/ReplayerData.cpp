@@ -0,0 +1,89 @@
+/* ReplayerData.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/capture/ReplayerData.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <StringConverter.h>
+#include <TransportParamVector.h>
+
+namespace input::capture {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+ReplayerData::ReplayerData() {
+	doInitialize();
+}
+
+ReplayerData::~ReplayerData() {}
+
+// =============================================================================
+// -- input::DeviceData --------------------------------------------------------
+// =============================================================================
+
+void ReplayerData::doNextAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "pathname", _filePath);
+	ADD_XML_ELEMENT(xml, "speed", _speed);
+}
+
+void ReplayerData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
+
+void ReplayerData::doInitialize() {
+	_filePath = "None";
+	_speed = 1.0;
+}
+
+void ReplayerData::doParseStreamString(const FeID id, const TransportParamVector& params) {
+	const std::string filePath = params.getURIParameter("uri");
+	const double speed = params.getDoubleParameter("speed");
+	// Check did we receive an new capture or speed or just the same again
+	if (!filePath.empty() && (filePath != _filePath || (speed >= 0.0 && speed != _speed))) {
+		initialize();
+		_frequencyChanged = true;
+		_filePath = filePath;
+		_speed = (speed >= 0.0) ? speed : 1.0;
+	}
+	parseAndUpdatePidsTable(id, params);
+}
+
+std::string ReplayerData::doAttributeDescribeString(const FeID id) const {
+	// ver=1.5;tuner=<feID>,<level>,<lock>,<quality>;uri=<file>
+	return StringConverter::stringFormat("ver=1.5;tuner=@#1,@#2,@#3,@#4;uri=@#5",
+			id, getSignalStrength(), hasLock(),
+			getSignalToNoiseRatio(), _filePath);
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+std::string ReplayerData::getFilePath() const {
+	base::MutexLock lock(_mutex);
+	return _filePath;
+}
+
+double ReplayerData::getSpeed() const {
+	base::MutexLock lock(_mutex);
+	return _speed;
+}
+
+}
@@ -26,7 +26,9 @@
 #include <mpegts/Generator.h>
 #include <mpegts/PacketBuffer.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <thread>
 
 namespace input::childpipe {
@@ -36,6 +38,13 @@ namespace input::childpipe {
 // =============================================================================
 static constexpr int WAIT_TIMER = 10;
 
+/// The maximum time to wait for data in @c isDataAvailable, so the writer
+/// of the stream still gets called regularly
+static constexpr int MAX_WAIT_MS = 100;
+
+/// The size of the blocks read from the pipe
+static constexpr std::size_t BLOCK_SIZE = 256 * 1024;
+
 // =============================================================================
 //  -- Constructors and destructor ---------------------------------------------
 // =============================================================================
@@ -45,6 +54,7 @@ TSReader::TSReader(
 		const std::string &appDataPath,
 		const bool enableUnsecureFrontends) :
 		Device(index),
+		_block(BLOCK_SIZE),
 		_transform(appDataPath, input::InputSystem::CHILDPIPE),
 		_enableUnsecureFrontends(enableUnsecureFrontends) {}
 
@@ -70,15 +80,21 @@ void TSReader::enumerate(
 void TSReader::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "frontendname", "Child PIPE - TS Reader");
 	ADD_XML_ELEMENT(xml, "transformation", _transform.toXML());
+	ADD_XML_NUMBER_INPUT(xml, "pacingBurst", _pacer.getBurst(), 1, mpegts::PCRPacer::MAX_BURST);
+	ADD_XML_ELEMENT(xml, "pacingBitrate", StringConverter::stringFormat("@#1 bits/s", _pacer.getBitrate()));
 
 	_deviceData.addToXML(xml);
 }
 
-void TSReader::doFromXML(const std::string &xml) {
-	std::string element;
+void TSReader::doFromXML(const base::XMLElement &xml) {
+	base::XMLElement element;
 	if (findXMLElement(xml, "transformation", element)) {
 		_transform.fromXML(element);
 	}
+	std::string value;
+	if (findXMLElement(xml, "pacingBurst.value", value)) {
+		_pacer.setBurst(std::stoi(value));
+	}
 	_deviceData.fromXML(xml);
 }
 
@@ -99,23 +115,29 @@ void TSReader::addDeliverySystemCount(
 	dvbc2 += 0;
 }
 
+void TSReader::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+	Device::addToMetrics(metrics, labels);
+	_pacer.addToMetrics(metrics, labels);
+	metrics.addHistogram("satpi_childpipe_read_bytes",
+		"Size of the reads from the Child PIPE", labels, _pipeReadSize);
+}
+
 bool TSReader::isDataAvailable() {
+	// A fixed PCR Timer overrules the pacing on the PCRs
 	const int pcrTimer = _deviceData.getPCRTimer();
-	const std::int64_t pcrDelta = _deviceData.getFilter().getPCRData()->getPCRDelta();
-	if (pcrDelta != 0 && pcrTimer == 0) {
-		_t2 = _t1;
-		_t1 = std::chrono::steady_clock::now();
-
-		const long interval = pcrDelta - std::chrono::duration_cast<std::chrono::microseconds>(_t1 - _t2).count();
-		if (interval > 0) {
-			std::this_thread::sleep_for(std::chrono::microseconds(interval));
-		}
-		_t1 = std::chrono::steady_clock::now();
-		_deviceData.getFilter().getPCRData()->clearPCRDelta();
-	} else {
+	if (pcrTimer > 0) {
 		std::this_thread::sleep_for(std::chrono::microseconds(WAIT_TIMER + pcrTimer));
+		return true;
 	}
-	return true;
+	if (!_exec.isOpen()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(MAX_WAIT_MS));
+		return false;
+	}
+	// Wait on the pipe when the last block is used up
+	if (_blockIndex == _blockSize && !_exec.waitForData(MAX_WAIT_MS)) {
+		return false;
+	}
+	return _pacer.waitUntilDue();
 }
 
 bool TSReader::readTSPackets(mpegts::PacketBuffer& buffer) {
@@ -135,16 +157,41 @@ bool TSReader::readTSPackets(mpegts::PacketBuffer& buffer) {
 	if (!_exec.isOpen()) {
 		return false;
 	}
-	const bool filter = _deviceData.isInternalPidFilteringEnabled();
-	for (int i = 0; i < 21; ++i) {
-		const int readSize = _exec.read(buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
-		if (readSize > 0) {
-			buffer.addAmountOfBytesWritten(readSize);
-			buffer.trySyncing();
-			_deviceData.getFilter().filterData(_feID, buffer, filter);
-			if (buffer.full()) {
-				return true;
+	// Spread the block read from the pipe over the buffers, read the next
+	// block (once) when it is used up
+	bool readBlock = false;
+	bool written = false;
+	while (!buffer.full()) {
+		if (_blockIndex == _blockSize) {
+			if (readBlock) {
+				break;
 			}
+			readBlock = true;
+			_blockIndex = 0;
+			_blockSize = 0;
+			const ssize_t readSize = _exec.read(_block.data(), _block.size());
+			if (readSize < 0) {
+				SI_LOG_INFO("Frontend: @#1, Child PIPE - TS Reader closed by exec", _feID);
+				_exec.close();
+				break;
+			} else if (readSize == 0) {
+				break;
+			}
+			_blockSize = readSize;
+			_pipeReadSize.observe(readSize);
+			captureRead(_block.data(), readSize);
+		}
+		const std::size_t size = std::min(_blockSize - _blockIndex, buffer.getAmountOfBytesToWrite());
+		std::memcpy(buffer.getWriteBufferPtr(), _block.data() + _blockIndex, size);
+		buffer.addAmountOfBytesWritten(size);
+		_blockIndex += size;
+		written = true;
+	}
+	if (written) {
+		buffer.trySyncing();
+		_deviceData.getFilter().filterData(_feID, buffer, _deviceData.isInternalPidFilteringEnabled());
+		if (buffer.full()) {
+			_pacer.addBuffer(buffer);
 		}
 	}
 	// Check again if buffer is full
@@ -201,9 +248,11 @@ bool TSReader::update() {
 		const std::string execPath = _deviceData.getFilePath();
 		_exec.open(execPath);
 		if (_exec.isOpen()) {
-			SI_LOG_INFO("Frontend: @#1, Child PIPE - TS Reader using exec: @#2", _feID, execPath);
-			_t1 = std::chrono::steady_clock::now();
-			_t2 = _t1;
+			SI_LOG_INFO("Frontend: @#1, Child PIPE - TS Reader using exec: @#2 (pipe size @#3)",
+				_feID, execPath, _exec.getPipeSize());
+			_blockIndex = 0;
+			_blockSize = 0;
+			_pacer.reset();
 		} else {
 			SI_LOG_ERROR("Frontend: @#1, Child PIPE - TS Reader unable to use exec: @#2", _feID, execPath);
 		}
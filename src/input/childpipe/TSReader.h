@@ -25,9 +25,10 @@
 #include <input/Device.h>
 #include <input/Transformation.h>
 #include <input/childpipe/TSReaderData.h>
+#include <mpegts/PCRPacer.h>
 
 #include <string>
-#include <chrono>
+#include <vector>
 
 FW_DECL_SP_NS2(input, childpipe, TSReader);
 
@@ -35,7 +36,8 @@ FW_DECL_VECTOR_OF_SP_NS0(Stream);
 
 namespace input::childpipe {
 
-/// The class @c TSReader is for reading from an Child PIPE as input device
+/// The class @c TSReader is for reading from an Child PIPE as input device.
+/// The pipe is read in large blocks, that are spread over the buffers.
 /// Some example for opening a TS file with 'cat /dir/test.ts':
 /// http://ip.of.your.box:8875/?msys=childpipe&exec="cat%20%2Fdir%2Ftest.ts"
 class TSReader :
@@ -72,7 +74,7 @@ class TSReader :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 
 		// =========================================================================
@@ -87,6 +89,8 @@ class TSReader :
 			std::size_t &dvbc,
 			std::size_t &dvbc2) final;
 
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) final;
+
 		virtual bool isDataAvailable() final;
 
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
@@ -115,23 +119,22 @@ class TSReader :
 			return _deviceData.getFilter();
 		}
 
-		// =========================================================================
-		//  -- Other member functions ----------------------------------------------
-		// =========================================================================
-	protected:
-
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
 	private:
 
 		base::ChildPIPEReader _exec;
+		/// The block read from the pipe, and the part that is already used
+		std::vector<unsigned char> _block;
+		std::size_t _blockSize = 0;
+		std::size_t _blockIndex = 0;
+		base::Histogram _pipeReadSize{ 1316, 4096, 16384, 65536, 131072, 262144 };
 		TSReaderData _deviceData;
 		input::Transformation _transform;
 		const bool _enableUnsecureFrontends;
 
-		std::chrono::steady_clock::time_point _t1;
-		std::chrono::steady_clock::time_point _t2;
+		mpegts::PCRPacer _pacer;
 };
 
 }
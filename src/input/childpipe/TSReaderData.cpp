@@ -42,7 +42,7 @@ void TSReaderData::doNextAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "pathname", base::XMLSupport::makeXMLString(_filePath));
 }
 
-void TSReaderData::doNextFromXML(const std::string &UNUSED(xml)) {}
+void TSReaderData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 void TSReaderData::doInitialize() {
 	_filePath = "None";
@@ -47,7 +47,7 @@ class TSReaderData :
 		virtual void doNextAddToXML(std::string &xml) const final;
 
 		/// @see DeviceData
-		virtual void doNextFromXML(const std::string &xml) final;
+		virtual void doNextFromXML(const base::XMLElement &xml) final;
 
 		/// @see DeviceData
 		virtual void doInitialize() final;
@@ -0,0 +1,87 @@
+/* Benchmarks.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/Benchmarks.h>
+
+#include <StringConverter.h>
+#include <TransportParamVector.h>
+#include <base/Benchmark.h>
+#include <input/dvb/DVBDevice.h>
+#include <input/dvb/Frontend.h>
+#include <input/dvb/SimulatedDVBDevice.h>
+
+#include <memory>
+#include <string>
+
+namespace input::dvb {
+
+namespace {
+
+	const std::string DVB_PATH = "/dev/dvb";
+
+	/// Tune the frontend with the request (as after 'GET /?')
+	bool tune(Frontend &frontend, const std::string &request) {
+		frontend.parseStreamString(TransportParamVector(StringConverter::split(request, "&")));
+		return frontend.update();
+	}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void Benchmarks::run(base::Benchmark &benchmark) {
+	if (!benchmark.isSelected("dvb/zap") && !benchmark.isSelected("dvb/pids")) {
+		return;
+	}
+	SimulatedDVBDevice::Config config;
+	config.adapters = 1;
+	UpDVBDevice device = DVBDevice::setInstance(std::make_unique<SimulatedDVBDevice>(config));
+	{
+		const DVBDevice::FrontendNumberVector numbers = DVBDevice::instance().findFrontends(DVB_PATH);
+		const std::string adapter = StringConverter::stringFormat("@#1/adapter@#2/", DVB_PATH, numbers[0].adapter);
+		Frontend frontend(0, "", adapter + "frontend0", adapter + "dvr0", adapter + "demux0");
+
+		// Zap between two transponders, this includes the lock time of the
+		// simulated frontend
+		const std::string zap[] = {
+			"src=1&freq=11494&pol=h&ro=0.35&msys=dvbs2&mtype=8psk&plts=on&sr=22000&fec=23&pids=0,17,18,256",
+			"src=1&freq=11538&pol=h&ro=0.35&msys=dvbs2&mtype=8psk&plts=on&sr=22000&fec=23&pids=0,17,18,256"
+		};
+		std::size_t i = 0;
+		benchmark.run("dvb/zap", 0, [&] {
+			base::Benchmark::doNotOptimize(tune(frontend, zap[++i % 2]));
+		});
+
+		// Change the PIDs on the tuned transponder
+		tune(frontend, zap[0]);
+		const std::string pids[] = {
+			"pids=0,17,18,256,512,513",
+			"pids=0,17,18,272,528,529"
+		};
+		benchmark.run("dvb/pids", 0, [&] {
+			base::Benchmark::doNotOptimize(tune(frontend, pids[++i % 2]));
+		});
+		frontend.teardown();
+	}
+	DVBDevice::setInstance(std::move(device));
+}
+
+}
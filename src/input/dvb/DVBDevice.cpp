@@ -0,0 +1,120 @@
+/* DVBDevice.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/DVBDevice.h>
+
+#include <StringConverter.h>
+
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+
+namespace input::dvb {
+
+namespace {
+
+	UpDVBDevice &device() {
+		static UpDVBDevice device(new DVBDevice);
+		return device;
+	}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+DVBDevice &DVBDevice::instance() {
+	return *device();
+}
+
+UpDVBDevice DVBDevice::setInstance(UpDVBDevice newDevice) {
+	UpDVBDevice previous = std::move(device());
+	device() = std::move(newDevice);
+	return previous;
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void DVBDevice::doFindFrontends(const std::string &path,
+		const std::string &startPath, FrontendNumberVector &frontends) const {
+	dirent **file_list;
+	const int n = scandir(path.data(), &file_list, nullptr, versionsort);
+	if (n <= 0) {
+		return;
+	}
+	for (int i = 0; i < n; ++i) {
+		const std::string full_path = StringConverter::stringFormat("@#1/@#2", path, file_list[i]->d_name);
+		struct stat stat_buf;
+		if (stat(full_path.data(), &stat_buf) == 0) {
+			switch (stat_buf.st_mode & S_IFMT) {
+				case S_IFCHR: // character device
+					if (strstr(file_list[i]->d_name, "frontend") != nullptr) {
+						FrontendNumber number;
+						sscanf(file_list[i]->d_name, "frontend%d", &number.frontend);
+						const std::string ADAPTER_TMP = startPath + "/adapter%d";
+						sscanf(path.data(), ADAPTER_TMP.data(), &number.adapter);
+						frontends.push_back(number);
+					}
+					break;
+				case S_IFDIR:
+					// do not use dir '.' an '..'
+					if (strcmp(file_list[i]->d_name, ".") != 0 && strcmp(file_list[i]->d_name, "..") != 0) {
+						doFindFrontends(full_path, startPath, frontends);
+					}
+					break;
+				default:
+					// Do nothing here, just find next
+					break;
+			}
+		}
+		free(file_list[i]);
+	}
+	free(file_list);
+}
+
+int DVBDevice::doOpen(const std::string &path, const int flags) {
+	return ::open(path.data(), flags);
+}
+
+int DVBDevice::doClose(const int fd) {
+	return ::close(fd);
+}
+
+int DVBDevice::doIoctl(const int fd, const unsigned long request, const unsigned long arg) {
+	return ::ioctl(fd, request, arg);
+}
+
+ssize_t DVBDevice::doRead(const int fd, void *buf, const std::size_t count) {
+	return ::read(fd, buf, count);
+}
+
+int DVBDevice::doPoll(struct pollfd *fds, const nfds_t nfds, const int timeout) {
+	return ::poll(fds, nfds, timeout);
+}
+
+}
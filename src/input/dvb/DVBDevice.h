@@ -0,0 +1,140 @@
+/* DVBDevice.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_DVB_DVBDEVICE_H_INCLUDE
+#define INPUT_DVB_DVBDEVICE_H_INCLUDE INPUT_DVB_DVBDEVICE_H_INCLUDE
+
+#include <FwDecl.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/types.h>
+
+FW_DECL_UP_NS2(input, dvb, DVBDevice);
+
+namespace input::dvb {
+
+/// The class @c DVBDevice is the thin layer between the frontend code and the
+/// DVB device nodes (frontend, demux and dvr). All the system calls on these
+/// nodes go via the (process wide) instance, so the frontend code can also run
+/// against a simulated adapter, see @c SimulatedDVBDevice. This base class
+/// just does the system calls.
+class DVBDevice {
+	public:
+
+		/// The adapter and frontend number of a found frontend
+		struct FrontendNumber {
+			int adapter;
+			int frontend;
+		};
+		using FrontendNumberVector = std::vector<FrontendNumber>;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		DVBDevice() = default;
+
+		virtual ~DVBDevice() = default;
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the device instance all the DVB calls should go to
+		static DVBDevice &instance();
+
+		/// Replace the device instance, this should be done before any frontend
+		/// is enumerated
+		/// @return the previous device instance
+		static UpDVBDevice setInstance(UpDVBDevice device);
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Find all the frontends in the DVB adapter path (recursive)
+		/// @param path specifies the path like '/dev/dvb'
+		FrontendNumberVector findFrontends(const std::string &path) const {
+			FrontendNumberVector frontends;
+			doFindFrontends(path, path, frontends);
+			return frontends;
+		}
+
+		/// See open(2)
+		int open(const std::string &path, const int flags) {
+			return doOpen(path, flags);
+		}
+
+		/// See close(2)
+		int close(const int fd) {
+			return doClose(fd);
+		}
+
+		/// See ioctl(2) for the requests with a pointer argument
+		template<typename T>
+		int ioctl(const int fd, const unsigned long request, T *arg) {
+			return doIoctl(fd, request, reinterpret_cast<unsigned long>(arg));
+		}
+
+		/// See ioctl(2) for the requests with a value argument
+		int ioctl(const int fd, const unsigned long request, const unsigned long arg) {
+			return doIoctl(fd, request, arg);
+		}
+
+		/// See read(2)
+		ssize_t read(const int fd, void *buf, const std::size_t count) {
+			return doRead(fd, buf, count);
+		}
+
+		/// See poll(2)
+		int poll(struct pollfd *fds, const nfds_t nfds, const int timeout) {
+			return doPoll(fds, nfds, timeout);
+		}
+
+	protected:
+
+		/// @param path specifies the path to search in
+		/// @param startPath specifies the DVB adapter path we started with
+		/// @param frontends specifies the found frontends
+		virtual void doFindFrontends(const std::string &path,
+			const std::string &startPath, FrontendNumberVector &frontends) const;
+
+		virtual int doOpen(const std::string &path, int flags);
+
+		virtual int doClose(int fd);
+
+		virtual int doIoctl(int fd, unsigned long request, unsigned long arg);
+
+		virtual ssize_t doRead(int fd, void *buf, std::size_t count);
+
+		virtual int doPoll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+};
+
+}
+
+#endif // INPUT_DVB_DVBDEVICE_H_INCLUDE
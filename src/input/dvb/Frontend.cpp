@@ -26,6 +26,7 @@
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
 #include <input/dvb/dvbfix.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DVBC.h>
 #include <input/dvb/delivery/DVBS.h>
@@ -40,10 +41,7 @@
 
 #include <fcntl.h>
 #include <poll.h>
-#include <dirent.h>
 #include <sys/ioctl.h>
-#include <sys/stat.h>
-#include <sys/types.h>
 
 #include <base/StopWatch.h>
 
@@ -97,79 +95,6 @@ Frontend::Frontend(
 // =============================================================================
 //  -- Static functions --------------------------------------------------------
 // =============================================================================
-namespace {
-	// Called recursive
-	void getAttachedFrontends(
-			StreamSpVector &streamVector,
-			const std::string &appDataPath,
-			decrypt::dvbapi::SpClient decrypt,
-			const std::string &path,
-			const std::string &startPath) {
-		const std::string ADAPTER = startPath + "/adapter@#1";
-		const std::string DMX = ADAPTER + "/demux@#2";
-		const std::string DVR = ADAPTER + "/dvr@#2";
-		const std::string FRONTEND = ADAPTER + "/frontend@#2";
-	#if SIMU
-		// unused var
-		(void)path;
-
-		const std::string fe0 = StringConverter::stringFormat(FRONTEND.data(), 0, 0);
-		const std::string dvr0 = StringConverter::stringFormat(DVR.data(), 0, 0);
-		const std::string dmx0 = StringConverter::stringFormat(DMX.data(), 0, 0);
-		input::dvb::SpFrontend frontend0 = std::make_shared<input::dvb::Frontend>(0, appDataPath, fe0, dvr0, dmx0);
-		streamVector.push_back(Stream::makeSP(frontend0, decrypt));
-
-		const std::string fe1 = StringConverter::stringFormat(FRONTEND.data(), 1, 0);
-		const std::string dvr1 = StringConverter::stringFormat(DVR.data(), 1, 0);
-		const std::string dmx1 = StringConverter::stringFormat(DMX.data(), 1, 0);
-		input::dvb::SpFrontend frontend1 = std::make_shared<input::dvb::Frontend>(1, appDataPath, fe1, dvr1, dmx1);
-		streamVector.push_back(Stream::makeSP(frontend1, decrypt));
-	#else
-		dirent **file_list;
-		const int n = scandir(path.data(), &file_list, nullptr, versionsort);
-		if (n > 0) {
-			for (int i = 0; i < n; ++i) {
-				const std::string full_path = StringConverter::stringFormat("@#1/@#2", path, file_list[i]->d_name);
-				struct stat stat_buf;
-				if (stat(full_path.data(), &stat_buf) == 0) {
-					switch (stat_buf.st_mode & S_IFMT) {
-						case S_IFCHR: // character device
-							if (strstr(file_list[i]->d_name, "frontend") != nullptr) {
-								int fe_nr;
-								sscanf(file_list[i]->d_name, "frontend%d", &fe_nr);
-								int adapt_nr;
-								const std::string ADAPTER_TMP = startPath + "/adapter%d";
-								sscanf(path.data(), ADAPTER_TMP.data(), &adapt_nr);
-
-								// Make new paths
-								const std::string fe = StringConverter::stringFormat(FRONTEND.data(), adapt_nr, fe_nr);
-								const std::string dvr = StringConverter::stringFormat(DVR.data(), adapt_nr, fe_nr);
-								const std::string dmx = StringConverter::stringFormat(DMX.data(), adapt_nr, fe_nr);
-
-								// Make new frontend here
-								const StreamSpVector::size_type size = streamVector.size();
-								const input::dvb::SpFrontend frontend = std::make_shared<input::dvb::Frontend>(size, appDataPath, fe, dvr, dmx);
-								streamVector.push_back(Stream::makeSP(frontend, decrypt));
-							}
-							break;
-						case S_IFDIR:
-							// do not use dir '.' an '..'
-							if (strcmp(file_list[i]->d_name, ".") != 0 && strcmp(file_list[i]->d_name, "..") != 0) {
-								getAttachedFrontends(streamVector, appDataPath, decrypt, full_path, startPath);
-							}
-							break;
-						default:
-							// Do nothing here, just find next
-							break;
-					}
-				}
-				free(file_list[i]);
-			}
-		}
-	#endif
-	}
-}
-
 // =============================================================================
 //  -- Static member functions -------------------------------------------------
 // =============================================================================
@@ -181,7 +106,21 @@ void Frontend::enumerate(
 		const std::string &dvbAdapterPath) {
 	const StreamSpVector::size_type beginSize = streamVector.size();
 	SI_LOG_INFO("Detecting frontends in: @#1", dvbAdapterPath);
-	getAttachedFrontends(streamVector, appDataPath, decrypt, dvbAdapterPath, dvbAdapterPath);
+	const std::string ADAPTER = dvbAdapterPath + "/adapter@#1";
+	const std::string DMX = ADAPTER + "/demux@#2";
+	const std::string DVR = ADAPTER + "/dvr@#2";
+	const std::string FRONTEND = ADAPTER + "/frontend@#2";
+	for (const DVBDevice::FrontendNumber &number : DVBDevice::instance().findFrontends(dvbAdapterPath)) {
+		// Make new paths
+		const std::string fe = StringConverter::stringFormat(FRONTEND.data(), number.adapter, number.frontend);
+		const std::string dvr = StringConverter::stringFormat(DVR.data(), number.adapter, number.frontend);
+		const std::string dmx = StringConverter::stringFormat(DMX.data(), number.adapter, number.frontend);
+
+		// Make new frontend here
+		const StreamSpVector::size_type size = streamVector.size();
+		const input::dvb::SpFrontend frontend = std::make_shared<input::dvb::Frontend>(size, appDataPath, fe, dvr, dmx);
+		streamVector.push_back(Stream::makeSP(frontend, decrypt));
+	}
 	const StreamSpVector::size_type endSize = streamVector.size();
 	SI_LOG_INFO("Frontends found: @#1", endSize - beginSize);
 }
@@ -215,7 +154,7 @@ void Frontend::doAddToXML(std::string &xml) const {
 	}
 }
 
-void Frontend::doFromXML(const std::string &xml) {
+void Frontend::doFromXML(const base::XMLElement &xml) {
 	std::string element;
 	if (findXMLElement(xml, "dvrbuffer.value", element)) {
 		const unsigned int newSize = std::stoi(element);
@@ -229,14 +168,15 @@ void Frontend::doFromXML(const std::string &xml) {
 	if (findXMLElement(xml, "forceOldStyleStatus.value", element)) {
 		_oldApiCallStats = (element == "true") ? true : false;
 	}
+	base::XMLElement child;
 	for (std::size_t i = 0; i < _deliverySystem.size(); ++i) {
 		const std::string deliverySystem = StringConverter::stringFormat("deliverySystem@#1", i);
-		if (findXMLElement(xml, deliverySystem, element)) {
-			_deliverySystem[i]->fromXML(element);
+		if (findXMLElement(xml, deliverySystem, child)) {
+			_deliverySystem[i]->fromXML(child);
 		}
 	}
-	if (findXMLElement(xml, "transformation", element)) {
-		_transform.fromXML(element);
+	if (findXMLElement(xml, "transformation", child)) {
+		_transform.fromXML(child);
 	}
 	_frontendData.fromXML(xml);
 }
@@ -263,7 +203,7 @@ bool Frontend::isDataAvailable() {
 	pfd.fd = _fd_dmx;
 	pfd.events = POLLIN;
 	pfd.revents = 0;
-	const int pollRet = ::poll(&pfd, 1, 100);
+	const int pollRet = DVBDevice::instance().poll(&pfd, 1, 100);
 	if (pollRet > 0) {
 		return (pfd.revents & POLLIN) == POLLIN;
 	} else if (pollRet < 0) {
@@ -276,8 +216,10 @@ bool Frontend::isDataAvailable() {
 
 bool Frontend::readTSPackets(mpegts::PacketBuffer& buffer) {
 	// try read maximum amount of bytes from DMX
-	const auto readSize = ::read(_fd_dmx, buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
+	const auto readSize = DVBDevice::instance().read(_fd_dmx, buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
 	if (readSize > 0) {
+		_dvrReadSize.observe(readSize);
+		captureRead(buffer.getWriteBufferPtr(), readSize);
 		buffer.addAmountOfBytesWritten(readSize);
 		if (buffer.full()) {
 			_frontendData.getFilter().filterData(_feID, buffer, false);
@@ -292,6 +234,19 @@ bool Frontend::readTSPackets(mpegts::PacketBuffer& buffer) {
 	return false;
 }
 
+void Frontend::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+	Device::addToMetrics(metrics, labels);
+	metrics.addHistogram("satpi_frontend_dvr_read_bytes",
+		"Size of the reads from the DVR/DMX device", labels, _dvrReadSize);
+	metrics.addHistogram("satpi_frontend_tune_duration_milliseconds",
+		"Time to open and tune the frontend", labels, _tuneTimeMS);
+	metrics.addHistogram("satpi_frontend_lock_duration_milliseconds",
+		"Time from tuning until the frontend has lock", labels, _lockTimeMS);
+#ifdef LIBDVBCSA
+	_dvbapiData.addToMetrics(metrics, labels);
+#endif
+}
+
 bool Frontend::capableOf(const input::InputSystem system) const {
 	for (const input::dvb::delivery::UpSystem& deliverySystem : _deliverySystem) {
 		if (deliverySystem->isCapableOf(system)) {
@@ -313,26 +268,21 @@ bool Frontend::capableToTransform(const TransportParamVector& params) const {
 }
 
 bool Frontend::isLockedByOtherProcess() const {
-	int fd = ::open(_path_to_fe.data(), O_RDWR);
+	const int fd = DVBDevice::instance().open(_path_to_fe, O_RDWR);
 	if (fd  < 0) {
 		return true;
 	}
-	CLOSE_FD(fd);
+	DVBDevice::instance().close(fd);
 	return false;
 }
 
 bool Frontend::monitorSignal(const bool showStatus) {
-#if SIMU
-	(void)showStatus;
-	_frontendData.setMonitorData(FE_HAS_LOCK, 214, 15, 0, 0);
-	return true;
-#else
 	if (_fd_fe == -1) {
 		return false;
 	}
 	// first read status
 	fe_status_t status{};
-	if (::ioctl(_fd_fe, FE_READ_STATUS, &status) == 0) {
+	if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_STATUS, &status) == 0) {
 		uint16_t strength = 0;
 		uint16_t snr = 0;
 		uint32_t ber = 0;
@@ -354,7 +304,7 @@ bool Frontend::monitorSignal(const bool showStatus) {
 			cmdseq.num = size;
 			cmdseq.props = p;
 
-			if (ioctl(_fd_fe, FE_GET_PROPERTY, &cmdseq) == -1) {
+			if (DVBDevice::instance().ioctl(_fd_fe, FE_GET_PROPERTY, &cmdseq) == -1) {
 				SI_LOG_PERROR("Frontend: @#1, FE_GET_PROPERTY failed", _feID);
 			}
 
@@ -400,16 +350,16 @@ bool Frontend::monitorSignal(const bool showStatus) {
 #  endif
 		if (_oldApiCallStats) {
 			// some frontends might not support all these ioctls
-			if (::ioctl(_fd_fe, FE_READ_SIGNAL_STRENGTH, &strength) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_SIGNAL_STRENGTH, &strength) != 0) {
 				strength = 0;
 			}
-			if (::ioctl(_fd_fe, FE_READ_SNR, &snr) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_SNR, &snr) != 0) {
 				snr = 0;
 			}
-			if (::ioctl(_fd_fe, FE_READ_BER, &ber) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_BER, &ber) != 0) {
 				ber = 0;
 			}
-			if (::ioctl(_fd_fe, FE_READ_UNCORRECTED_BLOCKS, &ublocks) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_UNCORRECTED_BLOCKS, &ublocks) != 0) {
 				ublocks = 0;
 			}
 			strength = (strength * 240) / 0xffff;
@@ -427,7 +377,6 @@ bool Frontend::monitorSignal(const bool showStatus) {
 		SI_LOG_PERROR("Frontend: @#1, FE_READ_STATUS failed", _feID);
 	}
 	return (status & FE_HAS_LOCK) == FE_HAS_LOCK;
-#endif
 }
 
 bool Frontend::hasDeviceFrequencyChanged() const {
@@ -496,7 +445,7 @@ void Frontend::closeActivePIDFilters() {
 		// closePid lambda function
 		[&](const int pid) {
 			uint16_t p = pid;
-			if (::ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
 				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(p));
 				return false;
 			}
@@ -527,7 +476,7 @@ void Frontend::updatePIDFilters() {
 				SI_LOG_INFO("Frontend: @#1, Opened @#2 using fd: @#3", _feID, _path_to_dmx, _fd_dmx);
 				if (_dvrBufferSizeMB > 0) {
 					const unsigned int size = _dvrBufferSizeMB * 1024 * 1024;
-					if (::ioctl(_fd_dmx, DMX_SET_BUFFER_SIZE, size) != 0) {
+					if (DVBDevice::instance().ioctl(_fd_dmx, DMX_SET_BUFFER_SIZE, size) != 0) {
 						SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_BUFFER_SIZE", _feID);
 					} else {
 						SI_LOG_INFO("Frontend: @#1, Set DMX buffer size to @#2 Bytes", _feID, size);
@@ -542,7 +491,7 @@ void Frontend::updatePIDFilters() {
 						offsetFile >> offset;
 					}
 					int n = DMX_SOURCE_FRONT0 + _index.getID();
-					if (::ioctl(_fd_dmx, DMX_SET_SOURCE, &n) != 0) {
+					if (DVBDevice::instance().ioctl(_fd_dmx, DMX_SET_SOURCE, &n) != 0) {
 						SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_SOURCE with (Src: @#2 - Offset: @#3)", _feID, n, offset);
 						return false;
 					}
@@ -554,11 +503,11 @@ void Frontend::updatePIDFilters() {
 				pesFilter.output   = DMX_OUT_TSDEMUX_TAP;
 				pesFilter.pes_type = DMX_PES_OTHER;
 				pesFilter.flags    = DMX_IMMEDIATE_START;
-				if (::ioctl(_fd_dmx, DMX_SET_PES_FILTER, &pesFilter) != 0) {
+				if (DVBDevice::instance().ioctl(_fd_dmx, DMX_SET_PES_FILTER, &pesFilter) != 0) {
 					SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_PES_FILTER for PID: @#2", _feID, PID(p));
 					return false;
 				}
-			} else if (::ioctl(_fd_dmx, DMX_ADD_PID, &p) != 0) {
+			} else if (DVBDevice::instance().ioctl(_fd_dmx, DMX_ADD_PID, &p) != 0) {
 				SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_ADD_PID for PID: @#2", _feID, PID(p));
 				return false;
 			}
@@ -568,7 +517,7 @@ void Frontend::updatePIDFilters() {
 		// closePid lambda function
 		[&](const int pid) {
 			uint16_t p = pid;
-			if (::ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
+			if (DVBDevice::instance().ioctl(_fd_dmx, DMX_REMOVE_PID, &p) != 0) {
 				SI_LOG_PERROR("Frontend: @#1, DMX_REMOVE_PID: PID @#2", _feID, PID(p));
 				return false;
 			}
@@ -582,13 +531,6 @@ void Frontend::updatePIDFilters() {
 // =============================================================================
 
 void Frontend::setupFrontend() {
-#if SIMU
-	sprintf(_fe_info.name, "Simulation DVB-S2/C/T Card");
-	_fe_info.frequency_min = 1000000UL;
-	_fe_info.frequency_max = 21000000UL;
-	_fe_info.symbol_rate_min = 20000UL;
-	_fe_info.symbol_rate_max = 250000UL;
-#else
 	// open frontend in readonly mode
 	int fd_fe = openFE(_path_to_fe, true);
 	if (fd_fe < 0) {
@@ -597,13 +539,12 @@ void Frontend::setupFrontend() {
 		return;
 	}
 
-	if (::ioctl(fd_fe, FE_GET_INFO, &_fe_info) != 0) {
+	if (DVBDevice::instance().ioctl(fd_fe, FE_GET_INFO, &_fe_info) != 0) {
 		snprintf(_fe_info.name, sizeof(_fe_info.name), "Not Set");
 		SI_LOG_PERROR("FE_GET_INFO");
-		CLOSE_FD(fd_fe);
+		closeFD(fd_fe);
 		return;
 	}
-#endif
 	SI_LOG_INFO("Frontend Name: @#1", _fe_info.name);
 	if (_oldApiCallStats) {
 		SI_LOG_INFO("Frontend Stat: Use legacy signal stats");
@@ -611,17 +552,6 @@ void Frontend::setupFrontend() {
 		SI_LOG_INFO("Frontend Stat: Use advanced signal stats");
 	}
 	struct dtv_property dtvProperty[2];
-#if SIMU
-	dtvProperty[0].u.buffer.len = 4;
-	dtvProperty[0].u.buffer.data[0] = SYS_DVBS;
-	dtvProperty[0].u.buffer.data[1] = SYS_DVBS2;
-	dtvProperty[0].u.buffer.data[2] = SYS_DVBT;
-#  if FULL_DVB_API_VERSION >= 0x0505
-	dtvProperty[0].u.buffer.data[3] = SYS_DVBC_ANNEX_A;
-#  else
-	dtvProperty[0].u.buffer.data[3] = SYS_DVBC_ANNEX_AC;
-#  endif
-#else
 	dtvProperty[0].cmd    = DTV_ENUM_DELSYS;
 	dtvProperty[0].u.data = DTV_UNDEFINED;
 	dtvProperty[1].cmd    = DTV_API_VERSION;
@@ -630,7 +560,7 @@ void Frontend::setupFrontend() {
 	struct dtv_properties dtvProperties;
 	dtvProperties.num = 2;
 	dtvProperties.props = dtvProperty;
-	if (::ioctl(fd_fe, FE_GET_PROPERTY, &dtvProperties ) != 0) {
+	if (DVBDevice::instance().ioctl(fd_fe, FE_GET_PROPERTY, &dtvProperties ) != 0) {
 		// If we are here it can mean we have an DVB-API <= 5.4
 		SI_LOG_DEBUG("Unable to enumerate the delivery systems, retrying via old API Call");
 		auto index = 0;
@@ -668,13 +598,12 @@ void Frontend::setupFrontend() {
 			// Fall-through
 			default:
 				SI_LOG_ERROR("Frontend does not have any known delivery systems");
-				CLOSE_FD(fd_fe);
+				closeFD(fd_fe);
 				return;
 		}
 		dtvProperty[0].u.buffer.len = index;
 	}
-	CLOSE_FD(fd_fe);
-#endif
+	closeFD(fd_fe);
 	// get capability of this frontend and count the delivery systems
 	for (std::size_t i = 0; i < dtvProperty[0].u.buffer.len; ++i) {
 		const int deliveryType = dtvProperty[0].u.buffer.data[i];
@@ -757,22 +686,31 @@ void Frontend::setupFrontend() {
 }
 
 int Frontend::openFE(const std::string &path, const bool readonly) const {
-	const int fd = ::open(path.data(), (readonly ? O_RDONLY : O_RDWR) | O_NONBLOCK);
+	const int fd = DVBDevice::instance().open(path, (readonly ? O_RDONLY : O_RDWR) | O_NONBLOCK);
 	if (fd  < 0) {
 		SI_LOG_PERROR("Frontend: @#1, Failed to open @#2", _feID, path);
 	}
 	return fd;
 }
 
+void Frontend::closeFD(int &fd) const {
+	if (fd != -1) {
+		if (DVBDevice::instance().close(fd) == -1) {
+			SI_LOG_PERROR("Frontend: @#1, close error fd @#2", _feID, fd);
+		}
+		fd = -1;
+	}
+}
+
 void Frontend::closeFE() {
 	if (_fd_fe != -1) {
 		SI_LOG_INFO("Frontend: @#1, Closing @#2 fd: @#3", _feID, _path_to_fe, _fd_fe);
-		CLOSE_FD(_fd_fe);
+		closeFD(_fd_fe);
 	}
 }
 
 int Frontend::openDMX(const std::string &path) const {
-	const int fd = ::open(path.data(), O_RDWR | O_NONBLOCK);
+	const int fd = DVBDevice::instance().open(path, O_RDWR | O_NONBLOCK);
 	if (fd < 0) {
 		SI_LOG_PERROR("Frontend: @#1, Failed to open @#2", _feID, path);
 	}
@@ -782,7 +720,7 @@ int Frontend::openDMX(const std::string &path) const {
 void Frontend::closeDMX() {
 	if (_fd_dmx != -1) {
 		SI_LOG_INFO("Frontend: @#1, Closing @#2 fd: @#3", _feID, _path_to_dmx, _fd_dmx);
-		CLOSE_FD(_fd_dmx);
+		closeFD(_fd_dmx);
 	}
 }
 
@@ -817,6 +755,8 @@ bool Frontend::setupAndTune() {
 			return false;
 		}
 		_tuned = true;
+		_tuneTimeMS.observe(sw.getIntervalMS());
+		const base::StopWatch swLock;
 		SI_LOG_INFO("Frontend: @#1, Tuned, waiting on lock...", _feID);
 		std::this_thread::sleep_for(std::chrono::milliseconds(300));
 		if (sw.getIntervalMS() < _waitOnLockTimeout) {
@@ -825,10 +765,11 @@ bool Frontend::setupAndTune() {
 			for (int i = 1;; ++i) {
 				fe_status_t status = FE_TIMEDOUT;
 				// first read status
-				if (::ioctl(_fd_fe, FE_READ_STATUS, &status) == 0) {
+				if (DVBDevice::instance().ioctl(_fd_fe, FE_READ_STATUS, &status) == 0) {
 					if (status & FE_HAS_LOCK) {
 						// We are tuned now, add some tuning stats
 						_frontendData.setMonitorData(FE_HAS_LOCK, 100, 8, 0, 0);
+						_lockTimeMS.observe(swLock.getIntervalMS());
 						SI_LOG_INFO("Frontend: @#1, Tuned and locked (FE status @#2)", _feID, HEX(status, 2));
 						break;
 					}
@@ -84,7 +84,7 @@ class Frontend :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 #ifdef LIBDVBCSA
 		// =========================================================================
@@ -117,14 +117,16 @@ class Frontend :
 			_dvbapiData.setBatchData(ptr, len, parity, originalPtr);
 		}
 
-		virtual const dvbcsa_bs_key_s* getKey(unsigned int parity) const final {
-			return _dvbapiData.getKey(parity);
+		virtual void markDecryptFailed(unsigned char* data) noexcept final {
+			_dvbapiData.markDecryptFailed(data);
 		}
 
-		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) final {
-			_dvbapiData.setKey(cw, parity, index);
+		virtual const decrypt::dvbapi::DescramblerKey* getKey(unsigned int parity) const final {
+			return _dvbapiData.getKey(parity);
 		}
 
+		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) final;
+
 		virtual void setICAM(const unsigned char ecm, unsigned int parity) final {
 			_dvbapiData.setICAM(ecm, parity);
 		}
@@ -134,9 +136,9 @@ class Frontend :
 
 		virtual void stopOSCamFilterData(int pid, unsigned int demux, unsigned int filter) final;
 
-		virtual bool findOSCamFilterData(int pid, const unsigned char* tsPacket, int tableID,
-				unsigned int& filter, unsigned int& demux, mpegts::TSData& filterData) final {
-			return _dvbapiData.findOSCamFilterData(_feID, pid, tsPacket, tableID, filter, demux, filterData);
+		virtual bool findOSCamFilterData(int pid, const unsigned char* tsPacket,
+				std::vector<decrypt::dvbapi::FilterSection>& sections) final {
+			return _dvbapiData.findOSCamFilterData(_feID, pid, tsPacket, sections);
 		}
 
 		virtual std::vector<int> getActiveOSCamDemuxFilters() const final {
@@ -215,6 +217,8 @@ class Frontend :
 			return _frontendData.getFilter();
 		}
 
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) final;
+
 		///
 		virtual void updatePIDFilters() final;
 
@@ -231,6 +235,9 @@ class Frontend :
 		///
 		int openFE(const std::string &path, bool readonly) const;
 
+		/// Close the file descriptor of the DVB device and set it to -1
+		void closeFD(int &fd) const;
+
 		///
 		void closeFE();
 
@@ -276,6 +283,9 @@ class Frontend :
 		unsigned long _dvrBufferSizeMB;
 		unsigned long _waitOnLockTimeout;
 		bool _oldApiCallStats;
+		base::Histogram _dvrReadSize{ 188, 376, 564, 752, 940, 1128, 1316 };
+		base::Histogram _tuneTimeMS{ 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 };
+		base::Histogram _lockTimeMS{ 100, 250, 500, 1000, 1500, 2000, 3000, 5000, 10000 };
 };
 
 }
@@ -70,7 +70,7 @@ void FrontendData::doNextAddToXML(std::string &xml) const {
 	}
 }
 
-void FrontendData::doNextFromXML(const std::string &UNUSED(xml)) {}
+void FrontendData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 void FrontendData::doInitialize() {
 	_freq = 0;
@@ -22,8 +22,9 @@
 
 #include <Defs.h>
 #include <FwDecl.h>
+#include <decrypt/dvbapi/FilterData.h>
 
-FW_DECL_NS0(dvbcsa_bs_key_s);
+FW_DECL_NS2(decrypt, dvbapi, DescramblerKey);
 
 FW_DECL_SP_NS1(mpegts, PMT);
 FW_DECL_SP_NS1(mpegts, SDT);
@@ -67,7 +68,10 @@ class FrontendDecryptInterface {
 			unsigned char* originalPtr) noexcept = 0;
 
 		///
-		virtual const dvbcsa_bs_key_s* getKey(unsigned int parity) const = 0;
+		virtual void markDecryptFailed(unsigned char* data) noexcept = 0;
+
+		///
+		virtual const decrypt::dvbapi::DescramblerKey* getKey(unsigned int parity) const = 0;
 
 		///
 		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) = 0;
@@ -82,9 +86,9 @@ class FrontendDecryptInterface {
 		///
 		virtual void stopOSCamFilterData(int pid, unsigned int demux, unsigned int filter) = 0;
 
-		///
-		virtual bool findOSCamFilterData(int pid, const unsigned char* tsPacket, int tableID,
-			unsigned int& filter, unsigned int& demux, mpegts::TSData& filterData) = 0;
+		/// Find the sections, finished with this ts packet, that match the OSCam filters
+		virtual bool findOSCamFilterData(int pid, const unsigned char* tsPacket,
+			std::vector<decrypt::dvbapi::FilterSection>& sections) = 0;
 
 		/// Get the vector of current 'active' OSCam demux filters
 		virtual std::vector<int> getActiveOSCamDemuxFilters() const = 0;
@@ -20,9 +20,17 @@
 #include <input/dvb/Frontend.h>
 
 #include <input/dvb/FrontendData.h>
+#include <input/capture/CaptureWriter.h>
 
 namespace input::dvb {
 
+void Frontend::setKey(const unsigned char* cw, const unsigned int parity, const int index) {
+	_dvbapiData.setKey(cw, parity, index);
+	if (_capture && _capture->isOpen()) {
+		_capture->addKey(cw, parity, index);
+	}
+}
+
 void Frontend::startOSCamFilterData(const int pid, const unsigned int demux, const unsigned int filter,
 	const unsigned char* filterData, const unsigned char* filterMask) {
 	SI_LOG_INFO("Frontend: @#1, Start filter PID: @#2  demux: @#3  filter: @#4 (data @#5 @#6 @#7 mask @#8 @#9 @#10 @#11)",
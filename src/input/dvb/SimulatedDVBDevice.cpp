@@ -0,0 +1,518 @@
+/* SimulatedDVBDevice.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/SimulatedDVBDevice.h>
+
+#include <Log.h>
+#include <StringConverter.h>
+#include <Unused.h>
+#include <mpegts/PidTable.h>
+#include <mpegts/TSCorpus.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+namespace input::dvb {
+
+namespace {
+
+	/// The delivery systems of the simulated frontend
+	constexpr std::uint32_t DELIVERY_SYSTEMS[] = {
+		SYS_DVBS, SYS_DVBS2, SYS_DVBT, SYS_DVBT2,
+#if FULL_DVB_API_VERSION >= 0x0505
+		SYS_DVBC_ANNEX_A
+#else
+		SYS_DVBC_ANNEX_AC
+#endif
+	};
+
+	/// A DiSEqC bit takes 1.5 ms on the wire (9 bits with parity per byte)
+	constexpr std::chrono::microseconds DISEQC_BYTE_TIME(9 * 1500);
+	/// The quiet time the driver waits after a DiSEqC message or burst
+	constexpr std::chrono::milliseconds DISEQC_QUIET_TIME(15);
+	/// The tone burst takes 12.5 ms on the wire
+	constexpr std::chrono::microseconds DISEQC_BURST_TIME(12500);
+
+	constexpr std::chrono::milliseconds POLL_STEP(2);
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+SimulatedDVBDevice::SimulatedDVBDevice(const Config &config) :
+		_config(config),
+		_adapters(config.adapters),
+		_nextFD(FD_BASE) {
+	if (_config.bitrate == 0) {
+		_config.bitrate = Config().bitrate;
+	}
+	if (!_config.tsFile.empty()) {
+		std::ifstream file(_config.tsFile, std::ios::binary);
+		const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		const std::size_t size = (data.size() / TS_PACKET_SIZE) * TS_PACKET_SIZE;
+		if (size == 0) {
+			SI_LOG_ERROR("Simulated DVB: Unable to read TS file @#1, generating a stream", _config.tsFile);
+		} else {
+			_fileStream = std::make_shared<const mpegts::TSData>(
+				reinterpret_cast<const unsigned char *>(data.data()), size);
+		}
+	}
+	SI_LOG_INFO("Simulated DVB: @#1 adapter(s) with a stream of @#2 kbit/s from @#3 and a lock time of @#4 ms",
+		_config.adapters, _config.bitrate, _fileStream ? _config.tsFile : "a generated corpus",
+		_config.lockTime);
+}
+
+// =============================================================================
+//  -- input::dvb::DVBDevice ---------------------------------------------------
+// =============================================================================
+
+void SimulatedDVBDevice::doFindFrontends(const std::string &UNUSED(path),
+		const std::string &UNUSED(startPath), FrontendNumberVector &frontends) const {
+	for (std::size_t i = 0; i < _config.adapters; ++i) {
+		frontends.push_back({static_cast<int>(i), 0});
+	}
+}
+
+int SimulatedDVBDevice::doOpen(const std::string &path, const int flags) {
+	// Path like: <dvb path>/adapter<n>/<node><m>
+	const std::string::size_type index = path.rfind("/adapter");
+	int adapterNr = -1;
+	int nodeNr = -1;
+	char node[32] = {};
+	if (index == std::string::npos ||
+			std::sscanf(path.data() + index, "/adapter%d/%31[a-z]%d", &adapterNr, node, &nodeNr) != 3 ||
+			adapterNr < 0 || static_cast<std::size_t>(adapterNr) >= _adapters.size() || nodeNr != 0) {
+		errno = ENOENT;
+		return -1;
+	}
+	Handle handle;
+	handle.adapter = adapterNr;
+	handle.writable = (flags & O_ACCMODE) != O_RDONLY;
+	if (std::strcmp(node, "frontend") == 0) {
+		handle.node = Node::Frontend;
+	} else if (std::strcmp(node, "demux") == 0) {
+		handle.node = Node::Demux;
+		handle.pids.resize(mpegts::PidTable::ALL_PIDS + 1, false);
+		handle.bufferSize = DEFAULT_DMX_BUFFER_SIZE;
+	} else if (std::strcmp(node, "dvr") == 0) {
+		handle.node = Node::Dvr;
+	} else {
+		errno = ENOENT;
+		return -1;
+	}
+	base::MutexLock lock(_mutex);
+	Adapter &adapter = _adapters[adapterNr];
+	if (handle.node == Node::Frontend && handle.writable) {
+		// Like the DVB core, only one read/write open at a time
+		if (adapter.writers > 0) {
+			errno = EBUSY;
+			return -1;
+		}
+		++adapter.writers;
+	}
+	const int fd = _nextFD++;
+	_handles.emplace(fd, std::move(handle));
+	return fd;
+}
+
+int SimulatedDVBDevice::doClose(const int fd) {
+	base::MutexLock lock(_mutex);
+	const auto it = _handles.find(fd);
+	if (it == _handles.end()) {
+		errno = EBADF;
+		return -1;
+	}
+	const Handle &handle = it->second;
+	if (handle.node == Node::Frontend && handle.writable) {
+		Adapter &adapter = _adapters[handle.adapter];
+		--adapter.writers;
+		if (adapter.writers == 0) {
+			// The frontend goes to sleep, so it loses the lock
+			adapter.tuned = false;
+		}
+	}
+	_handles.erase(it);
+	return 0;
+}
+
+int SimulatedDVBDevice::doIoctl(const int fd, const unsigned long request, const unsigned long arg) {
+	// DiSEqC takes time on the wire, so do not hold the lock while 'sending'
+	std::size_t wireBytes = 0;
+	bool burst = false;
+	int ret = -1;
+	{
+		base::MutexLock lock(_mutex);
+		Handle *handle = findHandle_L(fd);
+		if (handle == nullptr) {
+			errno = EBADF;
+			return -1;
+		}
+		switch (handle->node) {
+			case Node::Frontend:
+				if (request == FE_DISEQC_SEND_MASTER_CMD) {
+					const dvb_diseqc_master_cmd *cmd = reinterpret_cast<const dvb_diseqc_master_cmd *>(arg);
+					SI_LOG_DEBUG("Simulated DVB: Adapter @#1, DiSEqC [@#2] [@#3] [@#4] [@#5]", handle->adapter,
+						HEX(cmd->msg[0], 2), HEX(cmd->msg[1], 2), HEX(cmd->msg[2], 2), HEX(cmd->msg[3], 2));
+					wireBytes = cmd->msg_len;
+				} else if (request == FE_DISEQC_SEND_BURST) {
+					burst = true;
+				}
+				ret = frontendIoctl_L(*handle, request, arg);
+				break;
+			case Node::Demux:
+				ret = demuxIoctl_L(*handle, request, arg);
+				break;
+			case Node::Dvr:
+			default:
+				errno = ENOTTY;
+				break;
+		}
+	}
+	if (ret == 0 && wireBytes > 0) {
+		sleepOnWire(wireBytes);
+	} else if (ret == 0 && burst) {
+		std::this_thread::sleep_for(DISEQC_BURST_TIME + DISEQC_QUIET_TIME);
+	}
+	return ret;
+}
+
+ssize_t SimulatedDVBDevice::doRead(const int fd, void *buf, const std::size_t count) {
+	base::MutexLock lock(_mutex);
+	Handle *handle = findHandle_L(fd);
+	if (handle == nullptr) {
+		errno = EBADF;
+		return -1;
+	}
+	if (handle->node != Node::Demux) {
+		errno = EINVAL;
+		return -1;
+	}
+	const Clock::time_point now = Clock::now();
+	const std::uint64_t due = getDuePackets_L(*handle, now);
+	if (due == 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+	// The demux buffer is full when the reader is too slow, then the data is
+	// dropped like the DVB core does (this counts all packets of the stream,
+	// not only the filtered ones, so it overflows a bit early on a few PIDs)
+	const std::uint64_t bufferPackets = handle->bufferSize / TS_PACKET_SIZE;
+	if (due - handle->position > bufferPackets) {
+		handle->position = due - bufferPackets / 2;
+		errno = EOVERFLOW;
+		return -1;
+	}
+	const mpegts::TSData &stream = *_adapters[handle->adapter].stream;
+	const std::size_t packets = stream.size() / TS_PACKET_SIZE;
+	const bool allPIDs = handle->pids[mpegts::PidTable::ALL_PIDS];
+	unsigned char *out = static_cast<unsigned char *>(buf);
+	std::size_t size = 0;
+	for (; handle->position < due && size + TS_PACKET_SIZE <= count; ++handle->position) {
+		const unsigned char *packet = stream.data() + (handle->position % packets) * TS_PACKET_SIZE;
+		const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+		if (allPIDs || handle->pids[pid]) {
+			std::memcpy(out + size, packet, TS_PACKET_SIZE);
+			size += TS_PACKET_SIZE;
+		}
+	}
+	if (size == 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+	return size;
+}
+
+int SimulatedDVBDevice::doPoll(struct pollfd *fds, const nfds_t nfds, const int timeout) {
+	const Clock::time_point end = Clock::now() + std::chrono::milliseconds(timeout);
+	for (;;) {
+		int ready = 0;
+		const Clock::time_point now = Clock::now();
+		{
+			base::MutexLock lock(_mutex);
+			for (nfds_t i = 0; i < nfds; ++i) {
+				fds[i].revents = 0;
+				Handle *handle = findHandle_L(fds[i].fd);
+				if (handle == nullptr) {
+					fds[i].revents = POLLNVAL;
+				} else if (handle->node == Node::Demux && (fds[i].events & POLLIN) != 0 &&
+						skipToFilteredPacket_L(*handle, now)) {
+					fds[i].revents = POLLIN;
+				}
+				if (fds[i].revents != 0) {
+					++ready;
+				}
+			}
+		}
+		if (ready > 0 || timeout == 0 || (timeout > 0 && now >= end)) {
+			return ready;
+		}
+		std::this_thread::sleep_for(POLL_STEP);
+	}
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+int SimulatedDVBDevice::frontendIoctl_L(Handle &handle, const unsigned long request, const unsigned long arg) {
+	Adapter &adapter = _adapters[handle.adapter];
+	const Clock::time_point now = Clock::now();
+	const bool locked = hasLock_L(adapter, now);
+	switch (request) {
+		case FE_GET_INFO: {
+			dvb_frontend_info *info = reinterpret_cast<dvb_frontend_info *>(arg);
+			*info = {};
+			std::snprintf(info->name, sizeof(info->name), "Simulated DVB-S2/T2/C Frontend");
+			info->type = FE_QPSK;
+			info->frequency_min = 950000UL;
+			info->frequency_max = 2150000UL;
+			info->symbol_rate_min = 1000000UL;
+			info->symbol_rate_max = 45000000UL;
+			info->caps = static_cast<fe_caps>(FE_CAN_INVERSION_AUTO | FE_CAN_FEC_AUTO |
+				FE_CAN_QPSK | FE_CAN_QAM_AUTO | FE_CAN_2G_MODULATION | FE_CAN_MULTISTREAM);
+			return 0;
+		}
+		case FE_GET_PROPERTY:
+			return getProperties_L(adapter, *reinterpret_cast<dtv_properties *>(arg));
+		case FE_SET_PROPERTY:
+			if (!handle.writable) {
+				errno = EPERM;
+				return -1;
+			}
+			return setProperties_L(adapter, *reinterpret_cast<const dtv_properties *>(arg));
+		case FE_GET_EVENT:
+			// No pending events
+			errno = EWOULDBLOCK;
+			return -1;
+		case FE_READ_STATUS: {
+			fe_status_t *status = reinterpret_cast<fe_status_t *>(arg);
+			if (locked) {
+				*status = static_cast<fe_status_t>(FE_HAS_SIGNAL | FE_HAS_CARRIER |
+					FE_HAS_VITERBI | FE_HAS_SYNC | FE_HAS_LOCK);
+			} else {
+				*status = adapter.tuned ? FE_HAS_SIGNAL : static_cast<fe_status_t>(0);
+			}
+			return 0;
+		}
+		case FE_READ_SIGNAL_STRENGTH:
+			*reinterpret_cast<std::uint16_t *>(arg) = locked ? 0xC000 : 0x1000;
+			return 0;
+		case FE_READ_SNR:
+			*reinterpret_cast<std::uint16_t *>(arg) = locked ? 0x9999 : 0x0000;
+			return 0;
+		case FE_READ_BER:
+		case FE_READ_UNCORRECTED_BLOCKS:
+			*reinterpret_cast<std::uint32_t *>(arg) = 0;
+			return 0;
+		case FE_SET_VOLTAGE:
+		case FE_SET_TONE:
+		case FE_ENABLE_HIGH_LNB_VOLTAGE:
+		case FE_DISEQC_SEND_MASTER_CMD:
+		case FE_DISEQC_SEND_BURST:
+			if (!handle.writable) {
+				errno = EPERM;
+				return -1;
+			}
+			return 0;
+		default:
+			errno = ENOTTY;
+			return -1;
+	}
+}
+
+int SimulatedDVBDevice::demuxIoctl_L(Handle &handle, const unsigned long request, const unsigned long arg) {
+	switch (request) {
+		case DMX_SET_BUFFER_SIZE:
+			handle.bufferSize = std::max<std::size_t>(arg, TS_PACKET_SIZE);
+			return 0;
+		case DMX_SET_SOURCE:
+		case DMX_STOP:
+			return 0;
+		case DMX_START:
+			handle.started = true;
+			return 0;
+		case DMX_SET_PES_FILTER: {
+			const dmx_pes_filter_params *filter = reinterpret_cast<const dmx_pes_filter_params *>(arg);
+			if (filter->pid > mpegts::PidTable::ALL_PIDS) {
+				errno = EINVAL;
+				return -1;
+			}
+			handle.pids[filter->pid] = true;
+			handle.started = (filter->flags & DMX_IMMEDIATE_START) != 0;
+			return 0;
+		}
+		case DMX_ADD_PID:
+		case DMX_REMOVE_PID: {
+			const std::uint16_t pid = *reinterpret_cast<const std::uint16_t *>(arg);
+			if (pid > mpegts::PidTable::ALL_PIDS) {
+				errno = EINVAL;
+				return -1;
+			}
+			handle.pids[pid] = (request == DMX_ADD_PID);
+			return 0;
+		}
+		default:
+			errno = ENOTTY;
+			return -1;
+	}
+}
+
+int SimulatedDVBDevice::setProperties_L(Adapter &adapter, const struct dtv_properties &cmdseq) {
+	for (std::uint32_t i = 0; i < cmdseq.num; ++i) {
+		const dtv_property &p = cmdseq.props[i];
+		switch (p.cmd) {
+			case DTV_CLEAR:
+				adapter.tuned = false;
+				adapter.frequency = 0;
+				adapter.deliverySystem = SYS_UNDEFINED;
+				break;
+			case DTV_FREQUENCY:
+				adapter.frequency = p.u.data;
+				break;
+			case DTV_DELIVERY_SYSTEM:
+				adapter.deliverySystem = p.u.data;
+				break;
+			case DTV_TUNE:
+				adapter.tuned = true;
+				adapter.lockTime = Clock::now() + std::chrono::milliseconds(_config.lockTime);
+				++adapter.tuneCount;
+				if (_fileStream) {
+					adapter.stream = _fileStream;
+				} else {
+					const mpegts::TSCorpus corpus(CORPUS_PACKETS,
+						mpegts::TSCorpus::DEFAULT_SEED + adapter.frequency);
+					adapter.stream = std::make_shared<const mpegts::TSData>(corpus.getData());
+				}
+				break;
+			default:
+				// The other tuning parameters are not simulated
+				break;
+		}
+	}
+	return 0;
+}
+
+int SimulatedDVBDevice::getProperties_L(const Adapter &adapter, struct dtv_properties &cmdseq) const {
+	const bool locked = hasLock_L(adapter, Clock::now());
+	for (std::uint32_t i = 0; i < cmdseq.num; ++i) {
+		dtv_property &p = cmdseq.props[i];
+		switch (p.cmd) {
+			case DTV_ENUM_DELSYS:
+				p.u.buffer.len = 0;
+				for (const std::uint32_t system : DELIVERY_SYSTEMS) {
+					p.u.buffer.data[p.u.buffer.len++] = system;
+				}
+				break;
+			case DTV_API_VERSION:
+				p.u.data = FULL_DVB_API_VERSION;
+				break;
+			case DTV_FREQUENCY:
+				p.u.data = adapter.frequency;
+				break;
+			case DTV_DELIVERY_SYSTEM:
+				p.u.data = adapter.deliverySystem;
+				break;
+#if FULL_DVB_API_VERSION >= 0x050A
+			case DTV_STAT_SIGNAL_STRENGTH:
+				p.u.st.len = 1;
+				p.u.st.stat[0].scale = FE_SCALE_RELATIVE;
+				p.u.st.stat[0].uvalue = locked ? 0xC000 : 0x1000;
+				break;
+			case DTV_STAT_CNR:
+				p.u.st.len = 1;
+				p.u.st.stat[0].scale = FE_SCALE_RELATIVE;
+				p.u.st.stat[0].uvalue = locked ? 0x9999 : 0x0000;
+				break;
+			case DTV_STAT_ERROR_BLOCK_COUNT:
+				p.u.st.len = 1;
+				p.u.st.stat[0].scale = FE_SCALE_COUNTER;
+				p.u.st.stat[0].uvalue = 0;
+				break;
+#endif
+			default:
+				errno = EINVAL;
+				return -1;
+		}
+	}
+	return 0;
+}
+
+bool SimulatedDVBDevice::hasLock_L(const Adapter &adapter, const Clock::time_point now) const {
+	if (!adapter.tuned || now < adapter.lockTime || adapter.frequency == 0) {
+		return false;
+	}
+	return std::find(std::begin(DELIVERY_SYSTEMS), std::end(DELIVERY_SYSTEMS),
+		adapter.deliverySystem) != std::end(DELIVERY_SYSTEMS);
+}
+
+std::uint64_t SimulatedDVBDevice::getDuePackets_L(Handle &handle, const Clock::time_point now) {
+	const Adapter &adapter = _adapters[handle.adapter];
+	if (!handle.started || !hasLock_L(adapter, now)) {
+		return 0;
+	}
+	if (handle.tuneCount != adapter.tuneCount) {
+		// Tuned again, so start with the new stream
+		handle.tuneCount = adapter.tuneCount;
+		handle.streamStart = now;
+		handle.position = 0;
+	}
+	const std::uint64_t usec = std::chrono::duration_cast<std::chrono::microseconds>(
+		now - handle.streamStart).count();
+	return (usec * _config.bitrate) / (TS_PACKET_SIZE * 8 * 1000);
+}
+
+bool SimulatedDVBDevice::skipToFilteredPacket_L(Handle &handle, const Clock::time_point now) {
+	const std::uint64_t due = getDuePackets_L(handle, now);
+	if (handle.position >= due) {
+		return false;
+	}
+	if (handle.pids[mpegts::PidTable::ALL_PIDS]) {
+		return true;
+	}
+	const mpegts::TSData &stream = *_adapters[handle.adapter].stream;
+	const std::size_t packets = stream.size() / TS_PACKET_SIZE;
+	for (; handle.position < due; ++handle.position) {
+		const unsigned char *packet = stream.data() + (handle.position % packets) * TS_PACKET_SIZE;
+		if (handle.pids[((packet[1] & 0x1F) << 8) | packet[2]]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+SimulatedDVBDevice::Handle *SimulatedDVBDevice::findHandle_L(const int fd) {
+	const auto it = _handles.find(fd);
+	return (it == _handles.end()) ? nullptr : &it->second;
+}
+
+void SimulatedDVBDevice::sleepOnWire(const std::size_t bytes) {
+	std::this_thread::sleep_for(DISEQC_BYTE_TIME * bytes + DISEQC_QUIET_TIME);
+}
+
+}
@@ -0,0 +1,177 @@
+/* SimulatedDVBDevice.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_DVB_SIMULATEDDVBDEVICE_H_INCLUDE
+#define INPUT_DVB_SIMULATEDDVBDEVICE_H_INCLUDE INPUT_DVB_SIMULATEDDVBDEVICE_H_INCLUDE
+
+#include <base/Mutex.h>
+#include <input/dvb/DVBDevice.h>
+#include <input/dvb/dvbfix.h>
+#include <mpegts/TableData.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace input::dvb {
+
+/// The class @c SimulatedDVBDevice simulates DVB adapters with one multi
+/// standard (DVB-S2/T2/C) frontend each, so the frontend code can be run and
+/// benchmarked without any tuner. It models:
+///  - The lock time, the frontend locks a fixed time after DTV_TUNE
+///  - The DiSEqC timing, sending a command takes as long as on the wire
+///  - The demux, only the added PIDs are delivered at the rate of the stream
+///    and a reader that is too slow gets an overflow
+///  - Only one read/write open of a frontend at a time
+/// The stream is read from a TS file or, without a file, generated per
+/// frequency with @c mpegts::TSCorpus, so the data is deterministic.
+class SimulatedDVBDevice :
+	public DVBDevice {
+	public:
+
+		struct Config {
+			/// The number of simulated adapters
+			std::size_t adapters = 2;
+			/// The TS file to feed, empty generates a stream per frequency
+			std::string tsFile;
+			/// The rate of the stream in kbit/s
+			unsigned int bitrate = 20000;
+			/// The time, in msec, from tuning until the frontend has lock
+			unsigned int lockTime = 250;
+		};
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		explicit SimulatedDVBDevice(const Config &config);
+
+		virtual ~SimulatedDVBDevice() = default;
+
+		// =====================================================================
+		// -- input::dvb::DVBDevice --------------------------------------------
+		// =====================================================================
+	protected:
+
+		virtual void doFindFrontends(const std::string &path,
+			const std::string &startPath, FrontendNumberVector &frontends) const override;
+
+		virtual int doOpen(const std::string &path, int flags) override;
+
+		virtual int doClose(int fd) override;
+
+		virtual int doIoctl(int fd, unsigned long request, unsigned long arg) override;
+
+		virtual ssize_t doRead(int fd, void *buf, std::size_t count) override;
+
+		virtual int doPoll(struct pollfd *fds, nfds_t nfds, int timeout) override;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	private:
+
+		using Clock = std::chrono::steady_clock;
+		using SpTSData = std::shared_ptr<const mpegts::TSData>;
+
+		enum class Node {
+			Frontend,
+			Demux,
+			Dvr
+		};
+
+		struct Adapter {
+			int writers = 0;
+			bool tuned = false;
+			std::uint32_t frequency = 0;
+			std::uint32_t deliverySystem = 0;
+			Clock::time_point lockTime;
+			/// Incremented with every tune, so the demux knows to restart
+			std::uint64_t tuneCount = 0;
+			SpTSData stream;
+		};
+
+		struct Handle {
+			std::size_t adapter = 0;
+			Node node = Node::Frontend;
+			bool writable = false;
+			// Demux
+			std::vector<bool> pids;
+			bool started = false;
+			std::size_t bufferSize = 0;
+			std::uint64_t tuneCount = 0;
+			Clock::time_point streamStart;
+			/// The number of packets of the stream that are passed by
+			std::uint64_t position = 0;
+		};
+
+		/// Handle the frontend ioctls
+		int frontendIoctl_L(Handle &handle, unsigned long request, unsigned long arg);
+
+		/// Handle the demux ioctls
+		int demuxIoctl_L(Handle &handle, unsigned long request, unsigned long arg);
+
+		/// Set the tuning properties of the frontend
+		int setProperties_L(Adapter &adapter, const struct dtv_properties &cmdseq);
+
+		/// Get the properties and statistics of the frontend
+		int getProperties_L(const Adapter &adapter, struct dtv_properties &cmdseq) const;
+
+		bool hasLock_L(const Adapter &adapter, Clock::time_point now) const;
+
+		/// Get the number of stream packets that are due for this demux, also
+		/// restarts the demux after a tune
+		std::uint64_t getDuePackets_L(Handle &handle, Clock::time_point now);
+
+		/// Skip the packets that are not filtered by this demux
+		/// @return true if there is a filtered packet due
+		bool skipToFilteredPacket_L(Handle &handle, Clock::time_point now);
+
+		/// Find the handle of the simulated file descriptor
+		Handle *findHandle_L(int fd);
+
+		/// Simulate the time the DiSEqC message needs on the wire
+		static void sleepOnWire(std::size_t bytes);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// The simulated file descriptors start here, above any real one
+		static constexpr int FD_BASE = 0x40000000;
+		static constexpr std::size_t TS_PACKET_SIZE = 188;
+		static constexpr std::size_t DEFAULT_DMX_BUFFER_SIZE = 8192 * TS_PACKET_SIZE / 8;
+		static constexpr std::size_t CORPUS_PACKETS = 4000;
+
+		base::Mutex _mutex;
+		Config _config;
+		SpTSData _fileStream;
+		std::vector<Adapter> _adapters;
+		std::map<int, Handle> _handles;
+		int _nextFD;
+};
+
+}
+
+#endif // INPUT_DVB_SIMULATEDDVBDEVICE_H_INCLUDE
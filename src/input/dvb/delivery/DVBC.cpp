@@ -22,6 +22,7 @@
 #include <Log.h>
 #include <StringConverter.h>
 #include <Unused.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 
 
@@ -49,7 +50,7 @@ namespace input::dvb::delivery {
 		}
 	}
 
-	void DVBC::doFromXML(const std::string& xml) {
+	void DVBC::doFromXML(const base::XMLElement &xml) {
 		if (_fbc.isFBCTuner()) {
 			_fbc.fromXML(xml);
 		}
@@ -110,12 +111,12 @@ namespace input::dvb::delivery {
 		// get all pending events to clear the POLLPRI status
 		for (;; ) {
 			struct dvb_frontend_event dfe;
-			if (ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
+			if (DVBDevice::instance().ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
 				break;
 			}
 		}
 		// set the tuning properties
-		if ((ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
+		if ((DVBDevice::instance().ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
 			SI_LOG_PERROR("FE_SET_PROPERTY failed");
 			return false;
 		}
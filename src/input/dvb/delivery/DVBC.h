@@ -49,7 +49,7 @@ class DVBC :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		// -- input::dvb::delivery::System -----------------------------------------
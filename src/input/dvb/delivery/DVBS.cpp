@@ -23,6 +23,7 @@
 #include <StringConverter.h>
 #include <Utils.h>
 #include <base/Tokenizer.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DiSEqcEN50494.h>
 #include <input/dvb/delivery/DiSEqcEN50607.h>
@@ -98,7 +99,7 @@ namespace input::dvb::delivery {
 		}
 	}
 
-	void DVBS::doFromXML(const std::string &xml) {
+	void DVBS::doFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "turnoffLNBPower.value", element)) {
 			_turnoffLnbVoltage = (element == "true") ? true : false;
@@ -131,8 +132,9 @@ namespace input::dvb::delivery {
 		}
 		if (_diseqc != nullptr) {
 			// This after creating _diseqc!
-			if (findXMLElement(xml, "diseqc", element)) {
-				_diseqc->fromXML(element);
+			base::XMLElement diseqc;
+			if (findXMLElement(xml, "diseqc", diseqc)) {
+				_diseqc->fromXML(diseqc);
 			}
 		}
 		if (_fbc.isFBCTuner()) {
@@ -166,7 +168,7 @@ namespace input::dvb::delivery {
 
 		if (_fbc.doSendDiSEqcViaRootTuner()) {
 			SI_LOG_INFO("Frontend: @#1, Closing @#2 with fd: @#3", _feID, fePathDiseqc, feFDDiseqc);
-			::close(feFDDiseqc);
+			DVBDevice::instance().close(feFDDiseqc);
 		}
 
 		// Now tune by setting properties
@@ -236,12 +238,12 @@ namespace input::dvb::delivery {
 		// get all pending events to clear the POLLPRI status
 		for (;; ) {
 			struct dvb_frontend_event dfe;
-			if (ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
+			if (DVBDevice::instance().ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
 				break;
 			}
 		}
 		// set the tuning properties
-		if ((ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
+		if ((DVBDevice::instance().ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
 			SI_LOG_PERROR("FE_SET_PROPERTY failed");
 			return false;
 		}
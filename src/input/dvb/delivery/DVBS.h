@@ -53,7 +53,7 @@ class DVBS :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		// -- input::dvb::delivery::System -----------------------------------------
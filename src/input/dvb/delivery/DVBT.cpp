@@ -21,6 +21,7 @@
 
 #include <Log.h>
 #include <StringConverter.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 
 #include <fcntl.h>
@@ -48,7 +49,7 @@ namespace delivery {
 		ADD_XML_NUMBER_INPUT(xml, "lna", _lna, 0, 5);
 	}
 
-	void DVBT::doFromXML(const std::string &xml) {
+	void DVBT::doFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "lna.value", element)) {
 			_lna = std::stoi(element);
@@ -115,12 +116,12 @@ namespace delivery {
 		// get all pending events to clear the POLLPRI status
 		for (;; ) {
 			struct dvb_frontend_event dfe;
-			if (ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
+			if (DVBDevice::instance().ioctl(feFD, FE_GET_EVENT, &dfe) == -1) {
 				break;
 			}
 		}
 		// set the tuning properties
-		if ((ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
+		if ((DVBDevice::instance().ioctl(feFD, FE_SET_PROPERTY, &cmdseq)) == -1) {
 			SI_LOG_PERROR("FE_SET_PROPERTY failed");
 			return false;
 		}
@@ -49,7 +49,7 @@ namespace input::dvb::delivery {
 			virtual void doAddToXML(std::string &xml) const final;
 
 			/// @see XMLSupport
-			virtual void doFromXML(const std::string &xml) final;
+			virtual void doFromXML(const base::XMLElement &xml) final;
 
 			// =======================================================================
 			// -- Other member functions ---------------------------------------------
@@ -109,7 +109,7 @@ namespace input::dvb::delivery {
 			virtual void doNextAddToXML(std::string &UNUSED(xml)) const {}
 
 			/// Specialization for @see doFromXML
-			virtual void doNextFromXML(const std::string &UNUSED(xml)) {}
+			virtual void doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 			// =======================================================================
 			// -- Data members -------------------------------------------------------
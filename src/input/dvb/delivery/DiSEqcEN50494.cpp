@@ -84,7 +84,7 @@ namespace input::dvb::delivery {
 		ADD_XML_N_ELEMENT(xml, "lnb", 1, _lnb.toXML());
 	}
 
-	void DiSEqcEN50494::doNextFromXML(const std::string &xml) {
+	void DiSEqcEN50494::doNextFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "chFreq.value", element)) {
 			_chFreq = std::stoi(element);
@@ -95,8 +95,9 @@ namespace input::dvb::delivery {
 		if (findXMLElement(xml, "pin.value", element)) {
 			_pin = std::stoi(element);
 		}
-		if (findXMLElement(xml, "lnb1", element)) {
-			_lnb.fromXML(element);
+		base::XMLElement lnb;
+		if (findXMLElement(xml, "lnb1", lnb)) {
+			_lnb.fromXML(lnb);
 		}
 	}
 
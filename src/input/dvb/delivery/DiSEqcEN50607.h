@@ -54,7 +54,7 @@ namespace input::dvb::delivery {
 			virtual void doNextAddToXML(std::string &xml) const final;
 
 			/// @see DiSEqc
-			virtual void doNextFromXML(const std::string &xml) final;
+			virtual void doNextFromXML(const base::XMLElement &xml) final;
 
 			// =======================================================================
 			// -- Data members -------------------------------------------------------
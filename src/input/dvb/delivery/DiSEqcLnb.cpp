@@ -21,6 +21,7 @@
 
 #include <Log.h>
 #include <StringConverter.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 
 #include <chrono>
@@ -42,37 +43,37 @@ namespace input::dvb::delivery {
 
 		SI_LOG_INFO("Frontend: @#1, Sending LNB: Mini-Switch Src: @#2", id, src);
 
-		if (ioctl(feFD, FE_SET_VOLTAGE, SEC_VOLTAGE_18) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_VOLTAGE, SEC_VOLTAGE_18) == -1) {
 			SI_LOG_PERROR("FE_SET_VOLTAGE failed");
 			return false;
 		}
-		if (ioctl(feFD, FE_SET_TONE, SEC_TONE_OFF) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_TONE, SEC_TONE_OFF) == -1) {
 			SI_LOG_PERROR("FE_SET_TONE failed");
 			return false;
 		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(_delayBeforeWrite));
 
 		const auto b = (src % 2) ? SEC_MINI_B : SEC_MINI_A;
-		if (ioctl(feFD, FE_DISEQC_SEND_BURST, b) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_DISEQC_SEND_BURST, b) == -1) {
 			SI_LOG_PERROR("FE_DISEQC_SEND_BURST failed");
 			return false;
 		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(_delayAfterWrite));
 
-		if (ioctl(feFD, FE_SET_VOLTAGE, SEC_VOLTAGE_13) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_VOLTAGE, SEC_VOLTAGE_13) == -1) {
 			SI_LOG_PERROR("FE_SET_VOLTAGE failed to 13V");
 		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
 		// Set LNB
 		const auto v = (pol == Lnb::Polarization::Vertical || pol == Lnb::Polarization::CircularRight) ? SEC_VOLTAGE_13 : SEC_VOLTAGE_18;
-		if (ioctl(feFD, FE_SET_VOLTAGE, v) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_VOLTAGE, v) == -1) {
 			SI_LOG_PERROR("FE_SET_VOLTAGE failed");
 			return false;
 		}
 
 		const auto tone = hiband ? SEC_TONE_ON : SEC_TONE_OFF;
-		if (ioctl(feFD, FE_SET_TONE, tone) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_TONE, tone) == -1) {
 			SI_LOG_PERROR("FE_SET_TONE failed");
 			return false;
 		}
@@ -83,8 +84,8 @@ namespace input::dvb::delivery {
 		ADD_XML_N_ELEMENT(xml, "lnb", 1, _lnb.toXML());
 	}
 
-	void DiSEqcLnb::doNextFromXML(const std::string &xml) {
-		std::string element;
+	void DiSEqcLnb::doNextFromXML(const base::XMLElement &xml) {
+		base::XMLElement element;
 		if (findXMLElement(xml, "lnb1", element)) {
 			_lnb.fromXML(element);
 		}
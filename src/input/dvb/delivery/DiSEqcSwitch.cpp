@@ -21,6 +21,7 @@
 
 #include <Log.h>
 #include <StringConverter.h>
+#include <input/dvb/DVBDevice.h>
 #include <input/dvb/FrontendData.h>
 
 #include <chrono>
@@ -119,13 +120,13 @@ namespace input::dvb::delivery {
 
 		// Setup LNB
 		const auto v = (pol == Lnb::Polarization::Vertical || pol == Lnb::Polarization::CircularRight) ? SEC_VOLTAGE_13 : SEC_VOLTAGE_18;
-		if (ioctl(feFD, FE_SET_VOLTAGE, v) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_VOLTAGE, v) == -1) {
 			SI_LOG_PERROR("FE_SET_VOLTAGE failed");
 			return false;
 		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(20));
 		const auto tone = hiband ? SEC_TONE_ON : SEC_TONE_OFF;
-		if (ioctl(feFD, FE_SET_TONE, tone) == -1) {
+		if (DVBDevice::instance().ioctl(feFD, FE_SET_TONE, tone) == -1) {
 			SI_LOG_PERROR("FE_SET_TONE failed");
 			return false;
 		}
@@ -148,7 +149,7 @@ namespace input::dvb::delivery {
 		}
 	}
 
-	void DiSEqcSwitch::doNextFromXML(const std::string &xml) {
+	void DiSEqcSwitch::doNextFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "switchType.value", element)) {
 			const auto type = integerToEnum<SwitchType>(std::stoi(element));
@@ -175,8 +176,9 @@ namespace input::dvb::delivery {
 			_lnb.resize(_numberOfInputs);
 		}
 		for (int i = 0; i < _numberOfInputs; ++i) {
-			if (findXMLElement(xml, "lnb" + i + 1, element)) {
-				_lnb[i].fromXML(element);
+			base::XMLElement lnb;
+			if (findXMLElement(xml, StringConverter::stringFormat("lnb@#1", i + 1), lnb)) {
+				_lnb[i].fromXML(lnb);
 			}
 		}
 	}
@@ -24,6 +24,7 @@
 #include <Utils.h>
 #include <base/Tokenizer.h>
 #include <base/XMLSupport.h>
+#include <input/dvb/DVBDevice.h>
 
 #include <cmath>
 #include <fstream>
@@ -91,7 +92,7 @@ void FBC::doAddToXML(std::string& xml) const {
 	}
 }
 
-void FBC::doFromXML(const std::string &xml) {
+void FBC::doFromXML(const base::XMLElement &xml) {
 	if (_fbcTuner) {
 		std::string element;
 		if (findXMLElement(xml, "fbcLinked.value", element)) {
@@ -115,7 +116,7 @@ void FBC::doFromXML(const std::string &xml) {
 int FBC::getFileDescriptorOfRootTuner(std::string& fePath) const {
 	// Replace Frontend number with Root Frontend Number
 	fePath.replace(fePath.end()-1, fePath.end(), std::to_string(_fbcConnect));
-	int feFD = ::open(fePath.data(), O_RDWR | O_NONBLOCK);
+	int feFD = DVBDevice::instance().open(fePath, O_RDWR | O_NONBLOCK);
 	if (feFD  < 0) {
 		// Probably already open, try to find it and duplicate fd
 		dirent **fileList;
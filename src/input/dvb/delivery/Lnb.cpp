@@ -62,7 +62,7 @@ namespace input::dvb::delivery {
 		ADD_XML_NUMBER_INPUT(xml, "lofHigh", _lofHigh / 1000UL, 0, 20000);
 	}
 
-	void Lnb::doFromXML(const std::string &xml) {
+	void Lnb::doFromXML(const base::XMLElement &xml) {
 		std::string element;
 		if (findXMLElement(xml, "lnbtype", element)) {
 			_type = static_cast<LNBType>(std::stoi(element));
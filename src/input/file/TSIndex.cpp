@@ -0,0 +1,422 @@
+/* TSIndex.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/file/TSIndex.h>
+
+#include <Log.h>
+#include <base/MappedFile.h>
+#include <base/TimeCounter.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include <sys/stat.h>
+
+namespace input::file {
+
+namespace {
+
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+
+	/// The PCR runs with 27 MHz and wraps around after 2^33 * 300 ticks
+	constexpr std::uint64_t PCR_HZ = 27000000;
+	constexpr std::uint64_t PCR_WRAP = (1ULL << 33) * 300;
+
+	/// A PCR that jumps backwards or more than this forward is a discontinuity
+	constexpr std::uint64_t MAX_PCR_GAP = PCR_HZ;
+
+	/// The minimum time between two index entries
+	constexpr std::uint64_t MIN_ENTRY_INTERVAL_US = 100000;
+
+	/// The file is scanned in chunks of at least this size, by at most
+	/// MAX_THREADS threads
+	constexpr std::size_t MIN_CHUNK_SIZE = 16 * 1024 * 1024;
+	constexpr unsigned int MAX_THREADS = 8;
+
+	constexpr char INDEX_MAGIC[] = "SatPIIdx";
+	constexpr std::uint32_t INDEX_VERSION = 1;
+
+	struct IndexHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t reserved;
+		std::uint64_t fileSize;
+		std::int64_t fileMTime;
+		std::uint64_t count;
+	};
+
+	/// A TS packet with a PCR and/or a Random Access Indicator
+	struct Event {
+		std::uint64_t offset;
+		std::uint64_t pcr;
+		int pid;
+		bool hasPCR;
+		bool rap;
+	};
+	using EventVector = std::vector<Event>;
+
+	/// The file is read in blocks of this size while it is scanned
+	constexpr std::size_t SCAN_BLOCK_SIZE = 1024 * 1024;
+
+	/// The class @c BlockReader reads the file in blocks, and keeps the block
+	/// that holds the requested range
+	class BlockReader {
+		public:
+
+			BlockReader(base::MappedFile &file, const std::uint64_t size) :
+				_file(file),
+				_size(size),
+				_block(SCAN_BLOCK_SIZE) {}
+
+			/// Get the @c need bytes at @c pos
+			/// @return nullptr if they are beyond the end of the file
+			const unsigned char *get(const std::uint64_t pos, const std::size_t need) {
+				if (pos + need > _size) {
+					return nullptr;
+				}
+				if (pos < _blockOffset || pos + need > _blockOffset + _blockSize) {
+					_blockOffset = pos;
+					_blockSize = _file.read(pos, _block.data(), _block.size());
+					if (_blockSize < need) {
+						// Truncated while we are reading
+						_size = pos + _blockSize;
+						return nullptr;
+					}
+				}
+				return _block.data() + (pos - _blockOffset);
+			}
+
+		private:
+
+			base::MappedFile &_file;
+			std::uint64_t _size;
+			std::vector<unsigned char> _block;
+			std::uint64_t _blockOffset = 0;
+			std::size_t _blockSize = 0;
+	};
+
+	/// Find the first offset from @c begin where the TS packets are in sync
+	std::uint64_t findSync(BlockReader &reader, std::uint64_t begin, const std::uint64_t size) {
+		for (; begin + (2 * TS_PACKET_SIZE) < size; ++begin) {
+			const unsigned char *data = reader.get(begin, (2 * TS_PACKET_SIZE) + 1);
+			if (data == nullptr) {
+				break;
+			}
+			if (data[0] == 0x47 && data[TS_PACKET_SIZE] == 0x47 &&
+					data[2 * TS_PACKET_SIZE] == 0x47) {
+				return begin;
+			}
+		}
+		return size;
+	}
+
+	/// Collect the events of the TS packets that start in [begin, end)
+	void scanChunk(const std::string &filePath, const std::uint64_t size,
+			const std::uint64_t begin, const std::uint64_t end, const std::atomic_bool &abort,
+			EventVector &events) {
+		// Each scanner maps its own window of the file
+		base::MappedFile file;
+		if (!file.open(filePath)) {
+			return;
+		}
+		BlockReader reader(file, size);
+		std::uint64_t pos = findSync(reader, begin, size);
+		while (pos < end && pos + TS_PACKET_SIZE <= size && !abort.load(std::memory_order_relaxed)) {
+			const unsigned char *ts = reader.get(pos, TS_PACKET_SIZE);
+			if (ts == nullptr) {
+				break;
+			}
+			if (ts[0] != 0x47) {
+				pos = findSync(reader, pos + 1, size);
+				continue;
+			}
+			// No Transport Error Indicator and an adaptation field
+			if ((ts[1] & 0x80) == 0 && (ts[3] & 0x20) == 0x20 && ts[4] > 0) {
+				const bool rap = (ts[5] & 0x40) == 0x40;
+				const bool hasPCR = (ts[5] & 0x10) == 0x10 && ts[4] >= 7;
+				if (rap || hasPCR) {
+					std::uint64_t pcr = 0;
+					if (hasPCR) {
+						const std::uint64_t base =
+							(static_cast<std::uint64_t>(ts[6]) << 25) |
+							(static_cast<std::uint64_t>(ts[7]) << 17) |
+							(static_cast<std::uint64_t>(ts[8]) << 9)  |
+							(static_cast<std::uint64_t>(ts[9]) << 1)  |
+							(static_cast<std::uint64_t>(ts[10]) >> 7);
+						pcr = (base * 300) + ((static_cast<std::uint64_t>(ts[10] & 0x01) << 8) | ts[11]);
+					}
+					const int pid = ((ts[1] & 0x1F) << 8) | ts[2];
+					events.push_back({ pos, pcr, pid, hasPCR, rap });
+				}
+			}
+			pos += TS_PACKET_SIZE;
+		}
+	}
+
+	bool getFileState(const std::string &path, std::uint64_t &size, std::int64_t &mtime) {
+		struct stat st;
+		if (::stat(path.c_str(), &st) != 0) {
+			return false;
+		}
+		size = st.st_size;
+		mtime = st.st_mtime;
+		return true;
+	}
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+TSIndex::~TSIndex() {
+	clear();
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+std::string TSIndex::getSidecarPath(const std::string &filePath) {
+	return filePath + ".satidx";
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void TSIndex::open(const std::string &filePath) {
+	std::uint64_t fileSize;
+	std::int64_t fileMTime;
+	if (!getFileState(filePath, fileSize, fileMTime)) {
+		clear();
+		_ready = true;
+		return;
+	}
+	if (filePath == _filePath && fileSize == _fileSize && fileMTime == _fileMTime) {
+		return;
+	}
+	clear();
+	_filePath = filePath;
+	_fileSize = fileSize;
+	_fileMTime = fileMTime;
+	_thread = std::thread(&TSIndex::threadLoadOrBuild, this);
+}
+
+void TSIndex::clear() {
+	_abort = true;
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+	_abort = false;
+	_ready = false;
+	_entry.clear();
+	_filePath.clear();
+}
+
+void TSIndex::threadLoadOrBuild() {
+	const std::string sidecar = getSidecarPath(_filePath);
+	if (load(sidecar, _fileSize, _fileMTime)) {
+		SI_LOG_INFO("TS Index @#1 loaded with @#2 entries", sidecar, _entry.size());
+		_ready = true;
+		return;
+	}
+	const std::int64_t start = base::TimeCounter::getTicks();
+	build(_filePath, _fileSize);
+	if (_abort) {
+		return;
+	}
+	SI_LOG_INFO("TS Index of @#1 built with @#2 entries in @#3 ms", _filePath,
+		_entry.size(), base::TimeCounter::getTicks() - start);
+	if (!save(sidecar, _fileSize, _fileMTime)) {
+		SI_LOG_ERROR("TS Index @#1 could not be saved", sidecar);
+	}
+	_ready = true;
+}
+
+std::uint64_t TSIndex::findOffset(const std::uint64_t timeUS) const {
+	const auto it = std::upper_bound(_entry.begin(), _entry.end(), timeUS,
+		[](const std::uint64_t time, const Entry &entry) {
+			return time < entry.timeUS;
+		});
+	return (it == _entry.begin()) ? 0 : std::prev(it)->offset;
+}
+
+void TSIndex::build(const std::string &filePath, const std::uint64_t size) {
+	_entry.clear();
+	if (size < TS_PACKET_SIZE) {
+		return;
+	}
+	// Scan the file in parallel chunks, each chunk collects the events of the
+	// packets that start in it
+	const unsigned int threads = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_THREADS);
+	std::uint64_t chunkSize = std::max<std::uint64_t>(size / threads, MIN_CHUNK_SIZE);
+	chunkSize -= chunkSize % TS_PACKET_SIZE;
+	const std::size_t chunks = (size + chunkSize - 1) / chunkSize;
+	std::vector<EventVector> events(chunks);
+	std::vector<std::thread> scanners;
+	for (std::size_t i = 0; i < chunks; ++i) {
+		const std::uint64_t begin = i * chunkSize;
+		const std::uint64_t end = std::min(begin + chunkSize, size);
+		scanners.emplace_back(scanChunk, std::cref(filePath), size, begin, end,
+			std::cref(_abort), std::ref(events[i]));
+	}
+	for (std::thread &scanner : scanners) {
+		scanner.join();
+	}
+	if (_abort) {
+		return;
+	}
+
+	// The first program with a PCR is the reference clock. Prefer its random
+	// access points (usually the video), then any, else just its PCRs
+	int refPID = -1;
+	bool refHasRAP = false;
+	bool anyRAP = false;
+	for (const EventVector &chunk : events) {
+		for (const Event &event : chunk) {
+			if (refPID == -1 && event.hasPCR) {
+				refPID = event.pid;
+			}
+			anyRAP |= event.rap;
+		}
+	}
+	if (refPID == -1) {
+		return;
+	}
+	for (const EventVector &chunk : events) {
+		for (const Event &event : chunk) {
+			refHasRAP |= (event.rap && event.pid == refPID);
+		}
+	}
+
+	// Make the PCRs of the reference a continuous time, and extrapolate it
+	// with the bitrate over discontinuities
+	bool haveRef = false;
+	std::uint64_t lastPCR = 0;
+	std::uint64_t lastOffset = 0;
+	std::uint64_t ticks = 0;
+	double bitrate = 0.0;
+	_entry.push_back({ 0, 0 });
+	for (const EventVector &chunk : events) {
+		for (const Event &event : chunk) {
+			if (event.hasPCR && event.pid == refPID) {
+				if (haveRef) {
+					const std::uint64_t delta = (event.pcr + PCR_WRAP - lastPCR) % PCR_WRAP;
+					const std::uint64_t bytes = event.offset - lastOffset;
+					if (delta > 0 && delta <= MAX_PCR_GAP) {
+						bitrate = (bytes * 8.0 * PCR_HZ) / delta;
+						ticks += delta;
+					} else if (bitrate > 0.0) {
+						ticks += static_cast<std::uint64_t>((bytes * 8.0 * PCR_HZ) / bitrate);
+					}
+				}
+				haveRef = true;
+				lastPCR = event.pcr;
+				lastOffset = event.offset;
+			}
+			const bool point = refHasRAP ? (event.rap && event.pid == refPID) :
+				anyRAP ? event.rap : (event.hasPCR && event.pid == refPID);
+			if (!point || !haveRef) {
+				continue;
+			}
+			std::uint64_t timeUS = ticks / 27;
+			if (bitrate > 0.0) {
+				timeUS += static_cast<std::uint64_t>(((event.offset - lastOffset) * 8.0 * 1000000.0) / bitrate);
+			}
+			if (timeUS >= _entry.back().timeUS + MIN_ENTRY_INTERVAL_US) {
+				_entry.push_back({ timeUS, event.offset });
+			}
+		}
+	}
+	if (_entry.size() == 1) {
+		_entry.clear();
+	}
+}
+
+bool TSIndex::load(const std::string &path, const std::uint64_t fileSize, const std::int64_t fileMTime) {
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	IndexHeader header{};
+	if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != INDEX_VERSION) {
+		SI_LOG_ERROR("TS Index @#1 has an unknown format", path);
+		return false;
+	}
+	if (header.fileSize != fileSize || header.fileMTime != fileMTime) {
+		SI_LOG_INFO("TS Index @#1 is stale", path);
+		return false;
+	}
+	std::uint64_t sidecarSize;
+	std::int64_t sidecarMTime;
+	if (!getFileState(path, sidecarSize, sidecarMTime) ||
+			sidecarSize < sizeof(header) ||
+			header.count != (sidecarSize - sizeof(header)) / sizeof(Entry) ||
+			sidecarSize != sizeof(header) + header.count * sizeof(Entry)) {
+		SI_LOG_ERROR("TS Index @#1 has a wrong size", path);
+		return false;
+	}
+	_entry.resize(header.count);
+	if (!file.read(reinterpret_cast<char *>(_entry.data()), header.count * sizeof(Entry))) {
+		_entry.clear();
+		return false;
+	}
+	// Entries have to be in file order with increasing time, as found by build()
+	for (std::size_t i = 0; i < _entry.size(); ++i) {
+		if (_entry[i].offset >= fileSize || (i > 0 &&
+				(_entry[i].offset < _entry[i - 1].offset || _entry[i].timeUS < _entry[i - 1].timeUS))) {
+			SI_LOG_ERROR("TS Index @#1 has invalid entries", path);
+			_entry.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TSIndex::save(const std::string &path, const std::uint64_t fileSize, const std::int64_t fileMTime) const {
+	// Write a temporary file first, so a reader never sees half an index
+	const std::string tmpPath = path + ".tmp";
+	std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+	IndexHeader header{};
+	std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+	header.version = INDEX_VERSION;
+	header.fileSize = fileSize;
+	header.fileMTime = fileMTime;
+	header.count = _entry.size();
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(_entry.data()), _entry.size() * sizeof(Entry));
+	file.close();
+	if (!file || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+		std::remove(tmpPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+}
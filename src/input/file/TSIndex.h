@@ -0,0 +1,129 @@
+/* TSIndex.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_FILE_TSINDEX_H_INCLUDE
+#define INPUT_FILE_TSINDEX_H_INCLUDE INPUT_FILE_TSINDEX_H_INCLUDE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace input::file {
+
+/// The class @c TSIndex maps the (PCR) time of a TS file to the byte offsets
+/// of its random access points, so playing can start at a time offset.
+/// The index is built once with a parallel pass over the file and saved in
+/// a sidecar next to it (<file>.satidx), which is used again as long as the
+/// size and modification time of the file did not change.
+/// Loading or building is done on a background thread, see @c isReady().
+class TSIndex {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		TSIndex() = default;
+
+		virtual ~TSIndex();
+
+		TSIndex(const TSIndex&) = delete;
+
+		TSIndex& operator=(const TSIndex&) = delete;
+
+		// =========================================================================
+		//  -- Static member functions ---------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Get the path of the index sidecar of @c filePath
+		static std::string getSidecarPath(const std::string &filePath);
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Start loading the index sidecar of @c filePath, or building the
+		/// index from the file when there is no (valid) sidecar and saving it,
+		/// on a background thread. The index is kept while the same unchanged
+		/// file is opened again
+		void open(const std::string &filePath);
+
+		/// Stop a running load or build and forget the index
+		void clear();
+
+		/// Check if the index of the opened file is loaded or built, only then
+		/// the other getters can be used
+		bool isReady() const {
+			return _ready.load(std::memory_order_acquire);
+		}
+
+		/// Check if the file had no PCRs to index
+		bool empty() const {
+			return _entry.empty();
+		}
+
+		/// Find the offset of the last random access point at or before the
+		/// specified time
+		/// @param timeUS specifies the time since the start of the file
+		std::uint64_t findOffset(std::uint64_t timeUS) const;
+
+		/// Get the time of the last random access point
+		std::uint64_t getDurationUS() const {
+			return _entry.empty() ? 0 : _entry.back().timeUS;
+		}
+
+	private:
+
+		/// Load or build (and save) the index, runs on the background thread
+		void threadLoadOrBuild();
+
+		/// Build the index from the first @c size bytes of the TS file
+		void build(const std::string &filePath, std::uint64_t size);
+
+		///
+		bool load(const std::string &path, std::uint64_t fileSize, std::int64_t fileMTime);
+
+		///
+		bool save(const std::string &path, std::uint64_t fileSize, std::int64_t fileMTime) const;
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		struct Entry {
+			std::uint64_t timeUS;
+			std::uint64_t offset;
+		};
+		std::vector<Entry> _entry;
+		std::string _filePath;
+		std::uint64_t _fileSize = 0;
+		std::int64_t _fileMTime = 0;
+		std::thread _thread;
+		std::atomic_bool _ready{false};
+		std::atomic_bool _abort{false};
+};
+
+}
+
+#endif // INPUT_FILE_TSINDEX_H_INCLUDE
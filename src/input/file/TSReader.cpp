@@ -25,11 +25,20 @@
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
 
-#include <chrono>
-#include <thread>
+#include <algorithm>
+#include <cstring>
 
 namespace input::file {
 
+namespace {
+
+	/// The size of the blocks the kernel is asked to read ahead of us
+	constexpr std::size_t READ_AHEAD_SIZE = 4 * 1024 * 1024;
+
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+
+}
+
 // =============================================================================
 //  -- Constructors and destructor ---------------------------------------------
 // =============================================================================
@@ -64,15 +73,21 @@ void TSReader::enumerate(
 void TSReader::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "frontendname", "TS Reader");
 	ADD_XML_ELEMENT(xml, "transformation", _transform.toXML());
+	ADD_XML_NUMBER_INPUT(xml, "pacingBurst", _pacer.getBurst(), 1, mpegts::PCRPacer::MAX_BURST);
+	ADD_XML_ELEMENT(xml, "pacingBitrate", StringConverter::stringFormat("@#1 bits/s", _pacer.getBitrate()));
 
 	_deviceData.addToXML(xml);
 }
 
-void TSReader::doFromXML(const std::string &xml) {
-	std::string element;
+void TSReader::doFromXML(const base::XMLElement &xml) {
+	base::XMLElement element;
 	if (findXMLElement(xml, "transformation", element)) {
 		_transform.fromXML(element);
 	}
+	std::string value;
+	if (findXMLElement(xml, "pacingBurst.value", value)) {
+		_pacer.setBurst(std::stoi(value));
+	}
 	_deviceData.fromXML(xml);
 }
 
@@ -93,35 +108,50 @@ void TSReader::addDeliverySystemCount(
 	dvbc2 += 0;
 }
 
+void TSReader::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+	Device::addToMetrics(metrics, labels);
+	_pacer.addToMetrics(metrics, labels);
+}
+
 bool TSReader::isDataAvailable() {
-	const std::int64_t pcrDelta = _deviceData.getFilter().getPCRData()->getPCRDelta();
-	if (pcrDelta != 0) {
-		_t2 = _t1;
-		_t1 = std::chrono::steady_clock::now();
-
-		const long interval = pcrDelta - std::chrono::duration_cast<std::chrono::microseconds>(_t1 - _t2).count();
-		if (interval > 0) {
-			std::this_thread::sleep_for(std::chrono::microseconds(interval));
-		}
-		_t1 = std::chrono::steady_clock::now();
-		_deviceData.getFilter().getPCRData()->clearPCRDelta();
-	} else {
-		std::this_thread::sleep_for(std::chrono::microseconds(15));
-	}
-	return true;
+	return _pacer.waitUntilDue();
 }
 
 bool TSReader::readTSPackets(mpegts::PacketBuffer& buffer) {
-	if (!_file.is_open()) {
+	std::size_t size = 0;
+	// Jump to the time offset when the index is ready, between two buffers
+	if (_pendingSeekUS >= 0 && _index.isReady() && buffer.empty()) {
+		const std::int64_t timeUS = _pendingSeekUS;
+		_pendingSeekUS = -1;
+		seekToTime(timeUS);
+		_pacer.reset();
+	}
+	if (_mappedFile.isOpen()) {
+		size = _mappedFile.read(_position, buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
+		if (size > 0) {
+			_position += size;
+			// Keep the kernel reading ahead of us, in large blocks
+			if (_position + (READ_AHEAD_SIZE / 2) >= _readAhead) {
+				_mappedFile.willNeed(_readAhead, READ_AHEAD_SIZE);
+				_readAhead += READ_AHEAD_SIZE;
+			}
+		}
+	} else if (_file.is_open()) {
+		_file.read(reinterpret_cast<char *>(buffer.getWriteBufferPtr()),
+				buffer.getAmountOfBytesToWrite());
+		size = (_file.gcount() > 0) ? _file.gcount() : 0;
+	} else {
 		return false;
 	}
-	_file.read(reinterpret_cast<char *>(buffer.getWriteBufferPtr()),
-			buffer.getAmountOfBytesToWrite());
-	if (_file.gcount() > 0) {
-		buffer.addAmountOfBytesWritten(_file.gcount());
+	if (size > 0) {
+		captureRead(buffer.getWriteBufferPtr(), size);
+		buffer.addAmountOfBytesWritten(size);
 		buffer.trySyncing();
 		// Add data to Filter
 		_deviceData.getFilter().filterData(_feID, buffer, false);
+		if (buffer.full()) {
+			_pacer.addBuffer(buffer);
+		}
 	}
 	// Check again if buffer is full
 	return buffer.full();
@@ -170,17 +200,28 @@ bool TSReader::update() {
 	SI_LOG_INFO("Frontend: @#1, Updating frontend...", _feID);
 	if (_deviceData.hasDeviceFrequencyChanged()) {
 		_deviceData.resetDeviceFrequencyChanged();
+		_mappedFile.close();
 		_file.close();
-		if (!_file.is_open()) {
-			const std::string filePath = _deviceData.getFilePath();
+		_pendingSeekUS = -1;
+		const std::string filePath = _deviceData.getFilePath();
+		if (_mappedFile.open(filePath)) {
+			_position = 0;
+			_readAhead = READ_AHEAD_SIZE;
+			_mappedFile.willNeed(0, READ_AHEAD_SIZE);
+		} else {
 			_file.open(filePath, std::ifstream::binary | std::ifstream::in);
-			if (_file.is_open()) {
-				SI_LOG_INFO("Frontend: @#1, TS Reader using path: @#2", _feID, filePath);
-				_t1 = std::chrono::steady_clock::now();
-				_t2 = _t1;
-			} else {
-				SI_LOG_ERROR("Frontend: @#1, TS Reader unable to open path: @#2", _feID, filePath);
+		}
+		if (isFileOpen()) {
+			SI_LOG_INFO("Frontend: @#1, TS Reader using path: @#2 (@#3)", _feID, filePath,
+				_mappedFile.isOpen() ? "mapped" : "stream");
+			std::int64_t offset;
+			std::int64_t timeUS;
+			if (_deviceData.takeSeekRequest(offset, timeUS)) {
+				seek(offset, timeUS);
 			}
+			_pacer.reset();
+		} else {
+			SI_LOG_ERROR("Frontend: @#1, TS Reader unable to open path: @#2", _feID, filePath);
 		}
 	}
 	SI_LOG_DEBUG("Frontend: @#1, Updating frontend (Finished)", _feID);
@@ -190,12 +231,14 @@ bool TSReader::update() {
 bool TSReader::teardown() {
 	_deviceData.initialize();
 	_transform.resetTransformFlag();
+	_mappedFile.close();
 	_file.close();
+	_pendingSeekUS = -1;
 	return true;
 }
 
 std::string TSReader::attributeDescribeString() const {
-	if (_file.is_open()) {
+	if (isFileOpen()) {
 		const DeviceData &data = _transform.transformDeviceData(_deviceData);
 		return data.attributeDescribeString(_feID);
 	}
@@ -206,4 +249,43 @@ std::string TSReader::attributeDescribeString() const {
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
 
+void TSReader::seek(const std::int64_t offset, const std::int64_t timeUS) {
+	if (!_mappedFile.isOpen()) {
+		SI_LOG_ERROR("Frontend: @#1, TS Reader unable to seek in a stream", _feID);
+		return;
+	}
+	if (offset >= 0) {
+		seekToPosition(offset - (offset % TS_PACKET_SIZE), timeUS);
+		return;
+	}
+	_index.open(_deviceData.getFilePath());
+	if (_index.isReady()) {
+		seekToTime(timeUS);
+	} else {
+		_pendingSeekUS = timeUS;
+		SI_LOG_INFO("Frontend: @#1, TS Reader seek to @#2 ms waits for the index, reading from the start",
+			_feID, timeUS / 1000);
+	}
+}
+
+void TSReader::seekToTime(const std::int64_t timeUS) {
+	if (_index.empty()) {
+		SI_LOG_ERROR("Frontend: @#1, TS Reader unable to seek, no PCRs to index", _feID);
+		return;
+	}
+	seekToPosition(_index.findOffset(timeUS), timeUS);
+}
+
+void TSReader::seekToPosition(const std::uint64_t position, const std::int64_t timeUS) {
+	if (position >= _mappedFile.size()) {
+		SI_LOG_ERROR("Frontend: @#1, TS Reader unable to seek beyond the end (@#2)", _feID, position);
+		return;
+	}
+	_position = position;
+	_readAhead = position + READ_AHEAD_SIZE;
+	_mappedFile.willNeed(position, READ_AHEAD_SIZE);
+	SI_LOG_INFO("Frontend: @#1, TS Reader seek to @#2 ms at offset @#3", _feID,
+		(timeUS >= 0) ? timeUS / 1000 : -1, position);
+}
+
 }
@@ -21,12 +21,14 @@
 #define INPUT_FILE_TSREADER_H_INCLUDE INPUT_FILE_TSREADER_H_INCLUDE
 
 #include <FwDecl.h>
+#include <base/MappedFile.h>
 #include <input/Device.h>
 #include <input/Transformation.h>
+#include <input/file/TSIndex.h>
 #include <input/file/TSReaderData.h>
+#include <mpegts/PCRPacer.h>
 
 #include <string>
-#include <chrono>
 #include <fstream>
 
 FW_DECL_SP_NS2(input, file, TSReader);
@@ -35,9 +37,15 @@ FW_DECL_VECTOR_OF_SP_NS0(Stream);
 
 namespace input::file {
 
-/// The class @c TSReader is for reading from an TS files as input device
+/// The class @c TSReader is for reading from an TS files as input device.
+/// A regular file is memory mapped and read ahead in large blocks, other
+/// files (like a FIFO) are read with a stream.
 /// Some example for opening a TS file:
 /// http://ip.of.your.box:8875/?msys=file&uri="test.ts"
+/// A regular file can be started at a time offset in seconds (with the
+/// help of a @c TSIndex), or with a 'Range: bytes=<offset>-' or
+/// 'Range: npt=<sec>-' header:
+/// http://ip.of.your.box:8875/?msys=file&uri="test.ts"&seek=600
 class TSReader :
 	public input::Device {
 		// =========================================================================
@@ -72,7 +80,7 @@ class TSReader :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 
 		// =========================================================================
@@ -87,6 +95,8 @@ class TSReader :
 			std::size_t &dvbc,
 			std::size_t &dvbc2) final;
 
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) final;
+
 		virtual bool isDataAvailable() final;
 
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
@@ -118,20 +128,44 @@ class TSReader :
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
-	protected:
+	private:
+
+		/// Check if there is a file opened
+		bool isFileOpen() const {
+			return _mappedFile.isOpen() || _file.is_open();
+		}
+
+		/// Continue reading the mapped file from the requested position. A time
+		/// offset waits for the index, until then the file is read from the start
+		/// @param offset specifies the byte offset, or -1 to use @c timeUS
+		/// @param timeUS specifies the time offset
+		void seek(std::int64_t offset, std::int64_t timeUS);
+
+		/// Continue reading the mapped file from the time offset, with the index
+		/// that is ready
+		void seekToTime(std::int64_t timeUS);
+
+		/// Continue reading the mapped file from @c position
+		void seekToPosition(std::uint64_t position, std::int64_t timeUS);
 
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
 	private:
 
+		base::MappedFile _mappedFile;
+		std::uint64_t _position = 0;
+		/// The offset up until the kernel is asked to read ahead
+		std::uint64_t _readAhead = 0;
 		std::ifstream _file;
+		TSIndex _index;
+		/// The time offset that waits for the index, or -1
+		std::int64_t _pendingSeekUS = -1;
 		TSReaderData _deviceData;
 		input::Transformation _transform;
 		const bool _enableUnsecureFrontends;
 
-		std::chrono::steady_clock::time_point _t1;
-		std::chrono::steady_clock::time_point _t2;
+		mpegts::PCRPacer _pacer;
 };
 
 }
@@ -24,8 +24,19 @@
 #include <StringConverter.h>
 #include <TransportParamVector.h>
 
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
 namespace input::file {
 
+namespace {
+
+	/// A larger time offset is ignored, it would overflow the time in us
+	constexpr double MAX_SEEK_SEC = 1000000000.0;
+
+}
+
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
 // =============================================================================
@@ -44,20 +55,25 @@ void TSReaderData::doNextAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "pathname", _filePath);
 }
 
-void TSReaderData::doNextFromXML(const std::string &UNUSED(xml)) {}
+void TSReaderData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 void TSReaderData::doInitialize() {
 	_filePath = "None";
+	_seekOffset = -1;
+	_seekTimeUS = -1;
 }
 
 void TSReaderData::doParseStreamString(const FeID UNUSED(id), const TransportParamVector& params) {
 	const std::string filePath = params.getURIParameter("uri");
-	if (filePath.empty() || (hasFilePath() && filePath == _filePath)) {
+	if (filePath.empty()) {
 		return;
 	}
-	initialize();
-	_frequencyChanged = true;
-	_filePath = filePath;
+	if (!hasFilePath() || filePath != _filePath) {
+		initialize();
+		_frequencyChanged = true;
+		_filePath = filePath;
+	}
+	parseSeekRequest(params);
 }
 
 std::string TSReaderData::doAttributeDescribeString(const FeID id) const {
@@ -83,4 +99,42 @@ bool TSReaderData::hasFilePath() const {
 	return _filePath != "None";
 }
 
+bool TSReaderData::takeSeekRequest(std::int64_t &offset, std::int64_t &timeUS) {
+	base::MutexLock lock(_mutex);
+	offset = _seekOffset;
+	timeUS = _seekTimeUS;
+	_seekOffset = -1;
+	_seekTimeUS = -1;
+	return offset > 0 || timeUS > 0;
+}
+
+void TSReaderData::parseSeekRequest(const TransportParamVector& params) {
+	// The values come from the client, so ignore what is out of range
+	double seek = params.getDoubleParameter("seek");
+	const std::string range = params.getParameter("range");
+	if (range.compare(0, 6, "bytes=") == 0 && std::isdigit(range[6])) {
+		errno = 0;
+		const long long offset = std::strtoll(range.c_str() + 6, nullptr, 10);
+		if (errno != ERANGE) {
+			_seekOffset = offset;
+		}
+	} else if (range.compare(0, 4, "npt=") == 0 && std::isdigit(range[4])) {
+		errno = 0;
+		seek = std::strtod(range.c_str() + 4, nullptr);
+		if (errno == ERANGE) {
+			seek = -1.0;
+		}
+	}
+	if (seek > 0.0 && seek < MAX_SEEK_SEC) {
+		_seekTimeUS = static_cast<std::int64_t>(seek * 1000000.0);
+	}
+	// Start from the beginning (or 'now') is not a seek
+	if (_seekOffset > 0 || _seekTimeUS > 0) {
+		_frequencyChanged = true;
+	} else {
+		_seekOffset = -1;
+		_seekTimeUS = -1;
+	}
+}
+
 }
@@ -22,6 +22,7 @@
 
 #include <input/DeviceData.h>
 
+#include <cstdint>
 #include <string>
 
 namespace input::file {
@@ -48,7 +49,7 @@ class TSReaderData :
 		virtual void doNextAddToXML(std::string &xml) const final;
 
 		/// @see DeviceData
-		virtual void doNextFromXML(const std::string &xml) final;
+		virtual void doNextFromXML(const base::XMLElement &xml) final;
 
 		/// @see DeviceData
 		virtual void doInitialize() final;
@@ -69,12 +70,27 @@ class TSReaderData :
 
 		bool hasFilePath() const;
 
+		/// Get and clear the requested start position of the file
+		/// @param offset will be the requested byte offset, or -1
+		/// @param timeUS will be the requested time offset, or -1
+		/// @return true if a start position was requested
+		bool takeSeekRequest(std::int64_t &offset, std::int64_t &timeUS);
+
+	private:
+
+		/// Parse the requested start position, from the 'seek=<sec>' parameter
+		/// or a (translated) 'Range: bytes=<offset>-' or 'Range: npt=<sec>-'
+		/// header
+		void parseSeekRequest(const TransportParamVector& params);
+
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
 	private:
 
 		std::string _filePath;
+		std::int64_t _seekOffset;
+		std::int64_t _seekTimeUS;
 
 };
 
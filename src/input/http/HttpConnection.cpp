@@ -0,0 +1,561 @@
+/* HttpConnection.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+ */
+#include <input/http/HttpConnection.h>
+
+#include <Log.h>
+#include <Utils.h>
+#include <StringConverter.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace input::http {
+
+// =============================================================================
+//  -- Static constexpr variables ----------------------------------------------
+// =============================================================================
+
+/// The size of the blocks received from the connection
+static constexpr std::size_t BLOCK_SIZE = 256 * 1024;
+
+/// The back-off between reconnects, doubled every failed attempt
+static constexpr std::chrono::milliseconds INITIAL_BACKOFF(250);
+static constexpr std::chrono::milliseconds MAX_BACKOFF(5000);
+
+// =============================================================================
+//  -- Static functions --------------------------------------------------------
+// =============================================================================
+
+static bool equalsIgnoreCase(const std::string_view a, const std::string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+		[](const char c1, const char c2) {
+			return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+		});
+}
+
+static bool containsIgnoreCase(const std::string_view str, const std::string_view find) {
+	return std::search(str.begin(), str.end(), find.begin(), find.end(),
+		[](const char c1, const char c2) {
+			return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+		}) != str.end();
+}
+
+static std::string_view trim(std::string_view str) {
+	while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+		str.remove_prefix(1);
+	}
+	while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+		str.remove_suffix(1);
+	}
+	return str;
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+HttpConnection::HttpConnection() :
+	_block(BLOCK_SIZE),
+	_backoff(INITIAL_BACKOFF) {}
+
+HttpConnection::~HttpConnection() {
+	close();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool HttpConnection::open(const std::string &url) {
+	close();
+	if (!parseURL(url)) {
+		SI_LOG_ERROR("HTTP Reader: unable to use URL: @#1 (only http:// is supported)", url);
+		return false;
+	}
+	_url = url;
+	_opened = true;
+	_redirects = 0;
+	_backoff = INITIAL_BACKOFF;
+	if (!connect()) {
+		scheduleReconnect();
+	}
+	return true;
+}
+
+void HttpConnection::close() {
+	CLOSE_FD(_fd);
+	_opened = false;
+	_state = State::CLOSED;
+	_begin = 0;
+	_end = 0;
+}
+
+bool HttpConnection::waitForData(const int timeoutMS) {
+	switch (_state.load()) {
+		case State::CLOSED:
+			return false;
+		case State::WAIT_RECONNECT: {
+				const Clock::time_point now = Clock::now();
+				if (now < _reconnectTime) {
+					std::this_thread::sleep_for(std::min<Clock::duration>(_reconnectTime - now,
+						std::chrono::milliseconds(timeoutMS)));
+					return false;
+				}
+				_reconnects.add();
+				if (!connect()) {
+					scheduleReconnect();
+				}
+				return false;
+			}
+		default:
+			break;
+	}
+	// Is there still something to parse or consume
+	if (!_needData && _begin < _end) {
+		return true;
+	}
+	const bool connecting = _state == State::CONNECTING;
+	struct pollfd pfd;
+	pfd.fd = _fd;
+	pfd.events = connecting ? POLLOUT : POLLIN;
+	pfd.revents = 0;
+	if (::poll(&pfd, 1, timeoutMS) <= 0) {
+		return false;
+	}
+	if (connecting) {
+		int error = 0;
+		socklen_t len = sizeof(error);
+		if (::getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &len) == -1 || error != 0) {
+			SI_LOG_ERROR("HTTP Reader: unable to connect to @#1:@#2 (@#3)", _host, _port, std::strerror(error));
+			scheduleReconnect();
+		} else if (!sendRequest()) {
+			scheduleReconnect();
+		}
+		return false;
+	}
+	return true;
+}
+
+std::size_t HttpConnection::getBodyData(const unsigned char *&data) {
+	bool received = false;
+	for (;;) {
+		switch (_state.load()) {
+			case State::BODY:
+				if (_begin < _end) {
+					std::size_t size = _end - _begin;
+					if (_remaining >= 0) {
+						size = std::min<std::size_t>(size, _remaining);
+					}
+					if (!_firstByte) {
+						_firstByte = true;
+						_firstByteMS.observe(std::chrono::duration_cast<std::chrono::milliseconds>(
+							Clock::now() - _connectTime).count());
+						_backoff = INITIAL_BACKOFF;
+						_redirects = 0;
+					}
+					data = _block.data() + _begin;
+					return size;
+				}
+				break;
+			case State::HEADERS:
+				if (parseHeaders()) {
+					continue;
+				}
+				break;
+			case State::CHUNK_SIZE:
+			case State::CHUNK_TRAILER:
+				if (parseChunkLine()) {
+					continue;
+				}
+				break;
+			default:
+				return 0;
+		}
+		// Parsing failed and the connection was closed, or more data is
+		// needed (receive only once, so we do not block the caller)
+		if (_fd == -1 || received || !receive()) {
+			return 0;
+		}
+		received = true;
+	}
+}
+
+void HttpConnection::consumeBodyData(const std::size_t size) {
+	_begin += size;
+	_bodySize += size;
+	if (_remaining > 0) {
+		_remaining -= size;
+		if (_remaining == 0) {
+			if (_chunked) {
+				_state = State::CHUNK_SIZE;
+			} else {
+				endOfBody();
+			}
+		}
+	}
+}
+
+std::string HttpConnection::getStateString() const {
+	switch (_state.load()) {
+		case State::CLOSED:
+			return "Closed";
+		case State::WAIT_RECONNECT:
+			return "Waiting to reconnect";
+		case State::CONNECTING:
+			return "Connecting";
+		case State::HEADERS:
+			return "Requested";
+		case State::BODY:
+		case State::CHUNK_SIZE:
+		case State::CHUNK_TRAILER:
+			return "Streaming";
+		default:
+			return "Unknown";
+	}
+}
+
+void HttpConnection::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const {
+	metrics.addCounter("satpi_http_input_connects_total",
+		"Connections made to the HTTP source", labels, _connects.get());
+	metrics.addCounter("satpi_http_input_reconnects_total",
+		"Reconnects to the HTTP source after the connection was lost", labels, _reconnects.get());
+	metrics.addCounter("satpi_http_input_redirects_total",
+		"Redirects followed to the HTTP source", labels, _redirected.get());
+	metrics.addCounter("satpi_http_input_requests_total",
+		"GET requests send to the HTTP source", labels, _requests.get());
+	metrics.addCounter("satpi_http_input_received_bytes_total",
+		"Bytes received from the HTTP source", labels, _bytes.get());
+	metrics.addHistogram("satpi_http_input_read_bytes",
+		"Size of the reads from the HTTP source", labels, _readSize);
+	metrics.addHistogram("satpi_http_input_first_byte_milliseconds",
+		"Time from connecting until the first body byte of the HTTP source", labels, _firstByteMS);
+}
+
+bool HttpConnection::parseURL(const std::string &url) {
+	static constexpr std::string_view SCHEME("http://");
+	if (url.size() <= SCHEME.size() || !equalsIgnoreCase(std::string_view(url).substr(0, SCHEME.size()), SCHEME)) {
+		return false;
+	}
+	const std::string::size_type hostBegin = SCHEME.size();
+	std::string::size_type hostEnd = url.find_first_of("/?", hostBegin);
+	if (hostEnd == std::string::npos) {
+		hostEnd = url.size();
+	}
+	std::string hostPort = url.substr(hostBegin, hostEnd - hostBegin);
+	// Skip user info, we do not support authentication
+	const std::string::size_type at = hostPort.rfind('@');
+	if (at != std::string::npos) {
+		hostPort.erase(0, at + 1);
+	}
+	std::string::size_type colon = hostPort.rfind(':');
+	if (!hostPort.empty() && hostPort[0] == '[') {
+		// IPv6 literal like [::1]:8080
+		const std::string::size_type bracket = hostPort.find(']');
+		if (bracket == std::string::npos) {
+			return false;
+		}
+		_host = hostPort.substr(1, bracket - 1);
+		colon = (bracket + 1 < hostPort.size() && hostPort[bracket + 1] == ':') ? bracket + 1 : std::string::npos;
+	} else {
+		_host = hostPort.substr(0, colon);
+	}
+	_port = (colon != std::string::npos) ? hostPort.substr(colon + 1) : "80";
+	_path = (hostEnd < url.size()) ? url.substr(hostEnd) : "/";
+	if (_path[0] != '/') {
+		_path.insert(0, 1, '/');
+	}
+	return !_host.empty() && !_port.empty();
+}
+
+std::string HttpConnection::resolveLocation(const std::string &location) const {
+	// Absolute URL, or one without a scheme like //host/path
+	const std::string::size_type scheme = location.find("://");
+	if (scheme != std::string::npos && scheme < location.find_first_of("/?")) {
+		return location;
+	}
+	if (location.compare(0, 2, "//") == 0) {
+		return "http:" + location;
+	}
+	const std::string host = (_host.find(':') != std::string::npos) ?
+		StringConverter::stringFormat("[@#1]", _host) : _host;
+	const std::string origin = StringConverter::stringFormat("http://@#1:@#2", host, _port);
+	if (location[0] == '/') {
+		return origin + location;
+	}
+	// Relative to the path of the current request, without its query
+	const std::string path = _path.substr(0, _path.find('?'));
+	if (location[0] == '?') {
+		return origin + path + location;
+	}
+	return origin + path.substr(0, path.rfind('/') + 1) + location;
+}
+
+bool HttpConnection::connect() {
+	CLOSE_FD(_fd);
+	_begin = 0;
+	_end = 0;
+	_needData = false;
+
+	struct addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	struct addrinfo *result = nullptr;
+	const int error = ::getaddrinfo(_host.data(), _port.data(), &hints, &result);
+	if (error != 0) {
+		SI_LOG_ERROR("HTTP Reader: unable to resolve @#1 (@#2)", _host, ::gai_strerror(error));
+		return false;
+	}
+	for (struct addrinfo *addr = result; addr != nullptr; addr = addr->ai_next) {
+		_fd = ::socket(addr->ai_family, addr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addr->ai_protocol);
+		if (_fd == -1) {
+			continue;
+		}
+		if (::connect(_fd, addr->ai_addr, addr->ai_addrlen) == 0 || errno == EINPROGRESS) {
+			break;
+		}
+		CLOSE_FD(_fd);
+	}
+	::freeaddrinfo(result);
+	if (_fd == -1) {
+		SI_LOG_ERROR("HTTP Reader: unable to connect to @#1:@#2", _host, _port);
+		return false;
+	}
+	_connects.add();
+	_connectTime = Clock::now();
+	_firstByte = false;
+	_state = State::CONNECTING;
+	return true;
+}
+
+void HttpConnection::scheduleReconnect() {
+	CLOSE_FD(_fd);
+	_begin = 0;
+	_end = 0;
+	// Forget the redirects, they may have been temporary
+	parseURL(_url);
+	_redirects = 0;
+	_state = State::WAIT_RECONNECT;
+	_reconnectTime = Clock::now() + _backoff;
+	SI_LOG_INFO("HTTP Reader: reconnecting to @#1:@#2 in @#3 ms", _host, _port, _backoff.count());
+	_backoff = std::min(_backoff * 2, MAX_BACKOFF);
+}
+
+bool HttpConnection::sendRequest() {
+	const std::string host = (_host.find(':') != std::string::npos) ?
+		StringConverter::stringFormat("[@#1]", _host) : _host;
+	const std::string request = StringConverter::stringFormat(
+		"GET @#1 HTTP/1.1\r\n" \
+		"Host: @#2@#3\r\n" \
+		"User-Agent: SatPI\r\n" \
+		"Accept: */*\r\n" \
+		"Connection: keep-alive\r\n" \
+		"\r\n",
+		_path, host, (_port == "80") ? "" : ":" + _port);
+	// The request is small, so it fits in the socket buffer at once
+	const ssize_t size = ::send(_fd, request.data(), request.size(), MSG_NOSIGNAL);
+	if (size != static_cast<ssize_t>(request.size())) {
+		SI_LOG_PERROR("HTTP Reader: send request to @#1:@#2", _host, _port);
+		return false;
+	}
+	_requests.add();
+	_state = State::HEADERS;
+	return true;
+}
+
+bool HttpConnection::receive() {
+	// Move the unparsed data to the front, so there is room for a block
+	if (_begin > 0) {
+		std::memmove(_block.data(), _block.data() + _begin, _end - _begin);
+		_end -= _begin;
+		_begin = 0;
+	}
+	if (_end == _block.size()) {
+		SI_LOG_ERROR("HTTP Reader: response header from @#1:@#2 too large", _host, _port);
+		scheduleReconnect();
+		return false;
+	}
+	const ssize_t size = ::recv(_fd, _block.data() + _end, _block.size() - _end, 0);
+	if (size > 0) {
+		_end += size;
+		_needData = false;
+		_readSize.observe(size);
+		_bytes.add(size);
+		return true;
+	} else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+		_needData = true;
+		return false;
+	} else if (size < 0) {
+		SI_LOG_PERROR("HTTP Reader: receive from @#1:@#2", _host, _port);
+	} else {
+		SI_LOG_INFO("HTTP Reader: connection closed by @#1:@#2", _host, _port);
+	}
+	scheduleReconnect();
+	return false;
+}
+
+bool HttpConnection::parseHeaders() {
+	const std::string_view view(reinterpret_cast<const char *>(_block.data() + _begin), _end - _begin);
+	const std::string_view::size_type headerEnd = view.find("\r\n\r\n");
+	if (headerEnd == std::string_view::npos) {
+		_needData = true;
+		return false;
+	}
+	_begin += headerEnd + 4;
+
+	// Status line like 'HTTP/1.1 200 OK'
+	std::string_view::size_type lineEnd = view.find("\r\n");
+	const std::string_view statusLine = view.substr(0, lineEnd);
+	if (statusLine.size() < 12 || statusLine.substr(0, 7) != "HTTP/1.") {
+		SI_LOG_ERROR("HTTP Reader: invalid response from @#1:@#2", _host, _port);
+		scheduleReconnect();
+		return false;
+	}
+	const int status = std::atoi(std::string(statusLine.substr(9, 3)).data());
+	_keepAlive = statusLine[7] != '0';
+	_chunked = false;
+	_remaining = -1;
+	_bodySize = 0;
+	std::string location;
+	while (lineEnd < headerEnd) {
+		const std::string_view::size_type lineBegin = lineEnd + 2;
+		lineEnd = view.find("\r\n", lineBegin);
+		const std::string_view line = view.substr(lineBegin, lineEnd - lineBegin);
+		const std::string_view::size_type colon = line.find(':');
+		if (colon == std::string_view::npos) {
+			continue;
+		}
+		const std::string_view name = trim(line.substr(0, colon));
+		const std::string_view value = trim(line.substr(colon + 1));
+		if (equalsIgnoreCase(name, "Content-Length")) {
+			_remaining = std::strtoll(std::string(value).data(), nullptr, 10);
+		} else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+			_chunked = containsIgnoreCase(value, "chunked");
+		} else if (equalsIgnoreCase(name, "Connection")) {
+			if (containsIgnoreCase(value, "close")) {
+				_keepAlive = false;
+			} else if (containsIgnoreCase(value, "keep-alive")) {
+				_keepAlive = true;
+			}
+		} else if (equalsIgnoreCase(name, "Location")) {
+			location = value;
+		}
+	}
+
+	if ((status == 301 || status == 302 || status == 303 || status == 307 || status == 308) &&
+			!location.empty()) {
+		if (++_redirects > MAX_REDIRECTS) {
+			SI_LOG_ERROR("HTTP Reader: too many redirects for @#1", _url);
+			scheduleReconnect();
+			return false;
+		}
+		const std::string url = resolveLocation(location);
+		if (!parseURL(url)) {
+			SI_LOG_ERROR("HTTP Reader: unable to follow redirect to @#1", location);
+			scheduleReconnect();
+			return false;
+		}
+		SI_LOG_INFO("HTTP Reader: redirected to @#1", url);
+		_redirected.add();
+		if (!connect()) {
+			scheduleReconnect();
+		}
+		return false;
+	}
+	if (status < 200 || status > 299 || status == 204) {
+		SI_LOG_ERROR("HTTP Reader: @#1 responded with: @#2", _url, statusLine);
+		scheduleReconnect();
+		return false;
+	}
+	if (_chunked) {
+		_remaining = 0;
+		_state = State::CHUNK_SIZE;
+	} else {
+		_state = State::BODY;
+		if (_remaining == 0) {
+			endOfBody();
+		}
+	}
+	return true;
+}
+
+bool HttpConnection::parseChunkLine() {
+	const std::string_view view(reinterpret_cast<const char *>(_block.data() + _begin), _end - _begin);
+	const std::string_view::size_type lineEnd = view.find("\r\n");
+	if (lineEnd == std::string_view::npos) {
+		_needData = true;
+		return false;
+	}
+	const std::string_view line = view.substr(0, lineEnd);
+	_begin += lineEnd + 2;
+	if (_state == State::CHUNK_TRAILER) {
+		// The trailer ends with an empty line
+		if (line.empty()) {
+			endOfBody();
+		}
+		return true;
+	}
+	// Skip the line end after the data of the previous chunk
+	if (line.empty()) {
+		return true;
+	}
+	const std::string sizeStr(line.substr(0, line.find(';')));
+	char *sizeEnd = nullptr;
+	const std::int64_t size = std::strtoll(sizeStr.data(), &sizeEnd, 16);
+	if (sizeEnd == sizeStr.data() || size < 0) {
+		SI_LOG_ERROR("HTTP Reader: invalid chunk from @#1:@#2", _host, _port);
+		scheduleReconnect();
+		return false;
+	}
+	if (size == 0) {
+		_state = State::CHUNK_TRAILER;
+	} else {
+		_remaining = size;
+		_state = State::BODY;
+	}
+	return true;
+}
+
+void HttpConnection::endOfBody() {
+	// Request it again on the same connection, but do not hammer a source
+	// that returns an empty body
+	if (_keepAlive && _bodySize > 0) {
+		SI_LOG_DEBUG("HTTP Reader: end of body from @#1, requesting it again", _url);
+		_begin = 0;
+		_end = 0;
+		if (!sendRequest()) {
+			scheduleReconnect();
+		}
+	} else {
+		SI_LOG_INFO("HTTP Reader: end of body from @#1", _url);
+		scheduleReconnect();
+	}
+}
+
+}
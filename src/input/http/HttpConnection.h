@@ -0,0 +1,194 @@
+/* HttpConnection.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_HTTP_HTTP_CONNECTION_H_INCLUDE
+#define INPUT_HTTP_HTTP_CONNECTION_H_INCLUDE INPUT_HTTP_HTTP_CONNECTION_H_INCLUDE
+
+#include <base/Metrics.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace input::http {
+
+/// The class @c HttpConnection pulls the body of an HTTP/1.1 GET request
+/// over a non-blocking TCP connection. The body is received in large blocks
+/// and handed out without copying. When the body ends the request is done
+/// again on the same (keep-alive) connection, when the connection is lost
+/// it is reconnected with an increasing back-off. Redirects are followed
+/// for this connection only, a reconnect starts at the requested URL again.
+class HttpConnection {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		HttpConnection();
+
+		virtual ~HttpConnection();
+
+		HttpConnection(const HttpConnection&) = delete;
+
+		HttpConnection& operator=(const HttpConnection&) = delete;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Start pulling from the requested URL, like http://host:port/path
+		/// @return false if the URL can not be used
+		bool open(const std::string &url);
+
+		/// Stop pulling and close the connection
+		void close();
+
+		/// Is there an URL we are pulling from (connected or not)
+		bool isOpen() const {
+			return _opened;
+		}
+
+		/// Wait for data on the connection, this also takes care of
+		/// (re)connecting and sending the request.
+		/// @return true if there is data to receive or body data available
+		bool waitForData(int timeoutMS);
+
+		/// Get the body data that is received but not consumed yet. Receives
+		/// the next block and handles the response headers and chunks, when
+		/// everything is consumed.
+		/// @param data will point to the available body data
+		/// @return the amount of body data available, 0 if nothing is available
+		std::size_t getBodyData(const unsigned char *&data);
+
+		/// Consume @c size bytes of the body data from @c getBodyData
+		void consumeBodyData(std::size_t size);
+
+		/// Is the body of the response being received
+		bool isStreaming() const {
+			const State state = _state;
+			return state == State::BODY || state == State::CHUNK_SIZE || state == State::CHUNK_TRAILER;
+		}
+
+		/// Get the state of the connection as readable string
+		std::string getStateString() const;
+
+		///
+		void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const;
+
+	private:
+
+		/// Split the URL in host, port and path
+		bool parseURL(const std::string &url);
+
+		/// Resolve the Location of a redirect against the current request
+		/// @return the absolute URL to follow
+		std::string resolveLocation(const std::string &location) const;
+
+		/// Resolve the host and start the non-blocking connect
+		bool connect();
+
+		/// Close the socket and schedule a reconnect with back-off
+		void scheduleReconnect();
+
+		/// Send the GET request for the path
+		bool sendRequest();
+
+		/// Receive the next block from the socket (after the unparsed data)
+		/// @return false if the connection is closed or in error
+		bool receive();
+
+		/// Parse the response headers
+		/// @return false if more data is needed, or the response is not usable
+		bool parseHeaders();
+
+		/// Parse a chunk size line or the trailer of a chunked body
+		/// @return false if more data is needed
+		bool parseChunkLine();
+
+		/// The body of the response ended
+		void endOfBody();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	public:
+
+		/// The maximum amount of redirects that is followed
+		static constexpr int MAX_REDIRECTS = 3;
+
+	private:
+
+		enum class State {
+			CLOSED,
+			WAIT_RECONNECT,
+			CONNECTING,
+			HEADERS,
+			BODY,
+			CHUNK_SIZE,
+			CHUNK_TRAILER
+		};
+
+		using Clock = std::chrono::steady_clock;
+
+		int _fd = -1;
+		bool _opened = false;
+		std::atomic<State> _state{State::CLOSED};
+		std::string _url;
+		std::string _host;
+		std::string _port;
+		std::string _path;
+		bool _keepAlive = true;
+		int _redirects = 0;
+
+		/// The received block and the part that is not parsed/consumed yet
+		std::vector<unsigned char> _block;
+		std::size_t _begin = 0;
+		std::size_t _end = 0;
+		/// The unparsed data is not complete, wait for more
+		bool _needData = false;
+
+		/// Body bytes left of the Content-Length or chunk, or -1 if the body
+		/// ends when the connection is closed
+		std::int64_t _remaining = -1;
+		bool _chunked = false;
+		std::uint64_t _bodySize = 0;
+
+		std::chrono::milliseconds _backoff;
+		Clock::time_point _reconnectTime;
+		Clock::time_point _connectTime;
+		bool _firstByte = false;
+
+		base::Counter _connects;
+		base::Counter _reconnects;
+		base::Counter _redirected;
+		base::Counter _requests;
+		base::Counter _bytes;
+		base::Histogram _readSize{ 1316, 4096, 16384, 65536, 131072, 262144 };
+		base::Histogram _firstByteMS{ 5, 10, 25, 50, 100, 250, 500, 1000, 2500 };
+};
+
+}
+
+#endif // INPUT_HTTP_HTTP_CONNECTION_H_INCLUDE
@@ -0,0 +1,244 @@
+/* TSReader.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+ */
+#include <input/http/TSReader.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <Stream.h>
+#include <StringConverter.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace input::http {
+
+// =============================================================================
+//  -- Static constexpr variables ----------------------------------------------
+// =============================================================================
+
+/// The maximum time to wait for data in @c isDataAvailable, so the writer
+/// of the stream still gets called regularly
+static constexpr int MAX_WAIT_MS = 100;
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+TSReader::TSReader(
+		FeIndex index,
+		const std::string &appDataPath,
+		const bool enableUnsecureFrontends) :
+		Device(index),
+		_transform(appDataPath, input::InputSystem::HTTP),
+		_enableUnsecureFrontends(enableUnsecureFrontends) {}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void TSReader::enumerate(
+		StreamSpVector &streamVector,
+		const std::string &appDataPath,
+		const bool enableUnsecureFrontends) {
+	SI_LOG_INFO("Setting up HTTP - TS Reader using path: @#1", appDataPath);
+	const StreamSpVector::size_type size = streamVector.size();
+	const input::http::SpTSReader tsreader =
+		std::make_shared<input::http::TSReader>(size, appDataPath, enableUnsecureFrontends);
+	streamVector.push_back(Stream::makeSP(tsreader, nullptr));
+}
+
+// =============================================================================
+//  -- base::XMLSupport --------------------------------------------------------
+// =============================================================================
+
+void TSReader::doAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "frontendname", "HTTP - TS Reader");
+	ADD_XML_ELEMENT(xml, "transformation", _transform.toXML());
+	ADD_XML_ELEMENT(xml, "connection", _http.getStateString());
+	ADD_XML_NUMBER_INPUT(xml, "pacingBurst", _pacer.getBurst(), 1, mpegts::PCRPacer::MAX_BURST);
+	ADD_XML_ELEMENT(xml, "pacingBitrate", StringConverter::stringFormat("@#1 bits/s", _pacer.getBitrate()));
+
+	_deviceData.addToXML(xml);
+}
+
+void TSReader::doFromXML(const base::XMLElement &xml) {
+	base::XMLElement element;
+	if (findXMLElement(xml, "transformation", element)) {
+		_transform.fromXML(element);
+	}
+	std::string value;
+	if (findXMLElement(xml, "pacingBurst.value", value)) {
+		_pacer.setBurst(std::stoi(value));
+	}
+	_deviceData.fromXML(xml);
+}
+
+// =============================================================================
+//  -- input::Device -----------------------------------------------------------
+// =============================================================================
+
+void TSReader::addDeliverySystemCount(
+		std::size_t &dvbs2,
+		std::size_t &dvbt,
+		std::size_t &dvbt2,
+		std::size_t &dvbc,
+		std::size_t &dvbc2) {
+	dvbs2 += _transform.advertiseAsDVBS2() ? 1 : 0;
+	dvbt  += 0;
+	dvbt2 += 0;
+	dvbc  += _transform.advertiseAsDVBC() ? 1 : 0;
+	dvbc2 += 0;
+}
+
+void TSReader::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+	Device::addToMetrics(metrics, labels);
+	_pacer.addToMetrics(metrics, labels);
+	_http.addToMetrics(metrics, labels);
+}
+
+bool TSReader::isDataAvailable() {
+	if (!_http.isOpen()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(MAX_WAIT_MS));
+		return false;
+	}
+	if (!_http.waitForData(MAX_WAIT_MS)) {
+		return false;
+	}
+	return _pacer.waitUntilDue();
+}
+
+bool TSReader::readTSPackets(mpegts::PacketBuffer& buffer) {
+	if (!_http.isOpen()) {
+		return false;
+	}
+	// Spread the body data received from the connection over the buffers
+	bool written = false;
+	while (!buffer.full()) {
+		const unsigned char *data = nullptr;
+		const std::size_t available = _http.getBodyData(data);
+		if (available == 0) {
+			break;
+		}
+		const std::size_t size = std::min(available, buffer.getAmountOfBytesToWrite());
+		std::memcpy(buffer.getWriteBufferPtr(), data, size);
+		captureRead(data, size);
+		buffer.addAmountOfBytesWritten(size);
+		_http.consumeBodyData(size);
+		written = true;
+	}
+	if (written) {
+		buffer.trySyncing();
+		_deviceData.getFilter().filterData(_feID, buffer, _deviceData.isInternalPidFilteringEnabled());
+		if (buffer.full()) {
+			_pacer.addBuffer(buffer);
+		}
+	}
+	// Check again if buffer is full
+	return buffer.full();
+}
+
+bool TSReader::capableOf(const input::InputSystem system) const {
+	if (_enableUnsecureFrontends) {
+		return system == input::InputSystem::HTTP;
+	}
+	return false;
+}
+
+bool TSReader::capableToShare(const TransportParamVector& UNUSED(params)) const {
+	return false;
+}
+
+bool TSReader::capableToTransform(const TransportParamVector& params) const {
+	const input::InputSystem system = _transform.getTransformationSystemFor(params);
+	return system == input::InputSystem::HTTP;
+}
+
+bool TSReader::isLockedByOtherProcess() const {
+	return false;
+}
+
+bool TSReader::monitorSignal(bool UNUSED(showStatus)) {
+	if (_http.isStreaming()) {
+		_deviceData.setMonitorData(FE_HAS_LOCK, 240, 15, 0, 0);
+	} else {
+		_deviceData.setMonitorData(static_cast<fe_status_t>(0), 0, 0, 0, 0);
+	}
+	return true;
+}
+
+bool TSReader::hasDeviceFrequencyChanged() const {
+	return _deviceData.hasDeviceFrequencyChanged();
+}
+
+void TSReader::parseStreamString(const TransportParamVector& params) {
+	SI_LOG_INFO("Frontend: @#1, Parsing transport parameters...", _feID);
+
+	// Do we need to transform this request?
+	const TransportParamVector transParams = _transform.transformStreamString(_feID, params);
+
+	_deviceData.parseStreamString(_feID, transParams);
+	SI_LOG_DEBUG("Frontend: @#1, Parsing transport parameters (Finished)", _feID);
+}
+
+bool TSReader::update() {
+	SI_LOG_INFO("Frontend: @#1, Updating frontend...", _feID);
+	if (_deviceData.hasDeviceFrequencyChanged()) {
+		_deviceData.resetDeviceFrequencyChanged();
+		closeActivePIDFilters();
+		_http.close();
+	}
+	if (!_http.isOpen()) {
+		const std::string url = _deviceData.getURL();
+		if (_http.open(url)) {
+			SI_LOG_INFO("Frontend: @#1, HTTP - TS Reader using url: @#2", _feID, url);
+			_pacer.reset();
+		} else {
+			SI_LOG_ERROR("Frontend: @#1, HTTP - TS Reader unable to use url: @#2", _feID, url);
+		}
+	}
+	updatePIDFilters();
+	SI_LOG_DEBUG("Frontend: @#1, Updating frontend (Finished)", _feID);
+	return true;
+}
+
+bool TSReader::teardown() {
+	closeActivePIDFilters();
+	_deviceData.initialize();
+	_transform.resetTransformFlag();
+	_http.close();
+	return true;
+}
+
+std::string TSReader::attributeDescribeString() const {
+	if (_http.isOpen()) {
+		const DeviceData &data = _transform.transformDeviceData(_deviceData);
+		return data.attributeDescribeString(_feID);
+	}
+	return "";
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+}
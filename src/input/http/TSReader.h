@@ -0,0 +1,138 @@
+/* TSReader.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_HTTP_TSREADER_H_INCLUDE
+#define INPUT_HTTP_TSREADER_H_INCLUDE INPUT_HTTP_TSREADER_H_INCLUDE
+
+#include <FwDecl.h>
+#include <input/Device.h>
+#include <input/Transformation.h>
+#include <input/http/HttpConnection.h>
+#include <input/http/TSReaderData.h>
+#include <mpegts/PCRPacer.h>
+
+#include <string>
+
+FW_DECL_SP_NS2(input, http, TSReader);
+
+FW_DECL_VECTOR_OF_SP_NS0(Stream);
+
+namespace input::http {
+
+/// The class @c TSReader is for pulling a TS from an HTTP source as input
+/// device. The body is received in large blocks, that are copied into the
+/// buffers. The output is paced on the PCRs, because a static file (that is
+/// requested again when it ends) is received faster than real-time.
+/// Some example for pulling a TS from 'http://192.168.0.104:8080/ch1.ts':
+/// http://ip.of.your.box:8875/?msys=http&uri="http:%2F%2F192.168.0.104:8080%2Fch1.ts"
+class TSReader :
+	public input::Device {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		TSReader(
+			FeIndex index,
+			const std::string &appDataPath,
+			bool enableUnsecureFrontends);
+
+		virtual ~TSReader() = default;
+
+		// =========================================================================
+		//  -- Static member functions ---------------------------------------------
+		// =========================================================================
+	public:
+
+		///
+		static void enumerate(
+			StreamSpVector &streamVector,
+			const std::string &appDataPath,
+			bool enableUnsecureFrontends);
+
+		// =========================================================================
+		// -- base::XMLSupport -----------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// @see XMLSupport
+		virtual void doAddToXML(std::string &xml) const final;
+
+		/// @see XMLSupport
+		virtual void doFromXML(const base::XMLElement &xml) final;
+
+
+		// =========================================================================
+		//  -- input::Device--------------------------------------------------------
+		// =========================================================================
+	public:
+
+		virtual void addDeliverySystemCount(
+			std::size_t &dvbs2,
+			std::size_t &dvbt,
+			std::size_t &dvbt2,
+			std::size_t &dvbc,
+			std::size_t &dvbc2) final;
+
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) final;
+
+		virtual bool isDataAvailable() final;
+
+		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
+
+		virtual bool capableOf(input::InputSystem msys) const final;
+
+		virtual bool capableToShare(const TransportParamVector& params) const final;
+
+		virtual bool capableToTransform(const TransportParamVector& params) const final;
+
+		virtual bool isLockedByOtherProcess() const final;
+
+		virtual bool monitorSignal(bool showStatus) final;
+
+		virtual bool hasDeviceFrequencyChanged() const final;
+
+		virtual void parseStreamString(const TransportParamVector& params) final;
+
+		virtual bool update() final;
+
+		virtual bool teardown() final;
+
+		virtual std::string attributeDescribeString() const final;
+
+		virtual mpegts::Filter &getFilter() final {
+			return _deviceData.getFilter();
+		}
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		HttpConnection _http;
+		TSReaderData _deviceData;
+		input::Transformation _transform;
+		const bool _enableUnsecureFrontends;
+
+		mpegts::PCRPacer _pacer;
+};
+
+}
+
+#endif // INPUT_HTTP_TSREADER_H_INCLUDE
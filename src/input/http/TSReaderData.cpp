@@ -0,0 +1,85 @@
+/* TSReaderData.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/http/TSReaderData.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <StringConverter.h>
+#include <TransportParamVector.h>
+
+namespace input::http {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+TSReaderData::TSReaderData() {
+	doInitialize();
+}
+
+// =============================================================================
+// -- input::DeviceData --------------------------------------------------------
+// =============================================================================
+
+void TSReaderData::doNextAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "url", base::XMLSupport::makeXMLString(_url));
+}
+
+void TSReaderData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
+
+void TSReaderData::doInitialize() {
+	_url = "None";
+}
+
+void TSReaderData::doParseStreamString(const FeID id, const TransportParamVector& params) {
+	const std::string url = params.getURIParameter("uri");
+	// Check did we receive an new URL or just the same again
+	if (url.empty() || (hasURL() && StringConverter::getPercentDecoding(url) == _url)) {
+		parseAndUpdatePidsTable(id, params);
+		return;
+	}
+	initialize();
+	_frequencyChanged = true;
+	_url = StringConverter::getPercentDecoding(url);
+	parseAndUpdatePidsTable(id, params);
+}
+
+std::string TSReaderData::doAttributeDescribeString(const FeID id) const {
+	// ver=1.5;tuner=<feID>,<level>,<lock>,<quality>;uri=<url>
+	return StringConverter::stringFormat("ver=1.5;tuner=@#1,@#2,@#3,@#4;uri=@#5",
+		id, getSignalStrength(), hasLock(),
+		getSignalToNoiseRatio(), _url);
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+std::string TSReaderData::getURL() const {
+	base::MutexLock lock(_mutex);
+	return _url;
+}
+
+bool TSReaderData::hasURL() const {
+	base::MutexLock lock(_mutex);
+	return _url != "None";
+}
+
+}
@@ -25,10 +25,18 @@
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace input::stream {
 
+namespace {
+
+	constexpr std::size_t RTP_HEADER_SIZE = 12;
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+
+}
+
 // =============================================================================
 //  -- Constructors and destructor ---------------------------------------------
 // =============================================================================
@@ -38,11 +46,22 @@ Streamer::Streamer(
 	const std::string &bindIPAddress,
 	const std::string &appDataPath) :
 	Device(index),
+	_datagram(BATCH_SIZE),
+	_iov(BATCH_SIZE),
+	_msg(BATCH_SIZE),
 	_transform(appDataPath),
 	_bindIPAddress(bindIPAddress) {
 	_pfd[0].events  = 0;
 	_pfd[0].revents = 0;
 	_pfd[0].fd      = -1;
+	for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+		_iov[i].iov_base = _datagram[i].data;
+		_iov[i].iov_len  = MAX_DATAGRAM_SIZE;
+		std::memset(&_msg[i], 0, sizeof(mmsghdr));
+		_msg[i].msg_hdr.msg_iov     = &_iov[i];
+		_msg[i].msg_hdr.msg_iovlen  = 1;
+		_msg[i].msg_hdr.msg_control = _datagram[i].control;
+	}
 }
 
 // =============================================================================
@@ -66,11 +85,14 @@ void Streamer::enumerate(
 void Streamer::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "frontendname", "Streamer");
 	ADD_XML_ELEMENT(xml, "transformation", _transform.toXML());
+	ADD_XML_ELEMENT(xml, "kernelDrops", _kernelDrops.get());
+	ADD_XML_ELEMENT(xml, "truncatedDatagrams", _truncated.get());
+	ADD_XML_ELEMENT(xml, "rtpLost", _rtpLost.get());
 	_deviceData.addToXML(xml);
 }
 
-void Streamer::doFromXML(const std::string &xml) {
-	std::string element;
+void Streamer::doFromXML(const base::XMLElement &xml) {
+	base::XMLElement element;
 	if (findXMLElement(xml, "transformation", element)) {
 		_transform.fromXML(element);
 	}
@@ -94,7 +116,29 @@ void Streamer::addDeliverySystemCount(
 	dvbc2 += 0;
 }
 
+void Streamer::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) {
+	Device::addToMetrics(metrics, labels);
+	metrics.addCounter("satpi_streamer_recv_calls_total",
+		"Receive system calls of the streamer", labels, _recvCalls.get());
+	metrics.addCounter("satpi_streamer_datagrams_total",
+		"Datagrams received by the streamer", labels, _datagrams.get());
+	metrics.addHistogram("satpi_streamer_batch_datagrams",
+		"Datagrams received per system call", labels, _batchDatagrams);
+	metrics.addCounter("satpi_streamer_kernel_drops_total",
+		"Datagrams dropped by the kernel, because the receive buffer was full", labels, _kernelDrops.get());
+	metrics.addCounter("satpi_streamer_truncated_datagrams_total",
+		"Datagrams larger than the receive buffer of the streamer", labels, _truncated.get());
+	metrics.addCounter("satpi_streamer_rtp_lost_total",
+		"RTP datagrams missing in the sequence", labels, _rtpLost.get());
+	metrics.addCounter("satpi_streamer_rtp_reordered_total",
+		"RTP datagrams received duplicate or out of order", labels, _rtpReordered.get());
+}
+
 bool Streamer::isDataAvailable() {
+	// Still datagrams left from the last batch?
+	if (_batchIndex < _batchCount) {
+		return true;
+	}
 	// call poll with a timeout of 500 ms
 	const int pollRet = poll(_pfd, 1, 500);
 	if (pollRet > 0) {
@@ -107,12 +151,30 @@ bool Streamer::readTSPackets(mpegts::PacketBuffer& buffer) {
 	if (_udpMultiListen.getFD() == -1) {
 		return false;
 	}
-	// Read from stream
-	char *ptr = reinterpret_cast<char *>(buffer.getWriteBufferPtr());
-	const auto size = buffer.getAmountOfBytesToWrite();
-	const ssize_t readSize = _udpMultiListen.recvDatafrom(ptr, size, MSG_DONTWAIT);
-	if (readSize > 0) {
-		buffer.addAmountOfBytesWritten(readSize);
+	// Copy the payload of the received datagrams, receive the next batch
+	// (once) when they are all read
+	bool received = false;
+	bool written = false;
+	while (!buffer.full()) {
+		if (_batchIndex == _batchCount) {
+			if (received || !receiveBatch()) {
+				break;
+			}
+			received = true;
+		}
+		const Datagram &datagram = _datagram[_batchIndex];
+		const std::size_t size = std::min(datagram.size - _payloadOffset, buffer.getAmountOfBytesToWrite());
+		std::memcpy(buffer.getWriteBufferPtr(), datagram.data + datagram.begin + _payloadOffset, size);
+		captureRead(buffer.getWriteBufferPtr(), size);
+		buffer.addAmountOfBytesWritten(size);
+		written |= (size > 0);
+		_payloadOffset += size;
+		if (_payloadOffset == datagram.size) {
+			++_batchIndex;
+			_payloadOffset = 0;
+		}
+	}
+	if (written) {
 		buffer.trySyncing();
 		// Add data to Filter
 		_deviceData.getFilter().filterData(_feID, buffer, _deviceData.isInternalPidFilteringEnabled());
@@ -179,6 +241,10 @@ bool Streamer::update() {
 			// set receive buffer to 8MB
 			constexpr int bufferSize =  1024 * 1024 * 8;
 			_udpMultiListen.setNetworkReceiveBufferSize(bufferSize);
+			_udpMultiListen.setReceiveOverflowCounter();
+			_lastOverflow = 0;
+			_hasRTPSeq = false;
+			clearBatch();
 
 			_pfd[0].events  = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
 			_pfd[0].revents = 0;
@@ -198,6 +264,7 @@ bool Streamer::teardown() {
 	_deviceData.initialize();
 	_transform.resetTransformFlag();
 	_udpMultiListen.closeFD();
+	clearBatch();
 	return true;
 }
 
@@ -213,4 +280,99 @@ std::string Streamer::attributeDescribeString() const {
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
 
+bool Streamer::receiveBatch() {
+	clearBatch();
+	for (mmsghdr &msg : _msg) {
+		msg.msg_hdr.msg_controllen = sizeof(Datagram::control);
+		msg.msg_hdr.msg_flags = 0;
+		msg.msg_len = 0;
+	}
+	const int count = _udpMultiListen.recvMultipleDatafrom(_msg.data(), BATCH_SIZE, MSG_DONTWAIT);
+	_recvCalls.add();
+	if (count <= 0) {
+		return false;
+	}
+	_datagrams.add(count);
+	_batchDatagrams.observe(count);
+	std::size_t truncated = 0;
+	for (int i = 0; i < count; ++i) {
+		msghdr &hdr = _msg[i].msg_hdr;
+		const bool isTruncated = (hdr.msg_flags & MSG_TRUNC) == MSG_TRUNC;
+		if (isTruncated) {
+			++truncated;
+		}
+		// The kernel only adds the (total) drop counter when there are drops
+		for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+				std::uint32_t overflow;
+				std::memcpy(&overflow, CMSG_DATA(cmsg), sizeof(overflow));
+				_kernelDrops.add(overflow - _lastOverflow);
+				_lastOverflow = overflow;
+			}
+		}
+		Datagram &datagram = _datagram[i];
+		const unsigned char *data = datagram.data;
+		const std::size_t len = _msg[i].msg_len;
+		datagram.begin = 0;
+		// Keep only the whole TS packets of a truncated datagram
+		datagram.size = isTruncated ? len - (len % TS_PACKET_SIZE) : len;
+		// Plain TS starts with a SYNC Byte, else check for RTP version 2
+		if (len < RTP_HEADER_SIZE || data[0] == 0x47 || (data[0] & 0xC0) != 0x80) {
+			continue;
+		}
+		std::size_t header = RTP_HEADER_SIZE + ((data[0] & 0x0F) * 4);
+		if ((data[0] & 0x10) == 0x10) {
+			// The extension header does not fit, so drop it as a malformed RTP packet
+			if (len < header + 4) {
+				datagram.size = 0;
+				continue;
+			}
+			header += 4 + (((data[header + 2] << 8) | data[header + 3]) * 4);
+		}
+		// The padding of a truncated datagram is lost with its tail
+		const std::size_t padding = ((data[0] & 0x20) == 0x20 && !isTruncated) ? data[len - 1] : 0;
+		if (header + padding > len) {
+			datagram.size = 0;
+			continue;
+		}
+		datagram.begin = header;
+		datagram.size = len - header - padding;
+		if (isTruncated) {
+			datagram.size -= datagram.size % TS_PACKET_SIZE;
+		}
+		checkRTPSequence((data[2] << 8) | data[3]);
+	}
+	if (truncated > 0) {
+		// Only log the first time, the counter shows how often it happens
+		if (_truncated.get() == 0) {
+			SI_LOG_ERROR("Frontend: @#1, Streamer received datagrams larger than @#2 bytes, they are truncated",
+				_feID, MAX_DATAGRAM_SIZE);
+		}
+		_truncated.add(truncated);
+	}
+	_batchCount = count;
+	return true;
+}
+
+void Streamer::clearBatch() {
+	_batchCount = 0;
+	_batchIndex = 0;
+	_payloadOffset = 0;
+}
+
+void Streamer::checkRTPSequence(const std::uint16_t seq) {
+	if (_hasRTPSeq) {
+		const std::uint16_t diff = seq - _rtpSeq;
+		if (diff == 0 || diff >= 0x8000) {
+			_rtpReordered.add();
+			return;
+		}
+		if (diff > 1) {
+			_rtpLost.add(diff - 1);
+		}
+	}
+	_hasRTPSeq = true;
+	_rtpSeq = seq;
+}
+
 }
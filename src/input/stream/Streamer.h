@@ -21,15 +21,20 @@
 #define INPUT_STREAM_STREAMER_H_INCLUDE INPUT_STREAM_STREAMER_H_INCLUDE
 
 #include <FwDecl.h>
+#include <base/Metrics.h>
 #include <input/Device.h>
 #include <input/Transformation.h>
 #include <input/stream/StreamerData.h>
 #include <socket/SocketClient.h>
 #include <socket/UdpSocket.h>
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 FW_DECL_SP_NS2(input, stream, Streamer);
 
@@ -40,6 +45,9 @@ namespace input::stream {
 /// The class @c Streamer is for reading from an TS stream as input device.
 /// Stream can be an Multicast UDP e.g.
 /// http://ip.of.your.box:8875/?msys=streamer&uri="udp@224.0.1.3:1234"
+/// The datagrams are received in batches with one system call. Datagrams
+/// with an RTP header (like from an IPTV headend) are recognized, then the
+/// header is stripped and gaps in the sequence numbers are counted.
 class Streamer :
 	public input::Device,
 	protected UdpSocket {
@@ -74,7 +82,7 @@ class Streamer :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- input::Device--------------------------------------------------------
@@ -88,6 +96,8 @@ class Streamer :
 			std::size_t &dvbc,
 			std::size_t &dvbc2) final;
 
+		virtual void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) final;
+
 		virtual bool isDataAvailable() final;
 
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
@@ -119,13 +129,55 @@ class Streamer :
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
-	protected:
+	private:
+
+		/// Receive the next batch of datagrams
+		/// @return false if there was nothing to receive
+		bool receiveBatch();
+
+		/// Forget the datagrams that are not read yet
+		void clearBatch();
+
+		/// Count the lost and reordered datagrams with this RTP sequence number
+		void checkRTPSequence(std::uint16_t seq);
 
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
+	public:
+
+		static constexpr std::size_t BATCH_SIZE = 64;
+		static constexpr std::size_t MAX_DATAGRAM_SIZE = 2048;
+
 	private:
 
+		struct Datagram {
+			alignas(cmsghdr) unsigned char control[CMSG_SPACE(sizeof(std::uint32_t))];
+			unsigned char data[MAX_DATAGRAM_SIZE];
+			/// The TS payload of this datagram
+			std::size_t begin;
+			std::size_t size;
+		};
+		std::vector<Datagram> _datagram;
+		std::vector<iovec> _iov;
+		std::vector<mmsghdr> _msg;
+		std::size_t _batchCount = 0;
+		std::size_t _batchIndex = 0;
+		/// The bytes of the payload of the next datagram that are already read
+		std::size_t _payloadOffset = 0;
+		std::uint32_t _lastOverflow = 0;
+		bool _hasRTPSeq = false;
+		std::uint16_t _rtpSeq = 0;
+
+		base::Counter _recvCalls;
+		base::Counter _datagrams;
+		base::Counter _kernelDrops;
+		/// Datagrams larger than MAX_DATAGRAM_SIZE, their tail is lost
+		base::Counter _truncated;
+		base::Counter _rtpLost;
+		base::Counter _rtpReordered;
+		base::Histogram _batchDatagrams{ 1, 2, 4, 8, 16, 32, 64 };
+
 		StreamerData _deviceData;
 		input::Transformation _transform;
 
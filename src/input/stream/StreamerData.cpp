@@ -44,7 +44,7 @@ void StreamerData::doNextAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "pathname", _uri);
 }
 
-void StreamerData::doNextFromXML(const std::string &UNUSED(xml)) {}
+void StreamerData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 void StreamerData::doInitialize() {
 	_uri = "None";
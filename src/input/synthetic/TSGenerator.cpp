@@ -0,0 +1,261 @@
+/* TSGenerator.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/synthetic/TSGenerator.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <Stream.h>
+#include <StringConverter.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace input::synthetic {
+
+namespace {
+
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+	constexpr int NULL_PID = 0x1FFF;
+	constexpr char TIMESTAMP_MAGIC[] = "SatPI-TS";
+	constexpr std::size_t TIMESTAMP_MAGIC_SIZE = sizeof(TIMESTAMP_MAGIC) - 1;
+
+	/// The maximum time to sleep in @c isDataAvailable, so the writer of the
+	/// stream still gets called regularly
+	constexpr std::chrono::milliseconds MAX_WAIT(2);
+
+	/// When the generator is behind by more than this, it does not try
+	/// to catch up (to prevent bursts)
+	constexpr std::chrono::milliseconds MAX_BEHIND(100);
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+TSGenerator::TSGenerator(const FeIndex index) :
+		Device(index) {}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void TSGenerator::enumerate(StreamSpVector &streamVector) {
+	SI_LOG_INFO("Setting up Synthetic TS Generator");
+	const StreamSpVector::size_type size = streamVector.size();
+	const input::synthetic::SpTSGenerator generator =
+		std::make_shared<input::synthetic::TSGenerator>(size);
+	streamVector.push_back(Stream::makeSP(generator, nullptr));
+}
+
+void TSGenerator::makeTimestampPacket(unsigned char *packet,
+		const std::uint32_t frequency, const unsigned int cc) {
+	packet[0] = 0x47;
+	packet[1] = (TIMESTAMP_PID >> 8) & 0x1F;
+	packet[2] = TIMESTAMP_PID & 0xFF;
+	packet[3] = 0x10 | (cc & 0x0F);
+	std::memcpy(packet + 4, TIMESTAMP_MAGIC, TIMESTAMP_MAGIC_SIZE);
+	unsigned char *ptr = packet + 4 + TIMESTAMP_MAGIC_SIZE;
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		*ptr++ = (frequency >> shift) & 0xFF;
+	}
+	const std::uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	for (int shift = 56; shift >= 0; shift -= 8) {
+		*ptr++ = (time >> shift) & 0xFF;
+	}
+	std::memset(ptr, 0xFF, TS_PACKET_SIZE - (ptr - packet));
+}
+
+bool TSGenerator::parseTimestampPacket(const unsigned char *packet,
+		std::uint32_t &frequency, std::chrono::steady_clock::time_point &time) {
+	const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+	if (pid != TIMESTAMP_PID || std::memcmp(packet + 4, TIMESTAMP_MAGIC, TIMESTAMP_MAGIC_SIZE) != 0) {
+		return false;
+	}
+	const unsigned char *ptr = packet + 4 + TIMESTAMP_MAGIC_SIZE;
+	frequency = 0;
+	for (int i = 0; i < 4; ++i) {
+		frequency = (frequency << 8) | *ptr++;
+	}
+	std::uint64_t nsec = 0;
+	for (int i = 0; i < 8; ++i) {
+		nsec = (nsec << 8) | *ptr++;
+	}
+	time = std::chrono::steady_clock::time_point(std::chrono::duration_cast<
+		std::chrono::steady_clock::duration>(std::chrono::nanoseconds(nsec)));
+	return true;
+}
+
+// =============================================================================
+//  -- base::XMLSupport --------------------------------------------------------
+// =============================================================================
+
+void TSGenerator::doAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "frontendname", "Synthetic TS Generator");
+
+	_deviceData.addToXML(xml);
+}
+
+void TSGenerator::doFromXML(const base::XMLElement &xml) {
+	_deviceData.fromXML(xml);
+}
+
+// =============================================================================
+//  -- input::Device -----------------------------------------------------------
+// =============================================================================
+
+void TSGenerator::addDeliverySystemCount(
+		std::size_t &UNUSED(dvbs2),
+		std::size_t &UNUSED(dvbt),
+		std::size_t &UNUSED(dvbt2),
+		std::size_t &UNUSED(dvbc),
+		std::size_t &UNUSED(dvbc2)) {}
+
+bool TSGenerator::isDataAvailable() {
+	std::chrono::steady_clock::time_point nextBuffer;
+	bool generating;
+	{
+		base::MutexLock lock(_mutex);
+		generating = (_corpus != nullptr);
+		nextBuffer = _nextBuffer;
+	}
+	if (!generating) {
+		std::this_thread::sleep_for(MAX_WAIT);
+		return false;
+	}
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now >= nextBuffer) {
+		return true;
+	}
+	std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(nextBuffer - now, MAX_WAIT));
+	return std::chrono::steady_clock::now() >= nextBuffer;
+}
+
+bool TSGenerator::readTSPackets(mpegts::PacketBuffer& buffer) {
+	{
+		base::MutexLock lock(_mutex);
+		if (!_corpus) {
+			return false;
+		}
+		while (!buffer.full()) {
+			unsigned char *packet = buffer.getWriteBufferPtr();
+			if (buffer.getNumberOfCompletedPackets() == 0) {
+				makeTimestampPacket(packet, _frequency, _cc[TIMESTAMP_PID]++);
+			} else {
+				// Renumber the Continuity Counters, so they stay continuous when
+				// the corpus wraps around
+				std::memcpy(packet, _corpus->getPacket(_packet++), TS_PACKET_SIZE);
+				const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+				if (pid != NULL_PID) {
+					packet[3] = (packet[3] & 0xF0) | (_cc[pid]++ & 0x0F);
+				}
+			}
+			buffer.addAmountOfBytesWritten(TS_PACKET_SIZE);
+		}
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		_nextBuffer += _bufferInterval;
+		if (_nextBuffer + MAX_BEHIND < now) {
+			_nextBuffer = now;
+		}
+	}
+	buffer.trySyncing();
+	_deviceData.getFilter().filterData(_feID, buffer, true);
+	return buffer.full();
+}
+
+bool TSGenerator::capableOf(const input::InputSystem system) const {
+	return system == input::InputSystem::SYNTHETIC;
+}
+
+bool TSGenerator::capableToShare(const TransportParamVector& UNUSED(params)) const {
+	return false;
+}
+
+bool TSGenerator::capableToTransform(const TransportParamVector& UNUSED(params)) const {
+	return false;
+}
+
+bool TSGenerator::isLockedByOtherProcess() const {
+	return false;
+}
+
+bool TSGenerator::monitorSignal(bool UNUSED(showStatus)) {
+	_deviceData.setMonitorData(FE_HAS_LOCK, 240, 15, 0, 0);
+	return true;
+}
+
+bool TSGenerator::hasDeviceFrequencyChanged() const {
+	return _deviceData.hasDeviceFrequencyChanged();
+}
+
+void TSGenerator::parseStreamString(const TransportParamVector& params) {
+	SI_LOG_INFO("Frontend: @#1, Parsing transport parameters...", _feID);
+	_deviceData.parseStreamString(_feID, params);
+	SI_LOG_DEBUG("Frontend: @#1, Parsing transport parameters (Finished)", _feID);
+}
+
+bool TSGenerator::update() {
+	SI_LOG_INFO("Frontend: @#1, Updating frontend...", _feID);
+	if (_deviceData.hasDeviceFrequencyChanged()) {
+		_deviceData.resetDeviceFrequencyChanged();
+		closeActivePIDFilters();
+
+		const std::uint32_t frequency = _deviceData.getFrequency();
+		const unsigned int bitrate = _deviceData.getBitrate();
+		// Generate the new stream before taking the lock, the reader
+		// thread can keep going with the old one meanwhile
+		std::unique_ptr<mpegts::TSCorpus> corpus = std::make_unique<mpegts::TSCorpus>(
+			CORPUS_PACKETS, mpegts::TSCorpus::DEFAULT_SEED + frequency);
+		base::MutexLock lock(_mutex);
+		_corpus = std::move(corpus);
+		_packet = 0;
+		_frequency = frequency;
+		// Bits of one PacketBuffer divided by the bitrate in kbit/s gives msec
+		_bufferInterval = std::chrono::nanoseconds((mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS *
+			TS_PACKET_SIZE * 8 * UINT64_C(1000000)) / bitrate);
+		_nextBuffer = std::chrono::steady_clock::now();
+		SI_LOG_INFO("Frontend: @#1, Synthetic TS Generator using freq: @#2 at @#3 kbit/s",
+			_feID, frequency, bitrate);
+	}
+	updatePIDFilters();
+	SI_LOG_DEBUG("Frontend: @#1, Updating frontend (Finished)", _feID);
+	return true;
+}
+
+bool TSGenerator::teardown() {
+	closeActivePIDFilters();
+	_deviceData.initialize();
+	base::MutexLock lock(_mutex);
+	_corpus.reset();
+	return true;
+}
+
+std::string TSGenerator::attributeDescribeString() const {
+	base::MutexLock lock(_mutex);
+	if (_corpus) {
+		return _deviceData.attributeDescribeString(_feID);
+	}
+	return "";
+}
+
+}
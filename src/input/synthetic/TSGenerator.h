@@ -0,0 +1,156 @@
+/* TSGenerator.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_SYNTHETIC_TSGENERATOR_H_INCLUDE
+#define INPUT_SYNTHETIC_TSGENERATOR_H_INCLUDE INPUT_SYNTHETIC_TSGENERATOR_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Mutex.h>
+#include <input/Device.h>
+#include <input/synthetic/TSGeneratorData.h>
+#include <mpegts/TSCorpus.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+FW_DECL_SP_NS2(input, synthetic, TSGenerator);
+
+FW_DECL_VECTOR_OF_SP_NS0(Stream);
+
+namespace input::synthetic {
+
+/// The class @c TSGenerator is an input device without any hardware, it
+/// generates a synthetic Transport Stream (@see mpegts::TSCorpus) at the
+/// requested bitrate. The 'frequency' selects the generated stream, so a
+/// client can zap between streams. Every PacketBuffer starts with a packet
+/// on @c TIMESTAMP_PID carrying the frequency and the time it was generated,
+/// so a client in the same process can measure the delivery latency.
+/// Some example for opening a stream of 12 Mbit/s:
+/// http://ip.of.your.box:8875/?msys=synthetic&freq=1&bitrate=12000&pids=all
+class TSGenerator :
+	public input::Device {
+		// =========================================================================
+		//  -- Constructors and destructor -----------------------------------------
+		// =========================================================================
+	public:
+
+		/// The PID of the packets with the generation time
+		static constexpr int TIMESTAMP_PID = 0x1FF0;
+
+		TSGenerator(FeIndex index);
+
+		virtual ~TSGenerator() = default;
+
+		// =========================================================================
+		//  -- Static member functions ---------------------------------------------
+		// =========================================================================
+	public:
+
+		///
+		static void enumerate(StreamSpVector &streamVector);
+
+		/// Make a TS packet on @c TIMESTAMP_PID with the frequency and the
+		/// current time
+		/// @param packet specifies the TS packet to fill (188 bytes)
+		/// @param frequency specifies the frequency of the generated stream
+		/// @param cc specifies the Continuity Counter of the packet
+		static void makeTimestampPacket(unsigned char *packet,
+			std::uint32_t frequency, unsigned int cc);
+
+		/// Parse a TS packet made by @c makeTimestampPacket
+		/// @return true if @c packet is a timestamp packet, then @c frequency
+		/// and @c time are set
+		static bool parseTimestampPacket(const unsigned char *packet,
+			std::uint32_t &frequency, std::chrono::steady_clock::time_point &time);
+
+		// =========================================================================
+		// -- base::XMLSupport -----------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// @see XMLSupport
+		virtual void doAddToXML(std::string &xml) const final;
+
+		/// @see XMLSupport
+		virtual void doFromXML(const base::XMLElement &xml) final;
+
+		// =========================================================================
+		//  -- input::Device--------------------------------------------------------
+		// =========================================================================
+	public:
+
+		virtual void addDeliverySystemCount(
+			std::size_t &dvbs2,
+			std::size_t &dvbt,
+			std::size_t &dvbt2,
+			std::size_t &dvbc,
+			std::size_t &dvbc2) final;
+
+		virtual bool isDataAvailable() final;
+
+		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
+
+		virtual bool capableOf(input::InputSystem msys) const final;
+
+		virtual bool capableToShare(const TransportParamVector& params) const final;
+
+		virtual bool capableToTransform(const TransportParamVector& params) const final;
+
+		virtual bool isLockedByOtherProcess() const final;
+
+		virtual bool monitorSignal(bool showStatus) final;
+
+		virtual bool hasDeviceFrequencyChanged() const final;
+
+		virtual void parseStreamString(const TransportParamVector& params) final;
+
+		virtual bool update() final;
+
+		virtual bool teardown() final;
+
+		virtual std::string attributeDescribeString() const final;
+
+		virtual mpegts::Filter &getFilter() final {
+			return _deviceData.getFilter();
+		}
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		/// The number of TS packets of the generated stream before it repeats
+		static constexpr std::size_t CORPUS_PACKETS = 4000;
+
+		TSGeneratorData _deviceData;
+		/// Protects the generated stream, the reader thread uses it while a
+		/// client can zap to another stream
+		base::Mutex _mutex;
+		std::unique_ptr<mpegts::TSCorpus> _corpus;
+		std::size_t _packet = 0;
+		std::uint32_t _frequency = 0;
+		unsigned char _cc[0x2000] = {};
+		std::chrono::nanoseconds _bufferInterval{0};
+		std::chrono::steady_clock::time_point _nextBuffer;
+};
+
+}
+
+#endif // INPUT_SYNTHETIC_TSGENERATOR_H_INCLUDE
@@ -0,0 +1,92 @@
+/* TSGeneratorData.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/synthetic/TSGeneratorData.h>
+
+#include <Log.h>
+#include <Unused.h>
+#include <StringConverter.h>
+#include <TransportParamVector.h>
+
+#include <cmath>
+
+namespace input::synthetic {
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+TSGeneratorData::TSGeneratorData() {
+	doInitialize();
+}
+
+TSGeneratorData::~TSGeneratorData() {}
+
+// =============================================================================
+// -- input::DeviceData --------------------------------------------------------
+// =============================================================================
+
+void TSGeneratorData::doNextAddToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "frequency", _frequency);
+	ADD_XML_ELEMENT(xml, "bitrate", _bitrate);
+}
+
+void TSGeneratorData::doNextFromXML(const base::XMLElement &UNUSED(xml)) {}
+
+void TSGeneratorData::doInitialize() {
+	_frequency = 0;
+	_bitrate = DEFAULT_BITRATE;
+}
+
+void TSGeneratorData::doParseStreamString(const FeID id, const TransportParamVector& params) {
+	const double freq = params.getDoubleParameter("freq");
+	const int bitrate = params.getIntParameter("bitrate");
+	const std::uint32_t frequency = (freq > 0.0) ? std::lround(freq) : _frequency;
+	// Check did we receive an new 'frequency' or bitrate or just the same again
+	if (frequency != _frequency || (bitrate > 0 && static_cast<unsigned int>(bitrate) != _bitrate)) {
+		initialize();
+		_frequencyChanged = true;
+		_frequency = frequency;
+		_bitrate = (bitrate > 0) ? bitrate : DEFAULT_BITRATE;
+	}
+	parseAndUpdatePidsTable(id, params);
+}
+
+std::string TSGeneratorData::doAttributeDescribeString(const FeID id) const {
+	// ver=1.5;tuner=<feID>,<level>,<lock>,<quality>;freq=<freq>
+	return StringConverter::stringFormat("ver=1.5;tuner=@#1,@#2,@#3,@#4;freq=@#5",
+		id, getSignalStrength(), hasLock(),
+		getSignalToNoiseRatio(), _frequency);
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+std::uint32_t TSGeneratorData::getFrequency() const {
+	base::MutexLock lock(_mutex);
+	return _frequency;
+}
+
+unsigned int TSGeneratorData::getBitrate() const {
+	base::MutexLock lock(_mutex);
+	return _bitrate;
+}
+
+}
@@ -0,0 +1,406 @@
+/* ClientSimulator.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <loadtest/ClientSimulator.h>
+
+#include <HeaderVector.h>
+#include <Log.h>
+#include <StringConverter.h>
+#include <input/synthetic/TSGenerator.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+namespace loadtest {
+
+namespace {
+
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+	constexpr std::size_t RTP_HEADER_LEN = 12;
+	constexpr int NULL_PID = 0x1FFF;
+
+	/// The 'frequency' offset of the stream to zap to and back from
+	constexpr std::uint32_t ZAP_OFFSET = 10000;
+
+	constexpr std::chrono::milliseconds REPLY_TIMEOUT(5000);
+	constexpr std::chrono::milliseconds RECEIVE_TIMEOUT(50);
+	constexpr std::chrono::milliseconds RETRY_INTERVAL(500);
+	/// The RTSP session timeout of SatPI is 60 sec
+	constexpr std::chrono::seconds KEEP_ALIVE_INTERVAL(20);
+
+	std::chrono::nanoseconds toNanoseconds(const struct timespec &ts) {
+		return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+	}
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+ClientSimulator::ClientSimulator(const std::string &name, const Config &config) :
+		_thread(name, std::bind(&ClientSimulator::threadExecute, this)),
+		_config(config),
+		_datagram(RTP_HEADER_LEN + 64 * TS_PACKET_SIZE) {
+	std::fill(std::begin(_cc), std::end(_cc), NO_CC);
+}
+
+ClientSimulator::~ClientSimulator() {
+	_thread.terminateThread();
+}
+
+// =============================================================================
+// -- Static member functions --------------------------------------------------
+// =============================================================================
+
+std::string_view ClientSimulator::protocolToString(const Protocol protocol) {
+	switch (protocol) {
+		case Protocol::HTTP:
+			return "http";
+		case Protocol::RTSP_UDP:
+			return "rtsp";
+		case Protocol::RTSP_TCP:
+			return "rtsp-tcp";
+		default:
+			return "unknown";
+	}
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool ClientSimulator::start() {
+	return _thread.startThread();
+}
+
+void ClientSimulator::halt() {
+	_thread.terminateThread();
+	_halted = true;
+}
+
+void ClientSimulator::stop() {
+	_thread.terminateThread();
+	close();
+}
+
+bool ClientSimulator::threadExecute() {
+	if (!_cpuStartValid) {
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_cpuStart);
+		_cpuStartValid = true;
+	}
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!_opened) {
+		if (!open(_config.frequency)) {
+			++_stats.setupFailures;
+			close();
+			std::this_thread::sleep_for(RETRY_INTERVAL);
+		}
+	} else if (_config.zapInterval.count() > 0 && now >= _nextZap) {
+		const std::uint32_t frequency = (_frequency == _config.frequency) ?
+			_config.frequency + ZAP_OFFSET : _config.frequency;
+		if (!zap(frequency)) {
+			++_stats.zapFailures;
+		}
+	} else if (_config.protocol != Protocol::HTTP && now >= _nextKeepAlive) {
+		_nextKeepAlive = now + KEEP_ALIVE_INTERVAL;
+		sendRTSPRequest("OPTIONS", StringConverter::stringFormat("rtsp://@#1:@#2/",
+			_config.ipAddress, _config.rtspPort), "");
+	} else {
+		receive(RECEIVE_TIMEOUT);
+	}
+	struct timespec cpu;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+	_stats.cpuTime = toNanoseconds(cpu) - toNanoseconds(_cpuStart);
+	return true;
+}
+
+bool ClientSimulator::open(const std::uint32_t frequency) {
+	_rx.clear();
+	_headerReceived = false;
+	_frequency = frequency;
+	_tuning = true;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!_zapping) {
+		_tuneStart = now;
+	}
+	_nextZap = now + _config.zapInterval;
+	_nextKeepAlive = now + KEEP_ALIVE_INTERVAL;
+
+	const int port = (_config.protocol == Protocol::HTTP) ? _config.httpPort : _config.rtspPort;
+	_tcp.setupSocketStructure(_config.ipAddress, port, 0);
+	if (!_tcp.setupSocketHandle(SOCK_STREAM, IPPROTO_TCP) || !_tcp.connectTo()) {
+		SI_LOG_ERROR("Load test: unable to connect to @#1:@#2", _config.ipAddress, port);
+		return false;
+	}
+	_opened = true;
+	if (_config.protocol == Protocol::HTTP) {
+		const std::string request = StringConverter::stringFormat(
+			"GET /?@#1 HTTP/1.1\r\nHost: @#2:@#3\r\n\r\n",
+			makeQuery(frequency), _config.ipAddress, port);
+		_replyReceived = false;
+		return _tcp.sendData(request.data(), request.size(), MSG_NOSIGNAL) &&
+			waitForReply(REPLY_TIMEOUT);
+	}
+	std::string transport;
+	if (_config.protocol == Protocol::RTSP_UDP) {
+		_rtp.setupSocketStructureWithAnyAddress(_config.rtpPort, 0);
+		_rtcp.setupSocketStructureWithAnyAddress(_config.rtpPort + 1, 0);
+		if (!_rtp.setupSocketHandle(SOCK_DGRAM, IPPROTO_UDP) || !_rtp.bind() ||
+				!_rtcp.setupSocketHandle(SOCK_DGRAM, IPPROTO_UDP) || !_rtcp.bind()) {
+			return false;
+		}
+		_rtp.setNetworkReceiveBufferSize(1024 * 1024);
+		transport = StringConverter::stringFormat("Transport: RTP/AVP;unicast;client_port=@#1-@#2\r\n",
+			_config.rtpPort, _config.rtpPort + 1);
+	} else {
+		transport = "Transport: RTP/AVP/TCP;interleaved=0-1\r\n";
+	}
+	_sessionID.clear();
+	_streamID = -1;
+	if (!sendRTSPRequest("SETUP", StringConverter::stringFormat("rtsp://@#1:@#2/?@#3",
+			_config.ipAddress, port, makeQuery(frequency)), transport) || _streamID == -1) {
+		return false;
+	}
+	return sendRTSPRequest("PLAY", StringConverter::stringFormat("rtsp://@#1:@#2/stream=@#3",
+		_config.ipAddress, port, _streamID), "");
+}
+
+bool ClientSimulator::zap(const std::uint32_t frequency) {
+	if (_config.protocol == Protocol::HTTP) {
+		// HTTP can not change the stream, so request a new one
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		close();
+		_zapping = true;
+		_tuneStart = start;
+		if (!open(frequency)) {
+			close();
+			return false;
+		}
+		return true;
+	}
+	_frequency = frequency;
+	_tuning = true;
+	_zapping = true;
+	_tuneStart = std::chrono::steady_clock::now();
+	_nextZap = _tuneStart + _config.zapInterval;
+	return sendRTSPRequest("PLAY", StringConverter::stringFormat("rtsp://@#1:@#2/stream=@#3?@#4",
+		_config.ipAddress, _config.rtspPort, _streamID, makeQuery(frequency)), "");
+}
+
+void ClientSimulator::close() {
+	if (_opened && _config.protocol != Protocol::HTTP && !_sessionID.empty()) {
+		sendRTSPRequest("TEARDOWN", StringConverter::stringFormat("rtsp://@#1:@#2/stream=@#3",
+			_config.ipAddress, _config.rtspPort, _streamID), "");
+	}
+	_tcp.closeFD();
+	_rtp.closeFD();
+	_rtcp.closeFD();
+	_sessionID.clear();
+	_streamID = -1;
+	_opened = false;
+	_tuning = false;
+	_zapping = false;
+}
+
+std::string ClientSimulator::makeQuery(const std::uint32_t frequency) const {
+	return StringConverter::stringFormat("msys=synthetic&freq=@#1&bitrate=@#2&pids=all",
+		frequency, _config.bitrate);
+}
+
+bool ClientSimulator::sendRTSPRequest(const std::string_view method,
+		const std::string &uri, const std::string &headers) {
+	const std::string session = _sessionID.empty() ? "" :
+		StringConverter::stringFormat("Session: @#1\r\n", _sessionID);
+	const std::string request = StringConverter::stringFormat("@#1 @#2 RTSP/1.0\r\nCSeq: @#3\r\n@#4@#5\r\n",
+		method, uri, ++_cseq, session, headers);
+	_replyReceived = false;
+	return _tcp.sendData(request.data(), request.size(), MSG_NOSIGNAL) &&
+		waitForReply(REPLY_TIMEOUT);
+}
+
+bool ClientSimulator::waitForReply(const std::chrono::milliseconds timeout) {
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + timeout;
+	while (!_replyReceived && std::chrono::steady_clock::now() < end && _tcp.getFD() != -1) {
+		receive(RECEIVE_TIMEOUT);
+	}
+	return _replyReceived && _replyStatus == 200;
+}
+
+void ClientSimulator::receive(const std::chrono::milliseconds timeout) {
+	struct pollfd pfd[3];
+	pfd[0].fd = _tcp.getFD();
+	pfd[1].fd = _rtp.getFD();
+	pfd[2].fd = _rtcp.getFD();
+	for (struct pollfd &p : pfd) {
+		p.events = POLLIN;
+		p.revents = 0;
+	}
+	if (::poll(pfd, 3, timeout.count()) <= 0) {
+		return;
+	}
+	if (pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+		char buf[64 * 1024];
+		const ssize_t size = ::recv(pfd[0].fd, buf, sizeof(buf), MSG_DONTWAIT);
+		if (size > 0) {
+			_rx.append(buf, size);
+			processTCPData();
+		} else if (size == 0) {
+			// The server closed the connection, so open it again
+			_tcp.closeFD();
+			_sessionID.clear();
+			close();
+		}
+	}
+	if (pfd[1].revents & POLLIN) {
+		for (;;) {
+			const ssize_t size = _rtp.recvDatafrom(_datagram.data(), _datagram.size(), MSG_DONTWAIT);
+			if (size <= static_cast<ssize_t>(RTP_HEADER_LEN)) {
+				break;
+			}
+			processTSPackets(_datagram.data() + RTP_HEADER_LEN, size - RTP_HEADER_LEN);
+		}
+	}
+	if (pfd[2].revents & POLLIN) {
+		// Just drain the RTCP reports
+		while (_rtcp.recvDatafrom(_datagram.data(), _datagram.size(), MSG_DONTWAIT) > 0) {}
+	}
+}
+
+void ClientSimulator::processTCPData() {
+	std::size_t index = 0;
+	while (index < _rx.size()) {
+		if (_config.protocol == Protocol::HTTP && _headerReceived) {
+			// The rest is all TS data, keep an incomplete packet for later
+			const std::size_t size = ((_rx.size() - index) / TS_PACKET_SIZE) * TS_PACKET_SIZE;
+			processTSPackets(reinterpret_cast<const unsigned char *>(_rx.data() + index), size);
+			index += size;
+			break;
+		} else if (_rx[index] == '$') {
+			// Interleaved RTP: '$' <channel> <length 16 bits> <RTP packet>
+			if (_rx.size() - index < 4) {
+				break;
+			}
+			const std::size_t len = (static_cast<unsigned char>(_rx[index + 2]) << 8) |
+				static_cast<unsigned char>(_rx[index + 3]);
+			if (_rx.size() - index < 4 + len) {
+				break;
+			}
+			if (_rx[index + 1] == 0 && len > RTP_HEADER_LEN) {
+				processTSPackets(reinterpret_cast<const unsigned char *>(
+					_rx.data() + index + 4 + RTP_HEADER_LEN), len - RTP_HEADER_LEN);
+			}
+			index += 4 + len;
+		} else if (_rx.compare(index, 5, "RTSP/") == 0 || _rx.compare(index, 5, "HTTP/") == 0) {
+			_rx.erase(0, index);
+			index = processReply();
+			if (index == 0) {
+				return;
+			}
+		} else {
+			// Lost the framing, search for the next frame or reply. When closing
+			// the last frame before the TEARDOWN reply may be cut short
+			if (!_halted) {
+				++_stats.syncErrors;
+			}
+			index = _rx.find_first_of("$RH", index + 1);
+			if (index == std::string::npos) {
+				index = _rx.size();
+			}
+		}
+	}
+	_rx.erase(0, index);
+}
+
+std::size_t ClientSimulator::processReply() {
+	const std::size_t end = _rx.find("\r\n\r\n");
+	if (end == std::string::npos) {
+		return 0;
+	}
+	const HeaderVector headers(StringConverter::split(_rx.substr(0, end), "\r\n"));
+	const std::string contentLength = headers.getFieldParameter("Content-Length");
+	const std::size_t size = end + 4 + (contentLength.empty() ? 0 : std::stoul(contentLength));
+	if (_rx.size() < size) {
+		return 0;
+	}
+	// Status line: <protocol> <status code> <reason>
+	const std::string::size_type space = _rx.find(' ');
+	_replyStatus = (space < end) ? std::atoi(_rx.c_str() + space + 1) : 0;
+	const std::string session = headers.getFieldParameter("Session");
+	if (!session.empty()) {
+		_sessionID = session.substr(0, session.find(';'));
+	}
+	const std::string streamID = headers.getFieldParameter("com.ses.streamID");
+	if (!streamID.empty()) {
+		_streamID = std::stoi(streamID);
+	}
+	_headerReceived = true;
+	_replyReceived = true;
+	return size;
+}
+
+void ClientSimulator::processTSPackets(const unsigned char *data, const std::size_t size) {
+	// Data drained while closing is not part of the test
+	if (_halted) {
+		return;
+	}
+	_bytes.fetch_add(size, std::memory_order_relaxed);
+	_stats.bytes += size;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	for (const unsigned char *packet = data; packet + TS_PACKET_SIZE <= data + size; packet += TS_PACKET_SIZE) {
+		if (packet[0] != 0x47) {
+			++_stats.syncErrors;
+			continue;
+		}
+		++_stats.packets;
+		const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+		std::uint32_t frequency;
+		std::chrono::steady_clock::time_point time;
+		if (input::synthetic::TSGenerator::parseTimestampPacket(packet, frequency, time)) {
+			if (frequency != _frequency) {
+				// Still the stream from before the zap
+				continue;
+			}
+			if (_tuning) {
+				_tuning = false;
+				if (_zapping) {
+					_zapping = false;
+					_stats.zapLatency.push_back(std::chrono::duration_cast<
+						std::chrono::microseconds>(now - _tuneStart).count());
+				}
+				std::fill(std::begin(_cc), std::end(_cc), NO_CC);
+			}
+			_stats.latency.push_back(std::chrono::duration_cast<
+				std::chrono::microseconds>(now - time).count());
+		}
+		if (_tuning || pid == NULL_PID || (packet[3] & 0x10) == 0) {
+			continue;
+		}
+		const int cc = packet[3] & 0x0F;
+		if (_cc[pid] != NO_CC && ((_cc[pid] + 1) & 0x0F) != cc) {
+			++_stats.ccErrors;
+		}
+		_cc[pid] = cc;
+	}
+}
+
+}
@@ -0,0 +1,202 @@
+/* ClientSimulator.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef LOADTEST_CLIENTSIMULATOR_H_INCLUDE
+#define LOADTEST_CLIENTSIMULATOR_H_INCLUDE LOADTEST_CLIENTSIMULATOR_H_INCLUDE
+
+#include <base/Thread.h>
+#include <socket/SocketAttr.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace loadtest {
+
+/// The class @c ClientSimulator is one simulated SAT>IP client. It opens a
+/// stream of a 'Synthetic TS Generator' frontend via HTTP, RTSP with RTP over
+/// UDP or RTSP with RTP over TCP, zaps between streams and checks everything
+/// it receives in its own thread.
+class ClientSimulator {
+	public:
+
+		enum class Protocol {
+			HTTP,
+			RTSP_UDP,
+			RTSP_TCP
+		};
+
+		struct Config {
+			Protocol protocol = Protocol::HTTP;
+			std::string ipAddress = "127.0.0.1";
+			int httpPort = 0;
+			int rtspPort = 0;
+			/// The RTP port for RTSP over UDP, RTCP is the next port
+			int rtpPort = 0;
+			/// The bitrate of the requested stream in kbit/s
+			unsigned int bitrate = 0;
+			/// The 'frequency' of the first requested stream
+			std::uint32_t frequency = 1;
+			/// Zap to an other stream every interval, zero is no zapping
+			std::chrono::milliseconds zapInterval{0};
+		};
+
+		/// The statistics of this client, the latencies are in usec
+		struct Statistics {
+			std::uint64_t bytes = 0;
+			std::uint64_t packets = 0;
+			std::uint64_t ccErrors = 0;
+			std::uint64_t syncErrors = 0;
+			std::uint64_t setupFailures = 0;
+			std::uint64_t zapFailures = 0;
+			std::vector<std::uint32_t> latency;
+			std::vector<std::uint32_t> zapLatency;
+			std::chrono::nanoseconds cpuTime{0};
+		};
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		ClientSimulator(const std::string &name, const Config &config);
+
+		virtual ~ClientSimulator();
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		static std::string_view protocolToString(Protocol protocol);
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Start the thread of this client, it opens the stream
+		bool start();
+
+		/// Stop the thread of this client, but keep the stream open
+		void halt();
+
+		/// Stop the thread of this client and close the stream
+		void stop();
+
+		/// Get the amount of stream data received until now
+		std::uint64_t getReceivedBytes() const {
+			return _bytes.load(std::memory_order_relaxed);
+		}
+
+		/// Get the statistics of this client, only valid after @c stop
+		const Statistics &getStatistics() const {
+			return _stats;
+		}
+
+		const Config &getConfig() const {
+			return _config;
+		}
+
+	private:
+
+		/// The execution of the client thread
+		bool threadExecute();
+
+		/// Open the stream with the requested frequency
+		bool open(std::uint32_t frequency);
+
+		/// Zap to the stream with the requested frequency
+		bool zap(std::uint32_t frequency);
+
+		/// Close the stream (and TEARDOWN the RTSP session)
+		void close();
+
+		/// Make the transport parameters for the requested frequency
+		std::string makeQuery(std::uint32_t frequency) const;
+
+		/// Send a RTSP request and wait for the reply
+		/// @return true if the reply is '200 OK'
+		bool sendRTSPRequest(std::string_view method, const std::string &uri,
+			const std::string &headers);
+
+		/// Wait for the reply of the last request, meanwhile received stream
+		/// data is processed
+		bool waitForReply(std::chrono::milliseconds timeout);
+
+		/// Receive and process the available data within the timeout
+		void receive(std::chrono::milliseconds timeout);
+
+		/// Process the data received on the TCP connection
+		void processTCPData();
+
+		/// Process the HTTP/RTSP reply at the begin of @c _rx
+		/// @return the size of the reply or 0 if it is not complete yet
+		std::size_t processReply();
+
+		/// Process the stream data, a multiple of TS packets
+		void processTSPackets(const unsigned char *data, std::size_t size);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static constexpr int NO_CC = -1;
+
+		base::Thread _thread;
+		Config _config;
+		Statistics _stats;
+		std::atomic<std::uint64_t> _bytes{0};
+
+		SocketAttr _tcp;
+		SocketAttr _rtp;
+		SocketAttr _rtcp;
+		bool _opened = false;
+		bool _headerReceived = false;
+		std::string _rx;
+		std::vector<unsigned char> _datagram;
+
+		// RTSP session
+		unsigned int _cseq = 0;
+		std::string _sessionID;
+		int _streamID = -1;
+		int _replyStatus = 0;
+		bool _replyReceived = false;
+
+		std::uint32_t _frequency = 0;
+		bool _tuning = false;
+		bool _zapping = false;
+		bool _halted = false;
+		std::chrono::steady_clock::time_point _tuneStart;
+		std::chrono::steady_clock::time_point _nextZap;
+		std::chrono::steady_clock::time_point _nextKeepAlive;
+		int _cc[0x2000];
+
+		bool _cpuStartValid = false;
+		struct timespec _cpuStart = {};
+};
+
+}
+
+#endif // LOADTEST_CLIENTSIMULATOR_H_INCLUDE
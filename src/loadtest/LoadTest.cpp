@@ -0,0 +1,213 @@
+/* LoadTest.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <loadtest/LoadTest.h>
+
+#include <StringConverter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <sys/resource.h>
+
+namespace loadtest {
+
+namespace {
+
+	/// Interval of the progress lines
+	constexpr std::chrono::seconds PROGRESS_INTERVAL(5);
+
+	/// Start the clients one after another, not all at the same moment
+	constexpr std::chrono::milliseconds START_INTERVAL(20);
+
+	/// Get the CPU time (user and system) of this process in sec
+	double getProcessCPU() {
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+			(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+	}
+
+	/// Get the requested percentile of the values (which get sorted)
+	double percentile(std::vector<std::uint32_t> &values, const double p) {
+		if (values.empty()) {
+			return 0.0;
+		}
+		std::sort(values.begin(), values.end());
+		return values[static_cast<std::size_t>((p / 100.0) * (values.size() - 1) + 0.5)];
+	}
+
+	double toMbps(const std::uint64_t bytes, const double seconds) {
+		return (seconds > 0.0) ? (bytes * 8.0) / (seconds * 1000000.0) : 0.0;
+	}
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+LoadTest::LoadTest(const Config &config) :
+		_config(config) {
+	static constexpr ClientSimulator::Protocol PROTOCOLS[] = {
+		ClientSimulator::Protocol::HTTP,
+		ClientSimulator::Protocol::RTSP_UDP,
+		ClientSimulator::Protocol::RTSP_TCP
+	};
+	for (std::size_t i = 0; i < _config.clients; ++i) {
+		ClientSimulator::Config client;
+		if (_config.protocol == "http") {
+			client.protocol = ClientSimulator::Protocol::HTTP;
+		} else if (_config.protocol == "rtsp") {
+			client.protocol = ClientSimulator::Protocol::RTSP_UDP;
+		} else if (_config.protocol == "rtsp-tcp") {
+			client.protocol = ClientSimulator::Protocol::RTSP_TCP;
+		} else {
+			client.protocol = PROTOCOLS[i % 3];
+		}
+		client.httpPort = _config.httpPort;
+		client.rtspPort = _config.rtspPort;
+		client.rtpPort = _config.rtpPort + 2 * i;
+		client.bitrate = _config.bitrate;
+		client.frequency = i + 1;
+		client.zapInterval = std::chrono::seconds(_config.zap);
+		_clients.push_back(std::make_unique<ClientSimulator>(
+			StringConverter::stringFormat("LoadClient@#1", i + 1), client));
+	}
+}
+
+// =============================================================================
+// -- Static member functions --------------------------------------------------
+// =============================================================================
+
+bool LoadTest::isValidProtocol(const std::string &protocol) {
+	return protocol == "http" || protocol == "rtsp" || protocol == "rtsp-tcp" || protocol == "mix";
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+bool LoadTest::run(const std::atomic_bool &stop) {
+	std::printf("Load test with %zu %s clients of %u kbit/s for %u sec, zap every %u sec\r\n",
+		_config.clients, _config.protocol.c_str(), _config.bitrate, _config.duration, _config.zap);
+	std::fflush(stdout);
+
+	const double cpuStart = getProcessCPU();
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (const UpClientSimulator &client : _clients) {
+		client->start();
+		std::this_thread::sleep_for(START_INTERVAL);
+	}
+
+	const std::chrono::steady_clock::time_point end = start + std::chrono::seconds(_config.duration);
+	std::chrono::steady_clock::time_point progress = start + PROGRESS_INTERVAL;
+	std::uint64_t lastBytes = 0;
+	while (!stop && std::chrono::steady_clock::now() < end) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now >= progress) {
+			std::uint64_t bytes = 0;
+			for (const UpClientSimulator &client : _clients) {
+				bytes += client->getReceivedBytes();
+			}
+			std::printf("%5lld sec %10.1f Mbit/s\r\n",
+				static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(now - start).count()),
+				toMbps(bytes - lastBytes, std::chrono::duration<double>(PROGRESS_INTERVAL).count()));
+			std::fflush(stdout);
+			lastBytes = bytes;
+			progress += PROGRESS_INTERVAL;
+		}
+	}
+
+	// Halt all clients before closing the streams, a TEARDOWN takes time and
+	// the other clients would keep receiving meanwhile
+	for (const UpClientSimulator &client : _clients) {
+		client->halt();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double clientCPU = 0.0;
+	for (const UpClientSimulator &client : _clients) {
+		client->stop();
+		clientCPU += std::chrono::duration<double>(client->getStatistics().cpuTime).count();
+	}
+	const double serverCPU = getProcessCPU() - cpuStart - clientCPU;
+	return printReport(seconds, serverCPU);
+}
+
+bool LoadTest::printReport(const double seconds, const double serverCPU) const {
+	bool ok = true;
+	std::uint64_t bytes = 0;
+	std::uint64_t ccErrors = 0;
+	std::uint64_t syncErrors = 0;
+	std::uint64_t setupFailures = 0;
+	std::uint64_t zapFailures = 0;
+	std::vector<std::uint32_t> latency;
+	std::vector<std::uint32_t> zapLatency;
+
+	std::printf("\r\n%-14s %-9s %9s %10s %7s %7s %9s %9s %5s %5s %9s\r\n", "client", "protocol",
+		"Mbit/s", "packets", "cc-err", "sync", "lat-p50", "lat-p99", "zaps", "fail", "zap-p50");
+	std::size_t number = 0;
+	for (const UpClientSimulator &client : _clients) {
+		ClientSimulator::Statistics stats = client->getStatistics();
+		// A broken stream or a failed zap fails the run, as a failed setup does
+		ok &= stats.setupFailures == 0 && stats.zapFailures == 0 &&
+			stats.ccErrors == 0 && stats.syncErrors == 0 && stats.bytes > 0;
+		std::printf("%-14zu %-9s %9.2f %10llu %7llu %7llu %7.0fus %7.0fus %5zu %5llu %7.1fms\r\n",
+			++number,
+			ClientSimulator::protocolToString(client->getConfig().protocol).data(),
+			toMbps(stats.bytes, seconds),
+			static_cast<unsigned long long>(stats.packets),
+			static_cast<unsigned long long>(stats.ccErrors),
+			static_cast<unsigned long long>(stats.syncErrors),
+			percentile(stats.latency, 50.0), percentile(stats.latency, 99.0),
+			stats.zapLatency.size(), static_cast<unsigned long long>(stats.zapFailures),
+			percentile(stats.zapLatency, 50.0) / 1000.0);
+		bytes += stats.bytes;
+		ccErrors += stats.ccErrors;
+		syncErrors += stats.syncErrors;
+		setupFailures += stats.setupFailures;
+		zapFailures += stats.zapFailures;
+		latency.insert(latency.end(), stats.latency.begin(), stats.latency.end());
+		zapLatency.insert(zapLatency.end(), stats.zapLatency.begin(), stats.zapLatency.end());
+	}
+
+	const double mbps = toMbps(bytes, seconds);
+	const double cpu = (serverCPU * 100.0) / seconds;
+	std::printf("\r\nThroughput:      %.2f Mbit/s in %.1f sec\r\n", mbps, seconds);
+	std::printf("Server CPU:      %.1f%% of one core, %.3f%% per Mbit/s\r\n",
+		cpu, (mbps > 0.0) ? cpu / mbps : 0.0);
+	std::printf("Latency:         p50 %.0fus  p90 %.0fus  p99 %.0fus  max %.0fus (generated to received)\r\n",
+		percentile(latency, 50.0), percentile(latency, 90.0),
+		percentile(latency, 99.0), percentile(latency, 100.0));
+	std::printf("Zap latency:     p50 %.1fms  p90 %.1fms  p99 %.1fms  max %.1fms (%zu zaps, %llu failed)\r\n",
+		percentile(zapLatency, 50.0) / 1000.0, percentile(zapLatency, 90.0) / 1000.0,
+		percentile(zapLatency, 99.0) / 1000.0, percentile(zapLatency, 100.0) / 1000.0,
+		zapLatency.size(), static_cast<unsigned long long>(zapFailures));
+	std::printf("Errors:          %llu CC, %llu sync, %llu setup failures\r\n",
+		static_cast<unsigned long long>(ccErrors),
+		static_cast<unsigned long long>(syncErrors),
+		static_cast<unsigned long long>(setupFailures));
+	std::fflush(stdout);
+	return ok;
+}
+
+}
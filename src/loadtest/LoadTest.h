@@ -0,0 +1,103 @@
+/* LoadTest.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef LOADTEST_LOADTEST_H_INCLUDE
+#define LOADTEST_LOADTEST_H_INCLUDE LOADTEST_LOADTEST_H_INCLUDE
+
+#include <loadtest/ClientSimulator.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loadtest {
+
+/// The class @c LoadTest drives a number of simulated clients against the
+/// SatPI running in this process (on loopback with 'Synthetic TS Generator'
+/// frontends) and reports the throughput, CPU usage, delivery latency,
+/// Continuity Counter errors and zap latency.
+class LoadTest {
+	public:
+
+		struct Config {
+			std::size_t clients = 0;
+			/// 'http', 'rtsp' (RTP over UDP), 'rtsp-tcp' or 'mix' (all of them)
+			std::string protocol = "mix";
+			/// The bitrate per client in kbit/s
+			unsigned int bitrate = 8000;
+			unsigned int duration = 30;
+			/// Zap interval in sec, zero is no zapping
+			unsigned int zap = 10;
+			int httpPort = 0;
+			int rtspPort = 0;
+			/// The first RTP port for RTSP over UDP, each client uses two
+			int rtpPort = 45000;
+		};
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		explicit LoadTest(const Config &config);
+
+		virtual ~LoadTest() = default;
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Check if the protocol of the configuration is known
+		static bool isValidProtocol(const std::string &protocol);
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Run the load test and print the report
+		/// @param stop specifies to stop before the duration has elapsed
+		/// @return true if all clients could stream
+		bool run(const std::atomic_bool &stop);
+
+	private:
+
+		/// Print the report of the stopped clients
+		/// @param seconds specifies the duration of the test
+		/// @param serverCPU specifies the CPU time used by SatPI (without the clients)
+		/// @return true if all clients could stream
+		bool printReport(double seconds, double serverCPU) const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		using UpClientSimulator = std::unique_ptr<ClientSimulator>;
+
+		Config _config;
+		std::vector<UpClientSimulator> _clients;
+};
+
+}
+
+#endif // LOADTEST_LOADTEST_H_INCLUDE
@@ -21,7 +21,21 @@
 #include <Satpi.h>
 #include <StringConverter.h>
 #include <Utils.h>
+#include <base/Benchmark.h>
 #include <base/ChildPIPEReader.h>
+#include <base/Mutex.h>
+#include <input/dvb/Benchmarks.h>
+#include <input/dvb/DVBDevice.h>
+#include <input/dvb/SimulatedDVBDevice.h>
+#include <loadtest/LoadTest.h>
+#include <mpegts/Benchmarks.h>
+#include <mpegts/CRC32.h>
+#ifdef LIBDVBCSA
+#include <decrypt/dvbapi/Descrambler.h>
+#endif
+#ifdef ADDDVBCA
+#include <decrypt/dvbca/DVBCA.h>
+#endif
 
 #include <atomic>
 #include <iostream>
@@ -192,6 +206,9 @@ namespace {
 			"\t--version                     show the version number\r\n" \
 			"\t--user xx                     run as user\r\n" \
 			"\t--dvb-path <path>             set path were to find dvb devices default /dev/dvb\r\n" \
+			"\t--dvb-simulate <adapters>     simulate number of DVB adapters instead of using the devices (0 - 16)\r\n" \
+			"\t--dvb-simulate-ts <file>      feed the simulated adapters with this TS file, default a generated stream\r\n" \
+			"\t--dvb-simulate-lock <msec>    time the simulated frontends need to lock, default 250\r\n" \
 			"\t--app-data-path <path>        set path for application state data eg. xml files etc\r\n" \
 			"\t--iface-name                  set the network interface to bind to (eg. eth0)\r\n" \
 			"\t--http-path <path>            set root path of web/http pages\r\n" \
@@ -199,15 +216,78 @@ namespace {
 			"\t--rtsp-port <port>            set rtsp port default 554  ( 554 - 65535)\r\n" \
 			"\t--backtrace <file>            backtrace 'file'\r\n" \
 			"\t--ssdp-ttl <hops>             set the TTL that is used for SSDP server (1 - 15)\r\n" \
+			"\t--max-clients <number>        set the maximum amount of HTTP and RTSP clients each, default 0 (no limit)\r\n" \
+			"\t--httpc-threads <number>      set the amount of threads handling HTTP and RTSP requests each (1 - 16)\r\n" \
+			"\t                              stream session requests are still handled one at a time\r\n" \
 			"\t--childpipe <number>          enabled number amount of Frontends 'Child PIPE - TS Reader' (0 - 25)\r\n" \
-			"\t--enable-unsecure-frontends   enable to use 'Child PIPE - TS Reader' in command directly\r\n" \
+			"\t--http-input <number>         enabled number amount of Frontends 'HTTP - TS Reader' (0 - 25)\r\n" \
+			"\t--enable-unsecure-frontends   enable to use 'Child PIPE - TS Reader', 'HTTP - TS Reader' in command\r\n" \
+			"\t                              directly, 'Capture Replayer' and stream captures\r\n" \
+			"\t--synthetic <number>          enabled number amount of Frontends 'Synthetic TS Generator' (0 - 128)\r\n" \
 			"\t--no-daemon                   do NOT daemonize\r\n" \
-			"\t--no-ssdp                     do NOT advertise server\r\n", prog_name);
+			"\t--no-ssdp                     do NOT advertise server\r\n" \
+			"\t--mutex-profile               record mutex contention (see /metrics and log at exit)\r\n" \
+			"\t--bench <name|all>            run the micro benchmarks with 'name' in their name and exit\r\n" \
+			"\t--bench-json <file>           save the micro benchmark results as JSON to 'file'\r\n" \
+			"\t--bench-baseline <file>       compare the micro benchmarks with the JSON results of an earlier run\r\n" \
+			"\t--load-test <clients>         run a load test with simulated clients on loopback and exit (1 - 64)\r\n" \
+			"\t--load-test-protocol <name>   protocol of the clients 'http', 'rtsp', 'rtsp-tcp' or 'mix', default mix\r\n" \
+			"\t--load-test-bitrate <kbit/s>  bitrate of the stream per client, default 8000\r\n" \
+			"\t--load-test-duration <sec>    duration of the load test, default 30\r\n" \
+			"\t--load-test-zap <sec>         let the clients zap every 'sec', 0 is no zapping, default 10\r\n", prog_name);
+#ifdef LIBDVBCSA
+		printf("\t--descrambler <list>          descrambler backend(s) 'libdvbcsa' or path to libdvbcsa.so (CSV)\r\n" \
+			"\t                              the fastest one is selected, default libdvbcsa\r\n");
+#endif
+	}
+
+	/// Run the micro benchmarks
+	/// @return false if an implementation under test is incorrect or the
+	/// results are a regression to the baseline
+	bool runBenchmarks(const std::string &filter, const std::string &jsonFile,
+			const std::string &baselineFile) {
+		if (!mpegts::CRC32::checkImplementations()) {
+			printf("CRC32 known answer check failed\r\n");
+			return false;
+		}
+		base::Benchmark benchmark(filter);
+		mpegts::Benchmarks::run(benchmark);
+		input::dvb::Benchmarks::run(benchmark);
+		StringConverter::runBenchmarks(benchmark);
+#ifdef LIBDVBCSA
+		decrypt::dvbapi::Descrambler::runBenchmarks(benchmark);
+#endif
+		if (!jsonFile.empty()) {
+			std::ofstream file(jsonFile);
+			file << benchmark.toJSON();
+		}
+		if (!baselineFile.empty()) {
+			std::ifstream file(baselineFile);
+			if (!file.is_open()) {
+				printf("Could not open baseline: %s\r\n", baselineFile.c_str());
+				return false;
+			}
+			const std::string baseline((std::istreambuf_iterator<char>(file)),
+				std::istreambuf_iterator<char>());
+			return benchmark.compareWith(baseline);
+		}
+		return true;
 	}
 }
 
 int main(int argc, char *argv[]) {
 	bool daemon = true;
+	std::string bench;
+	std::string benchJSON;
+	std::string benchBaseline;
+	loadtest::LoadTest::Config loadTest;
+	input::dvb::SimulatedDVBDevice::Config dvbSimulate;
+#ifdef SIMU
+	dvbSimulate.adapters = 2;
+#else
+	dvbSimulate.adapters = 0;
+#endif
+	bool loadTestOK = true;
 	char *user = nullptr;
 	extern const char *satpi_version;
 	exitApp = false;
@@ -240,6 +320,40 @@ int main(int argc, char *argv[]) {
 					printUsage(argv[0]);
 					return EXIT_FAILURE;
 				}
+			} else if (strcmp(argv[i], "--dvb-simulate") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					const int adapters = std::stoi(argv[i]);
+					if (adapters < 0 || adapters > 16) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+					dvbSimulate.adapters = adapters;
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--dvb-simulate-ts") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					dvbSimulate.tsFile = argv[i];
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--dvb-simulate-lock") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					const int lockTime = std::stoi(argv[i]);
+					if (lockTime < 0) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+					dvbSimulate.lockTime = lockTime;
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
 			} else if (strcmp(argv[i], "--childpipe") == 0) {
 				if (i + 1 < argc) {
 					++i;
@@ -252,6 +366,30 @@ int main(int argc, char *argv[]) {
 					printUsage(argv[0]);
 					return EXIT_FAILURE;
 				}
+			} else if (strcmp(argv[i], "--http-input") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.numberOfHTTP = std::stoi(argv[i]);
+					if (params.numberOfHTTP < 0 || params.numberOfHTTP > 25) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--synthetic") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.numberOfSynthetic = std::stoi(argv[i]);
+					if (params.numberOfSynthetic < 0 || params.numberOfSynthetic > 128) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
 			} else if (strcmp(argv[i], "--enable-unsecure-frontends") == 0) {
 				params.enableUnsecureFrontends = true;
 			} else if (strcmp(argv[i], "--app-data-path") == 0) {
@@ -324,6 +462,114 @@ int main(int argc, char *argv[]) {
 					printUsage(argv[0]);
 					return EXIT_FAILURE;
 				}
+			} else if (strcmp(argv[i], "--max-clients") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.maxClients = std::stoi(argv[i]);
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--httpc-threads") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.httpcThreads = std::stoi(argv[i]);
+					if (params.httpcThreads < 1 || params.httpcThreads > Properties::HTTPC_THREADS_MAX) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--mutex-profile") == 0) {
+				base::MutexProfiler::enable();
+			} else if (strcmp(argv[i], "--bench") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					bench = argv[i];
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--bench-json") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					benchJSON = argv[i];
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--bench-baseline") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					benchBaseline = argv[i];
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--load-test") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					loadTest.clients = std::stoi(argv[i]);
+					if (loadTest.clients < 1 || loadTest.clients > 64) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--load-test-protocol") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					loadTest.protocol = argv[i];
+					if (!loadtest::LoadTest::isValidProtocol(loadTest.protocol)) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--load-test-bitrate") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					loadTest.bitrate = std::stoi(argv[i]);
+					if (loadTest.bitrate == 0) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--load-test-duration") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					loadTest.duration = std::stoi(argv[i]);
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--load-test-zap") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					loadTest.zap = std::stoi(argv[i]);
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+#ifdef LIBDVBCSA
+			} else if (strcmp(argv[i], "--descrambler") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					decrypt::dvbapi::Descrambler::setSelection(argv[i]);
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+#endif
 			} else if (strcmp(argv[i], "--version") == 0) {
 				std::cout << "SatPI version: " << satpi_version << "\r\n";
 				return EXIT_SUCCESS;
@@ -339,6 +585,19 @@ int main(int argc, char *argv[]) {
 		printUsage(argv[0]);
 		return EXIT_FAILURE;
 	}
+	if (!bench.empty()) {
+		return runBenchmarks(bench, benchJSON, benchBaseline) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (loadTest.clients > 0) {
+		// Run on loopback with (spare, for HTTP zapping) synthetic frontends
+		daemon = false;
+		params.ssdp = false;
+		params.numberOfSynthetic = std::max<int>(params.numberOfSynthetic, 2 * loadTest.clients);
+		params.httpPort = (params.httpPort == 0) ? 8875 : params.httpPort;
+		params.rtspPort = (params.rtspPort == 0) ? 554 : params.rtspPort;
+		loadTest.httpPort = params.httpPort;
+		loadTest.rtspPort = params.rtspPort;
+	}
 
 	// Open logging
 	Log::openAppLog("SatPI", daemon);
@@ -347,6 +606,7 @@ int main(int argc, char *argv[]) {
 	if (daemon) {
 		daemonize("/var/lock/" LOCK_FILE, user);
 	}
+	Log::startLogThread();
 
 	// trap signals that we expect to receive
 	signal(SIGSEGV, child_handler);
@@ -355,6 +615,10 @@ int main(int argc, char *argv[]) {
 	// notify we are alive
 	SI_LOG_INFO("--- Starting SatPI version: @#1 ---", satpi_version);
 	SI_LOG_INFO("Number of processors online: @#1", base::ThreadBase::getNumberOfProcessorsOnline());
+	if (dvbSimulate.adapters > 0) {
+		input::dvb::DVBDevice::setInstance(
+			std::make_unique<input::dvb::SimulatedDVBDevice>(dvbSimulate));
+	}
 	do {
 		try {
 			restartApp = false;
@@ -365,6 +629,12 @@ int main(int argc, char *argv[]) {
 #endif
 			SatPI satpi(params);
 
+			if (loadTest.clients > 0) {
+				loadtest::LoadTest test(loadTest);
+				loadTestOK = test.run(exitApp);
+				exitApp = true;
+			}
+
 			// Loop
 			while (!exitApp && !restartApp) {
 				std::this_thread::sleep_for(std::chrono::milliseconds(150));
@@ -378,9 +648,10 @@ int main(int argc, char *argv[]) {
 			SI_LOG_INFO("--- Restarting SatPI version: @#1 ---", satpi_version);
 		}
 	} while (restartApp);
+	base::MutexProfiler::logReport();
 	SI_LOG_INFO("--- stopped ---");
 
 	Log::closeAppLog();
 
-	return EXIT_SUCCESS;
+	return loadTestOK ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,184 @@
+/* Benchmarks.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/Benchmarks.h>
+
+#include <base/Benchmark.h>
+#include <mpegts/CRC32.h>
+#include <mpegts/Filter.h>
+#include <mpegts/PacketBuffer.h>
+#include <mpegts/PAT.h>
+#include <mpegts/PidTable.h>
+#include <mpegts/PMT.h>
+#include <mpegts/SDT.h>
+#include <mpegts/SectionAssembler.h>
+#include <mpegts/TableData.h>
+#include <mpegts/TSCorpus.h>
+#include <StringConverter.h>
+
+#include <cstring>
+#include <vector>
+
+namespace mpegts {
+
+namespace {
+
+	constexpr std::size_t CORPUS_PACKETS = 7 * 1024;
+	constexpr std::size_t BUFFER_SIZE = PacketBuffer::MTU_MAX_TS_PACKET_SIZE;
+
+	/// Make the section, as the @c SectionAssembler would deliver it
+	Section makeSection(const int pid, const TSData &data) {
+		Section section;
+		section.pid = pid;
+		section.data = data.data();
+		section.length = data.size();
+		section.tableID = data[0];
+		section.syntax = true;
+		section.tableIDExtension = (data[3] << 8) | data[4];
+		section.version = (data[5] >> 1) & 0x1F;
+		section.currentNext = true;
+		section.secNr = data[6];
+		section.lastSecNr = data[7];
+		const std::size_t crc = data.size() - 4;
+		section.crc = (data[crc] << 24) | (data[crc + 1] << 16) | (data[crc + 2] << 8) | data[crc + 3];
+		section.changed = true;
+		return section;
+	}
+
+	/// Measure the filter for the requested PIDs
+	void runFilter(base::Benchmark &benchmark, const std::string &name,
+			const TSCorpus &corpus, const std::string &pids, const bool purge) {
+		if (!benchmark.isSelected(name)) {
+			return;
+		}
+		const FeID id = 0;
+		Filter filter;
+		filter.parsePIDString(id, pids, true);
+		filter.updatePIDFilters(id,
+			[](const int) { return true; },
+			[](const int) { return true; });
+		PacketBuffer buffer;
+		std::size_t packet = 0;
+		benchmark.run(name, BUFFER_SIZE, [&] {
+			packet = corpus.fill(buffer, packet);
+			filter.filterData(id, buffer, purge);
+		});
+	}
+
+	/// Measure the purge of the marked packets
+	void runPurge(base::Benchmark &benchmark, const std::string &name,
+			const TSCorpus &corpus, const std::vector<std::size_t> &marked) {
+		PacketBuffer buffer;
+		std::size_t packet = 0;
+		benchmark.run(name, BUFFER_SIZE, [&] {
+			packet = corpus.fill(buffer, packet);
+			for (const std::size_t i : marked) {
+				buffer.markTSForPurging(i);
+			}
+			buffer.purge();
+		});
+	}
+
+	/// Measure the parsing of one section of the table
+	template<typename TABLE>
+	void runParse(base::Benchmark &benchmark, const std::string &name,
+			const int pid, const TSData &data) {
+		const Section section = makeSection(pid, data);
+		benchmark.run(name, data.size(), [&] {
+			TABLE table;
+			table.addSection(section);
+			table.parse(0);
+			base::Benchmark::doNotOptimize(table);
+		});
+	}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+void Benchmarks::run(base::Benchmark &benchmark) {
+	const TSCorpus corpus(CORPUS_PACKETS);
+
+	// PacketBuffer::trySyncing on unsynced buffers, a synced buffer returns
+	// immediately (the fill of the buffer is included)
+	{
+		PacketBuffer buffer;
+		std::vector<unsigned char> noSync(BUFFER_SIZE, 0x00);
+		const struct {
+			const char *name;
+			const unsigned char *data;
+		} cases[] = {
+			// The buffer starts in the middle of the first packet
+			{ "mpegts/trySyncing/resync", corpus.getPacket(0) + 37 },
+			// The buffer starts just after the sync byte, so the scan is the longest
+			{ "mpegts/trySyncing/resync-late", corpus.getPacket(0) + 1 },
+			// No sync at all, the whole buffer is scanned and flushed
+			{ "mpegts/trySyncing/no-sync", noSync.data() }
+		};
+		for (const auto &c : cases) {
+			benchmark.run(c.name, BUFFER_SIZE, [&] {
+				buffer.reset();
+				std::memcpy(buffer.getWriteBufferPtr(), c.data, BUFFER_SIZE);
+				buffer.addAmountOfBytesWritten(BUFFER_SIZE);
+				base::Benchmark::doNotOptimize(buffer.trySyncing());
+			});
+		}
+	}
+
+	// PacketBuffer::purge (the fill of the buffer is included, see 'none')
+	runPurge(benchmark, "mpegts/purge/none", corpus, {});
+	runPurge(benchmark, "mpegts/purge/sparse", corpus, {3});
+	runPurge(benchmark, "mpegts/purge/every-other", corpus, {0, 2, 4, 6});
+	runPurge(benchmark, "mpegts/purge/trailing", corpus, {4, 5, 6});
+	runPurge(benchmark, "mpegts/purge/all-but-one", corpus, {0, 1, 2, 4, 5, 6});
+
+	// Filter::filterData (the fill of the buffer is included)
+	runFilter(benchmark, "mpegts/filterData/all-pids", corpus, "all", false);
+	runFilter(benchmark, "mpegts/filterData/sparse-pids", corpus,
+		StringConverter::stringFormat("0,17,@#1,@#2,@#3", TSCorpus::PMT_PID,
+			TSCorpus::VIDEO_PID, TSCorpus::AUDIO_PID), true);
+
+	// PidTable::addPIDData
+	{
+		PidTable pidTable;
+		std::size_t packet = 0;
+		benchmark.run("mpegts/PidTable::addPIDData", 188, [&] {
+			const unsigned char *ts = corpus.getPacket(packet++);
+			pidTable.addPIDData(((ts[1] & 0x1F) << 8) | ts[2], ts[3]);
+		});
+	}
+
+	// CRC32 per implementation and TableData::calculateCRC32 (selected one)
+	CRC32::runBenchmarks(benchmark);
+	for (const std::size_t size : {188, 1024, 4096}) {
+		const unsigned char *data = corpus.getData().data();
+		benchmark.run(StringConverter::stringFormat("mpegts/calculateCRC32/@#1", size), size, [&] {
+			base::Benchmark::doNotOptimize(TableData::calculateCRC32(data, size));
+		});
+	}
+
+	// PSI/SI parsing
+	runParse<PAT>(benchmark, "mpegts/PAT::parse", 0, TSCorpus::makePAT());
+	runParse<PMT>(benchmark, "mpegts/PMT::parse", TSCorpus::PMT_PID, TSCorpus::makePMT(0));
+	runParse<SDT>(benchmark, "mpegts/SDT::parse", 17, TSCorpus::makeSDT());
+}
+
+}
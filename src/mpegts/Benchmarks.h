@@ -0,0 +1,40 @@
+/* Benchmarks.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_BENCHMARKS_H_INCLUDE
+#define MPEGTS_BENCHMARKS_H_INCLUDE MPEGTS_BENCHMARKS_H_INCLUDE
+
+#include <FwDecl.h>
+
+FW_DECL_NS1(base, Benchmark);
+
+namespace mpegts {
+
+/// The class @c Benchmarks has the micro benchmarks of the mpegts data path,
+/// they run on a @c TSCorpus
+class Benchmarks {
+	public:
+
+		/// Run the (selected) mpegts micro benchmarks
+		static void run(base::Benchmark &benchmark);
+};
+
+}
+
+#endif // MPEGTS_BENCHMARKS_H_INCLUDE
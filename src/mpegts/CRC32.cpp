@@ -0,0 +1,469 @@
+/* CRC32.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+
+#include <Log.h>
+#include <StringConverter.h>
+#include <base/Benchmark.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define HAS_CRC32_PCLMUL
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+	#include <arm_neon.h>
+	#define HAS_CRC32_PMULL
+#endif
+
+namespace mpegts {
+
+namespace {
+	std::array<uint32_t, 256> globalCRC32Table  {
+		0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9,
+		0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005,
+		0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
+		0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd,
+		0x4c11db70, 0x48d0c6c7, 0x4593e01e, 0x4152fda9,
+		0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
+		0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011,
+		0x791d4014, 0x7ddc5da3, 0x709f7b7a, 0x745e66cd,
+		0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
+		0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5,
+		0xbe2b5b58, 0xbaea46ef, 0xb7a96036, 0xb3687d81,
+		0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
+		0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49,
+		0xc7361b4c, 0xc3f706fb, 0xceb42022, 0xca753d95,
+		0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
+		0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d,
+		0x34867077, 0x30476dc0, 0x3d044b19, 0x39c556ae,
+		0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
+		0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16,
+		0x018aeb13, 0x054bf6a4, 0x0808d07d, 0x0cc9cdca,
+		0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
+		0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02,
+		0x5e9f46bf, 0x5a5e5b08, 0x571d7dd1, 0x53dc6066,
+		0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
+		0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e,
+		0xbfa1b04b, 0xbb60adfc, 0xb6238b25, 0xb2e29692,
+		0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
+		0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a,
+		0xe0b41de7, 0xe4750050, 0xe9362689, 0xedf73b3e,
+		0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
+		0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686,
+		0xd5b88683, 0xd1799b34, 0xdc3abded, 0xd8fba05a,
+		0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
+		0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb,
+		0x4f040d56, 0x4bc510e1, 0x46863638, 0x42472b8f,
+		0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
+		0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47,
+		0x36194d42, 0x32d850f5, 0x3f9b762c, 0x3b5a6b9b,
+		0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
+		0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623,
+		0xf12f560e, 0xf5ee4bb9, 0xf8ad6d60, 0xfc6c70d7,
+		0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
+		0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f,
+		0xc423cd6a, 0xc0e2d0dd, 0xcda1f604, 0xc960ebb3,
+		0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
+		0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b,
+		0x9b3660c6, 0x9ff77d71, 0x92b45ba8, 0x9675461f,
+		0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
+		0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640,
+		0x4e8ee645, 0x4a4ffbf2, 0x470cdd2b, 0x43cdc09c,
+		0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
+		0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24,
+		0x119b4be9, 0x155a565e, 0x18197087, 0x1cd86d30,
+		0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
+		0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088,
+		0x2497d08d, 0x2056cd3a, 0x2d15ebe3, 0x29d4f654,
+		0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
+		0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c,
+		0xe3a1cbc1, 0xe760d676, 0xea23f0af, 0xeee2ed18,
+		0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
+		0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0,
+		0x9abc8bd5, 0x9e7d9662, 0x933eb0bb, 0x97ffad0c,
+		0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
+		0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
+	};
+
+	// =========================================================================
+	//  -- Table (byte at a time) ----------------------------------------------
+	// =========================================================================
+
+	uint32_t updateTable(uint32_t crc, const unsigned char *data, const std::size_t len) noexcept {
+		for (std::size_t i = 0; i < len; ++i) {
+			crc = (crc << 8) ^ globalCRC32Table[((crc >> 24) ^ data[i]) & 0xff];
+		}
+		return crc;
+	}
+
+	uint32_t calculateTable(const unsigned char *data, const std::size_t len) {
+		return updateTable(0xffffffff, data, len);
+	}
+
+	// =========================================================================
+	//  -- Slice-by-8 ----------------------------------------------------------
+	// =========================================================================
+
+	/// Table @c [k][b] is the CRC of byte b followed by k zero bytes
+	using SliceTable = std::array<std::array<uint32_t, 256>, 8>;
+
+	const SliceTable &getSliceTable() noexcept {
+		static const SliceTable table = [] {
+			SliceTable t;
+			t[0] = globalCRC32Table;
+			for (std::size_t k = 1; k < t.size(); ++k) {
+				for (std::size_t b = 0; b < 256; ++b) {
+					const uint32_t prev = t[k - 1][b];
+					t[k][b] = (prev << 8) ^ globalCRC32Table[prev >> 24];
+				}
+			}
+			return t;
+		}();
+		return table;
+	}
+
+	uint32_t updateSlice8(uint32_t crc, const unsigned char *data, std::size_t len) noexcept {
+		const SliceTable &t = getSliceTable();
+		while (len >= 8) {
+			const uint32_t w1 = crc ^ ((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+			crc = t[7][w1 >> 24] ^ t[6][(w1 >> 16) & 0xff] ^ t[5][(w1 >> 8) & 0xff] ^ t[4][w1 & 0xff] ^
+			      t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+			data += 8;
+			len -= 8;
+		}
+		return updateTable(crc, data, len);
+	}
+
+	uint32_t calculateSlice8(const unsigned char *data, const std::size_t len) {
+		return updateSlice8(0xffffffff, data, len);
+	}
+
+	// =========================================================================
+	//  -- Carry-less multiply folding -----------------------------------------
+	// =========================================================================
+
+	/// The 128 bit state X = H * x^64 + L is folded over a distance of d bits
+	/// with X * x^d = H * (x^(d+64) mod P) + L * (x^d mod P), so only the two
+	/// 32 bit constants are needed. The folded state is turned into the CRC
+	/// register by feeding its 16 bytes to the table implementation.
+
+	/// Calculate x^n mod P
+	uint32_t xPowModP(std::size_t n) noexcept {
+		uint32_t r = 1;
+		while (n-- > 0) {
+			r = (r & 0x80000000) ? ((r << 1) ^ 0x04c11db7) : (r << 1);
+		}
+		return r;
+	}
+
+	struct FoldConstants {
+		uint64_t k128[2]; // x^128 mod P, x^192 mod P
+		uint64_t k512[2]; // x^512 mod P, x^576 mod P
+	};
+
+	[[maybe_unused]] const FoldConstants &getFoldConstants() noexcept {
+		static const FoldConstants constants = {
+			{ xPowModP(128), xPowModP(192) },
+			{ xPowModP(512), xPowModP(576) }
+		};
+		return constants;
+	}
+
+#ifdef HAS_CRC32_PCLMUL
+	__attribute__((target("pclmul,ssse3")))
+	inline __m128i loadBE(const unsigned char *data, const __m128i reverse) noexcept {
+		return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), reverse);
+	}
+
+	__attribute__((target("pclmul,ssse3")))
+	inline __m128i fold(const __m128i x, const __m128i k) noexcept {
+		return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+	}
+
+	__attribute__((target("pclmul,ssse3")))
+	uint32_t calculatePCLMUL(const unsigned char *data, std::size_t len) {
+		if (len < 64) {
+			return calculateSlice8(data, len);
+		}
+		const FoldConstants &c = getFoldConstants();
+		const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		const __m128i k128 = _mm_set_epi64x(c.k128[1], c.k128[0]);
+		const __m128i k512 = _mm_set_epi64x(c.k512[1], c.k512[0]);
+
+		// Initial value 0xFFFFFFFF is xor-ed with the first 32 bits
+		__m128i x0 = _mm_xor_si128(loadBE(data, reverse), _mm_set_epi32(-1, 0, 0, 0));
+		__m128i x1 = loadBE(data + 16, reverse);
+		__m128i x2 = loadBE(data + 32, reverse);
+		__m128i x3 = loadBE(data + 48, reverse);
+		data += 64;
+		len -= 64;
+		while (len >= 64) {
+			x0 = _mm_xor_si128(fold(x0, k512), loadBE(data, reverse));
+			x1 = _mm_xor_si128(fold(x1, k512), loadBE(data + 16, reverse));
+			x2 = _mm_xor_si128(fold(x2, k512), loadBE(data + 32, reverse));
+			x3 = _mm_xor_si128(fold(x3, k512), loadBE(data + 48, reverse));
+			data += 64;
+			len -= 64;
+		}
+		__m128i x = _mm_xor_si128(fold(x0, k128), x1);
+		x = _mm_xor_si128(fold(x, k128), x2);
+		x = _mm_xor_si128(fold(x, k128), x3);
+		while (len >= 16) {
+			x = _mm_xor_si128(fold(x, k128), loadBE(data, reverse));
+			data += 16;
+			len -= 16;
+		}
+		alignas(16) unsigned char state[16];
+		_mm_store_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi8(x, reverse));
+		const uint32_t crc = updateSlice8(0, state, sizeof(state));
+		return updateSlice8(crc, data, len);
+	}
+#endif
+
+#ifdef HAS_CRC32_PMULL
+	/// Load 16 bytes as one big endian 128 bit value, lane 0 has the low 64 bits
+	inline uint64x2_t loadBE(const unsigned char *data) noexcept {
+		const uint8x16_t v = vrev64q_u8(vld1q_u8(data));
+		return vreinterpretq_u64_u8(vextq_u8(v, v, 8));
+	}
+
+	inline uint64x2_t fold(const uint64x2_t x, const uint64x2_t k) noexcept {
+		const poly64x2_t px = vreinterpretq_p64_u64(x);
+		const poly64x2_t pk = vreinterpretq_p64_u64(k);
+		return veorq_u64(
+			vreinterpretq_u64_p128(vmull_p64(vgetq_lane_p64(px, 0), vgetq_lane_p64(pk, 0))),
+			vreinterpretq_u64_p128(vmull_high_p64(px, pk)));
+	}
+
+	/// The same folding as @c calculatePCLMUL with the ARMv8 Crypto Extension
+	uint32_t calculatePMULL(const unsigned char *data, std::size_t len) {
+		if (len < 64) {
+			return calculateSlice8(data, len);
+		}
+		const FoldConstants &c = getFoldConstants();
+		const uint64x2_t k128 = vcombine_u64(vcreate_u64(c.k128[0]), vcreate_u64(c.k128[1]));
+		const uint64x2_t k512 = vcombine_u64(vcreate_u64(c.k512[0]), vcreate_u64(c.k512[1]));
+
+		// Initial value 0xFFFFFFFF is xor-ed with the first 32 bits
+		uint64x2_t x0 = veorq_u64(loadBE(data), vcombine_u64(vcreate_u64(0), vcreate_u64(0xffffffff00000000)));
+		uint64x2_t x1 = loadBE(data + 16);
+		uint64x2_t x2 = loadBE(data + 32);
+		uint64x2_t x3 = loadBE(data + 48);
+		data += 64;
+		len -= 64;
+		while (len >= 64) {
+			x0 = veorq_u64(fold(x0, k512), loadBE(data));
+			x1 = veorq_u64(fold(x1, k512), loadBE(data + 16));
+			x2 = veorq_u64(fold(x2, k512), loadBE(data + 32));
+			x3 = veorq_u64(fold(x3, k512), loadBE(data + 48));
+			data += 64;
+			len -= 64;
+		}
+		uint64x2_t x = veorq_u64(fold(x0, k128), x1);
+		x = veorq_u64(fold(x, k128), x2);
+		x = veorq_u64(fold(x, k128), x3);
+		while (len >= 16) {
+			x = veorq_u64(fold(x, k128), loadBE(data));
+			data += 16;
+			len -= 16;
+		}
+		const uint8x16_t v = vrev64q_u8(vreinterpretq_u8_u64(x));
+		unsigned char state[16];
+		vst1q_u8(state, vextq_u8(v, v, 8));
+		const uint32_t crc = updateSlice8(0, state, sizeof(state));
+		return updateSlice8(crc, data, len);
+	}
+#endif
+
+	// =========================================================================
+	//  -- Selection -----------------------------------------------------------
+	// =========================================================================
+
+	/// Check the implementation against CRCs calculated bit by bit. The lengths
+	/// are chosen to pass every path of the folding implementations (short
+	/// input, 64 byte blocks, 16 byte tail and the remaining bytes)
+	template<typename FUNC>
+	bool knownAnswerCheck(FUNC function) {
+		// The check value of CRC-32/MPEG-2
+		const unsigned char check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+		if (function(check, 0) != 0xffffffff || function(check, sizeof(check)) != 0x0376e6e7) {
+			return false;
+		}
+		// PAT section (program 1 on PID 0x100), the CRC over the section
+		// including its CRC is zero
+		const unsigned char pat[] = {
+			0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1, 0x00, 0x00,
+			0x00, 0x01, 0xe1, 0x00, 0xe8, 0xf9, 0x5e, 0x7d
+		};
+		if (function(pat, sizeof(pat) - 4) != 0xe8f95e7d || function(pat, sizeof(pat)) != 0) {
+			return false;
+		}
+		std::vector<unsigned char> buf(256);
+		for (std::size_t i = 0; i < buf.size(); ++i) {
+			buf[i] = static_cast<unsigned char>(i);
+		}
+		if (function(buf.data(), buf.size()) != 0x494a116a) {
+			return false;
+		}
+		buf.assign(1000, 0x00);
+		if (function(buf.data(), buf.size()) != 0xfe172f9f) {
+			return false;
+		}
+		buf.assign(4096, 0xff);
+		return function(buf.data(), buf.size()) == 0xaf19d570;
+	}
+
+	/// Check the implementation against the known answers and against the
+	/// byte-wise table implementation with pseudo random data for all lengths
+	/// up to a few KB
+	template<typename FUNC>
+	bool selfCheck(FUNC function) {
+		if (!knownAnswerCheck(function)) {
+			return false;
+		}
+		std::vector<unsigned char> buf(4096 + 64);
+		uint32_t seed = 0x12345678;
+		for (unsigned char &b : buf) {
+			seed = seed * 1103515245 + 12345;
+			b = seed >> 24;
+		}
+		for (std::size_t len = 0; len <= 600; ++len) {
+			for (std::size_t offset = 0; offset < 4; ++offset) {
+				if (function(&buf[offset], len) != calculateTable(&buf[offset], len)) {
+					return false;
+				}
+			}
+		}
+		return function(buf.data(), 4096) == calculateTable(buf.data(), 4096) &&
+			function(buf.data() + 3, 4093) == calculateTable(buf.data() + 3, 4093);
+	}
+
+	/// Check the implementation against the byte-wise table implementation
+	/// with random buffers of random lengths at random alignments
+	template<typename FUNC>
+	bool propertyCheck(FUNC function, const uint32_t seed) {
+		std::mt19937 gen(seed);
+		std::vector<unsigned char> buf(16 * 1024 + 64);
+		std::uniform_int_distribution<unsigned int> byte(0, 255);
+		for (unsigned char &b : buf) {
+			b = static_cast<unsigned char>(byte(gen));
+		}
+		std::uniform_int_distribution<std::size_t> length(0, 16 * 1024);
+		std::uniform_int_distribution<std::size_t> offset(0, 63);
+		for (unsigned int i = 0; i < 2000; ++i) {
+			const std::size_t len = length(gen);
+			const unsigned char *data = buf.data() + offset(gen);
+			if (function(data, len) != calculateTable(data, len)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool hasPCLMUL() noexcept {
+#ifdef HAS_CRC32_PCLMUL
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#else
+		return false;
+#endif
+	}
+
+}
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+const CRC32::Implementation &CRC32::getSelected() noexcept {
+	static const Implementation selected = [] {
+		Implementation impl = { "slice-by-8", &calculateSlice8 };
+#ifdef HAS_CRC32_PCLMUL
+		if (hasPCLMUL()) {
+			impl = { "pclmul", &calculatePCLMUL };
+		}
+#endif
+#ifdef HAS_CRC32_PMULL
+		impl = { "pmull", &calculatePMULL };
+#endif
+		if (!selfCheck(impl.function)) {
+			SI_LOG_ERROR("CRC32: @#1 failed self check, using slice-by-8", impl.name);
+			impl = { "slice-by-8", &calculateSlice8 };
+		}
+		SI_LOG_INFO("CRC32: Using @#1 implementation", impl.name);
+		return impl;
+	}();
+	return selected;
+}
+
+std::vector<CRC32::Implementation> CRC32::getImplementations() {
+	std::vector<Implementation> impls = {
+		{ "table", &calculateTable },
+		{ "slice-by-8", &calculateSlice8 }
+	};
+#ifdef HAS_CRC32_PCLMUL
+	if (hasPCLMUL()) {
+		impls.push_back({ "pclmul", &calculatePCLMUL });
+	}
+#endif
+#ifdef HAS_CRC32_PMULL
+	impls.push_back({ "pmull", &calculatePMULL });
+#endif
+	return impls;
+}
+
+bool CRC32::checkImplementations() {
+	// A new seed every run, it is logged to reproduce a failure
+	const uint32_t seed = std::random_device()();
+	bool ok = true;
+	for (const Implementation &impl : getImplementations()) {
+		if (!selfCheck(impl.function)) {
+			SI_LOG_ERROR("CRC32: @#1 failed self check", impl.name);
+			ok = false;
+		} else if (!propertyCheck(impl.function, seed)) {
+			SI_LOG_ERROR("CRC32: @#1 differs from the table implementation with random buffers (seed @#2)",
+				impl.name, seed);
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+void CRC32::runBenchmarks(base::Benchmark &benchmark) {
+	std::vector<unsigned char> buf(4096);
+	for (std::size_t i = 0; i < buf.size(); ++i) {
+		buf[i] = static_cast<unsigned char>(i * 7 + 3);
+	}
+	// Typical PSI/SI section sizes
+	for (const Implementation &impl : getImplementations()) {
+		for (const std::size_t size : {188, 1024, 4096}) {
+			benchmark.run(StringConverter::stringFormat("mpegts/CRC32/@#1/@#2", impl.name, size), size, [&] {
+				base::Benchmark::doNotOptimize(impl.function(buf.data(), size));
+			});
+		}
+	}
+}
+
+}
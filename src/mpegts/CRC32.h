@@ -0,0 +1,86 @@
+/* CRC32.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_CRC32_H_INCLUDE
+#define MPEGTS_CRC32_H_INCLUDE MPEGTS_CRC32_H_INCLUDE
+
+#include <FwDecl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+FW_DECL_NS1(base, Benchmark);
+
+namespace mpegts {
+
+/// The class @c CRC32 calculates the MPEG-2 CRC32 (polynomial 0x04C11DB7,
+/// initial value 0xFFFFFFFF, not reflected and no final xor). The fastest
+/// implementation for this CPU is selected on first use and checked against
+/// known answers and the byte-wise table implementation.
+class CRC32 {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		CRC32() = delete;
+
+		// =========================================================================
+		//  -- Static member functions ---------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Calculate the CRC32 with the selected implementation
+		static uint32_t calculate(const unsigned char *data, std::size_t len) noexcept {
+			return getSelected().function(data, len);
+		}
+
+		/// Get the name of the selected implementation
+		static const char *getImplementationName() noexcept {
+			return getSelected().name;
+		}
+
+		/// Check all implementations available on this CPU against the known
+		/// answers and the byte-wise table implementation, also with random
+		/// buffers of random lengths and alignments, failures are logged
+		/// @return true if all implementations are correct
+		static bool checkImplementations();
+
+		/// Run the (selected) micro benchmarks of all implementations available
+		/// on this CPU
+		static void runBenchmarks(base::Benchmark &benchmark);
+
+	private:
+
+		using Function = uint32_t (*)(const unsigned char *data, std::size_t len);
+
+		struct Implementation {
+			const char *name;
+			Function function;
+		};
+
+		static const Implementation &getSelected() noexcept;
+
+		static std::vector<Implementation> getImplementations();
+};
+
+}
+
+#endif // MPEGTS_CRC32_H_INCLUDE
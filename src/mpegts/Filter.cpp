@@ -23,11 +23,12 @@
 #include <Utils.h>
 #include <StringConverter.h>
 #include <mpegts/PacketBuffer.h>
+#ifdef ADDDVBCA
+#include <decrypt/dvbca/CAChannel.h>
+#endif
 
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
+#include <algorithm>
+#include <vector>
 
 namespace mpegts {
 
@@ -35,12 +36,14 @@ namespace mpegts {
 // -- Constructors and destructor ----------------------------------------------
 // =============================================================================
 
-Filter::Filter() {
+Filter::Filter() :
+	_mutex(base::Mutex::Type::NonRecursive) {
 	_nit = std::make_shared<NIT>();
 	_pat = std::make_shared<PAT>();
 	_pcr = std::make_shared<PCR>();
 	_sdt = std::make_shared<SDT>();
 	_userPids = "0,1,16,17,18";
+	subscribeTables_L();
 }
 
 // =============================================================================
@@ -59,8 +62,17 @@ void Filter::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "networkname", sdtData.networkNameUTF8);
 
 	ADD_XML_ELEMENT(xml, "pat", getPATData()->toXML());
+	// Take a snapshot, the reader thread may change the map while we build the XML
+	std::vector<mpegts::SpPMT> pmtList;
+	{
+		base::MutexLock lock(_mutex);
+		pmtList.reserve(_pmtMap.size());
+		for (const auto& [_, pmt] : _pmtMap) {
+			pmtList.push_back(pmt);
+		}
+	}
 	ADD_XML_BEGIN_ELEMENT(xml, "pmtlist");
-		for (const auto& [pid, pmt] : _pmtMap) {
+		for (const mpegts::SpPMT &pmt : pmtList) {
 			ADD_XML_ELEMENT(xml, "pmt", pmt->toXML());
 		}
 	ADD_XML_END_ELEMENT(xml, "pmtlist");
@@ -68,7 +80,7 @@ void Filter::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "nit", getNITData()->toXML());
 }
 
-void Filter::doFromXML(const std::string &xml) {
+void Filter::doFromXML(const base::XMLElement &xml) {
 	std::string element;
 	if (findXMLElement(xml, "addUserPids.value", element)) {
 		if (element.size() > 0) {
@@ -98,7 +110,14 @@ void Filter::clear() {
 	_pcr = std::make_shared<PCR>();
 	_sdt = std::make_shared<SDT>();
 	_pmtMap.clear();
+	_pendingNIT.reset();
+	_pendingPAT.reset();
+	_pendingSDT.reset();
+	_pendingPMTMap.clear();
 	_pidTable.clear();
+	_sectionFilter.clear();
+	_pmtSubscription.clear();
+	subscribeTables_L();
 }
 
 void Filter::parsePIDString(const FeID id, const std::string &reqPids, const bool add) {
@@ -135,6 +154,11 @@ void Filter::parsePIDString(const FeID id, const std::string &reqPids, const boo
 }
 
 void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool filter) {
+	// Reading is completed when the buffer is full
+	const bool full = buffer.full();
+	if (full) {
+		buffer.stamp(mpegts::PacketBuffer::Stage::READ);
+	}
 	base::MutexLock lock(_mutex);
 	const std::size_t begin = buffer.getBeginOfUnFilteredPackets();
 	const std::size_t size = buffer.getNumberOfCompletedPackets();
@@ -151,105 +175,149 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 		}
 		_pidTable.addPIDData(pid, ptr[3]);
 
-		switch (pid) {
-			case 0:
-				if (!_pat->isCollected()) {
-					// collect PAT data
-					_pat->collectData(id, TableData::PAT_ID, ptr, false);
-					// Did we finish collecting PAT
-					if (_pat->isCollected()) {
-						_pat->parse(id);
-					}
-				}
-				break;
-			case 1:
-				// Empty
-				break;
-			case 16:
-				if (!_nit->isCollected()) {
-					// collect NIT data
-					_nit->collectData(id, TableData::NIT_ID, ptr, false);
-
-					// Did we finish collecting SDT
-					if (_nit->isCollected()) {
-						_nit->parse(id);
-					}
-				}
-				break;
-			case 17:
-				if (!_sdt->isCollected()) {
-					// collect SDT data
-					_sdt->collectData(id, TableData::SDT_ID, ptr, false);
-					// Did we finish collecting SDT
-					if (_sdt->isCollected()) {
-						_sdt->parse(id);
-					}
+		if (_sectionFilter.isSubscribed(pid)) {
+			_sectionFilter.filterPacket(id, ptr);
+		} else if (_filterPCR && PCR::isPCRTableData(ptr)) {
+			for (const auto& [_, pmt] : _pmtMap) {
+				const int pcrPID = pmt->getPCRPid();
+				if (pid == pcrPID && _pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
+					_pcr->collectData(id, ptr);
 				}
-				break;
-			case 18:
-				// Empty
-				break;
-			case 20: {
-				const unsigned int tableID = ptr[5];
-				const unsigned int mjd = (ptr[8] << 8) | (ptr[9]);
-				const unsigned int y1 = static_cast<unsigned int>((mjd - 15078.2) / 365.25);
-				const unsigned int m1 = static_cast<unsigned int>((mjd - 14956.1 - static_cast<unsigned int>(y1 * 365.25)) / 30.6001);
-				const unsigned int d = static_cast<unsigned int>(mjd - 14956.0 - static_cast<unsigned int>(y1 * 365.25) - static_cast<unsigned int>(m1 * 30.6001 ));
-				const unsigned int k = (m1 == 14 || m1 ==15) ? 1 : 0;
-				const unsigned int y = y1 + k + 1900;
-				const unsigned int m = m1 - 1 - (k * 12);
-				const unsigned int h = ptr[10];
-				const unsigned int mi = ptr[11];
-				const unsigned int s = ptr[12];
-
-				SI_LOG_INFO("Frontend: @#1, TDT - Table ID: @#2  Date: @#3-@#4-@#5  Time: @#6:@#7.@#8  MJD: @#9",
-					id, HEX(tableID, 2), y, m, d, DIGIT(h, 2), DIGIT(mi, 2), DIGIT(s, 2), HEX(mjd, 4));
-#ifdef ADDDVBCA
-				const char fileFIFO[] = "/tmp/fifo";
-				int fd = ::open(fileFIFO, O_WRONLY | O_NONBLOCK);
-				if (fd > 0) {
-					::write(fd, ptr, 188);
-					::close(fd);
-				}
-#endif
-				}
-				break;
-			case 21:
-				// Empty
-				break;
-			default:
-				if (_pat->isMarkedAsPMT(pid)) {
-					// Did we finish collecting PMT, we always get a valid PMT (empty or filled)
-					mpegts::SpPMT pmt = _pmtMap.try_emplace(pid, std::make_shared<PMT>()).first->second;
-					if (!pmt->isCollected()) {
-						// collect PMT data
-						pmt->collectData(id, TableData::PMT_ID, ptr, false);
-						if (pmt->isCollected()) {
-							pmt->parse(id);
-						}
-#ifdef ADDDVBCA
-						const char fileFIFO[] = "/tmp/fifo";
-						int fd = ::open(fileFIFO, O_WRONLY | O_NONBLOCK);
-						if (fd > 0) {
-							::write(fd, ptr, 188);
-							::close(fd);
-						}
-#endif
-					}
-				} else if (_filterPCR && PCR::isPCRTableData(ptr)) {
-					for (const auto& [_, pmt] : _pmtMap) {
-						const int pcrPID = pmt->getPCRPid();
-						if (pid == pcrPID && _pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
-							_pcr->collectData(id, ptr);
-						}
-					}
-				}
-				break;
+			}
 		}
 	}
 	if (filter) {
 		buffer.purge();
 	}
+	if (full) {
+		buffer.stamp(mpegts::PacketBuffer::Stage::FILTER);
+	}
+}
+
+void Filter::subscribeTables_L() {
+	using namespace std::placeholders;
+	_sectionFilter.subscribe(0, SectionFilter::Match::forTableID(TableData::PAT_ID),
+		std::bind(&Filter::handlePAT_L, this, _1, _2));
+	_sectionFilter.subscribe(16, SectionFilter::Match::forTableID(TableData::NIT_ID),
+		std::bind(&Filter::handleNIT_L, this, _1, _2));
+	_sectionFilter.subscribe(17, SectionFilter::Match::forTableID(TableData::SDT_ID),
+		std::bind(&Filter::handleSDT_L, this, _1, _2));
+	_sectionFilter.subscribe(20, SectionFilter::Match::forTableID(TableData::TDT_ID),
+		std::bind(&Filter::handleTDT_L, this, _1, _2));
+	_sectionFilter.subscribe(20, SectionFilter::Match::forTableID(TableData::TOT_ID),
+		std::bind(&Filter::handleTDT_L, this, _1, _2));
+}
+
+template<typename TABLE>
+bool Filter::updateTable_L(const FeID id, std::shared_ptr<TABLE> &table,
+		std::shared_ptr<TABLE> &pending, const Section &section) {
+	// Not applicable yet
+	if (!section.currentNext) {
+		return false;
+	}
+	if (!table->isCollected()) {
+		table->addSection(section);
+		// Did we finish collecting the table
+		if (table->isCollected()) {
+			table->parse(id);
+			return true;
+		}
+		return false;
+	}
+	// Collected table, so only a changed section starts a new one
+	if (!pending) {
+		if (!section.changed) {
+			return false;
+		}
+		SI_LOG_INFO("Frontend: @#1, @#2 - PID @#3: Version changed to @#4, collecting again",
+			id, TableData::getTableTXT(section.tableID), PID(section.pid), section.version);
+		pending = std::make_shared<TABLE>();
+	}
+	pending->addSection(section);
+	if (!pending->isCollected()) {
+		return false;
+	}
+	pending->parse(id);
+	// Readers holding the old table keep it until they let go
+	table = std::move(pending);
+	pending.reset();
+	return true;
+}
+
+void Filter::handlePAT_L(const FeID id, const Section &section) {
+	if (!updateTable_L(id, _pat, _pendingPAT, section)) {
+		return;
+	}
+	const std::vector<int> pmtPIDs = _pat->getPMTPidList();
+	// Forget the PMTs of the programs that are not in this PAT (version) anymore
+	for (auto it = _pmtSubscription.begin(); it != _pmtSubscription.end(); ) {
+		const int pid = it->first;
+		if (std::find(pmtPIDs.begin(), pmtPIDs.end(), pid) != pmtPIDs.end()) {
+			++it;
+			continue;
+		}
+		SI_LOG_INFO("Frontend: @#1, PMT - PID @#2: Removed from the PAT", id, PID(pid));
+		_sectionFilter.unsubscribe(it->second);
+		_pmtMap.erase(pid);
+		_pendingPMTMap.erase(pid);
+		it = _pmtSubscription.erase(it);
+	}
+	using namespace std::placeholders;
+	for (const int pid : pmtPIDs) {
+		// Not on the PID of the PAT itself, we are called from its subscription
+		if (pid != 0 && _pmtSubscription.find(pid) == _pmtSubscription.end()) {
+			_pmtSubscription[pid] = _sectionFilter.subscribe(pid,
+				SectionFilter::Match::forTableID(TableData::PMT_ID),
+				std::bind(&Filter::handlePMT_L, this, _1, _2));
+		}
+	}
+}
+
+void Filter::handleNIT_L(const FeID id, const Section &section) {
+	updateTable_L(id, _nit, _pendingNIT, section);
+}
+
+void Filter::handleSDT_L(const FeID id, const Section &section) {
+	updateTable_L(id, _sdt, _pendingSDT, section);
+}
+
+void Filter::handleTDT_L(const FeID id, const Section &section) {
+	if (section.length < 8) {
+		return;
+	}
+	const unsigned char* ptr = section.data;
+	const unsigned int tableID = ptr[0];
+	const unsigned int mjd = (ptr[3] << 8) | (ptr[4]);
+	const unsigned int y1 = static_cast<unsigned int>((mjd - 15078.2) / 365.25);
+	const unsigned int m1 = static_cast<unsigned int>((mjd - 14956.1 - static_cast<unsigned int>(y1 * 365.25)) / 30.6001);
+	const unsigned int d = static_cast<unsigned int>(mjd - 14956.0 - static_cast<unsigned int>(y1 * 365.25) - static_cast<unsigned int>(m1 * 30.6001 ));
+	const unsigned int k = (m1 == 14 || m1 ==15) ? 1 : 0;
+	const unsigned int y = y1 + k + 1900;
+	const unsigned int m = m1 - 1 - (k * 12);
+	const unsigned int h = ptr[5];
+	const unsigned int mi = ptr[6];
+	const unsigned int s = ptr[7];
+
+	SI_LOG_INFO("Frontend: @#1, TDT - Table ID: @#2  Date: @#3-@#4-@#5  Time: @#6:@#7.@#8  MJD: @#9",
+		id, HEX(tableID, 2), y, m, d, DIGIT(h, 2), DIGIT(mi, 2), DIGIT(s, 2), HEX(mjd, 4));
+#ifdef ADDDVBCA
+	decrypt::dvbca::CAChannel::getInstance().publishTimeDate(section);
+#endif
+}
+
+void Filter::handlePMT_L(const FeID id, const Section &section) {
+	// We always get a valid PMT (empty or filled)
+	mpegts::SpPMT &pmt = _pmtMap.try_emplace(section.pid, std::make_shared<PMT>()).first->second;
+	mpegts::SpPMT &pending = _pendingPMTMap[section.pid];
+	const bool updated = updateTable_L(id, pmt, pending, section);
+	if (!pending) {
+		_pendingPMTMap.erase(section.pid);
+	}
+	if (updated) {
+#ifdef ADDDVBCA
+		decrypt::dvbca::CAChannel::getInstance().publishPMT(id, pmt);
+#endif
+	}
 }
 
 }
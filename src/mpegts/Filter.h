@@ -31,6 +31,7 @@
 #include <mpegts/PidTable.h>
 #include <mpegts/PMT.h>
 #include <mpegts/SDT.h>
+#include <mpegts/SectionFilter.h>
 
 #include <unordered_map>
 
@@ -59,7 +60,7 @@ class Filter :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
@@ -202,6 +203,28 @@ class Filter :
 
 	private:
 
+		/// Subscribe to the PSI/SI tables we need from the start (PAT, NIT, SDT and TDT/TOT)
+		void subscribeTables_L();
+
+		/// Add the section to the table. When the table is already collected and
+		/// the section changed (version or CRC), a new table is collected next to
+		/// it and swapped in when it is complete and parsed.
+		/// @param id specifies the frontend ID
+		/// @param table specifies the table in use
+		/// @param pending specifies the table that is being re-collected
+		/// @param section specifies the complete and CRC checked section
+		/// @return true if @c table was (re)collected and parsed with this section
+		template<typename TABLE>
+		bool updateTable_L(FeID id, std::shared_ptr<TABLE> &table,
+			std::shared_ptr<TABLE> &pending, const Section &section);
+
+		/// Handle the sections of the subscribed tables
+		void handlePAT_L(FeID id, const Section &section);
+		void handleNIT_L(FeID id, const Section &section);
+		void handleSDT_L(FeID id, const Section &section);
+		void handleTDT_L(FeID id, const Section &section);
+		void handlePMT_L(FeID id, const Section &section);
+
 		/// Open requesed PID filter
 		/// @param feID specifies the frontend ID
 		/// @param pid specifies the PID to open with openPid
@@ -239,10 +262,13 @@ class Filter :
 				// Need to clear the PID Tables as well?
 				if (pid == 0) {
 					_pat = std::make_shared<PAT>();
+					_pendingPAT.reset();
 				} else if (pid == 17) {
 					_sdt = std::make_shared<SDT>();
+					_pendingSDT.reset();
 				} else if (_pmtMap.find(pid) != _pmtMap.end()) {
 					_pmtMap.erase(pid);
+					_pendingPMTMap.erase(pid);
 				} else {
 					// Did we close the PCR Pid
 					for (const auto& [_, pmt] : _pmtMap) {
@@ -270,10 +296,18 @@ class Filter :
 		mutable PMTMap _pmtMap;
 
 		mutable mpegts::PidTable _pidTable;
+		mpegts::SectionFilter _sectionFilter;
 		mutable mpegts::SpNIT _nit;
 		mutable mpegts::SpPAT _pat;
 		mutable mpegts::SpPCR _pcr;
 		mutable mpegts::SpSDT _sdt;
+		/// The subscription of each PMT PID in the PAT
+		std::unordered_map<int, SectionFilter::SubscriptionID> _pmtSubscription;
+		// Tables that are re-collected after a version change
+		PMTMap _pendingPMTMap;
+		mpegts::SpNIT _pendingNIT;
+		mpegts::SpPAT _pendingPAT;
+		mpegts::SpSDT _pendingSDT;
 		bool _filterPCR = false;
 		std::string _userPids;
 };
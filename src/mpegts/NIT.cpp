@@ -160,7 +160,7 @@ void NIT::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "networkID", DIGIT(_nid, 4));
 	ADD_XML_ELEMENT(xml, "networkName", _networkName);
 	for (const auto& entry : _table) {
-		std::string name = "transportStreamID_" + DIGIT(entry.transportStreamID, 0);
+		const std::string name = StringConverter::stringFormat("transportStreamID_@#1", entry.transportStreamID);
 		ADD_XML_BEGIN_ELEMENT(xml, name);
 			ADD_XML_ELEMENT(xml, "msys", entry.msys);
 			ADD_XML_ELEMENT(xml, "freq", entry.freq);
@@ -172,7 +172,7 @@ void NIT::doAddToXML(std::string &xml) const {
 	}
 }
 
-void NIT::doFromXML(const std::string &UNUSED(xml)) {}
+void NIT::doFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
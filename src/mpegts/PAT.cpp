@@ -45,7 +45,7 @@ void PAT::doAddToXML(std::string &xml) const {
 	}
 }
 
-void PAT::doFromXML(const std::string &UNUSED(xml)) {}
+void PAT::doFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 FW_DECL_SP_NS1(mpegts, PAT);
 
@@ -60,7 +61,7 @@ class PAT :
 		virtual void doAddToXML(std::string &xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string &xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
@@ -77,6 +78,15 @@ class PAT :
 			return false;
 		}
 
+		/// Get the PMT PIDs of this PAT
+		std::vector<int> getPMTPidList() const {
+			std::vector<int> pids;
+			for (const auto& [pid, _] : _pmtPidTable) {
+				pids.push_back(pid);
+			}
+			return pids;
+		}
+
 		TSData generateFrom(
 				FeID id, const base::M3UParser::TransformationMap &info);
 
@@ -0,0 +1,199 @@
+/* PCRPacer.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+ */
+#include <mpegts/PCRPacer.h>
+
+#include <mpegts/PCR.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+
+#include <time.h>
+
+namespace mpegts {
+
+namespace {
+
+	constexpr std::size_t TS_PACKET_SIZE = 188;
+
+	/// The PCR runs with 27 MHz and wraps around after 2^33 * 300 ticks
+	constexpr std::int64_t PCR_HZ = 27000000;
+	constexpr std::uint64_t PCR_WRAP = (1ULL << 33) * 300;
+
+	/// A PCR that jumps backwards or more than this forward is a discontinuity
+	constexpr std::uint64_t MAX_PCR_GAP = PCR_HZ;
+
+	/// The weight of a new bitrate sample is 1/BITRATE_SMOOTHING
+	constexpr double BITRATE_SMOOTHING = 8.0;
+
+	/// When the output is behind (or ahead) by more than this, it does not
+	/// try to catch up (to prevent bursts) but starts again from now
+	constexpr std::int64_t MAX_BEHIND_NS = 200000000;
+	constexpr std::int64_t MAX_AHEAD_NS  = 2000000000;
+
+	/// The maximum time to sleep in @c waitUntilDue, so the writer of the
+	/// stream still gets called regularly
+	constexpr std::int64_t MAX_WAIT_NS = 20000000;
+
+	/// The time to sleep when nothing was read since the last wait
+	constexpr std::int64_t IDLE_WAIT_NS = 1000000;
+
+	std::int64_t getMonotonicNS() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (static_cast<std::int64_t>(ts.tv_sec) * 1000000000) + ts.tv_nsec;
+	}
+
+	void sleepUntilNS(const std::int64_t timeNS) {
+		struct timespec ts;
+		ts.tv_sec  = timeNS / 1000000000;
+		ts.tv_nsec = timeNS % 1000000000;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+	}
+
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void PCRPacer::reset() {
+	_bitrate = 0;
+	_clock.clear();
+	_referencePID = -1;
+	_mediaTicks = 0;
+	_mediaPosition = 0;
+	_bitrateEstimate = 0.0;
+	_position = 0;
+	_buffers = 0;
+	_added = false;
+	_anchored = false;
+	_anchorNS = 0;
+	_anchorMediaNS = 0;
+	_deadlineNS = 0;
+}
+
+void PCRPacer::addBuffer(const PacketBuffer &buffer) {
+	const std::size_t packets = buffer.getNumberOfCompletedPackets();
+	for (std::size_t i = 0; i < packets; ++i) {
+		collectPCR(buffer.getTSPacketPtr(i), _position + (i * TS_PACKET_SIZE));
+	}
+	_position += packets * TS_PACKET_SIZE;
+	_bitrate.store(static_cast<std::uint64_t>(_bitrateEstimate), std::memory_order_relaxed);
+	_added = true;
+
+	// Without a bitrate there is nothing to pace with, so release immediately
+	++_buffers;
+	if (_bitrateEstimate <= 0.0 || (_buffers % _burst) != 0) {
+		return;
+	}
+	// The next burst is due when its first byte is due
+	const std::int64_t nowNS = getMonotonicNS();
+	const std::int64_t mediaNS = getMediaTimeNS(_position);
+	std::int64_t deadlineNS = _anchorNS + (mediaNS - _anchorMediaNS);
+	if (!_anchored || nowNS - deadlineNS > MAX_BEHIND_NS || deadlineNS - nowNS > MAX_AHEAD_NS) {
+		_anchored = true;
+		_anchorNS = nowNS;
+		_anchorMediaNS = mediaNS;
+		deadlineNS = nowNS;
+	}
+	_deadlineNS = deadlineNS;
+}
+
+bool PCRPacer::waitUntilDue() {
+	if (_deadlineNS != 0) {
+		std::int64_t nowNS = getMonotonicNS();
+		if (nowNS < _deadlineNS) {
+			sleepUntilNS(std::min(_deadlineNS, nowNS + MAX_WAIT_NS));
+			_wakeups.add();
+			nowNS = getMonotonicNS();
+			if (nowNS < _deadlineNS) {
+				return false;
+			}
+		}
+		_latenessUS.observe((nowNS - _deadlineNS) / 1000);
+		_deadlineNS = 0;
+	} else if (!_added) {
+		// Nothing read since the last time (end of file or no room)
+		sleepUntilNS(getMonotonicNS() + IDLE_WAIT_NS);
+		_wakeups.add();
+	}
+	_added = false;
+	return true;
+}
+
+void PCRPacer::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const {
+	metrics.addGauge("satpi_pacing_bitrate_bits_per_second",
+		"Smoothed PCR bitrate of the paced source", labels, getBitrate());
+	metrics.addHistogram("satpi_pacing_lateness_microseconds",
+		"How late the bursts of the paced source were released", labels, _latenessUS);
+	metrics.addCounter("satpi_pacing_wakeups_total",
+		"Sleeps of the pacer of the source", labels, _wakeups.get());
+}
+
+void PCRPacer::collectPCR(const unsigned char *data, const std::uint64_t position) {
+	// Sync byte, no Transport Error Indicator and an adaptation field with PCR
+	if (data[0] != 0x47 || (data[1] & 0x80) == 0x80 || !PCR::isPCRTableData(data) || data[4] < 7) {
+		return;
+	}
+	const int pid = ((data[1] & 0x1F) << 8) | data[2];
+	const std::uint64_t base =
+		(static_cast<std::uint64_t>(data[6]) << 25) |
+		(static_cast<std::uint64_t>(data[7]) << 17) |
+		(static_cast<std::uint64_t>(data[8]) << 9)  |
+		(static_cast<std::uint64_t>(data[9]) << 1)  |
+		(static_cast<std::uint64_t>(data[10]) >> 7);
+	const std::uint64_t ext = (static_cast<std::uint64_t>(data[10] & 0x01) << 8) | data[11];
+	const std::uint64_t pcr = (base * 300) + ext;
+
+	const auto prev = _clock.find(pid);
+	if (_referencePID == -1) {
+		_referencePID = pid;
+		_mediaPosition = position;
+	} else if (pid != _referencePID && _bitrateEstimate > 0.0 &&
+			(position - _clock[_referencePID].position) * 8 > _bitrateEstimate) {
+		// The reference program did not have a PCR for a second, so
+		// continue with the clock of this program
+		_mediaTicks += static_cast<std::int64_t>((position - _mediaPosition) * 8 * PCR_HZ / _bitrateEstimate);
+		_mediaPosition = position;
+		_referencePID = pid;
+	} else if (pid == _referencePID && prev != _clock.end()) {
+		const std::uint64_t delta = (pcr + PCR_WRAP - prev->second.pcr) % PCR_WRAP;
+		const std::uint64_t bytes = position - prev->second.position;
+		if (delta > 0 && delta <= MAX_PCR_GAP && bytes > 0) {
+			const double bitrate = (bytes * 8.0 * PCR_HZ) / delta;
+			_bitrateEstimate = (_bitrateEstimate <= 0.0) ? bitrate :
+				_bitrateEstimate + ((bitrate - _bitrateEstimate) / BITRATE_SMOOTHING);
+			_mediaTicks += delta;
+		} else if (_bitrateEstimate > 0.0) {
+			// Discontinuity, so continue the media time with the bitrate
+			_mediaTicks += static_cast<std::int64_t>(bytes * 8 * PCR_HZ / _bitrateEstimate);
+		}
+		_mediaPosition = position;
+	}
+	_clock[pid] = { pcr, position };
+}
+
+std::int64_t PCRPacer::getMediaTimeNS(const std::uint64_t position) const {
+	const double mediaNS = (_mediaTicks * 1000.0 / 27.0) +
+		((position - _mediaPosition) * 8.0 * 1000000000.0 / _bitrateEstimate);
+	return static_cast<std::int64_t>(mediaNS);
+}
+
+}
@@ -0,0 +1,143 @@
+/* PCRPacer.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PCR_PACER_H_INCLUDE
+#define MPEGTS_PCR_PACER_H_INCLUDE MPEGTS_PCR_PACER_H_INCLUDE
+
+#include <base/Metrics.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace mpegts {
+
+class PacketBuffer;
+
+/// The class @c PCRPacer paces the output of a source that can be read faster
+/// than real-time (like a file), to the bitrate of the original mux.
+/// The PCRs of every program are collected from the buffers that are read,
+/// and one of them is used as reference clock. The time of each byte is then
+/// interpolated between (and extrapolated after) the PCRs with a smoothed
+/// bitrate. Buffers are released in bursts, on absolute deadlines, so a
+/// late wakeup does not add up.
+class PCRPacer {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		PCRPacer() = default;
+
+		virtual ~PCRPacer() = default;
+
+		PCRPacer(const PCRPacer&) = delete;
+
+		PCRPacer& operator=(const PCRPacer&) = delete;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Start pacing a new source
+		void reset();
+
+		/// Add a full buffer that was just read from the source
+		void addBuffer(const PacketBuffer &buffer);
+
+		/// Wait until the next buffer is due.
+		/// @return true if the next buffer should be read now, false if the
+		/// maximum wait time has passed and it is not due yet
+		bool waitUntilDue();
+
+		/// Set the amount of buffers that are released at once
+		void setBurst(unsigned int burst) {
+			_burst = (burst < 1) ? 1 : (burst > MAX_BURST) ? MAX_BURST : burst;
+		}
+
+		unsigned int getBurst() const {
+			return _burst;
+		}
+
+		/// Get the smoothed bitrate of the source in bits/s, or 0 if not
+		/// known (yet)
+		std::uint64_t getBitrate() const {
+			return _bitrate.load(std::memory_order_relaxed);
+		}
+
+		/// Add the pacing metrics
+		/// @param labels specifies the labels of the stream of this device
+		void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const;
+
+	private:
+
+		/// Collect the PCR of the TS packet at @c position, if it has one
+		void collectPCR(const unsigned char *data, std::uint64_t position);
+
+		/// Get the media time in ns of the byte at @c position
+		std::int64_t getMediaTimeNS(std::uint64_t position) const;
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	public:
+
+		static constexpr unsigned int MAX_BURST = 50;
+		static constexpr unsigned int DEFAULT_BURST = 4;
+
+	private:
+
+		struct PCRClock {
+			std::uint64_t pcr = 0;
+			std::uint64_t position = 0;
+		};
+
+		std::atomic<unsigned int> _burst{DEFAULT_BURST};
+		std::atomic<std::uint64_t> _bitrate{0};
+
+		/// The PCR of the last packet of each PCR PID
+		std::map<int, PCRClock> _clock;
+		int _referencePID = -1;
+		/// The continuous media time in 27 MHz ticks at the last reference PCR
+		std::int64_t _mediaTicks = 0;
+		std::uint64_t _mediaPosition = 0;
+		double _bitrateEstimate = 0.0;
+
+		/// Amount of bytes and buffers added since the reset
+		std::uint64_t _position = 0;
+		std::uint64_t _buffers = 0;
+		bool _added = false;
+
+		/// The monotonic time (ns) at which the media time _anchorMediaNS is due
+		bool _anchored = false;
+		std::int64_t _anchorNS = 0;
+		std::int64_t _anchorMediaNS = 0;
+		/// The deadline (ns) of the next burst, or 0 if there is none
+		std::int64_t _deadlineNS = 0;
+
+		base::Histogram _latenessUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Counter _wakeups;
+};
+
+}
+
+#endif // MPEGTS_PCR_PACER_H_INCLUDE
@@ -52,7 +52,7 @@ void PMT::doAddToXML(std::string &xml) const {
 		ADD_XML_END_ELEMENT(xml, "elementary");
 	}
 	for (const auto& data : _pmtData.ecmPID) {
-		std::string name = "caid_" + HEX(data.caid, 4);
+		const std::string name = StringConverter::stringFormat("caid_@#1", HEX(data.caid, 4));
 		ADD_XML_BEGIN_ELEMENT(xml, name);
 			ADD_XML_ELEMENT(xml, "ecmPID", data.ecmpid);
 			ADD_XML_ELEMENT(xml, "provid", data.provid);
@@ -60,7 +60,7 @@ void PMT::doAddToXML(std::string &xml) const {
 	}
 }
 
-void PMT::doFromXML(const std::string &UNUSED(xml)) {}
+void PMT::doFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 // =============================================================================
 // -- Static member functions --------------------------------------------------
@@ -20,12 +20,25 @@
 #ifndef MPEGTS_PACKET_BUFFER_H_INCLUDE
 #define MPEGTS_PACKET_BUFFER_H_INCLUDE MPEGTS_PACKET_BUFFER_H_INCLUDE
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
 
 namespace mpegts {
 
 class PacketBuffer {
+	public:
+
+		/// The stages of the data path a traced buffer gets a timestamp for
+		enum class Stage {
+			READ,    // Read from the device completed
+			FILTER,  // Filtering completed
+			DECRYPT, // Decrypting completed, also when it was done in a later batch
+			SEND,    // Sending to the clients started
+			MAX
+		};
+
 		// =====================================================================
 		// -- Constructors and destructor --------------------------------------
 		// =====================================================================
@@ -59,6 +72,10 @@ class PacketBuffer {
 
 		/// Reset this TS buffer
 		void reset() noexcept {
+			if (_traced) {
+				_stamp.fill(std::chrono::steady_clock::time_point());
+			}
+			_traced = false;
 			_decryptPending = false;
 			_purgePending = 0;
 			_writeIndex = RTP_HEADER_LEN;
@@ -171,6 +188,46 @@ class PacketBuffer {
 			return ready;
 		}
 
+		/// Trace this buffer through the data path, see @c stamp. It is
+		/// cleared with @c reset
+		void setTraced() noexcept {
+			_traced = true;
+		}
+
+		/// Check if this buffer is traced
+		bool isTraced() const noexcept {
+			return _traced;
+		}
+
+		/// Take the timestamp for the requested stage, if this buffer is traced
+		void stamp(const Stage stage) noexcept {
+			if (_traced) {
+				_stamp[static_cast<std::size_t>(stage)] = std::chrono::steady_clock::now();
+			}
+		}
+
+		/// Check if the timestamp for the requested stage is taken
+		bool hasStamp(const Stage stage) const noexcept {
+			return _stamp[static_cast<std::size_t>(stage)] != std::chrono::steady_clock::time_point();
+		}
+
+		/// Get the timestamp of the requested stage
+		std::chrono::steady_clock::time_point getStamp(const Stage stage) const noexcept {
+			return _stamp[static_cast<std::size_t>(stage)];
+		}
+
+		/// Get the time in microseconds between two stamps, or between the
+		/// stamp and @c end
+		std::uint64_t getLatencyUS(const Stage from,
+				const std::chrono::steady_clock::time_point end) const noexcept {
+			const auto begin = _stamp[static_cast<std::size_t>(from)];
+			return (end > begin) ?
+				std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() : 0;
+		}
+		std::uint64_t getLatencyUS(const Stage from, const Stage to) const noexcept {
+			return getLatencyUS(from, _stamp[static_cast<std::size_t>(to)]);
+		}
+
 	protected:
 
 		/// Check if the first three TS packets are in sync
@@ -199,6 +256,9 @@ class PacketBuffer {
 		mutable std::size_t _processedIndex = RTP_HEADER_LEN;
 		bool                _decryptPending = false;
 		std::size_t         _purgePending = 0;
+		bool                _traced = false;
+		std::array<std::chrono::steady_clock::time_point,
+			static_cast<std::size_t>(Stage::MAX)> _stamp;
 
 };
 
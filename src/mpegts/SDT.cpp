@@ -50,7 +50,7 @@ void SDT::doAddToXML(std::string &xml) const {
 	}
 }
 
-void SDT::doFromXML(const std::string &UNUSED(xml)) {}
+void SDT::doFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
@@ -0,0 +1,174 @@
+/* SectionAssembler.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/SectionAssembler.h>
+
+#include <Log.h>
+
+#include <algorithm>
+
+namespace mpegts {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void SectionAssembler::addPacket(const FeID id, const unsigned char *ts, const Callback &callback) {
+	const int pid = ((ts[1] & 0x1F) << 8) | ts[2];
+	const bool payloadStart = (ts[1] & 0x40) == 0x40;
+	const unsigned int afc = (ts[3] >> 4) & 0x03;
+	const int cc = ts[3] & 0x0F;
+
+	// No payload, nothing to do (and the CC does not increment)
+	if ((afc & 0x01) == 0) {
+		return;
+	}
+	// Skip duplicate packets and start over on a discontinuity
+	if (_cc != -1) {
+		if (cc == _cc) {
+			return;
+		}
+		if (cc != ((_cc + 1) & 0x0F)) {
+			_section.clear();
+		}
+	}
+	_cc = cc;
+
+	std::size_t offset = 4;
+	if ((afc & 0x02) == 0x02) {
+		offset += ts[4] + 1;
+	}
+	if (offset >= 188) {
+		return;
+	}
+	const unsigned char *payload = &ts[offset];
+	std::size_t size = 188 - offset;
+
+	if (payloadStart) {
+		const std::size_t pointer = payload[0];
+		++payload;
+		--size;
+		if (pointer > size) {
+			_section.clear();
+			return;
+		}
+		// The pointer field points past the end of the previous section
+		if (!_section.empty()) {
+			append(id, pid, payload, pointer, callback);
+			_section.clear();
+		}
+		payload += pointer;
+		size -= pointer;
+		// One or more sections can start in this packet until stuffing
+		while (size > 0 && payload[0] != 0xFF) {
+			const std::size_t used = append(id, pid, payload, size, callback);
+			if (!_section.empty()) {
+				break;
+			}
+			payload += used;
+			size -= used;
+		}
+	} else if (!_section.empty()) {
+		append(id, pid, payload, size, callback);
+	}
+}
+
+void SectionAssembler::clear() noexcept {
+	_section.clear();
+	_cc = -1;
+	_lastCRC.clear();
+}
+
+std::size_t SectionAssembler::append(const FeID id, const int pid, const unsigned char *data,
+		const std::size_t size, const Callback &callback) {
+	std::size_t used = 0;
+	// First get the table_id and section_length
+	if (_section.size() < 3) {
+		used = std::min(3 - _section.size(), size);
+		_section.append(data, used);
+		if (_section.size() < 3) {
+			return used;
+		}
+	}
+	const std::size_t total = (((_section[1] & 0x0F) << 8) | _section[2]) + 3;
+	if (total > MAX_SECTION_SIZE) {
+		_section.clear();
+		return size;
+	}
+	const std::size_t len = std::min(total - _section.size(), size - used);
+	_section.append(&data[used], len);
+	used += len;
+	if (_section.size() == total) {
+		deliver(id, pid, callback);
+		_section.clear();
+	}
+	return used;
+}
+
+void SectionAssembler::deliver(const FeID id, const int pid, const Callback &callback) {
+	const unsigned char *data = _section.data();
+	const std::size_t length = _section.size();
+
+	Section section;
+	section.pid = pid;
+	section.data = data;
+	section.length = length;
+	section.tableID = data[0];
+	section.syntax = (data[1] & 0x80) == 0x80;
+	section.tableIDExtension = 0;
+	section.version = 0;
+	section.currentNext = true;
+	section.secNr = 0;
+	section.lastSecNr = 0;
+	section.crc = 0;
+	section.changed = true;
+
+	// Long sections and the TOT carry a CRC32
+	if (section.syntax || section.tableID == 0x73) {
+		if (length < 3 + 4 + (section.syntax ? 5 : 0)) {
+			return;
+		}
+		const uint32_t crc = (data[length - 4] << 24) | (data[length - 3] << 16) |
+			(data[length - 2] << 8) | data[length - 1];
+		const uint32_t calccrc = TableData::calculateCRC32(data, length - 4);
+		if (calccrc != crc) {
+			SI_LOG_ERROR("Frontend: @#1, @#2 - PID @#3: CRC Error! Calc CRC32: @#4 - TS CRC32: @#5",
+				id, TableData::getTableTXT(section.tableID), DIGIT(pid, 4), HEX(calccrc, 4), HEX(crc, 4));
+			return;
+		}
+		section.crc = crc;
+	}
+	if (section.syntax) {
+		section.tableIDExtension = (data[3] << 8) | data[4];
+		section.version          = (data[5] >> 1) & 0x1F;
+		section.currentNext      = (data[5] & 0x01) == 0x01;
+		section.secNr            = data[6];
+		section.lastSecNr        = data[7];
+
+		const uint32_t key = (section.tableID << 24) | (section.tableIDExtension << 8) | section.secNr;
+		const auto [it, inserted] = _lastCRC.try_emplace(key, section.crc);
+		if (!inserted) {
+			section.changed = it->second != section.crc;
+			it->second = section.crc;
+		}
+	}
+	callback(section);
+}
+
+}
@@ -0,0 +1,106 @@
+/* SectionAssembler.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_SECTION_ASSEMBLER_H_INCLUDE
+#define MPEGTS_SECTION_ASSEMBLER_H_INCLUDE MPEGTS_SECTION_ASSEMBLER_H_INCLUDE
+
+#include <Defs.h>
+#include <mpegts/TableData.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace mpegts {
+
+/// The struct @c Section is a complete and (when it has one) CRC checked
+/// PSI/SI section. @c data points to the table_id and is only valid during
+/// the callback it is passed to
+struct Section {
+	int pid;
+	const unsigned char *data;
+	std::size_t length;
+	int tableID;
+	bool syntax;
+	int tableIDExtension;
+	int version;
+	bool currentNext;
+	int secNr;
+	int lastSecNr;
+	uint32_t crc;
+	/// @c false if this section is equal to the previous one with the same
+	/// table_id, table_id_extension and section_number on this PID
+	bool changed;
+};
+
+/// The class @c SectionAssembler assembles the sections of one PID from its
+/// TS packets. It handles the pointer field, sections spanning multiple
+/// packets and multiple sections in one packet.
+class SectionAssembler {
+	public:
+
+		using Callback = std::function<void(const Section &section)>;
+
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		SectionAssembler() = default;
+
+		virtual ~SectionAssembler() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Add the TS packet of this PID, @c callback is called for each
+		/// section that is finished with this packet
+		void addPacket(FeID id, const unsigned char *ts, const Callback &callback);
+
+		/// Clear the partial section and the version tracking
+		void clear() noexcept;
+
+	private:
+
+		/// Append data to the current section and deliver it when it is complete
+		/// @return the number of bytes used from data
+		std::size_t append(FeID id, int pid, const unsigned char *data,
+			std::size_t size, const Callback &callback);
+
+		/// Check and deliver the finished section
+		void deliver(FeID id, int pid, const Callback &callback);
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		static constexpr std::size_t MAX_SECTION_SIZE = 4096;
+
+		TSData _section;
+		int _cc = -1;
+		std::unordered_map<uint32_t, uint32_t> _lastCRC;
+};
+
+}
+
+#endif // MPEGTS_SECTION_ASSEMBLER_H_INCLUDE
@@ -0,0 +1,110 @@
+/* SectionFilter.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/SectionFilter.h>
+
+#include <cstring>
+
+namespace mpegts {
+
+// =============================================================================
+//  -- SectionFilter::Match ----------------------------------------------------
+// =============================================================================
+
+SectionFilter::Match::Match() {
+	std::memset(data, 0x00, SIZE);
+	std::memset(mask, 0x00, SIZE);
+}
+
+SectionFilter::Match::Match(const unsigned char *filterData, const unsigned char *filterMask) {
+	std::memcpy(data, filterData, SIZE);
+	std::memcpy(mask, filterMask, SIZE);
+}
+
+SectionFilter::Match SectionFilter::Match::forTableID(const int tableID, const int tableMask) {
+	Match match;
+	match.data[0] = tableID;
+	match.mask[0] = tableMask;
+	return match;
+}
+
+bool SectionFilter::Match::matches(const unsigned char *section, const std::size_t length) const noexcept {
+	for (std::size_t i = 0; i < SIZE; ++i) {
+		if (mask[i] == 0x00) {
+			continue;
+		}
+		// skip section_length bytes
+		const std::size_t k = (i == 0) ? 0 : i + 2;
+		if (k >= length || (section[k] & mask[i]) != (data[i] & mask[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+SectionFilter::SubscriptionID SectionFilter::subscribe(const int pid, const Match &match, Callback callback) {
+	const SubscriptionID id = _nextID++;
+	_pids[pid].subscriptions.push_back({id, match, std::move(callback)});
+	_subscribedPIDs.set(pid & 0x1FFF);
+	return id;
+}
+
+void SectionFilter::unsubscribe(const SubscriptionID subscriptionID) {
+	for (auto it = _pids.begin(); it != _pids.end(); ++it) {
+		std::vector<Subscription> &subscriptions = it->second.subscriptions;
+		for (auto sub = subscriptions.begin(); sub != subscriptions.end(); ++sub) {
+			if (sub->id == subscriptionID) {
+				subscriptions.erase(sub);
+				if (subscriptions.empty()) {
+					_subscribedPIDs.reset(it->first & 0x1FFF);
+					_pids.erase(it);
+				}
+				return;
+			}
+		}
+	}
+}
+
+void SectionFilter::clear() {
+	_pids.clear();
+	_subscribedPIDs.reset();
+}
+
+void SectionFilter::filterPacket(const FeID id, const unsigned char *ts) {
+	const int pid = ((ts[1] & 0x1F) << 8) | ts[2];
+	if (!isSubscribed(pid)) {
+		return;
+	}
+	PIDEntry &entry = _pids[pid];
+	entry.assembler.addPacket(id, ts, [&](const Section &section) {
+		// Index based, a callback may add subscriptions to this PID
+		for (std::size_t i = 0; i < entry.subscriptions.size(); ++i) {
+			if (entry.subscriptions[i].match.matches(section.data, section.length)) {
+				const Callback callback = entry.subscriptions[i].callback;
+				callback(id, section);
+			}
+		}
+	});
+}
+
+}
@@ -0,0 +1,119 @@
+/* SectionFilter.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_SECTION_FILTER_H_INCLUDE
+#define MPEGTS_SECTION_FILTER_H_INCLUDE MPEGTS_SECTION_FILTER_H_INCLUDE
+
+#include <Defs.h>
+#include <mpegts/SectionAssembler.h>
+
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace mpegts {
+
+/// The class @c SectionFilter assembles the sections of all subscribed PIDs
+/// once and hands them to every subscriber with a matching filter.
+/// It is not thread safe, the owner should lock it.
+class SectionFilter {
+	public:
+
+		/// Called for each matching section. Callbacks may subscribe, but should
+		/// only unsubscribe from other PIDs than the one of the section
+		using Callback = std::function<void(FeID id, const Section &section)>;
+		using SubscriptionID = int;
+
+		/// The struct @c Match is a section filter like the Linux demux API. The
+		/// first byte is matched with the table_id, the others start after the
+		/// section_length field
+		struct Match {
+			static constexpr std::size_t SIZE = 16;
+
+			Match();
+
+			Match(const unsigned char *filterData, const unsigned char *filterMask);
+
+			/// Match only the table_id
+			static Match forTableID(int tableID, int tableMask = 0xFF);
+
+			bool matches(const unsigned char *data, std::size_t length) const noexcept;
+
+			unsigned char data[SIZE];
+			unsigned char mask[SIZE];
+		};
+
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		SectionFilter() = default;
+
+		virtual ~SectionFilter() = default;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Subscribe to the sections of PID that match
+		/// @return the ID to unsubscribe with
+		SubscriptionID subscribe(int pid, const Match &match, Callback callback);
+
+		/// Remove the requested subscription
+		void unsubscribe(SubscriptionID subscriptionID);
+
+		/// Remove all subscriptions
+		void clear();
+
+		/// Check if there is any subscription for the requested PID
+		bool isSubscribed(int pid) const noexcept {
+			return _subscribedPIDs.test(pid & 0x1FFF);
+		}
+
+		/// Add the TS packet, it is ignored if nobody subscribed to its PID
+		void filterPacket(FeID id, const unsigned char *ts);
+
+		// =========================================================================
+		//  -- Data members --------------------------------------------------------
+		// =========================================================================
+	private:
+
+		struct Subscription {
+			SubscriptionID id;
+			Match match;
+			Callback callback;
+		};
+
+		struct PIDEntry {
+			SectionAssembler assembler;
+			std::vector<Subscription> subscriptions;
+		};
+
+		std::unordered_map<int, PIDEntry> _pids;
+		std::bitset<0x2000> _subscribedPIDs;
+		SubscriptionID _nextID = 0;
+};
+
+}
+
+#endif // MPEGTS_SECTION_FILTER_H_INCLUDE
@@ -0,0 +1,229 @@
+/* TSCorpus.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/TSCorpus.h>
+
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace mpegts {
+
+namespace {
+
+	constexpr int VERSION = 3;
+	constexpr int TRANSPORT_STREAM_ID = 0x0001;
+	constexpr int NETWORK_ID = 0x0001;
+	constexpr int CAID = 0x0500;
+	constexpr int ECM_PID = 0x300;
+	constexpr int NULL_PID = 0x1FFF;
+
+	/// Interval, in packets, of the PSI/SI tables
+	constexpr std::size_t TABLE_INTERVAL = 500;
+
+	/// Make a long section (single section, with CRC) around the payload
+	TSData makeSection(const int tableID, const int extension, const TSData &payload) {
+		// 5 = extension, version, section number, last section number  4 = CRC
+		const std::size_t length = 5 + payload.size() + 4;
+		TSData section;
+		section.push_back(static_cast<unsigned char>(tableID));
+		section.push_back(static_cast<unsigned char>(0xB0 | ((length >> 8) & 0x0F)));
+		section.push_back(static_cast<unsigned char>(length & 0xFF));
+		section.push_back(static_cast<unsigned char>((extension >> 8) & 0xFF));
+		section.push_back(static_cast<unsigned char>(extension & 0xFF));
+		section.push_back(static_cast<unsigned char>(0xC1 | (VERSION << 1)));
+		section.push_back(0x00);
+		section.push_back(0x00);
+		section += payload;
+		const uint32_t crc = TableData::calculateCRC32(section.data(), section.size());
+		section.push_back(static_cast<unsigned char>((crc >> 24) & 0xFF));
+		section.push_back(static_cast<unsigned char>((crc >> 16) & 0xFF));
+		section.push_back(static_cast<unsigned char>((crc >>  8) & 0xFF));
+		section.push_back(static_cast<unsigned char>(crc & 0xFF));
+		return section;
+	}
+
+	void addWord(TSData &data, const int word, const int reserved = 0x00) {
+		data.push_back(static_cast<unsigned char>(reserved | ((word >> 8) & 0xFF)));
+		data.push_back(static_cast<unsigned char>(word & 0xFF));
+	}
+
+	void addString(TSData &data, const std::string &str) {
+		data.push_back(static_cast<unsigned char>(str.size()));
+		data.append(reinterpret_cast<const unsigned char *>(str.data()), str.size());
+	}
+
+}
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+TSCorpus::TSCorpus(const std::size_t packets, const std::uint32_t seed) {
+	std::mt19937 random(seed);
+	const TSData pat = makePAT();
+	const TSData sdt = makeSDT();
+	_data.reserve((packets + PROGRAMS + 2) * TS_PACKET_SIZE);
+	while (getNumberOfPackets() < packets) {
+		if (getNumberOfPackets() % TABLE_INTERVAL == 0) {
+			addSection(0, pat);
+			for (std::size_t p = 0; p < PROGRAMS; ++p) {
+				addSection(PMT_PID + p, makePMT(p));
+			}
+			addSection(17, sdt);
+			continue;
+		}
+		const std::uint32_t r = random();
+		const std::size_t program = (r >> 8) % PROGRAMS;
+		const std::uint32_t percentage = r % 100;
+		if (percentage < 5) {
+			addPayload(NULL_PID, r);
+		} else if (percentage < 25) {
+			addPayload(AUDIO_PID + program * PID_STEP, r);
+		} else {
+			addPayload(VIDEO_PID + program * PID_STEP, r);
+		}
+	}
+	_data.resize(packets * TS_PACKET_SIZE);
+}
+
+// =============================================================================
+// -- Static member functions --------------------------------------------------
+// =============================================================================
+
+TSData TSCorpus::makePAT() {
+	TSData payload;
+	// NIT
+	addWord(payload, 0);
+	addWord(payload, 0x10, 0xE0);
+	for (std::size_t p = 0; p < PROGRAMS; ++p) {
+		addWord(payload, p + 1);
+		addWord(payload, PMT_PID + p, 0xE0);
+	}
+	return makeSection(TableData::PAT_ID, TRANSPORT_STREAM_ID, payload);
+}
+
+TSData TSCorpus::makePMT(const std::size_t program) {
+	const int videoPID = VIDEO_PID + program * PID_STEP;
+	const int audioPID = AUDIO_PID + program * PID_STEP;
+	TSData payload;
+	// PCR PID
+	addWord(payload, videoPID, 0xE0);
+	// Program info with CA descriptor
+	addWord(payload, 6, 0xF0);
+	payload.push_back(0x09);
+	payload.push_back(0x04);
+	addWord(payload, CAID);
+	addWord(payload, ECM_PID + program, 0xE0);
+	// Video (H.264)
+	payload.push_back(0x1B);
+	addWord(payload, videoPID, 0xE0);
+	addWord(payload, 0, 0xF0);
+	// Audio (MPEG-1) with ISO 639 language descriptor
+	payload.push_back(0x03);
+	addWord(payload, audioPID, 0xE0);
+	addWord(payload, 6, 0xF0);
+	payload.push_back(0x0A);
+	payload.push_back(0x04);
+	payload.append(reinterpret_cast<const unsigned char *>("eng"), 3);
+	payload.push_back(0x00);
+	return makeSection(TableData::PMT_ID, program + 1, payload);
+}
+
+TSData TSCorpus::makeSDT() {
+	TSData payload;
+	addWord(payload, NETWORK_ID);
+	payload.push_back(0xFF);
+	for (std::size_t p = 0; p < PROGRAMS; ++p) {
+		const std::string provider = "SatPI";
+		const std::string name = "Channel " + std::to_string(p + 1);
+		// Service descriptor
+		TSData desc;
+		desc.push_back(0x48);
+		desc.push_back(static_cast<unsigned char>(1 + 1 + provider.size() + 1 + name.size()));
+		desc.push_back(0x01);
+		addString(desc, provider);
+		addString(desc, name);
+
+		addWord(payload, p + 1);
+		payload.push_back(0xFC);
+		// Running, not scrambled
+		addWord(payload, desc.size(), 0x80);
+		payload += desc;
+	}
+	return makeSection(TableData::SDT_ID, TRANSPORT_STREAM_ID, payload);
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+std::size_t TSCorpus::fill(PacketBuffer &buffer, std::size_t packet) const noexcept {
+	buffer.reset();
+	for (std::size_t i = 0; i < PacketBuffer::NUMBER_OF_TS_PACKETS; ++i) {
+		std::memcpy(buffer.getWriteBufferPtr(), getPacket(packet), TS_PACKET_SIZE);
+		buffer.addAmountOfBytesWritten(TS_PACKET_SIZE);
+		packet = (packet + 1) % getNumberOfPackets();
+	}
+	return packet;
+}
+
+void TSCorpus::addSection(const int pid, const TSData &section) {
+	std::size_t offset = 0;
+	bool first = true;
+	while (offset < section.size()) {
+		addHeader(pid, first);
+		std::size_t space = TS_PACKET_SIZE - 4;
+		if (first) {
+			// Pointer field
+			_data.push_back(0x00);
+			--space;
+			first = false;
+		}
+		const std::size_t size = std::min(space, section.size() - offset);
+		_data.append(section, offset, size);
+		_data.append(space - size, 0xFF);
+		offset += size;
+	}
+}
+
+void TSCorpus::addPayload(const int pid, std::uint32_t random) {
+	addHeader(pid, false);
+	// xorshift32 (never 0), so the payload is reproducible and cheap to generate
+	random |= 1;
+	for (std::size_t i = 4; i < TS_PACKET_SIZE; ++i) {
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		_data.push_back(static_cast<unsigned char>(random));
+	}
+}
+
+void TSCorpus::addHeader(const int pid, const bool payloadUnitStart) {
+	_data.push_back(0x47);
+	_data.push_back(static_cast<unsigned char>((payloadUnitStart ? 0x40 : 0x00) | ((pid >> 8) & 0x1F)));
+	_data.push_back(static_cast<unsigned char>(pid & 0xFF));
+	_data.push_back(static_cast<unsigned char>(0x10 | _cc[pid]));
+	_cc[pid] = (_cc[pid] + 1) & 0x0F;
+}
+
+}
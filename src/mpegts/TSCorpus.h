@@ -0,0 +1,125 @@
+/* TSCorpus.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_TSCORPUS_H_INCLUDE
+#define MPEGTS_TSCORPUS_H_INCLUDE MPEGTS_TSCORPUS_H_INCLUDE
+
+#include <FwDecl.h>
+#include <mpegts/TableData.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+FW_DECL_NS1(mpegts, PacketBuffer);
+
+namespace mpegts {
+
+/// The class @c TSCorpus generates a synthetic, but valid, Transport Stream.
+/// With the same seed it generates exactly the same stream, so it can be used
+/// to benchmark and compare builds. The stream has a PAT, PMTs (with a CA
+/// descriptor), a SDT and per program a video and audio PID with correct
+/// Continuity Counters, and some NULL packets.
+class TSCorpus {
+	public:
+
+		static constexpr std::uint32_t DEFAULT_SEED = 0x5A7B1;
+		static constexpr std::size_t PROGRAMS = 4;
+		static constexpr int PMT_PID = 0x100;
+		static constexpr int VIDEO_PID = 0x200;
+		static constexpr int AUDIO_PID = 0x201;
+		/// The video and audio PIDs of program n are at n * PID_STEP from
+		/// @c VIDEO_PID and @c AUDIO_PID
+		static constexpr int PID_STEP = 0x10;
+
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// @param packets specifies the number of TS packets to generate
+		/// @param seed specifies the seed of the pseudo random payload and PIDs
+		explicit TSCorpus(std::size_t packets, std::uint32_t seed = DEFAULT_SEED);
+
+		virtual ~TSCorpus() = default;
+
+		// =====================================================================
+		// -- Static member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Make a PAT section (with CRC) of all programs
+		static TSData makePAT();
+
+		/// Make the PMT section (with CRC) of the requested program
+		static TSData makePMT(std::size_t program);
+
+		/// Make a SDT section (with CRC) of all programs
+		static TSData makeSDT();
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the number of TS packets in this corpus
+		std::size_t getNumberOfPackets() const noexcept {
+			return _data.size() / TS_PACKET_SIZE;
+		}
+
+		/// Get the requested TS packet
+		const unsigned char *getPacket(const std::size_t packet) const noexcept {
+			return _data.data() + (packet % getNumberOfPackets()) * TS_PACKET_SIZE;
+		}
+
+		/// Get the whole stream
+		const TSData &getData() const noexcept {
+			return _data;
+		}
+
+		/// Fill the buffer with the next packets, starting at packet (it
+		/// wraps around at the end of the corpus)
+		/// @return the packet number to continue with
+		std::size_t fill(PacketBuffer &buffer, std::size_t packet) const noexcept;
+
+	private:
+
+		/// Add the section as TS packet(s) on the requested PID
+		void addSection(int pid, const TSData &section);
+
+		/// Add a TS packet with random payload on the requested PID
+		void addPayload(int pid, std::uint32_t random);
+
+		/// Add the TS header of a packet on the requested PID
+		void addHeader(int pid, bool payloadUnitStart);
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static constexpr std::size_t TS_PACKET_SIZE = 188;
+
+		TSData _data;
+		unsigned char _cc[0x2000] = {};
+};
+
+}
+
+#endif // MPEGTS_TSCORPUS_H_INCLUDE
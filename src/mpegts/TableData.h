@@ -21,11 +21,14 @@
 #define MPEGTS_TABLE_DATA_H_INCLUDE MPEGTS_TABLE_DATA_H_INCLUDE
 
 #include <Defs.h>
+#include <FwDecl.h>
 
 #include <cstdint>
 #include <string>
 #include <map>
 
+FW_DECL_NS1(mpegts, Section);
+
 namespace mpegts {
 
 using TSData = std::basic_string<unsigned char>;
@@ -41,12 +44,6 @@ class TableData {
 		// =========================================================================
 		// -- Defines --------------------------------------------------------------
 		// =========================================================================
-		#define CRC(data, sectionLength) \
-			(data[sectionLength - 4 + 8] << 24) |     \
-			(data[sectionLength - 4 + 8 + 1] << 16) | \
-			(data[sectionLength - 4 + 8 + 2] <<  8) | \
-			 data[sectionLength - 4 + 8 + 3]
-
 		static constexpr int PAT_ID       = 0x00;
 		static constexpr int CAT_ID       = 0x01;
 		static constexpr int PMT_ID       = 0x02;
@@ -55,6 +52,8 @@ class TableData {
 		static constexpr int SDT_ID       = 0x42;
 		static constexpr int EIT1_ID      = 0x4E;
 		static constexpr int EIT2_ID      = 0x4F;
+		static constexpr int TDT_ID       = 0x70;
+		static constexpr int TOT_ID       = 0x73;
 		static constexpr int ECM0_ID      = 0x80;
 		static constexpr int ECM1_ID      = 0x81;
 		static constexpr int EMM1_ID      = 0x82;
@@ -75,8 +74,12 @@ class TableData {
 		// =========================================================================
 	public:
 
+		/// Calculate the MPEG-2 CRC32, see @c CRC32
 		static uint32_t calculateCRC32(const unsigned char* data, std::size_t len) noexcept;
 
+		///
+		static const char* getTableTXT(int tableID) noexcept;
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
@@ -90,15 +93,9 @@ class TableData {
 		/// @param data
 		bool getDataForSectionNumber(size_t secNr, TableData::Data &data) const noexcept;
 
-		/// Collect Table data for tableID
-		void collectData(FeID id, int tableID, const unsigned char* data, bool trace) {
-			collectData(id, tableID, data, trace, false);
-		}
-
-		/// Collect Raw Table data for tableID
-		void collectRawData(FeID id, int tableID, const unsigned char* data, bool trace) {
-			collectData(id, tableID, data, trace, true);
-		}
+		/// Add a complete and CRC checked section of this table. A section with
+		/// an other version than the ones already collected starts over.
+		void addSection(const Section &section);
 
 		/// Get the collected Table Data
 		TSData getData(size_t secNr) const;
@@ -116,15 +113,6 @@ class TableData {
 
 	protected:
 
-		/// Add Table data that was collected
-		bool addData(int tableID, const unsigned char* data, int length, int pid, int cc);
-
-		/// Set if the current Table has been collected
-		void setCollected() noexcept;
-
-		///
-		const char* getTableTXT(int tableID) const noexcept;
-
 		///
 		uint8_t getByte(size_t &i, const unsigned char* buf) const noexcept {
 			uint8_t d = buf[i];
@@ -153,9 +141,6 @@ class TableData {
 
 	private:
 
-		/// Collect Table data for tableID
-		void collectData(FeID id, int tableID, const unsigned char* data, bool trace, bool raw);
-
 		/// Check if all sections are collected
 		bool checkAllCollected() const noexcept;
 
@@ -184,7 +169,6 @@ class TableData {
 
 	private:
 
-		std::size_t _currentSectionNumber = 0;
 		mutable bool _collectingFinished = false;
 		std::map<int, Data> _dataTable;
 
@@ -35,9 +35,11 @@ namespace output {
 // =============================================================================
 
 StreamClient::StreamClient(FeID feID) :
+		_mutex(base::Mutex::Type::NonRecursive),
 		_feID(feID),
 		_streamActive(false),
 		_socketClient(nullptr),
+		_socketConnectionID(0),
 		_sessionTimeoutCheck(SessionTimeoutCheck::WATCHDOG),
 		_ipAddressOfStream("0.0.0.0"),
 		_watchdog(0),
@@ -67,9 +69,11 @@ void StreamClient::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "httpPort", (_socketClient == nullptr) ? 0 : _socketClient->getSocketPort());
 	ADD_XML_ELEMENT(xml, "spc", _senderRtpPacketCnt.load());
 	ADD_XML_ELEMENT(xml, "clientPayload", _payload.load() / (1024.0 * 1024.0));
+	ADD_XML_ELEMENT(xml, "latencySendP99", _latencySendUS.getQuantile(0.99));
+	ADD_XML_ELEMENT(xml, "latencyTotalP99", _latencyTotalUS.getQuantile(0.99));
 }
 
-void StreamClient::doFromXML(const std::string &UNUSED(xml)) {}
+void StreamClient::doFromXML(const base::XMLElement &UNUSED(xml)) {}
 
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
@@ -77,7 +81,7 @@ void StreamClient::doFromXML(const std::string &UNUSED(xml)) {}
 
 bool StreamClient::processStreamingRequest(const SocketClient &client) {
 	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HeaderVector &headers = client.getHeaders();
 
 	// Save clients seq number
 	const std::string cseq = headers.getFieldParameter("CSeq");
@@ -109,10 +113,20 @@ bool StreamClient::writeData(mpegts::PacketBuffer& buffer) {
 	++_senderRtpPacketCnt;
 	_senderOctectPayloadCnt += dataSize;
 	_payload += dataSize;
+	_bytesSent.add(dataSize);
+	_buffersSent.add();
 	_timestamp = timestamp;
 	buffer.tagRTPHeaderWith(_ssrc, _senderRtpPacketCnt, timestamp);
 
-	return doWriteData(buffer);
+	if (!buffer.isTraced()) {
+		return doWriteData(buffer);
+	}
+	const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	const bool written = doWriteData(buffer);
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	_latencySendUS.observe(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+	_latencyTotalUS.observe(buffer.getLatencyUS(mpegts::PacketBuffer::Stage::READ, end));
+	return written;
 }
 
 void StreamClient::writeRTCPData(const std::string& attributeDescribeString) {
@@ -140,6 +154,29 @@ void StreamClient::teardown() {
 	}
 }
 
+void StreamClient::addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const {
+	const std::string clientLabels = labels + "," +
+		base::MetricsWriter::makeLabel("session", getSessionID());
+	metrics.addCounter("satpi_client_sent_bytes_total",
+		"Bytes of TS data written to the client", clientLabels, _bytesSent.get());
+	metrics.addCounter("satpi_client_sent_buffers_total",
+		"Buffers of TS data written to the client", clientLabels, _buffersSent.get());
+	metrics.addHistogram("satpi_client_latency_send_microseconds",
+		"Traced buffers: time to send to the client", clientLabels, _latencySendUS);
+	metrics.addHistogram("satpi_client_latency_total_microseconds",
+		"Traced buffers: time from read completed until send to the client", clientLabels, _latencyTotalUS);
+	base::MutexLock lock(_mutex);
+	const SocketAttr *socket = getDataSocket();
+	if (socket != nullptr) {
+		metrics.addCounter("satpi_client_send_calls_total",
+			"Send system calls on the data socket of the client", clientLabels, socket->getSendCalls());
+		metrics.addCounter("satpi_client_send_errors_total",
+			"Failed send system calls (dropped data) on the data socket of the client", clientLabels, socket->getSendErrors());
+		metrics.addCounter("satpi_client_send_eagain_total",
+			"Send system calls that returned EAGAIN on the data socket of the client", clientLabels, socket->getSendWouldBlock());
+	}
+}
+
 void StreamClient::selfDestruct() {
 	base::MutexLock lock(_mutex);
 	_watchdog = 1;
@@ -157,7 +194,10 @@ bool StreamClient::sessionTimeout() const {
 		case SessionTimeoutCheck::WATCHDOG:
 			return ((_watchdog != 0) && (_watchdog < std::time(nullptr)));
 		case SessionTimeoutCheck::FILE_DESCRIPTOR:
-			return (_socketClient == nullptr) ? false : (_socketClient->getFD() == -1);
+			// A failed write makes the client self destruct, so do not wait
+			// until the connection is closed by the other side
+			return (_socketClient == nullptr) ? false :
+				(_watchdog == 1 || !isSocketClientConnected());
 		default:
 			return false;
 	};
@@ -166,6 +206,14 @@ bool StreamClient::sessionTimeout() const {
 void StreamClient::setSocketClient(SocketClient &socket) {
 	base::MutexLock lock(_mutex);
 	_socketClient = &socket;
+	_socketConnectionID = socket.getConnectionID();
+}
+
+bool StreamClient::isSocketClientConnected() const {
+	// The socket client is reused when the connection is closed, so check we
+	// are still on the same connection and not writing into a new one
+	return _socketClient->getFD() != -1 &&
+		_socketClient->getConnectionID() == _socketConnectionID;
 }
 
 std::string StreamClient::getSetupMethodReply(const StreamID UNUSED(streamID)) {
@@ -351,13 +399,30 @@ std::pair<PacketPtr, int> StreamClient::getSDES() const {
 // =============================================================================
 
 bool StreamClient::sendHttpData(const void *buf, std::size_t len, int flags) {
-//	base::MutexLock lock(_mutex);
-	return (_socketClient == nullptr) ? false : _socketClient->sendData(buf, len, flags);
+	SocketClient *socketClient;
+	std::uint64_t connectionID;
+	{
+		base::MutexLock lock(_mutex);
+		socketClient = _socketClient;
+		connectionID = _socketConnectionID;
+	}
+	// The connection check and the send are done under the socket lock, so the
+	// connection can not be closed or reused in between
+	return (socketClient == nullptr) ? false :
+		socketClient->sendDataOnConnection(connectionID, buf, len, flags);
 }
 
 bool StreamClient::writeHttpData(const struct iovec *iov, int iovcnt) {
-//	base::MutexLock lock(_mutex);
-	return (_socketClient == nullptr) ? false : _socketClient->writeData(iov, iovcnt);
+	SocketClient *socketClient;
+	std::uint64_t connectionID;
+	{
+		base::MutexLock lock(_mutex);
+		socketClient = _socketClient;
+		connectionID = _socketConnectionID;
+	}
+	// @see sendHttpData
+	return (socketClient == nullptr) ? false :
+		socketClient->writeDataOnConnection(connectionID, iov, iovcnt);
 }
 
 int StreamClient::getHttpSocketPort() const {
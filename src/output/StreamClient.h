@@ -23,6 +23,7 @@
 #include <Defs.h>
 #include <FwDecl.h>
 #include <Unused.h>
+#include <base/Metrics.h>
 #include <base/Mutex.h>
 #include <base/XMLSupport.h>
 #include <mpegts/PacketBuffer.h>
@@ -75,7 +76,7 @@ class StreamClient : public base::XMLSupport {
 		virtual void doAddToXML(std::string& xml) const final;
 
 		/// @see XMLSupport
-		virtual void doFromXML(const std::string& xml) final;
+		virtual void doFromXML(const base::XMLElement &xml) final;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
@@ -97,12 +98,20 @@ class StreamClient : public base::XMLSupport {
 		///
 		void teardown();
 
+		/// Add the metrics of this client
+		/// @param labels specifies the labels of the stream of this client
+		void addToMetrics(base::MetricsWriter &metrics, const std::string &labels) const;
+
 		/// Check if this client has an session timeout
 		bool sessionTimeout() const;
 
 		/// Set the client that is sending data
 		void setSocketClient(SocketClient &socket);
 
+		/// Check if the socket client is still on the connection it had when
+		/// it was set
+		bool isSocketClientConnected() const;
+
 		/// Set the session ID for this client
 		/// @param specifies the the session ID to use
 		void setSessionID(const std::string& sessionID) {
@@ -152,6 +161,13 @@ class StreamClient : public base::XMLSupport {
 			return "";
 		}
 
+	protected:
+
+		/// Get the socket the stream data is send with
+		virtual const SocketAttr *getDataSocket() const {
+			return _socketClient;
+		}
+
 	private:
 
 		///
@@ -220,6 +236,7 @@ class StreamClient : public base::XMLSupport {
 		FeID _feID;
 		bool _streamActive;
 		SocketClient *_socketClient;
+		std::uint64_t _socketConnectionID;
 		SessionTimeoutCheck _sessionTimeoutCheck;
 		std::string _ipAddressOfStream;
 		std::time_t _watchdog;
@@ -234,6 +251,10 @@ class StreamClient : public base::XMLSupport {
 		std::atomic<uint32_t> _senderOctectPayloadCnt;
 		std::atomic<long> _timestamp;
 		std::atomic<long> _payload;
+		base::Counter _bytesSent;
+		base::Counter _buffersSent;
+		base::Histogram _latencySendUS{base::Histogram::LATENCY_US_BOUNDS};
+		base::Histogram _latencyTotalUS{base::Histogram::LATENCY_US_BOUNDS};
 
 };
 
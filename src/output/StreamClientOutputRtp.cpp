@@ -91,7 +91,7 @@ std::string StreamClientOutputRtp::getSDPMediaLevelString(
 
 bool StreamClientOutputRtp::doProcessStreamingRequest(const SocketClient& client) {
 	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HeaderVector &headers = client.getHeaders();
 
 	std::string ports;
 	int ttl = 0;
@@ -65,6 +65,13 @@ class StreamClientOutputRtp : public output::StreamClient {
 				StreamID streamID,
 				const std::string& fmtp) const final;
 
+	protected:
+
+		/// Specialization for @see getDataSocket
+		virtual const SocketAttr *getDataSocket() const final {
+			return &_rtp;
+		}
+
 	private:
 
 		/// Specialization for @see processStreamingRequest
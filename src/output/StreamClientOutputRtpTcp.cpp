@@ -47,7 +47,7 @@ std::string StreamClientOutputRtpTcp::getSetupMethodReply(const StreamID streamI
 
 bool StreamClientOutputRtpTcp::doProcessStreamingRequest(const SocketClient& client) {
 	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HeaderVector &headers = client.getHeaders();
 
 	const int interleaved = headers.getIntFieldParameter("Transport", "interleaved");
 	if (interleaved != -1) {
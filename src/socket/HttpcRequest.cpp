@@ -0,0 +1,208 @@
+/* HttpcRequest.cpp
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <socket/HttpcRequest.h>
+
+#include <StringConverter.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+	bool equalsNoCase(const std::string_view a, const std::string_view b) noexcept {
+		if (a.size() != b.size()) {
+			return false;
+		}
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			if (std::tolower(static_cast<unsigned char>(a[i])) !=
+				std::tolower(static_cast<unsigned char>(b[i]))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void HttpcRequest::clear() {
+	_msg.clear();
+	_next.clear();
+	_scanPos = 0;
+	_lineBegin = 0;
+	_contentBegin = std::string::npos;
+	_contentLength = 0;
+	_lines.clear();
+	_requestLine = Slice();
+	_protocol = Slice();
+	_requestedFile = Slice();
+	_method.clear();
+	_hasTransportParameters = false;
+	_headers.reset();
+	_params.reset();
+}
+
+void HttpcRequest::next() {
+	std::string data = std::move(_next);
+	clear();
+	append(data);
+}
+
+void HttpcRequest::append(const std::string_view data) {
+	if (data.empty()) {
+		return;
+	}
+	// Data after a complete message belongs to the next one
+	if (isComplete()) {
+		_next.append(data);
+		return;
+	}
+	_msg.append(data);
+	_headers.reset();
+	_params.reset();
+	// Only the headers need indexing, the content is taken as is
+	while (!isHeaderComplete() && !isHeaderTooLarge()) {
+		const std::string::size_type end = _msg.find("\r\n", _scanPos);
+		if (end == std::string::npos) {
+			// Maybe we have the '\r' already, so look again from there
+			_scanPos = std::max(_lineBegin, _msg.size() - 1);
+			break;
+		}
+		if (end == _lineBegin && !_lines.empty()) {
+			// Empty line, so end of headers
+			_contentBegin = end + 2;
+		} else if (end != _lineBegin) {
+			addLine(_lineBegin, end);
+		}
+		_lineBegin = end + 2;
+		_scanPos = _lineBegin;
+	}
+	splitOffNext();
+}
+
+void HttpcRequest::insertHeader(const std::string_view header) {
+	if (!isHeaderComplete()) {
+		return;
+	}
+	// The request line stays the same, so keep the Transport Parameters
+	std::unique_ptr<TransportParamVector> params = std::move(_params);
+	std::string msg = std::move(_msg);
+	std::string next = std::move(_next);
+	msg.insert(_contentBegin - 2, header);
+	clear();
+	append(msg);
+	_next = std::move(next);
+	_params = std::move(params);
+}
+
+std::string_view HttpcRequest::getContent() const noexcept {
+	if (_contentLength == 0 || !isHeaderComplete()) {
+		return std::string_view();
+	}
+	return std::string_view(_msg).substr(_contentBegin, _contentLength);
+}
+
+const HeaderVector &HttpcRequest::getHeaders() const {
+	if (!_headers) {
+		// The request line and the header lines are already indexed
+		StringVector lines;
+		lines.reserve(_lines.size());
+		for (const Slice &line : _lines) {
+			lines.emplace_back(slice(line));
+		}
+		_headers.reset(new HeaderVector(std::move(lines)));
+	}
+	return *_headers;
+}
+
+const TransportParamVector &HttpcRequest::getTransportParameters() const {
+	if (!_params) {
+		_params.reset(new TransportParamVector(StringConverter::split(
+			StringConverter::getPercentDecoding(std::string(getRequestLine())), " /?&")));
+	}
+	return *_params;
+}
+
+void HttpcRequest::splitOffNext() {
+	if (!isComplete()) {
+		return;
+	}
+	const std::size_t end = _contentBegin + _contentLength;
+	if (_msg.size() > end) {
+		_next.insert(0, _msg, end, std::string::npos);
+		_msg.resize(end);
+	}
+}
+
+void HttpcRequest::addLine(const std::size_t begin, const std::size_t end) {
+	_lines.push_back({ begin, end - begin });
+	if (_lines.size() == 1) {
+		_requestLine = _lines[0];
+		parseRequestLine();
+		return;
+	}
+	const std::string_view line = slice(_lines.back());
+	const std::string_view::size_type colon = line.find(':');
+	if (colon != std::string_view::npos && equalsNoCase(line.substr(0, colon), "Content-Length")) {
+		const std::string_view value = line.substr(colon + 1);
+		const std::string_view::size_type digit = value.find_first_not_of(" \t");
+		if (digit != std::string_view::npos && std::isdigit(static_cast<unsigned char>(value[digit]))) {
+			_contentLength = std::strtoul(std::string(value.substr(digit)).c_str(), nullptr, 10);
+		}
+	}
+}
+
+void HttpcRequest::parseRequestLine() {
+	const std::string_view line = getRequestLine();
+	const std::size_t offset = _requestLine.begin;
+
+	// Method, upper case without leading whitespace
+	std::string_view::size_type i = line.find_first_not_of(' ');
+	for (; i < line.size() && line[i] != ' '; ++i) {
+		_method += std::toupper(static_cast<unsigned char>(line[i]));
+	}
+
+	// Protocol, between the last ' ' and the last '/' (eg. 'RTSP/1.0')
+	const std::string_view::size_type protoBegin = line.find_last_of(' ');
+	const std::string_view::size_type protoEnd = line.find_last_of('/');
+	if (protoBegin != std::string_view::npos && protoEnd != std::string_view::npos &&
+		protoEnd > protoBegin) {
+		_protocol = { offset + protoBegin + 1, protoEnd - protoBegin - 1 };
+	}
+
+	// Requested resource, from the first '/' until the next ' '
+	const std::string_view::size_type fileBegin = line.find_first_of('/');
+	if (fileBegin != std::string_view::npos) {
+		std::string_view::size_type fileEnd = line.find_first_of(' ', fileBegin);
+		if (fileEnd == std::string_view::npos) {
+			fileEnd = line.size();
+		}
+		_requestedFile = { offset + fileBegin, fileEnd - fileBegin };
+	}
+
+	// Transport Parameters, something after the '?'
+	const std::string_view::size_type query = line.find_first_of('?');
+	_hasTransportParameters = query != std::string_view::npos &&
+		query < line.size() - 1 && line[query + 1] != ' ';
+}
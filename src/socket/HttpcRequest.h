@@ -0,0 +1,174 @@
+/* HttpcRequest.h
+
+   Copyright (C) 2014 - 2023 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef SOCKET_HTTPCREQUEST_H_INCLUDE
+#define SOCKET_HTTPCREQUEST_H_INCLUDE SOCKET_HTTPCREQUEST_H_INCLUDE
+
+#include <HeaderVector.h>
+#include <TransportParamVector.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// The class @c HttpcRequest holds one HTTP/RTSP message. The request line
+/// and the header lines are indexed while the data arrives, so the message
+/// is only scanned once. The headers and transport parameters are split
+/// on first use and then kept until the message changes.
+class HttpcRequest {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		HttpcRequest() = default;
+
+		virtual ~HttpcRequest() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// The maximum size of the request line and the header lines
+		static constexpr std::size_t MAX_HEADER_SIZE = 16 * 1024;
+
+		/// Clear the message, with the data received after it
+		void clear();
+
+		/// Start the next message with the data that was received after this
+		/// (complete) one, like a pipelined request
+		void next();
+
+		/// Is there data received after this message
+		bool hasNext() const noexcept {
+			return !_next.empty();
+		}
+
+		/// Add received message data and index the new complete lines
+		void append(std::string_view data);
+
+		/// Insert an extra header line (with '\r\n') at the end of the headers,
+		/// references from @c getHeaders() are invalid afterwards
+		void insertHeader(std::string_view header);
+
+		/// Is the end of the headers '\r\n\r\n' received
+		bool isHeaderComplete() const noexcept {
+			return _contentBegin != std::string::npos;
+		}
+
+		/// Are the headers and the content (Content-Length) received
+		bool isComplete() const noexcept {
+			return isHeaderComplete() && _msg.size() >= _contentBegin + _contentLength;
+		}
+
+		/// Are the headers larger than @c MAX_HEADER_SIZE
+		bool isHeaderTooLarge() const noexcept {
+			return isHeaderComplete() ? _contentBegin > MAX_HEADER_SIZE : _msg.size() > MAX_HEADER_SIZE;
+		}
+
+		/// Get the raw message data
+		const std::string &getRawMessage() const noexcept {
+			return _msg;
+		}
+
+		/// Get the first (request) line
+		std::string_view getRequestLine() const noexcept {
+			return slice(_requestLine);
+		}
+
+		/// Get the method (upper case) from the request line
+		const std::string &getMethod() const noexcept {
+			return _method;
+		}
+
+		/// Get the protocol (eg. 'HTTP' or 'RTSP') from the request line
+		std::string_view getProtocol() const noexcept {
+			return slice(_protocol);
+		}
+
+		/// Get the requested resource from the request line
+		std::string_view getRequestedFile() const noexcept {
+			return slice(_requestedFile);
+		}
+
+		/// Does the request line have any Transport Parameters
+		bool hasTransportParameters() const noexcept {
+			return _hasTransportParameters;
+		}
+
+		/// Get the value of the Content-Length header field
+		std::size_t getContentLength() const noexcept {
+			return _contentLength;
+		}
+
+		/// Get the content, when there is a Content-Length
+		std::string_view getContent() const noexcept;
+
+		/// Get the request line and the header lines, made from the line index
+		/// on first use
+		const HeaderVector &getHeaders() const;
+
+		/// Get the Transport Parameters of the request line, split on first use
+		const TransportParamVector &getTransportParameters() const;
+
+	private:
+
+		/// Offset and size of a part of @c _msg
+		struct Slice {
+			std::size_t begin = 0;
+			std::size_t size = 0;
+		};
+
+		std::string_view slice(const Slice &s) const noexcept {
+			return std::string_view(_msg).substr(s.begin, s.size);
+		}
+
+		/// Move the data after the content to @c _next
+		void splitOffNext();
+
+		/// Index the line, the first one is the request line
+		void addLine(std::size_t begin, std::size_t end);
+
+		///
+		void parseRequestLine();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::string _msg;
+		std::string _next;
+		std::size_t _scanPos = 0;
+		std::size_t _lineBegin = 0;
+		std::size_t _contentBegin = std::string::npos;
+		std::size_t _contentLength = 0;
+		std::vector<Slice> _lines;
+		Slice _requestLine;
+		Slice _protocol;
+		Slice _requestedFile;
+		std::string _method;
+		bool _hasTransportParameters = false;
+		mutable std::unique_ptr<HeaderVector> _headers;
+		mutable std::unique_ptr<TransportParamVector> _params;
+};
+
+#endif // SOCKET_HTTPCREQUEST_H_INCLUDE
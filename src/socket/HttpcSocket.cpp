@@ -23,15 +23,12 @@
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
 
-#include <chrono>
-#include <thread>
+#include <cerrno>
 
 #include <unistd.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
-const int HttpcSocket::HTTPC_TIMEOUT = 500;
-
 	// =========================================================================
 	//  -- Constructors and destructor -----------------------------------------
 	// =========================================================================
@@ -44,64 +41,46 @@ const int HttpcSocket::HTTPC_TIMEOUT = 500;
 	// =========================================================================
 
 	ssize_t HttpcSocket::recvHttpcMessage(SocketClient &client, int recv_flags) {
-		return recv_recvfrom_httpc_message(client, recv_flags, nullptr, nullptr);
-	}
-
-	ssize_t HttpcSocket::recvfromHttpcMessage(SocketClient &client, int recv_flags,
-		struct sockaddr_in *si_other, socklen_t *addrlen) {
-		return recv_recvfrom_httpc_message(client, recv_flags, si_other, addrlen);
-	}
-
-	ssize_t HttpcSocket::recv_recvfrom_httpc_message(SocketClient &client,
-		int recv_flags, struct sockaddr_in *si_other, socklen_t *addrlen) {
+		// A new message starts after the previous one is complete, with the
+		// data received after it, otherwise continue with the part that is
+		// already received
+		if (client.getRequest().isComplete()) {
+			client.nextMessage();
+			// A pipelined request may be complete already
+			if (client.getRequest().isComplete()) {
+				return client.getRawMessage().size();
+			}
+		}
 		std::size_t read_len = 0;
-		std::size_t timeout = HTTPC_TIMEOUT;
-		bool done = false;
-		bool end = false;
-		std::size_t actualSize = 0;
 
-		client.clearMessage();
-
-		// read until we have '\r\n\r\n' (end of HTTP/RTSP message) then check
-		// if the header field 'Content-Length' is present
+		// read until we have '\r\n\r\n' (end of HTTP/RTSP message) and the
+		// content given by the header field 'Content-Length'
 		do {
 			char buf[1024];
-			const ssize_t size = ::recvfrom(client.getFD(), buf, sizeof(buf)-1, recv_flags, (struct sockaddr *)si_other, addrlen);
-			if (size > 0) {
-				read_len += size;
-				// terminate
-				buf[size] = 0;
-				client.addMessage(buf);
-				// reset timeout again
-				timeout = HTTPC_TIMEOUT;
-				// end of message "\r\n\r\n" ?
-				if (!end) {
-					const std::string::size_type headerSize = client.getRawMessage().find("\r\n\r\n");
-					end = headerSize != std::string::npos;
-
-					// check do we need to read more?
-					const std::string parameter = client.getHeaders().getFieldParameter("Content-Length");
-					const std::size_t contentLength = parameter.empty() ? 0 : std::stoi(parameter);
-					if (contentLength > 0) {
-						// now check did we read it all
-						actualSize = headerSize + contentLength + 4; // 4 = "\r\n\r\n"
-						done = actualSize == client.getRawMessage().size();
-					} else if (end) {
-						done = true;
-					}
-				} else {
-					// now check did we read it all this time around?
-					done = actualSize == client.getRawMessage().size();
-				}
-			} else {
-				if (timeout != 0 && size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-					std::this_thread::sleep_for(std::chrono::microseconds(1000));
-					--timeout;
-				} else {
-					return size;
-				}
+			const ssize_t size = ::recv(client.getFD(), buf, sizeof(buf), recv_flags);
+			if (size <= 0) {
+				// With EAGAIN the partial message is kept for the next call
+				return size;
 			}
-		} while (!done);
+			read_len += size;
+			client.addMessage(std::string_view(buf, size));
+			if (client.getRequest().isHeaderTooLarge()) {
+				errno = EMSGSIZE;
+				return -1;
+			}
+		} while (!client.getRequest().isComplete());
 
 		return read_len;
 	}
+
+	ssize_t HttpcSocket::recvfromHttpcMessage(SocketClient &client, int recv_flags,
+		struct sockaddr_in *si_other, socklen_t *addrlen) {
+		// A datagram is always one complete message
+		client.clearMessage();
+		char buf[4096];
+		const ssize_t size = ::recvfrom(client.getFD(), buf, sizeof(buf), recv_flags, (struct sockaddr *)si_other, addrlen);
+		if (size > 0) {
+			client.addMessage(std::string_view(buf, size));
+		}
+		return size;
+	}
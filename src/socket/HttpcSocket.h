@@ -31,8 +31,6 @@ FW_DECL_NS0(SocketClient);
 class HttpcSocket  {
 	public:
 
-		static const int HTTPC_TIMEOUT;
-
 		// =====================================================================
 		//  -- Constructors and destructor -------------------------------------
 		// =====================================================================
@@ -46,13 +44,16 @@ class HttpcSocket  {
 
 	protected:
 
-		/// Receive an HTTP message from client
+		/// Receive an HTTP message from a connected client. An incomplete
+		/// message is kept by the client and completed on the next call
 		/// @param client
 		/// @param recv_flags
-		/// @return the amount of bytes red
+		/// @return the amount of bytes red when the message is complete, 0 if
+		/// the connection is closed or -1 on error (EAGAIN when incomplete,
+		/// EMSGSIZE when the headers are too large)
 		ssize_t recvHttpcMessage(SocketClient &client, int recv_flags);
 
-		/// Receive an HTTP message from client
+		/// Receive an HTTP message datagram
 		/// @param client
 		/// @param recv_flags
 		/// @param si_other
@@ -61,11 +62,6 @@ class HttpcSocket  {
 		ssize_t recvfromHttpcMessage(SocketClient &client, int recv_flags,
 			struct sockaddr_in *si_other, socklen_t *addrlen);
 
-	private:
-		/// Main receive HTTP message from client
-		ssize_t recv_recvfrom_httpc_message(SocketClient &client, int recv_flags,
-			struct sockaddr_in *si_other, socklen_t *addrlen);
-
 };
 
 #endif // HTTPC_SOCKET_H_INCLUDE
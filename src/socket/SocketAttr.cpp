@@ -27,11 +27,33 @@
 #include <cstring>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <arpa/inet.h>
+#include <poll.h>
 #include <sys/uio.h>
 #include <sys/socket.h>
-#include <sys/select.h>
+
+namespace {
+
+	/// The time a send may wait for room in a full socket
+	constexpr std::chrono::milliseconds SEND_TIMEOUT(5000);
+
+	/// Wait until the socket can take data again, or the deadline is passed
+	bool waitUntilWritable(const int fd, const std::chrono::steady_clock::time_point deadline) {
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now()).count();
+		if (left <= 0) {
+			return false;
+		}
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLOUT;
+		pfd.revents = 0;
+		return ::poll(&pfd, 1, static_cast<int>(left)) > 0 && (pfd.revents & POLLOUT) != 0;
+	}
+
+}
 
 	// ===================================================================
 	//  -- Constructors and destructor -----------------------------------
@@ -166,43 +188,89 @@
 
 	bool SocketAttr::sendData(const void *buf, std::size_t len, int flags) {
 		base::MutexLock lock(_mutex);
-		if (::send(_fd, buf, len, flags) == -1) {
-			SI_LOG_PERROR("send");
-			return false;
+		return sendData_L(buf, len, flags);
+	}
+
+	bool SocketAttr::sendData_L(const void *buf, std::size_t len, const int flags) {
+		const std::chrono::steady_clock::time_point deadline =
+			std::chrono::steady_clock::now() + SEND_TIMEOUT;
+		const char *data = static_cast<const char *>(buf);
+		while (len > 0) {
+			_sendCalls.add();
+			const ssize_t sent = ::send(_fd, data, len, flags);
+			if (sent >= 0) {
+				// Only a part may be send, so continue with the rest
+				data += sent;
+				len -= sent;
+				continue;
+			}
+			countSendError();
+			if (errno == EINTR) {
+				continue;
+			}
+			const bool wouldBlock = errno == EAGAIN || errno == EWOULDBLOCK;
+			if (!wouldBlock || (flags & MSG_DONTWAIT) != 0 || !waitUntilWritable(_fd, deadline)) {
+				SI_LOG_PERROR("send");
+				return false;
+			}
 		}
 		return true;
 	}
 
 	bool SocketAttr::writeData(const iovec *iov, const int iovcnt) {
+		base::MutexLock lock(_mutex);
+		return writeData_L(iov, iovcnt);
+	}
+
+	bool SocketAttr::writeData_L(const iovec *iov, const int iovcnt) {
 		if (_fd == -1) {
 			return false;
 		}
-		{
-			base::MutexLock lock(_mutex);
-			if (::writev(_fd, iov, iovcnt) != -1) {
-				return true;
-			}
+		std::size_t size = 0;
+		for (int i = 0; i < iovcnt; ++i) {
+			size += iov[i].iov_len;
+		}
+		_sendCalls.add();
+		ssize_t written = ::writev(_fd, iov, iovcnt);
+		if (written >= 0 && static_cast<std::size_t>(written) == size) {
+			return true;
 		}
-		if (errno != EBADF) {
-			timeval tv{};
-			fd_set fds{};
-			tv.tv_sec = 5;
-			FD_ZERO(&fds);
-			FD_SET(_fd, &fds);
-			if (select(1, &fds, nullptr, nullptr, &tv) != -1) {
-				base::MutexLock lock(_mutex);
-				if (::writev(_fd, iov, iovcnt) != -1) {
+		// Only a part is written or the socket is full, so resume with a copy
+		// of the vector at the offset that is not written yet
+		const std::chrono::steady_clock::time_point deadline =
+			std::chrono::steady_clock::now() + SEND_TIMEOUT;
+		std::vector<iovec> rest(iov, iov + iovcnt);
+		std::size_t index = 0;
+		for (;;) {
+			if (written >= 0) {
+				std::size_t done = written;
+				while (index < rest.size() && done >= rest[index].iov_len) {
+					done -= rest[index].iov_len;
+					++index;
+				}
+				if (index == rest.size()) {
 					return true;
 				}
+				rest[index].iov_base = static_cast<char *>(rest[index].iov_base) + done;
+				rest[index].iov_len -= done;
+			} else {
+				countSendError();
+				if (errno != EINTR && ((errno != EAGAIN && errno != EWOULDBLOCK) ||
+						!waitUntilWritable(_fd, deadline))) {
+					SI_LOG_PERROR("writeData");
+					return false;
+				}
 			}
+			_sendCalls.add();
+			written = ::writev(_fd, rest.data() + index, rest.size() - index);
 		}
-		SI_LOG_PERROR("writeData: ");
-		return false;
 	}
 
 	bool SocketAttr::sendDataTo(const void *buf, std::size_t len, int flags) {
+		_sendCalls.add();
 		if (::sendto(_fd, buf, len, flags, reinterpret_cast<sockaddr *>(&_addr),
 				   sizeof(_addr)) == -1) {
+			countSendError();
 			SI_LOG_PERROR("sendto (fd: @#1)", _fd);
 			return false;
 		}
@@ -216,6 +284,10 @@
 		return size;
 	}
 
+	int SocketAttr::recvMultipleDatafrom(struct mmsghdr *msgs, const unsigned int vlen, const int flags) {
+		return ::recvmmsg(_fd, msgs, vlen, flags, nullptr);
+	}
+
 	int SocketAttr::getFD() const {
 		return _fd;
 	}
@@ -275,3 +347,12 @@
 		}
 		return true;
 	}
+
+	bool SocketAttr::setReceiveOverflowCounter() {
+		const int on = 1;
+		if (::setsockopt(_fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) == -1) {
+			SI_LOG_PERROR("setsockopt: SO_RXQ_OVFL");
+			return false;
+		}
+		return true;
+	}
@@ -21,8 +21,10 @@
 #define SOCKET_SOCKETATTR_H_INCLUDE SOCKET_SOCKETATTR_H_INCLUDE
 
 #include <FwDecl.h>
+#include <base/Metrics.h>
 #include <base/Mutex.h>
 
+#include <cerrno>
 #include <string>
 #include <string_view>
 
@@ -30,6 +32,8 @@
 
 FW_DECL_NS0(SocketClient);
 
+struct mmsghdr;
+
 /// Socket attributes
 class SocketAttr {
 	public:
@@ -74,10 +78,12 @@ class SocketAttr {
 			return _ipAddr;
 		}
 
-		///
+		/// Write all the data of the vector, a partial write is resumed and a
+		/// full socket is waited for (with a timeout)
 		bool writeData(const struct iovec* iov, int iovcnt);
 
-		/// Use this function when the socket is in connected state
+		/// Use this function when the socket is in connected state, all data
+		/// is send unless @c MSG_DONTWAIT is given and the socket is full
 		bool sendData(const void* buf, std::size_t len, int flags);
 
 		/// Use this function when the socket is on a
@@ -96,6 +102,10 @@ class SocketAttr {
 		/// Set the network receive buffer size for this Socket
 		bool setNetworkReceiveBufferSize(int size);
 
+		/// Let the kernel add the number of dropped datagrams (SO_RXQ_OVFL)
+		/// to every received datagram
+		bool setReceiveOverflowCounter();
+
 		/// Set the Receive and Send timeout in Sec for this socket
 		void setSocketTimeoutInSec(unsigned int timeout);
 
@@ -110,6 +120,10 @@ class SocketAttr {
 		///
 		ssize_t recvDatafrom(void* buf, std::size_t len, int flags);
 
+		/// Receive a batch of datagrams with one system call
+		/// @return the number of received datagrams, or -1 on error
+		int recvMultipleDatafrom(struct mmsghdr *msgs, unsigned int vlen, int flags);
+
 		/// bind the socket to the port number
 		bool bind();
 
@@ -121,6 +135,21 @@ class SocketAttr {
 		/// Set connect on this Socket
 		bool connectTo();
 
+		/// Get the number of send calls done on this Socket
+		std::uint64_t getSendCalls() const noexcept {
+			return _sendCalls.get();
+		}
+
+		/// Get the number of failed send calls, including EAGAIN/EWOULDBLOCK
+		std::uint64_t getSendErrors() const noexcept {
+			return _sendErrors.get();
+		}
+
+		/// Get the number of send calls that returned EAGAIN/EWOULDBLOCK
+		std::uint64_t getSendWouldBlock() const noexcept {
+			return _sendWouldBlock.get();
+		}
+
 		/// Accept an connection on this Socket and save client IP address etc.
 		/// in client
 		bool acceptConnection(SocketClient& client, bool showLogInfo);
@@ -134,6 +163,20 @@ class SocketAttr {
 		///
 		void setKeepAlive();
 
+		/// @see writeData, but the caller should hold @c _mutex
+		bool writeData_L(const struct iovec* iov, int iovcnt);
+
+		/// @see sendData, but the caller should hold @c _mutex
+		bool sendData_L(const void* buf, std::size_t len, int flags);
+
+		/// Count the last failed send call and if it would have blocked
+		void countSendError() noexcept {
+			_sendErrors.add();
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				_sendWouldBlock.add();
+			}
+		}
+
 		// ===================================================================
 		//  -- Data members --------------------------------------------------
 		// ===================================================================
@@ -145,6 +188,9 @@ class SocketAttr {
 		struct sockaddr_in _addr;
 		std::string _ipAddr;
 		int _ttl;
+		base::Counter _sendCalls;
+		base::Counter _sendErrors;
+		base::Counter _sendWouldBlock;
 
 };
 
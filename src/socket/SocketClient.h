@@ -23,9 +23,13 @@
 #include <HeaderVector.h>
 #include <StringConverter.h>
 #include <TransportParamVector.h>
+#include <socket/HttpcRequest.h>
 #include <socket/SocketAttr.h>
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 ///
 class SocketClient :
@@ -36,7 +40,6 @@ class SocketClient :
 	public:
 
 		SocketClient() :
-			_msg(""),
 			_protocolString("None") {}
 
 		virtual ~SocketClient() {}
@@ -46,10 +49,14 @@ class SocketClient :
 		// =====================================================================
 	public:
 
-		/// Close the file descriptor of this Socket
+		/// Close the file descriptor of this Socket. This is done under the
+		/// socket lock, so a write on this connection does not see a closed or
+		/// reused file descriptor
 		virtual void closeFD() final {
+			base::MutexLock lock(_mutex);
 			SocketAttr::closeFD();
-			_msg.clear();
+			_request.clear();
+			++_connectionID;
 		}
 
 		// =====================================================================
@@ -59,126 +66,80 @@ class SocketClient :
 
 		/// Clear the HTTP message
 		void clearMessage() {
-			_msg.clear();
+			_request.clear();
+		}
+
+		/// Start the next HTTP message with the data received after the
+		/// current one
+		void nextMessage() {
+			_request.next();
 		}
 
 		/// Add HTTP message data
 		/// @param msg specifies the message to set/add
-		void addMessage(const std::string &msg) {
-			_msg += msg;
+		void addMessage(std::string_view msg) {
+			_request.append(msg);
+		}
+
+		/// Get the parsed HTTP message
+		const HttpcRequest &getRequest() const {
+			return _request;
 		}
 
 		/// Get the Headers of the HTTP message
-		HeaderVector getHeaders() const {
-			return HeaderVector(StringConverter::split(_msg, "\r\n"));
+		const HeaderVector &getHeaders() const {
+			return _request.getHeaders();
 		}
 
 		/// Get the Raw HTTP message data
-		std::string getRawMessage() const {
-			return _msg;
+		const std::string &getRawMessage() const {
+			return _request.getRawMessage();
 		}
 
 		/// Spoof HTTP message with given data header
 		/// @param header specifies the header to spoof/add to HTTP message
 		void spoofHeaderWith(const std::string &header) const {
-			const std::string::size_type n = _msg.find("\r\n\r\n");
-			if (n != std::string::npos) {
-				_msg.insert(n + 2, header);
-			}
+			_request.insertHeader(header);
 		}
 
 		/// Get the Method used for this HTTP message
 		std::string getMethod() const {
-			// request line should be in the first line (method)
-			HeaderVector headers = getHeaders();
-			const std::string& line = headers[0];
-			if (!headers[0].empty()) {
-				std::string::const_iterator it = line.begin();
-				// remove any leading whitespace
-				while (*it == ' ') ++it;
-
-				// copy method (upper case)
-				std::string method;
-				while (*it != ' ') {
-					method += std::toupper(*it);
-					++it;
-				}
-				return method;
-			}
-			return std::string();
+			return _request.getMethod();
 		}
 
 		/// Get the content from HTTP message
 		std::string getContentFrom() const {
-			HeaderVector headers = getHeaders();
-			const std::string p = headers.getFieldParameter("Content-Length");
-			const std::size_t contentLength = (!p.empty() && std::isdigit(p[0])) ? std::stoi(p) : 0;
-			if (contentLength > 0) {
-				const std::string::size_type headerSize = _msg.find("\r\n\r\n", 0);
-				if (headerSize != std::string::npos) {
-					return _msg.substr(headerSize + 4);
-				}
-			}
-			return std::string();
+			return std::string(_request.getContent());
 		}
 
 		/// Get the requested resource from HTTP message
 		std::string getRequestedFile() const {
-			HeaderVector headers = getHeaders();
-			const std::string& param = headers[0];
-			if (!param.empty()) {
-				const std::string::size_type begin = param.find_first_of("/");
-				const std::string::size_type end   = param.find_first_of(" ", begin);
-				return param.substr(begin, end - begin);
-			}
-			return std::string();
+			return std::string(_request.getRequestedFile());
 		}
 
 		/// Is the request the root-resource
 		bool isRootFile() const {
-			return _msg.find("/ ") != std::string::npos;
+			return _request.getRawMessage().find("/ ") != std::string::npos;
 		}
 
 		/// Does the request have any Transport Parameters
 		bool hasTransportParameters() const {
-			// Transport Parameters should be in the first line (method)
-			std::string::size_type nextline = 0;
-			const std::string line = StringConverter::getline(_msg, nextline, "\r\n");
-			if (!line.empty()) {
-				const std::string::size_type size = line.size() - 1;
-				const std::string::size_type found = line.find_first_of("?");
-				if (found != std::string::npos && found < size && line[found + 1] != ' ') {
-					return true;
-				}
-			}
-			return false;
+			return _request.hasTransportParameters();
 		}
 
 		/// Get the Transport Parameters
-		TransportParamVector getTransportParameters() const {
-			HeaderVector headers = getHeaders();
-			return TransportParamVector(StringConverter::split(
-				StringConverter::getPercentDecoding(headers[0]), " /?&"));
+		const TransportParamVector &getTransportParameters() const {
+			return _request.getTransportParameters();
 		}
 
 		/// Get the Percent Decoded HTTP message from this client
 		std::string getPercentDecodedMessage() const {
-			return StringConverter::getPercentDecoding(_msg);
+			return StringConverter::getPercentDecoding(_request.getRawMessage());
 		}
 
 		/// Get the protocol specified in this HTTP message
 		std::string getProtocol() const {
-			// Protocol should be in the first line
-			std::string::size_type nextline = 0;
-			const std::string line = StringConverter::getline(_msg, nextline, "\r\n");
-			if (!line.empty()) {
-				const std::string::size_type begin = line.find_last_of(" ") + 1;
-				const std::string::size_type end   = line.find_last_of("/");
-				if (begin != std::string::npos && end != std::string::npos) {
-					return line.substr(begin, end - begin);
-				}
-			}
-			return std::string();
+			return std::string(_request.getProtocol());
 		}
 
 		/// Set protocol string
@@ -192,13 +153,45 @@ class SocketClient :
 			return _protocolString;
 		}
 
+		/// Get the ID of the current connection. This client is reused for new
+		/// connections, so the ID changes every time the connection is closed
+		std::uint64_t getConnectionID() const {
+			return _connectionID.load(std::memory_order_acquire);
+		}
+
+		/// Write the data only if the connection with the given ID is still open,
+		/// checked under the same lock as closing it
+		/// @see SocketAttr::writeData
+		bool writeDataOnConnection(const std::uint64_t connectionID,
+				const struct iovec* iov, const int iovcnt) {
+			base::MutexLock lock(_mutex);
+			return isConnection_L(connectionID) && writeData_L(iov, iovcnt);
+		}
+
+		/// Send the data only if the connection with the given ID is still open,
+		/// checked under the same lock as closing it
+		/// @see SocketAttr::sendData
+		bool sendDataOnConnection(const std::uint64_t connectionID,
+				const void* buf, const std::size_t len, const int flags) {
+			base::MutexLock lock(_mutex);
+			return isConnection_L(connectionID) && sendData_L(buf, len, flags);
+		}
+
+	private:
+
+		/// Check if the connection with the given ID is still open
+		bool isConnection_L(const std::uint64_t connectionID) const {
+			return _fd != -1 && _connectionID.load(std::memory_order_acquire) == connectionID;
+		}
+
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
 		// =====================================================================
 	private:
 
-		mutable std::string _msg;
+		mutable HttpcRequest _request;
 		std::string _protocolString;
+		std::atomic<std::uint64_t> _connectionID{0};
 };
 
 #endif // SOCKET_SOCKETCLIENT_H_INCLUDE
@@ -21,13 +21,17 @@
 
 #include <socket/SocketClient.h>
 #include <Log.h>
-#include <Utils.h>
+#include <StringConverter.h>
+
+#include <chrono>
+#include <thread>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
@@ -35,97 +39,207 @@
 //  -- Constructors and destructor --------------------------------------------
 // ============================================================================
 
-TcpSocket::TcpSocket(int maxClients, const std::string &protocol) :
-		_MAX_CLIENTS(maxClients),
-		_MAX_POLL(maxClients + 1),
-		_pfd(new pollfd[maxClients + 1]),
-		_client(new SocketClient[maxClients]),
+TcpSocket::TcpSocket(const std::string &protocol) :
+		_epfd(-1),
+		_maxClients(0),
+		_connectedClients(0),
+		_acceptPaused(false),
 		_protocolString(protocol) {}
 
 TcpSocket::~TcpSocket() {
-	DELETE_ARRAY(_pfd);
-	DELETE_ARRAY(_client);
+	terminateWorkers();
+	for (std::unique_ptr<SocketClient> &client : _clients) {
+		client->closeFD();
+	}
 	_server.closeFD();
+	if (_epfd != -1) {
+		::close(_epfd);
+	}
 }
 
 // ============================================================================
 //  -- Other member functions -------------------------------------------------
 // ============================================================================
 
-void TcpSocket::initialize(const std::string &ipAddr, int port, bool nonblock) {
-	for (std::size_t i = 0; i < _MAX_CLIENTS; ++i) {
-		_client[i].setProtocol(_protocolString);
+void TcpSocket::initialize(const std::string &ipAddr, const int port,
+		const std::size_t maxClients, const std::size_t threads) {
+	_maxClients = maxClients;
+	_epfd = ::epoll_create1(EPOLL_CLOEXEC);
+	if (_epfd == -1) {
+		SI_LOG_PERROR("epoll_create1");
+		return;
+	}
+	if (!initServerSocket(ipAddr, port)) {
+		return;
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.ptr = nullptr;
+	if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _server.getFD(), &ev) == -1) {
+		SI_LOG_PERROR("epoll_ctl");
+		return;
+	}
+	// The thread calling poll() is the first one
+	for (std::size_t i = 1; i < threads; ++i) {
+		_workers.emplace_back(new base::Thread(
+			StringConverter::stringFormat("@#1Worker@#2", _protocolString, i),
+			[this]() {
+				poll(500);
+				return true;
+			}));
+		_workers.back()->startThread();
+	}
+	SI_LOG_INFO("@#1 server listening on port @#2 with @#3 thread(s) and @#4 clients",
+		_protocolString, port, threads,
+		(_maxClients == 0) ? std::string("unlimited") : std::to_string(_maxClients));
+}
+
+void TcpSocket::terminateWorkers() {
+	for (std::unique_ptr<base::Thread> &worker : _workers) {
+		worker->terminateThread();
 	}
-	if (initServerSocket(ipAddr, port, _MAX_CLIENTS, nonblock)) {
-		_pfd[0].fd = _server.getFD();
-		_pfd[0].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-		_pfd[0].revents = 0;
+	_workers.clear();
+}
 
-		for (std::size_t i = 1; i < _MAX_POLL; ++i) {
-			_pfd[i].fd = -1;
-			_pfd[i].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-			_pfd[i].revents = 0;
+int TcpSocket::poll(const int timeout) {
+	if (_epfd == -1) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+		return 0;
+	}
+	struct epoll_event events[MAX_EVENTS];
+	const int n = ::epoll_wait(_epfd, events, MAX_EVENTS, timeout);
+	for (int i = 0; i < n; ++i) {
+		// No client means the server socket
+		if (events[i].data.ptr == nullptr) {
+			acceptConnections();
+		} else {
+			handleClient(*static_cast<SocketClient *>(events[i].data.ptr), events[i].events);
 		}
 	}
+	return n;
 }
 
-int TcpSocket::poll(int timeout) {
-	if (::poll(_pfd, _MAX_POLL, timeout) > 0) {
-		// Check who is sending data, so iterate over pfd
-		for (std::size_t i = 0; i < _MAX_POLL; ++i) {
-			if (_pfd[i].revents == 0) {
-				continue;
-			}
-			// index 0 is server
-			if (i == 0) {
-				// Try to find a free poll entry
-				for (std::size_t j = 0; j < _MAX_CLIENTS; ++j) {
-					if (_pfd[j + 1].fd != -1) {
-						continue;
-					}
-					if (acceptConnection(_client[j], true)) {
-						// setup polling
-						_pfd[j + 1].fd = _client[j].getFD();
-						_pfd[j + 1].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-						_pfd[j + 1].revents = 0;
-						break;
-					}
-				}
-			} else {
-				// receive httpc messages
-				const auto dataSize = recvHttpcMessage(_client[i-1], MSG_DONTWAIT);
-				if (dataSize > 0) {
-					process(_client[i - 1]);
-					continue;
-				}
-				// Try to find the client that requested to close
-				for (std::size_t j = 0; j < _MAX_CLIENTS; ++j) {
-					if (_client[j].getFD() != _pfd[i].fd) {
-						continue;
-					}
-					SI_LOG_INFO("@#1 Client @#2:@#3 Connection closed with fd: @#4",
-						_client[j].getProtocolString(),
-						_client[j].getIPAddressOfSocket(),
-						_client[j].getSocketPort(), _client[j].getFD());
-					_client[j].closeFD();
-					break;
+void TcpSocket::acceptConnections() {
+	// Edge triggered, so accept until there are no more pending connections
+	for (;;) {
+		SocketClient *client = nullptr;
+		{
+			base::MutexLock lock(_mutex);
+			// At the limit the connections stay in the listen backlog, until
+			// closeClient() makes room again
+			if (_maxClients != 0 && _connectedClients >= _maxClients) {
+				if (!_acceptPaused) {
+					SI_LOG_ERROR("@#1 Maximum of @#2 clients reached, not accepting new connections",
+						_protocolString, _maxClients);
 				}
-				_pfd[i].fd = -1;
+				_acceptPaused = true;
+				return;
 			}
+			if (_freeClients.empty()) {
+				_clients.emplace_back(new SocketClient);
+				_clients.back()->setProtocol(_protocolString);
+				_freeClients.push_back(_clients.back().get());
+			}
+			client = _freeClients.back();
+			_freeClients.pop_back();
+		}
+		if (!_server.acceptConnection(*client, true)) {
+			base::MutexLock lock(_mutex);
+			_freeClients.push_back(client);
+			return;
+		}
+		{
+			base::MutexLock lock(_mutex);
+			++_connectedClients;
+		}
+		struct epoll_event ev;
+		ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+		ev.data.ptr = client;
+		if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, client->getFD(), &ev) == -1) {
+			SI_LOG_PERROR("epoll_ctl");
+			closeClient(*client);
 		}
 	}
-	return 1;
 }
 
-bool TcpSocket::initServerSocket(
-		const std::string &ipAddr,
-		int port,
-		int maxClients,
-		bool nonblock) {
+void TcpSocket::handleClient(SocketClient &client, const uint32_t events) {
+	if ((events & (EPOLLERR | EPOLLHUP)) != 0) {
+		closeClient(client);
+		return;
+	}
+	// Edge triggered and one shot, so this thread owns the client until it
+	// is armed again. Handle all the requests that are already received
+	for (;;) {
+		const auto dataSize = recvHttpcMessage(client, MSG_DONTWAIT);
+		if (dataSize == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			// The client keeps the partial request, wait for the rest
+			break;
+		}
+		if (dataSize == -1 && errno == EMSGSIZE) {
+			SI_LOG_ERROR("@#1 Client @#2: Request headers larger than @#3 bytes, closing connection",
+				_protocolString, client.getIPAddressOfSocket(), HttpcRequest::MAX_HEADER_SIZE);
+			// RTSP has no 431, so use the generic one there
+			const std::string reply = (_protocolString == "RTSP") ?
+				"RTSP/1.0 400 Bad Request\r\n\r\n" :
+				"HTTP/1.1 431 Request Header Fields Too Large\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+			client.sendData(reply.data(), reply.size(), MSG_NOSIGNAL);
+			closeClient(client);
+			return;
+		}
+		if (dataSize <= 0) {
+			closeClient(client);
+			return;
+		}
+		process(client);
+
+		// A pipelined request may already be received completely
+		if (client.getRequest().hasNext()) {
+			continue;
+		}
+		char c;
+		const ssize_t pending = ::recv(client.getFD(), &c, 1, MSG_PEEK | MSG_DONTWAIT);
+		if (pending == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+	ev.data.ptr = &client;
+	if (::epoll_ctl(_epfd, EPOLL_CTL_MOD, client.getFD(), &ev) == -1) {
+		SI_LOG_PERROR("epoll_ctl");
+		closeClient(client);
+	}
+}
+
+void TcpSocket::closeClient(SocketClient &client) {
+	SI_LOG_INFO("@#1 Client @#2:@#3 Connection closed with fd: @#4",
+		client.getProtocolString(),
+		client.getIPAddressOfSocket(),
+		client.getSocketPort(), client.getFD());
+	::epoll_ctl(_epfd, EPOLL_CTL_DEL, client.getFD(), nullptr);
+	client.closeFD();
+	bool resume = false;
+	{
+		base::MutexLock lock(_mutex);
+		_freeClients.push_back(&client);
+		--_connectedClients;
+		resume = _acceptPaused;
+		_acceptPaused = false;
+	}
+	// The server socket is edge triggered, so pick up the connections that
+	// are waiting in the backlog
+	if (resume) {
+		SI_LOG_INFO("@#1 Accepting new connections again", _protocolString);
+		acceptConnections();
+	}
+}
+
+bool TcpSocket::initServerSocket(const std::string &ipAddr, const int port) {
 	// fill in the socket structure with host information
 	_server.setupSocketStructure(ipAddr, port, 0);
 
-	if (!_server.setupSocketHandle(SOCK_STREAM | ((nonblock) ? SOCK_NONBLOCK : 0), 0)) {
+	// Non blocking, because the server socket is edge triggered
+	if (!_server.setupSocketHandle(SOCK_STREAM | SOCK_NONBLOCK, 0)) {
 		SI_LOG_ERROR("TCP Server handle failed");
 		return false;
 	}
@@ -136,14 +250,9 @@ bool TcpSocket::initServerSocket(
 		SI_LOG_ERROR("TCP Bind failed");
 		return false;
 	}
-	if (!_server.listen(maxClients)) {
+	if (!_server.listen(SOMAXCONN)) {
 		SI_LOG_ERROR("TCP Listen failed");
 		return false;
 	}
 	return true;
 }
-
-bool TcpSocket::acceptConnection(SocketClient &client, bool showLogInfo) {
-	// check if we have a client?
-	return _server.acceptConnection(client, showLogInfo);
-}
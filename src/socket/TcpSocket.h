@@ -21,14 +21,19 @@
 #define SOCKET_TCPSOCKET_H_INCLUDE SOCKET_TCPSOCKET_H_INCLUDE
 
 #include <FwDecl.h>
+#include <base/Mutex.h>
+#include <base/Thread.h>
 #include <socket/HttpcSocket.h>
 #include <socket/SocketAttr.h>
 
-#include <poll.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 FW_DECL_NS0(SocketClient);
 
-/// TCP Socket
+/// TCP Socket server, the connected clients are watched with an edge
+/// triggered epoll set and the requests can be handled by several threads
 class TcpSocket :
 	public HttpcSocket {
 		// =====================================================================
@@ -37,7 +42,7 @@ class TcpSocket :
 
 	public:
 
-		TcpSocket(int maxClients, const std::string &protocol);
+		explicit TcpSocket(const std::string &protocol);
 
 		virtual ~TcpSocket();
 
@@ -48,13 +53,24 @@ class TcpSocket :
 	public:
 
 		/// Call this function periodically to check for messages
-		/// @param timeout specifies the timeout 'poll' should use
+		/// @param timeout specifies the timeout 'epoll_wait' should use
 		int poll(int timeout);
 
 	protected:
 
 		/// Call this to initialize and setup this socket(s)
-		virtual void initialize(const std::string &ipAddr, int port, bool nonblock);
+		/// @param ipAddr specifies the IP address to bind to
+		/// @param port specifies the port to listen on
+		/// @param maxClients specifies the maximum amount of connected clients,
+		/// 0 means no limit
+		/// @param threads specifies the amount of threads handling requests, the
+		/// thread calling @c poll included
+		virtual void initialize(const std::string &ipAddr, int port,
+			std::size_t maxClients, std::size_t threads);
+
+		/// Stop the extra request threads, call this before the derived class
+		/// is destroyed
+		void terminateWorkers();
 
 		/// Callback function if an messages was received
 		/// @param client specifies the client that sended the message etc.
@@ -68,14 +84,16 @@ class TcpSocket :
 	private:
 
 		///
-		bool initServerSocket(
-			const std::string &ipAddr,
-			int port,
-			int maxClients,
-			bool nonblock);
+		bool initServerSocket(const std::string &ipAddr, int port);
 
-		/// Accept an connection and save client IP address etc.
-		bool acceptConnection(SocketClient &client, bool showLogInfo);
+		/// Accept all pending connections on the server socket
+		void acceptConnections();
+
+		/// Receive and process all pending requests of this client
+		void handleClient(SocketClient &client, uint32_t events);
+
+		/// Close the connection and put the client back in the free list
+		void closeClient(SocketClient &client);
 
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
@@ -83,12 +101,20 @@ class TcpSocket :
 
 	private:
 
-		std::size_t        _MAX_CLIENTS;   //
-		std::size_t        _MAX_POLL;      //
-		struct pollfd     *_pfd;           //
-		SocketAttr         _server;        //
-		SocketClient      *_client;        //
-		const std::string  _protocolString;//
+		static constexpr int MAX_EVENTS = 32;
+
+		base::Mutex        _mutex;           //
+		int                _epfd;            //
+		std::size_t        _maxClients;      // 0 means no limit
+		std::size_t        _connectedClients;//
+		bool               _acceptPaused;    // Stopped accepting at _maxClients
+		SocketAttr         _server;          //
+		const std::string  _protocolString;  //
+		// Clients are never deleted while the server lives, because a
+		// StreamClient may still point to one of them
+		std::vector<std::unique_ptr<SocketClient>> _clients;
+		std::vector<SocketClient *> _freeClients;
+		std::vector<std::unique_ptr<base::Thread>> _workers;
 
 };
 
@@ -79,7 +79,7 @@ void Server::doAddToXML(std::string &xml) const {
 	}
 }
 
-void Server::doFromXML(const std::string &xml) {
+void Server::doFromXML(const base::XMLElement &xml) {
 	base::MutexLock lock(_mutex);
 	std::string element;
 	if (findXMLElement(xml, "annouceTime.value", element)) {
@@ -166,7 +166,7 @@ void Server::checkReply(
 	// save client ip address
 	const std::string ipAddress = inet_ntoa(si_other.sin_addr);
 
-	HeaderVector headers = udpMultiListen.getHeaders();
+	const HeaderVector &headers = udpMultiListen.getHeaders();
 
 	// @TODO we should probably listen to only one message
 	// check do we hear our echo, same UUID
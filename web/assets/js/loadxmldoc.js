@@ -41,3 +41,78 @@ function loadJSONDoc(filename) {
 	jsonhttp.open("GET", filename, true);
 	jsonhttp.send();
 }
+
+var statusEpoch = 0;
+var statusVersion = 0;
+var statusDoc;
+var statusElements = {};
+
+// Rebuild the SatPI.xml document from the status values, which are in
+// document order with a path like 'data/streams/stream1/attached'
+function buildStatusDoc(values) {
+	statusDoc = document.implementation.createDocument(null, null, null);
+	statusElements = {};
+	var nodes = {};
+	for (var path in values) {
+		var names = path.split("/");
+		var parent = statusDoc;
+		var nodePath = "";
+		for (var i = 0; i < names.length; i++) {
+			nodePath += (i > 0) ? "/" + names[i] : names[i];
+			var node = nodes[nodePath];
+			if (!node) {
+				// Repeated elements have an index like 'stream[1]'
+				node = statusDoc.createElement(names[i].replace(/\[\d+\]$/, ""));
+				parent.appendChild(node);
+				nodes[nodePath] = node;
+			}
+			parent = node;
+		}
+		parent.textContent = values[path];
+		statusElements[path] = parent;
+	}
+}
+
+// Poll the status, only the values changed since the previous poll are
+// received. xmlloaded() gets the same document as with loadXMLDoc("SatPI.xml")
+function loadStatusDoc() {
+	if (window.XMLHttpRequest) {
+		statushttp = new XMLHttpRequest();
+	} else if (window.ActiveXObject) {
+		statushttp = new ActiveXObject("Microsoft.XMLHTTP");
+	} else {
+		throw new Error("Ajax is not supported by this browser");
+	}
+	var request = statushttp;
+
+	// callback function
+	request.onreadystatechange = function() {
+		if (request.readyState == 4 && request.status == 200) {
+			var status = JSON.parse(request.responseText);
+			if (status.epoch == statusEpoch && status.version < statusVersion) {
+				// Answer to an older poll
+				return;
+			}
+			if (status.full) {
+				buildStatusDoc(status.values);
+			} else {
+				for (var path in status.values) {
+					if (!statusElements[path]) {
+						// Out of sync, get everything with the next poll
+						statusVersion = 0;
+						return;
+					}
+					statusElements[path].textContent = status.values[path];
+				}
+			}
+			statusEpoch = status.epoch;
+			statusVersion = status.version;
+			filename = "SatPI.xml";
+			xmlLoaded = statusDoc;
+			xmlloaded(statusDoc);
+		}
+	}
+
+	request.open("GET", "status.json?since=" + statusVersion + "&epoch=" + statusEpoch, true);
+	request.send();
+}